@@ -0,0 +1,229 @@
+/*
+ * a5200core.c - display-less interface to the emulation core
+ *
+ * This file is part of the a5200 port of the Atari800 emulator.
+ * See a5200core.h for the description of the calls.
+ */
+
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "a5200core.h"
+#include "antic.h"
+#include "atari.h"
+#include "cartridge.h"
+#include "cpu.h"
+#ifdef CPU_JIT
+#include "cpu_jit.h"
+#endif
+#ifdef CPU_BLOCKS
+#include "cpu_blocks.h"
+#endif
+#include "input.h"
+#include "memory.h"
+#include "pia.h"
+#include "pokeysnd.h"
+#include "rewind.h"
+#include "screen.h"
+#include "statesav.h"
+
+extern EMU_TLS unsigned int trig0;
+extern EMU_TLS unsigned int stick0;
+
+static int load_bios(const char *filename)
+{
+	FILE *fp = fopen(filename, "rb");
+	if (fp == NULL)
+		return FALSE;
+	if (fread(atari_os, 1, 0x800, fp) != 0x800) {
+		fclose(fp);
+		return FALSE;
+	}
+	fclose(fp);
+	return TRUE;
+}
+
+int A5200_Initialise(const char *bios_filename)
+{
+	if (!load_bios(bios_filename))
+		return FALSE;
+	return A5200_InitialiseImage(atari_os);
+}
+
+int A5200_InitialiseImage(const UBYTE *bios)
+{
+	if (bios != atari_os)
+		memcpy(atari_os, bios, 0x800);
+	/* cart_type defaults to CART_5200_32 and CART_Start() would copy
+	   from a NULL image during Coldstart() */
+	CART_Remove();
+	return Atari800_Initialise();
+}
+
+int A5200_LoadCart(const char *filename)
+{
+	return Atari800_OpenFile(filename, TRUE, 1, TRUE);
+}
+
+int A5200_LoadCartImage(const UBYTE *image, int size)
+{
+	if (CART_InsertImage(image, size) != 0)
+		return AFILE_ERROR;
+	Coldstart();
+	return AFILE_ROM;
+}
+
+void A5200_StepFrames(unsigned int frames, unsigned int refresh_rate)
+{
+	while (frames-- > 0)
+		Atari800_Frame(refresh_rate);
+}
+
+const UBYTE *A5200_GetFrameBuffer(int *width, int *height, int *pitch)
+{
+	if (width != NULL)
+		*width = A5200_SCREEN_WIDTH;
+	if (height != NULL)
+		*height = A5200_SCREEN_HEIGHT;
+	if (pitch != NULL)
+		*pitch = SCREEN_PITCH;
+	return vidBuf + 32;
+}
+
+int A5200_SetVideoOutput(int format, void *pixels, int pitch, const ULONG *palette,
+	ULONG shown)
+{
+	switch (format) {
+	case A5200_VIDEO_INDEXED:
+		Screen_SetHostOutput(SCREEN_HOST_NONE, NULL, 0, NULL, 0);
+		return TRUE;
+	case A5200_VIDEO_RGB565:
+		Screen_SetHostOutput(SCREEN_HOST_RGB565, pixels, pitch, palette, shown);
+		return TRUE;
+	case A5200_VIDEO_XRGB8888:
+		Screen_SetHostOutput(SCREEN_HOST_XRGB8888, pixels, pitch, palette, shown);
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+ULONG A5200_GetLineGenerations(const ULONG **line_gen)
+{
+	if (line_gen != NULL)
+		*line_gen = screen_line_gen;
+	return screen_frame_gen;
+}
+
+void A5200_GetAudio(UBYTE *buffer, unsigned int nsamples)
+{
+	Pokey_set_timed(FALSE);
+	Pokey_process(buffer, nsamples);
+}
+
+void A5200_GetFrameAudio(UBYTE *buffer, unsigned int nsamples)
+{
+	Pokey_set_timed(TRUE);
+	Pokey_process_frame(buffer, nsamples);
+}
+
+void A5200_SetAudioQuality(int quality)
+{
+	Pokey_set_mzquality(quality);
+}
+
+void A5200_SetInput(int stick, int trig, int key)
+{
+	stick0 = stick;
+	trig0 = trig;
+	key_code = key;
+}
+
+int A5200_SetCPUEngine(int engine)
+{
+#ifdef CPU_JIT
+	if (engine == A5200_CPU_BLOCKS)
+		return FALSE;
+	return JIT_Enable(engine == A5200_CPU_JIT);
+#elif defined(CPU_BLOCKS)
+	if (engine == A5200_CPU_JIT)
+		return FALSE;
+	return BLOCKS_Enable(engine == A5200_CPU_BLOCKS);
+#else
+	return engine == A5200_CPU_INTERPRETER;
+#endif
+}
+
+void A5200_GetCPUState(A5200_CPUState *state)
+{
+	CPU_GetStatus();
+	state->pc = regPC;
+	state->a = regA;
+	state->x = regX;
+	state->y = regY;
+	state->s = regS;
+	state->p = regP;
+	state->instructions = cpu_instructions;
+	state->xpos = xpos;
+	state->ypos = ypos;
+}
+
+const UBYTE *A5200_GetMemory(void)
+{
+	/* the banks mapped in are read from the cartridge image */
+	MEMORY_SyncROM();
+	return memory;
+}
+
+int A5200_StateSize(void)
+{
+	return AtariStateSize(FALSE);
+}
+
+int A5200_SaveState(UBYTE *buffer, int size)
+{
+	return SaveAtariStateMem(buffer, size, FALSE);
+}
+
+int A5200_LoadState(const UBYTE *buffer, int size)
+{
+	return ReadAtariStateMem(buffer, size);
+}
+
+int A5200_SetRewind(int interval, int size)
+{
+	return Rewind_Init(interval, size);
+}
+
+int A5200_Rewind(void)
+{
+	return Rewind_Back();
+}
+
+int A5200_SetTraceHooks(void (*line)(void), void (*write)(UWORD addr, UBYTE byte),
+	void (*insn)(void))
+{
+#ifdef TRACE_HOOKS
+	trace_line_hook = line;
+	trace_write_hook = write;
+	trace_insn_hook = insn;
+	return TRUE;
+#else
+	return line == NULL && write == NULL && insn == NULL;
+#endif
+}
+
+void A5200_Exit(void)
+{
+#ifdef CPU_JIT
+	JIT_Enable(FALSE);
+#endif
+#ifdef CPU_BLOCKS
+	BLOCKS_Enable(FALSE);
+#endif
+	Screen_SetHostOutput(SCREEN_HOST_NONE, NULL, 0, NULL, 0);
+	Rewind_Init(0, 0);
+	CART_Remove();
+	Atari800_Exit(FALSE);
+}
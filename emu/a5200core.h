@@ -0,0 +1,142 @@
+#ifndef _A5200CORE_H_
+#define _A5200CORE_H_
+
+#include "atari.h"
+
+/* Display-less C interface to the emulation core (liba5200core).
+   Everything here works without SDL; a frontend only has to pace the
+   calls and present the frame buffer and samples somewhere. */
+
+/* Visible part of the frame buffer returned by A5200_GetFrameBuffer(). */
+#define A5200_SCREEN_WIDTH   320
+#define A5200_SCREEN_HEIGHT  240
+
+/* Format of the samples produced by A5200_GetAudio(): unsigned 8-bit mono. */
+#define A5200_SAMPLE_RATE    44100
+
+/* Loads the 2 KB 5200 BIOS image and initialises the core.
+   Returns FALSE if the BIOS can't be read. */
+int A5200_Initialise(const char *bios_filename);
+/* Same with the 2 KB BIOS image already in memory. */
+int A5200_InitialiseImage(const UBYTE *bios);
+
+/* Inserts a cartridge image and cold-starts the machine.
+   Returns one of the AFILE_* values, AFILE_ERROR on failure. */
+int A5200_LoadCart(const char *filename);
+/* Same for a raw cartridge image (no CART header) of size bytes. */
+int A5200_LoadCartImage(const UBYTE *image, int size);
+
+/* Emulates the given number of frames as fast as possible.
+   refresh_rate works as for Atari800_Frame(): the screen is drawn
+   once every refresh_rate frames, 0 or 1 draws every frame. */
+void A5200_StepFrames(unsigned int frames, unsigned int refresh_rate);
+
+/* Returns the first visible pixel of the frame buffer. Each pixel is an
+   Atari colour code; *pitch receives the distance in bytes between lines. */
+const UBYTE *A5200_GetFrameBuffer(int *width, int *height, int *pitch);
+
+/* Pixel formats for A5200_SetVideoOutput() */
+#define A5200_VIDEO_INDEXED    0	/* Atari colour codes, A5200_GetFrameBuffer() */
+#define A5200_VIDEO_RGB565     1
+#define A5200_VIDEO_XRGB8888   2
+
+/* Makes the following frames be drawn straight into a host buffer of
+   A5200_SCREEN_WIDTH x A5200_SCREEN_HEIGHT pixels, pitch bytes per line,
+   each line converted as soon as it is drawn, instead of the Atari colour
+   codes of A5200_GetFrameBuffer() (which then isn't updated). palette
+   holds the host pixel values of the 256 Atari colours for the even
+   lines followed by those for the odd lines. shown is the frame the
+   buffer shows already (see A5200_GetLineGenerations()), 0 if none: the
+   lines that haven't changed since are left as they are, on this and
+   the next frames drawn into the same buffer.
+   A5200_VIDEO_INDEXED goes back to the frame buffer. Returns FALSE for an
+   unknown format. */
+int A5200_SetVideoOutput(int format, void *pixels, int pitch, const ULONG *palette,
+	ULONG shown);
+
+/* Returns the number of the last drawn frame and points *line_gen at
+   A5200_SCREEN_HEIGHT entries, the number of the last frame that changed
+   each line. A copy of frame n only needs the lines with line_gen > n. */
+ULONG A5200_GetLineGenerations(const ULONG **line_gen);
+
+/* Synthesizes the next nsamples samples of POKEY output into buffer. */
+void A5200_GetAudio(UBYTE *buffer, unsigned int nsamples);
+
+/* Synthesizes the POKEY output of the frame just emulated as nsamples
+   samples into buffer (A5200_SAMPLE_RATE / 60 to keep up with 60 frames a
+   second). Each register write is heard from the sample matching the
+   cycle it happened at, not from the start of the buffer as with
+   A5200_GetAudio(). The first call switches POKEY to timed writes,
+   A5200_GetAudio() back. */
+void A5200_GetFrameAudio(UBYTE *buffer, unsigned int nsamples);
+
+/* Output quality of the POKEY sound of the calling thread's machine,
+   kept when it loads another cartridge: 0 (the default) takes the output at
+   the cycle each sample falls on, which is cheapest but folds tones above
+   half the sample rate back as false ones; 1 to 3 synthesize it
+   band-limited, each about twice the work of the one before. */
+void A5200_SetAudioQuality(int quality);
+
+/* Sets controller 0: STICK_* position, trigger (0 = pressed)
+   and AKEY_5200_* keypad code (AKEY_NONE for no key). */
+void A5200_SetInput(int stick, int trig, int key);
+
+/* 6502 engines for A5200_SetCPUEngine() */
+#define A5200_CPU_INTERPRETER  0
+#define A5200_CPU_JIT          1	/* x86-64 only, needs make JIT=1 */
+#define A5200_CPU_BLOCKS       2	/* pre-decoded blocks, needs make BLOCKS=1 */
+
+/* Selects how the 6502 code runs; the default is the interpreter. Both
+   run the same instructions with the same timing. Returns FALSE if the
+   engine isn't available in this build. */
+int A5200_SetCPUEngine(int engine);
+
+typedef struct {
+	UWORD pc;
+	UBYTE a, x, y, s, p;
+	ULONG instructions;			/* executed so far, 0 without CPU_INSN_COUNT */
+	int xpos, ypos;				/* beam position in cycles and scanlines */
+} A5200_CPUState;
+
+/* Reads the 6502 registers as they are between two frames, or inside
+   a frame from one of the trace hooks below. */
+void A5200_GetCPUState(A5200_CPUState *state);
+/* Returns the 64 KB address space as the 6502 sees it without the
+   hardware registers: RAM at 0x0000-0x3fff, cartridge and BIOS ROM. */
+const UBYTE *A5200_GetMemory(void);
+
+/* Snapshots of the whole machine between two frames, in a buffer of the
+   caller: A5200_StateSize() bytes are enough for one (it stays the same
+   for a cartridge), A5200_SaveState() returns the length it used, 0 if
+   the buffer is too small. The bytes are those of an uncompressed state
+   file. A5200_LoadState() only restores a snapshot of the cartridge in
+   already, or of one it can load from the file it came from; returns
+   FALSE if buffer doesn't hold a snapshot. */
+int A5200_StateSize(void);
+int A5200_SaveState(UBYTE *buffer, int size);
+int A5200_LoadState(const UBYTE *buffer, int size);
+
+/* Rewinding (emu/rewind.h): a snapshot every interval frames kept in
+   size bytes as differences to the next one, 0 switches it off. Returns
+   FALSE if there's no memory for it. A5200_Rewind() goes back to the
+   latest snapshot and drops it, so each call steps back further;
+   returns FALSE once the history is used up. Loading a cartridge
+   starts a new history. */
+int A5200_SetRewind(int interval, int size);
+int A5200_Rewind(void);
+
+/* Sets functions the core calls while it emulates, NULL for none:
+   line at the end of each scanline, write before each write to a
+   hardware register or to the cartridge area (bank switching) and insn
+   before each 6502 instruction, with the JIT and the blocks left out
+   while it is set. The hooks may call A5200_GetCPUState() and
+   A5200_GetMemory().
+   Returns FALSE if the core was built without TRACE_HOOKS (make
+   LOCKSTEP=1). */
+int A5200_SetTraceHooks(void (*line)(void), void (*write)(UWORD addr, UBYTE byte),
+	void (*insn)(void));
+
+/* Removes the cartridge and shuts the core down. */
+void A5200_Exit(void);
+
+#endif /* _A5200CORE_H_ */
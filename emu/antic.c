@@ -26,7 +26,6 @@
 #include <string.h>
 
 #define ALEKSCR_DIRECT 1
-#include "shared.h"
 
 #define NO_YPOS_BREAK_FLICKER
 
@@ -38,7 +37,9 @@
 #include "screen.h"
 
 #include "memory.h"
+#include "pokey.h"
 #include "pokeysnd.h"
+#include "profile.h"
 #include "util.h"
 #if !defined(BASIC) && !defined(CURSES_BASIC)
 #include "input.h"
@@ -51,10 +52,25 @@
 #include "cycle_map.h"
 #endif
 
+#ifdef FRAME_PROFILE
+/* charge the time spent in the other chips to their own stage */
+#define GO(limit)           PROFILE_CALL(PROFILE_CPU, GO(limit))
+#define new_pm_scanline()   PROFILE_CALL(PROFILE_GTIA, new_pm_scanline())
+#define update_pmpl_colls() PROFILE_CALL(PROFILE_GTIA, update_pmpl_colls())
+#endif
+
+/* POKEY_Scanline() only on the lines where it has something to do */
+#define POKEY_Scanline() do { \
+		if (POKEY_LINE_DUE()) \
+			PROFILE_CALL(PROFILE_POKEY, POKEY_Scanline()); \
+		else \
+			pokey_pending_lines++; \
+	} while (0)
+
 #define LCHOP 3			/* do not build lefmost 0..3 characters in wide mode */
 #define RCHOP 3			/* do not build rightmost 0..3 characters in wide mode */
 
-int break_ypos = 999;
+EMU_TLS int break_ypos = 999;
 #ifdef NEW_CYCLE_EXACT
 void draw_partial_scanline(int l,int r);
 void update_scanline(void);
@@ -67,7 +83,7 @@ const int *antic2cpu_ptr;
 int delayed_wsync = 0;
 int dmactl_changed = 0;
 UBYTE DELAYED_DMACTL;
-int draw_antic_ptr_changed = 0;
+EMU_TLS int draw_antic_ptr_changed = 0;
 UBYTE need_load;
 int dmactl_bug_chdata;
 #ifndef NO_GTIA11_DELAY
@@ -233,19 +249,19 @@ void video_putbyte(UBYTE *ptr, UBYTE val) {
     
 /* ANTIC Registers --------------------------------------------------------- */
 
-UBYTE DMACTL;
-UBYTE CHACTL;
-UWORD dlist;
-UBYTE HSCROL;
-UBYTE VSCROL;
-UBYTE PMBASE;
-UBYTE CHBASE;
-UBYTE NMIEN;
-UBYTE NMIST;
+EMU_TLS UBYTE DMACTL;
+EMU_TLS UBYTE CHACTL;
+EMU_TLS UWORD dlist;
+EMU_TLS UBYTE HSCROL;
+EMU_TLS UBYTE VSCROL;
+EMU_TLS UBYTE PMBASE;
+EMU_TLS UBYTE CHBASE;
+EMU_TLS UBYTE NMIEN;
+EMU_TLS UBYTE NMIST;
 
 /* ANTIC Memory ------------------------------------------------------------ */
 
-UBYTE ANTIC_memory[52];
+EMU_TLS UBYTE ANTIC_memory[52];
 #define ANTIC_margin 4
 /* It's number of bytes in ANTIC_memory, which are never loaded, but may be
    read in wide playfield mode. These bytes are uninitialized, because on
@@ -257,7 +273,7 @@ UBYTE ANTIC_memory[52];
    This allows special optimisations under certain conditions.
    ------------------------------------------------------------------------ */
 
-UWORD *scrn_ptr;
+EMU_TLS UWORD *scrn_ptr;
 
 /* Separate access to XE extended memory ----------------------------------- */
 /* It's available in 130 XE and 320 KB Compy Shop.
@@ -271,7 +287,7 @@ UWORD *scrn_ptr;
 /* Pointer to 16 KB seen by ANTIC in 0x4000-0x7fff.
    If it's the same what the CPU sees (and what's in memory[0x4000..0x7fff],
    then NULL. */
-const UBYTE *antic_xe_ptr = NULL;
+EMU_TLS const UBYTE *antic_xe_ptr = NULL;
 
 /* ANTIC Timing --------------------------------------------------------------
 
@@ -419,7 +435,7 @@ These are all cases:
 #define SCR_C	28
 #define VSCOF_C	112
 
-unsigned int screenline_cpu_clock = 0;
+EMU_TLS unsigned int screenline_cpu_clock = 0;
 
 #ifdef NEW_CYCLE_EXACT
 #define UPDATE_DMACTL if (dmactl_changed) { \
@@ -433,20 +449,29 @@ unsigned int screenline_cpu_clock = 0;
 #else
 #define UPDATE_DMACTL
 #endif /* NEW_CYCLE_EXACT */
+#ifdef TRACE_HOOKS
+#define TRACE_LINE if (trace_line_hook != NULL) trace_line_hook()
+#else
+#define TRACE_LINE
+#endif
 #define GOEOL_CYCLE_EXACT  GO(antic2cpu_ptr[LINE_C]); \
 	xpos = cpu2antic_ptr[xpos]; \
 	xpos -= LINE_C; \
 	screenline_cpu_clock += LINE_C; \
 	ypos++; \
-	update_pmpl_colls();
-#define GOEOL GO(LINE_C); xpos -= LINE_C; screenline_cpu_clock += LINE_C; UPDATE_DMACTL ypos++
+	update_pmpl_colls(); \
+	TRACE_LINE;
+#define GOEOL GO(LINE_C); xpos -= LINE_C; screenline_cpu_clock += LINE_C; UPDATE_DMACTL ypos++; TRACE_LINE
 #define OVERSCREEN_LINE	xpos += DMAR; GOEOL
 
-int xpos = 0;
-int xpos_limit;
-UBYTE wsync_halt = FALSE;
+EMU_TLS int xpos = 0;
+EMU_TLS int xpos_limit;
+EMU_TLS UBYTE wsync_halt = FALSE;
 
-int ypos;						/* Line number - lines 8..247 are on screen */
+EMU_TLS int ypos;						/* Line number - lines 8..247 are on screen */
+#ifdef TRACE_HOOKS
+EMU_TLS void (*trace_line_hook)(void) = NULL;
+#endif
 
 /* Timing in first line of modes 2-5
 In these modes ANTIC takes more bytes than cycles. Despite this, it would be
@@ -462,20 +487,20 @@ contains difference between bytes taken and cycles taken plus before_cycles. */
 
 static UBYTE PENH;
 static UBYTE PENV;
-UBYTE PENH_input = 0x00;
-UBYTE PENV_input = 0xff;
+EMU_TLS UBYTE PENH_input = 0x00;
+EMU_TLS UBYTE PENV_input = 0xff;
 
 #ifndef BASIC
 
 /* Internal ANTIC registers ------------------------------------------------ */
 
-static UWORD screenaddr;		/* Screen Pointer */
-static UBYTE IR;				/* Instruction Register */
-static UBYTE anticmode;			/* Antic mode */
-static UBYTE dctr;				/* Delta Counter */
-static UBYTE lastline;			/* dctr limit */
-static UBYTE need_dl;			/* boolean: fetch DL next line */
-static UBYTE vscrol_off;		/* boolean: displaying line ending VSC */
+static EMU_TLS UWORD screenaddr;		/* Screen Pointer */
+static EMU_TLS UBYTE IR;				/* Instruction Register */
+static EMU_TLS UBYTE anticmode;			/* Antic mode */
+static EMU_TLS UBYTE dctr;				/* Delta Counter */
+static EMU_TLS UBYTE lastline;			/* dctr limit */
+static EMU_TLS UBYTE need_dl;			/* boolean: fetch DL next line */
+static EMU_TLS UBYTE vscrol_off;		/* boolean: displaying line ending VSC */
 
 #endif
 
@@ -489,23 +514,23 @@ static UBYTE vscrol_off;		/* boolean: displaying line ending VSC */
 #define SCROLL0 3				/* modes 2,3,4,5,0xd,0xe,0xf with HSC */
 #define SCROLL1 4				/* modes 6,7,0xa,0xb,0xc with HSC */
 #define SCROLL2 5				/* modes 8,9 with HSC */
-static int md;					/* current mode NORMAL0..SCROLL2 */
+static EMU_TLS int md;					/* current mode NORMAL0..SCROLL2 */
 /* tables for modes NORMAL0..SCROLL2 */
-static int chars_read[6];
-static int chars_displayed[6];
-static int x_min[6];
-static int ch_offset[6];
-static int load_cycles[6];
-static int font_cycles[6];
-static int before_cycles[6];
-static int extra_cycles[6];
+static EMU_TLS int chars_read[6];
+static EMU_TLS int chars_displayed[6];
+static EMU_TLS int x_min[6];
+static EMU_TLS int ch_offset[6];
+static EMU_TLS int load_cycles[6];
+static EMU_TLS int font_cycles[6];
+static EMU_TLS int before_cycles[6];
+static EMU_TLS int extra_cycles[6];
 
 /* border parameters for current display width */
-static int left_border_chars;
-static int right_border_start;
+static EMU_TLS int left_border_chars;
+static EMU_TLS int right_border_start;
 #ifdef NEW_CYCLE_EXACT
-static int left_border_start = LCHOP * 4;
-static int right_border_end = (48 - RCHOP) * 4;
+static EMU_TLS int left_border_start = LCHOP * 4;
+static EMU_TLS int right_border_end = (48 - RCHOP) * 4;
 #define LBORDER_START left_border_start
 #define RBORDER_END right_border_end
 #else
@@ -514,23 +539,23 @@ static int right_border_end = (48 - RCHOP) * 4;
 #endif /* NEW_CYCLE_EXACT */
 
 /* set with CHBASE *and* CHACTL - bits 0..2 set if flip on */
-static UWORD chbase_20;			/* CHBASE for 20 character mode */
+static EMU_TLS UWORD chbase_20;			/* CHBASE for 20 character mode */
 
 /* set with CHACTL */
-static UBYTE invert_mask;
-static int blank_mask;
+static EMU_TLS UBYTE invert_mask;
+static EMU_TLS int blank_mask;
 
 /* A scanline of AN0 and AN1 signals as transmitted from ANTIC to GTIA.
    In every byte, bit 0 is AN0 and bit 1 is AN1 */
-static UBYTE an_scanline[ATARI_WIDTH / 2 + 8];
+static EMU_TLS UBYTE an_scanline[ATARI_WIDTH / 2 + 8];
 
 /* lookup tables */
-static UBYTE blank_lookup[256];
-static UWORD lookup2[256];
-ULONG lookup_gtia9[16];
-ULONG lookup_gtia11[16];
-static UBYTE playfield_lookup[257];
-static UBYTE mode_e_an_lookup[256];
+static EMU_TLS UBYTE blank_lookup[256];
+static EMU_TLS UWORD lookup2[256];
+EMU_TLS ULONG lookup_gtia9[16];
+EMU_TLS ULONG lookup_gtia11[16];
+static EMU_TLS UBYTE playfield_lookup[257];
+static EMU_TLS UBYTE mode_e_an_lookup[256];
 
 /* Colour lookup table
    This single table replaces 4 previously used: cl_word, cur_prior,
@@ -560,7 +585,7 @@ static UBYTE mode_e_an_lookup[256];
    PF3 if (PRIOR & 0x1f) == 0x10, PF0 or PF1 otherwise.
    Additional column 'colls' holds collisions of playfields with PMG. */
 
-UWORD cl_lookup[128];
+EMU_TLS UWORD cl_lookup[128];
 
 #define C_PM0	0x01
 #define C_PM1	0x02
@@ -675,13 +700,13 @@ UWORD cl_lookup[128];
 #define HIRES_LUM_10	0x000f
 #endif
 
-static UWORD hires_lookup_n[128];
-static UWORD hires_lookup_m[128];
+static EMU_TLS UWORD hires_lookup_n[128];
+static EMU_TLS UWORD hires_lookup_m[128];
 #define hires_norm(x)	hires_lookup_n[(x) >> 1]
 #define hires_mask(x)	hires_lookup_m[(x) >> 1]
 
 #ifndef USE_COLOUR_TRANSLATION_TABLE
-UWORD hires_lookup_l[128];	/* accessed in gtia.c */
+EMU_TLS UWORD hires_lookup_l[128];	/* accessed in gtia.c */
 #define hires_lum(x)	hires_lookup_l[(x) >> 1]
 #endif
 
@@ -693,24 +718,24 @@ UWORD hires_lookup_l[128];	/* accessed in gtia.c */
 #define PF3PM (*(UBYTE *) &cl_lookup[C_PF3 | C_COLLS])
 #define PF_COLLS(x) (((UBYTE *) &cl_lookup)[(x) + L_COLLS])
 
-static UBYTE singleline;
-UBYTE player_dma_enabled;
-UBYTE player_gra_enabled;
-UBYTE missile_dma_enabled;
-UBYTE missile_gra_enabled;
-UBYTE player_flickering;
-UBYTE missile_flickering;
+static EMU_TLS UBYTE singleline;
+EMU_TLS UBYTE player_dma_enabled;
+EMU_TLS UBYTE player_gra_enabled;
+EMU_TLS UBYTE missile_dma_enabled;
+EMU_TLS UBYTE missile_gra_enabled;
+EMU_TLS UBYTE player_flickering;
+EMU_TLS UBYTE missile_flickering;
 
-static UWORD pmbase_s;
-static UWORD pmbase_d;
+static EMU_TLS UWORD pmbase_s;
+static EMU_TLS UWORD pmbase_d;
 
-extern UBYTE pm_scanline[ATARI_WIDTH / 2 + 8];
-extern UBYTE pm_dirty;
+extern EMU_TLS UBYTE pm_scanline[ATARI_WIDTH / 2 + 8];
+extern EMU_TLS UBYTE pm_dirty;
 
 /* PMG lookup tables */
-UBYTE pm_lookup_table[20][256];
+EMU_TLS UBYTE pm_lookup_table[20][256];
 /* current PMG lookup table */
-static const UBYTE *pm_lookup_ptr;
+static EMU_TLS const UBYTE *pm_lookup_ptr;
 
 #define PL_00	0	/* 0x00,0x01,0x02,0x03,0x04,0x06,0x08,0x09,0x0a,0x0b */
 #define PL_05	1	/* 0x05,0x07,0x0c,0x0d,0x0e,0x0f */
@@ -820,7 +845,7 @@ static void pmg_dma(void) {
 				if (antic_xe_ptr != NULL && pmbase_s < 0x8000 && pmbase_s >= 0x4000)
 					base = antic_xe_ptr + pmbase_s - 0x4000 + ypos;
 				else
-					base = memory + pmbase_s + ypos;
+					base = dFetchPtr(pmbase_s + ypos);
 				if (ypos & 1) {
 					GRAFP0 = base[0x400];
 					GRAFP1 = base[0x500];
@@ -842,7 +867,7 @@ static void pmg_dma(void) {
 				if (antic_xe_ptr != NULL && pmbase_d < 0x8000 && pmbase_d >= 0x4000)
 					base = antic_xe_ptr + (pmbase_d - 0x4000) + (ypos >> 1);
 				else
-					base = memory + pmbase_d + (ypos >> 1);
+					base = dFetchPtr(pmbase_d + (ypos >> 1));
 				if (ypos & 1) {
 					GRAFP0 = base[0x200];
 					GRAFP1 = base[0x280];
@@ -869,7 +894,7 @@ static void pmg_dma(void) {
 			if (antic_xe_ptr != NULL && pmbase_s < 0x8000 && pmbase_s >= 0x4000)
 				data = antic_xe_ptr[singleline ? pmbase_s + ypos + 0x300 - 0x4000 : pmbase_d + (ypos >> 1) + 0x180 - 0x4000];
 			else
-				data = dGetByte(singleline ? pmbase_s + ypos + 0x300 : pmbase_d + (ypos >> 1) + 0x180);
+				data = dFetchByte(singleline ? pmbase_s + ypos + 0x300 : pmbase_d + (ypos >> 1) + 0x180);
 			/* in odd lines load all missiles, in even only those, for which VDELAY bit is zero */
 			GRAFM = ypos & 1 ? data : ((GRAFM ^ data) & hold_missiles_tab[VDELAY & 0xf]) ^ data;
 		}
@@ -879,28 +904,29 @@ static void pmg_dma(void) {
 
 /* Artifacting ------------------------------------------------------------ */
 
-int global_artif_mode;
+EMU_TLS int global_artif_mode;
 
-static ULONG art_lookup_normal[256];
-static ULONG art_lookup_reverse[256];
-static ULONG art_bkmask_normal[256];
-static ULONG art_lummask_normal[256];
-static ULONG art_bkmask_reverse[256];
-static ULONG art_lummask_reverse[256];
+static EMU_TLS ULONG art_lookup_normal[256];
+static EMU_TLS ULONG art_lookup_reverse[256];
+static EMU_TLS ULONG art_bkmask_normal[256];
+static EMU_TLS ULONG art_lummask_normal[256];
+static EMU_TLS ULONG art_bkmask_reverse[256];
+static EMU_TLS ULONG art_lummask_reverse[256];
 
-static ULONG *art_curtable = art_lookup_normal;
-static ULONG *art_curbkmask = art_bkmask_normal;
-static ULONG *art_curlummask = art_lummask_normal;
+/* thread-local addresses aren't constants: these are set in ANTIC_Initialise() */
+static EMU_TLS ULONG *art_curtable;
+static EMU_TLS ULONG *art_curbkmask;
+static EMU_TLS ULONG *art_curlummask;
 
-static UWORD art_normal_colpf1_save;
-static UWORD art_normal_colpf2_save;
-static UWORD art_reverse_colpf1_save;
-static UWORD art_reverse_colpf2_save;
+static EMU_TLS UWORD art_normal_colpf1_save;
+static EMU_TLS UWORD art_normal_colpf2_save;
+static EMU_TLS UWORD art_reverse_colpf1_save;
+static EMU_TLS UWORD art_reverse_colpf2_save;
+static EMU_TLS UWORD *art_colpf1_save;
+static EMU_TLS UWORD *art_colpf2_save;
 
 static void setup_art_colours(void)
 {
-	static UWORD *art_colpf1_save = &art_normal_colpf1_save;
-	static UWORD *art_colpf2_save = &art_normal_colpf2_save;
 	UWORD curlum = cl_lookup[C_PF1] & 0x0f0f;
 
 	if (curlum != *art_colpf1_save || cl_lookup[C_PF2] != *art_colpf2_save) {
@@ -944,6 +970,12 @@ static void setup_art_colours(void)
 
 void ANTIC_Initialise(void) {
 #if !defined(BASIC) && !defined(CURSES_BASIC)
+	atari_screen = (UWORD *) vidBuf;
+	art_curtable = art_lookup_normal;
+	art_curbkmask = art_bkmask_normal;
+	art_curlummask = art_lummask_normal;
+	art_colpf1_save = &art_normal_colpf1_save;
+	art_colpf2_save = &art_normal_colpf2_save;
 	ANTIC_UpdateArtifacting();
 
 	playfield_lookup[0x00] = L_BAK;
@@ -1350,7 +1382,7 @@ static void draw_an_gtia11(const ULONG *t_pm_scanline_ptr)
 
 #define GET_CHDATA_ANTIC_2	chdata = (screendata & invert_mask) ? 0xff : 0;\
 	if (blank_lookup[screendata & blank_mask])\
-		chdata ^= dGetByte(t_chbase + ((UWORD) (screendata & 0x7f) << 3));
+		chdata ^= dFetchByte(t_chbase + ((UWORD) (screendata & 0x7f) << 3));
 
 #else /* PAGED_MEM */
 
@@ -1358,7 +1390,7 @@ static void draw_an_gtia11(const ULONG *t_pm_scanline_ptr)
 	if (antic_xe_ptr != NULL && chbase_20 < 0x8000 && chbase_20 >= 0x4000)\
 		chptr = antic_xe_ptr + ((dctr ^ chbase_20) & 0x3c07);\
 	else\
-		chptr = memory + ((dctr ^ chbase_20) & 0xfc07);\
+		chptr = dFetchPtr((dctr ^ chbase_20) & 0xfc07);\
 	ADD_FONT_CYCLES;\
 	blank_lookup[0x60] = (anticmode == 2 || dctr & 0xe) ? 0xff : 0;\
 	blank_lookup[0x00] = blank_lookup[0x20] = blank_lookup[0x40] = (dctr & 0xe) == 8 ? 0 : 0xff;
@@ -1474,7 +1506,7 @@ static void prepare_an_antic_2(int nchars, const UBYTE *ANTIC_memptr, const ULON
 	if (antic_xe_ptr != NULL && chbase_20 < 0x8000 && chbase_20 >= 0x4000)
 		chptr = antic_xe_ptr + ((dctr ^ chbase_20) & 0x3c07);
 	else
-		chptr = memory + ((dctr ^ chbase_20) & 0xfc07);
+		chptr = dFetchPtr((dctr ^ chbase_20) & 0xfc07);
 #endif
 
 	CHAR_LOOP_BEGIN
@@ -1661,7 +1693,7 @@ static void draw_antic_4(int nchars, const UBYTE *ANTIC_memptr, UWORD *ptr, cons
 	if (antic_xe_ptr != NULL && chbase_20 < 0x8000 && chbase_20 >= 0x4000)
 		chptr = antic_xe_ptr + (((anticmode == 4 ? dctr : dctr >> 1) ^ chbase_20) & 0x3c07);
 	else
-		chptr = memory + (((anticmode == 4 ? dctr : dctr >> 1) ^ chbase_20) & 0xfc07);
+		chptr = dFetchPtr(((anticmode == 4 ? dctr : dctr >> 1) ^ chbase_20) & 0xfc07);
 #endif
 
 	ADD_FONT_CYCLES;
@@ -1682,7 +1714,7 @@ static void draw_antic_4(int nchars, const UBYTE *ANTIC_memptr, UWORD *ptr, cons
 		else
 			lookup = lookup2;
 #ifdef PAGED_MEM
-		chdata = dGetByte(t_chbase + ((UWORD) (screendata & 0x7f) << 3));
+		chdata = dFetchByte(t_chbase + ((UWORD) (screendata & 0x7f) << 3));
 #else
 		chdata = chptr[(screendata & 0x7f) << 3];
 #endif
@@ -1724,7 +1756,7 @@ static void prepare_an_antic_4(int nchars, const UBYTE *ANTIC_memptr, const ULON
 	if (antic_xe_ptr != NULL && chbase_20 < 0x8000 && chbase_20 >= 0x4000)
 		chptr = antic_xe_ptr + (((anticmode == 4 ? dctr : dctr >> 1) ^ chbase_20) & 0x3c07);
 	else
-		chptr = memory + (((anticmode == 4 ? dctr : dctr >> 1) ^ chbase_20) & 0xfc07);
+		chptr = dFetchPtr(((anticmode == 4 ? dctr : dctr >> 1) ^ chbase_20) & 0xfc07);
 #endif
 
 	ADD_FONT_CYCLES;
@@ -1733,7 +1765,7 @@ static void prepare_an_antic_4(int nchars, const UBYTE *ANTIC_memptr, const ULON
 		UBYTE an;
 		UBYTE chdata;
 #ifdef PAGED_MEM
-		chdata = dGetByte(t_chbase + ((UWORD) (screendata & 0x3f) << 3));
+		chdata = dFetchByte(t_chbase + ((UWORD) (screendata & 0x3f) << 3));
 #else
 		chdata = chptr[(screendata & 0x3f) << 3];
 #endif
@@ -1759,7 +1791,7 @@ static void draw_antic_6(int nchars, const UBYTE *ANTIC_memptr, UWORD *ptr, cons
 	if (antic_xe_ptr != NULL && chbase_20 < 0x8000 && chbase_20 >= 0x4000)
 		chptr = antic_xe_ptr + (((anticmode == 6 ? dctr & 7 : dctr >> 1) ^ chbase_20) - 0x4000);
 	else
-		chptr = memory + ((anticmode == 6 ? dctr & 7 : dctr >> 1) ^ chbase_20);
+		chptr = dFetchPtr((anticmode == 6 ? dctr & 7 : dctr >> 1) ^ chbase_20);
 #endif
 
 	ADD_FONT_CYCLES;
@@ -1770,7 +1802,7 @@ static void draw_antic_6(int nchars, const UBYTE *ANTIC_memptr, UWORD *ptr, cons
 		int kk = 2;
 		colour = COLOUR((playfield_lookup + 0x40)[screendata & 0xc0]);
 #ifdef PAGED_MEM
-		chdata = dGetByte(t_chbase + ((UWORD) (screendata & 0x3f) << 3));
+		chdata = dFetchByte(t_chbase + ((UWORD) (screendata & 0x3f) << 3));
 #else
 		chdata = chptr[(screendata & 0x3f) << 3];
 #endif
@@ -1839,7 +1871,7 @@ static void prepare_an_antic_6(int nchars, const UBYTE *ANTIC_memptr, const ULON
 	if (antic_xe_ptr != NULL && chbase_20 < 0x8000 && chbase_20 >= 0x4000)
 		chptr = antic_xe_ptr + (((anticmode == 6 ? dctr & 7 : dctr >> 1) ^ chbase_20) - 0x4000);
 	else
-		chptr = memory + ((anticmode == 6 ? dctr & 7 : dctr >> 1) ^ chbase_20);
+		chptr = dFetchPtr((anticmode == 6 ? dctr & 7 : dctr >> 1) ^ chbase_20);
 #endif
 
 	ADD_FONT_CYCLES;
@@ -1848,7 +1880,7 @@ static void prepare_an_antic_6(int nchars, const UBYTE *ANTIC_memptr, const ULON
 		UBYTE an = screendata >> 6;
 		UBYTE chdata;
 #ifdef PAGED_MEM
-		chdata = dGetByte(t_chbase + ((UWORD) (screendata & 0x3f) << 3));
+		chdata = dFetchByte(t_chbase + ((UWORD) (screendata & 0x3f) << 3));
 #else
 		chdata = chptr[(screendata & 0x3f) << 3];
 #endif
@@ -2414,7 +2446,7 @@ static void draw_antic_f_gtia_bug(int nchars, const UBYTE *ANTIC_memptr, UWORD *
 typedef void (*draw_antic_function)(int nchars, const UBYTE *ANTIC_memptr, UWORD *ptr, const ULONG *t_pm_scanline_ptr);
 
 /* tables for all GTIA and ANTIC modes */
-static draw_antic_function draw_antic_table[4][16] = {
+static EMU_TLS draw_antic_function draw_antic_table[4][16] = {
 /* normal */
 		{ NULL,			NULL,			draw_antic_2,	draw_antic_2,
 		draw_antic_4,	draw_antic_4,	draw_antic_6,	draw_antic_6,
@@ -2437,12 +2469,12 @@ static draw_antic_function draw_antic_table[4][16] = {
 		draw_antic_9_gtia11,	draw_antic_e_gtia11,	draw_antic_e_gtia11,	draw_antic_f_gtia11}};
 
 /* pointer to current GTIA/ANTIC mode routine */
-static draw_antic_function draw_antic_ptr = draw_antic_8;
+static EMU_TLS draw_antic_function draw_antic_ptr = draw_antic_8;
 #ifdef NEW_CYCLE_EXACT
-static draw_antic_function saved_draw_antic_ptr;
+static EMU_TLS draw_antic_function saved_draw_antic_ptr;
 #endif
 /* pointer to current GTIA mode blank drawing routine */
-static void (*draw_antic_0_ptr)(void) = draw_antic_0;
+static EMU_TLS void (*draw_antic_0_ptr)(void) = draw_antic_0;
 
 #ifdef NEW_CYCLE_EXACT
 /* wrapper for antic_0, for dmactl bugs */
@@ -2594,13 +2626,13 @@ static void ANTIC_load(void)
 	UWORD new_screenaddr = screenaddr + chars_read[md];
 	if ((screenaddr ^ new_screenaddr) & 0xf000) {
 		do
-			*ANTIC_memptr++ = dGetByte(screenaddr++);
+			*ANTIC_memptr++ = dFetchByte(screenaddr++);
 		while (screenaddr & 0xfff);
 		screenaddr -= 0x1000;
 		new_screenaddr -= 0x1000;
 	}
 	while (screenaddr < new_screenaddr)
-		*ANTIC_memptr++ = dGetByte(screenaddr++);
+		*ANTIC_memptr++ = dFetchByte(screenaddr++);
 #else
 	UWORD new_screenaddr = screenaddr + chars_read[md];
 	if ((screenaddr ^ new_screenaddr) & 0xf000) {
@@ -2616,9 +2648,9 @@ static void ANTIC_load(void)
 				CopyFromMem((UWORD) (screenaddr + bytes - 0x1000), ANTIC_memory + ANTIC_margin + bytes, new_screenaddr & 0xfff);
 		}
 		else {
-			dCopyFromMem(screenaddr, ANTIC_memory + ANTIC_margin, bytes);
+			memcpy(ANTIC_memory + ANTIC_margin, dFetchPtr(screenaddr), bytes);
 			if (new_screenaddr & 0xfff)
-				dCopyFromMem(screenaddr + bytes - 0x1000, ANTIC_memory + ANTIC_margin + bytes, new_screenaddr & 0xfff);
+				memcpy(ANTIC_memory + ANTIC_margin + bytes, dFetchPtr(screenaddr + bytes - 0x1000), new_screenaddr & 0xfff);
 		}
 		screenaddr = new_screenaddr - 0x1000;
 	}
@@ -2628,7 +2660,7 @@ static void ANTIC_load(void)
 		else if ((screenaddr & 0xf000) == 0xd000)
 			CopyFromMem(screenaddr, ANTIC_memory + ANTIC_margin, chars_read[md]);
 		else
-			dCopyFromMem(screenaddr, ANTIC_memory + ANTIC_margin, chars_read[md]);
+			memcpy(ANTIC_memory + ANTIC_margin, dFetchPtr(screenaddr), chars_read[md]);
 		screenaddr = new_screenaddr;
 	}
 #endif
@@ -2641,8 +2673,25 @@ int cur_screen_pos = NOT_DRAWING;
 #ifdef USE_CURSES
 void curses_display_line(int anticmode, const UBYTE *screendata);
 
-static int scanlines_to_curses_display = 0;
+static EMU_TLS int scanlines_to_curses_display = 0;
+#endif
+
+/* Next line of atari_screen, after the drawn one has been checked for
+   changes; with a host buffer set (see Screen_SetHostOutput()) ANTIC
+   draws every line at atari_screen and Screen_LineDone() converts it.
+   GOEOL has already moved ypos to the next line.
+   KEEP_LINE: the next line reads this one back (GTIA mode 11 delay). */
+#if defined(NO_GTIA11_DELAY)
+#define KEEP_LINE FALSE
+#elif defined(NEW_CYCLE_EXACT)
+#define KEEP_LINE TRUE
+#else
+#define KEEP_LINE (delayed_gtia11 == ypos)
 #endif
+#define NEXT_SCANLINE \
+	Screen_LineDone(ypos - 9, KEEP_LINE); \
+	if (screen_host_format == SCREEN_HOST_NONE) \
+		scrn_ptr += SCREEN_PITCH / 2;
 
 /* This function emulates one frame drawing screen at atari_screen */
 void ANTIC_Frame(int draw_display) {
@@ -2687,6 +2736,8 @@ void ANTIC_Frame(int draw_display) {
 #else
 	scrn_ptr = (UWORD *) atari_screen;
 #endif
+	if (draw_display)
+		Screen_FrameStart();
 
 #ifdef NEW_CYCLE_EXACT
 	cur_screen_pos = NOT_DRAWING;
@@ -2722,13 +2773,13 @@ void ANTIC_Frame(int draw_display) {
 				if (player_flickering) {
 					UBYTE hold = ypos & 1 ? 0 : VDELAY;
 					if ((hold & 0x10) == 0)
-						GRAFP0 = dGetByte((UWORD) (regPC - xpos + 8));
+						GRAFP0 = dFetchByte((UWORD) (regPC - xpos + 8));
 					if ((hold & 0x20) == 0)
-						GRAFP1 = dGetByte((UWORD) (regPC - xpos + 9));
+						GRAFP1 = dFetchByte((UWORD) (regPC - xpos + 9));
 					if ((hold & 0x40) == 0)
-						GRAFP2 = dGetByte((UWORD) (regPC - xpos + 10));
+						GRAFP2 = dFetchByte((UWORD) (regPC - xpos + 10));
 					if ((hold & 0x80) == 0)
-						GRAFP3 = dGetByte((UWORD) (regPC - xpos + 11));
+						GRAFP3 = dFetchByte((UWORD) (regPC - xpos + 11));
 				}
 			}
 			else
@@ -2880,7 +2931,7 @@ void ANTIC_Frame(int draw_display) {
 		}
 #ifndef NO_YPOS_BREAK_FLICKER
 #define YPOS_BREAK_FLICKER if (ypos == break_ypos - 1000) {\
-				static int toggle;\
+				static EMU_TLS int toggle;\
 				if (toggle == 1) {\
 					FILL_VIDEO(scrn_ptr + LBORDER_START, 0x0f0f, (RBORDER_END - LBORDER_START) * 2);\
 				}\
@@ -2898,11 +2949,7 @@ void ANTIC_Frame(int draw_display) {
 			UPDATE_DMACTL
 			cur_screen_pos = NOT_DRAWING;
 			YPOS_BREAK_FLICKER
-#ifdef ALEKSCR_DIRECT
-      scrn_ptr += 256;
-#else
-      scrn_ptr += 256; //+= ATARI_WIDTH / 2;
-#endif
+			NEXT_SCANLINE
 			if (no_jvb) {
 				dctr++;
 				dctr &= 0xf;
@@ -2925,14 +2972,10 @@ void ANTIC_Frame(int draw_display) {
 		xpos += DMAR;
 
 		if (anticmode < 2 || (DMACTL & 3) == 0) {
-			draw_antic_0_ptr();
+			PROFILE_CALL(PROFILE_ANTIC, draw_antic_0_ptr());
 			GOEOL;
 			YPOS_BREAK_FLICKER
-#ifdef ALEKSCR_DIRECT
-      scrn_ptr += 256;
-#else
-      scrn_ptr += 256; //+= ATARI_WIDTH / 2;
-#endif
+			NEXT_SCANLINE
 			if (no_jvb) {
 				dctr++;
 				dctr &= 0xf;
@@ -2956,10 +2999,10 @@ void ANTIC_Frame(int draw_display) {
 				xpos -= extra_cycles[md];
 		}
 
-		draw_antic_ptr(chars_displayed[md],
+		PROFILE_CALL(PROFILE_ANTIC, draw_antic_ptr(chars_displayed[md],
 			ANTIC_memory + ANTIC_margin + ch_offset[md],
 			scrn_ptr + x_min[md],
-			(ULONG *) &pm_scanline[x_min[md]]);
+			(ULONG *) &pm_scanline[x_min[md]]));
 
 #endif /* NEW_CYCLE_EXACT */
 #ifndef NO_GTIA11_DELAY
@@ -3066,11 +3109,7 @@ void ANTIC_Frame(int draw_display) {
 		GOEOL;
 #endif /* NEW_CYCLE_EXACT */
 		YPOS_BREAK_FLICKER
-#ifdef ALEKSCR_DIRECT
-      scrn_ptr += 256;
-#else
-      scrn_ptr += 256; //+= ATARI_WIDTH / 2;
-#endif
+		NEXT_SCANLINE
 		dctr++;
 		dctr &= 0xf;
 	} while (ypos < (ATARI_HEIGHT + 8));
@@ -3380,13 +3419,13 @@ void draw_partial_scanline(int l, int r)
 		else if (l >= rborder_start) {
 			left_border_start = right_border_start;
 		}
-		draw_antic_0_ptr();
+		PROFILE_CALL(PROFILE_ANTIC, draw_antic_0_ptr());
 	}
 	else {
-		draw_antic_ptr(nchars, /* chars_displayed[md], */
+		PROFILE_CALL(PROFILE_ANTIC, draw_antic_ptr(nchars, /* chars_displayed[md], */
 			ANTIC_memory + ANTIC_margin + ch_offset[md] + ch_adj,
 			scrn_ptr + x_min[md] + x_min_adj,
-			(ULONG *) &pm_scanline[x_min[md] + x_min_adj]);
+			(ULONG *) &pm_scanline[x_min[md] + x_min_adj]));
 	}
 	memcpy(scrn_ptr + sv_bufstart2, sv_buf2, sv_bufsize2 * sizeof(UWORD)); /* restore screen */
 	memcpy(scrn_ptr + sv_bufstart, sv_buf, sv_bufsize * sizeof(UWORD)); /* restore screen */
@@ -23,27 +23,32 @@
 #define _NMIRES 0x0f
 #define _NMIST 0x0f
 
-extern UBYTE CHACTL;
-extern UBYTE CHBASE;
-extern UWORD dlist;
-extern UBYTE DMACTL;
-extern UBYTE HSCROL;
-extern UBYTE NMIEN;
-extern UBYTE NMIST;
-extern UBYTE PMBASE;
-extern UBYTE VSCROL;
-
-extern int break_ypos;
-extern int ypos;
-extern UBYTE wsync_halt;
+extern EMU_TLS UBYTE CHACTL;
+extern EMU_TLS UBYTE CHBASE;
+extern EMU_TLS UWORD dlist;
+extern EMU_TLS UBYTE DMACTL;
+extern EMU_TLS UBYTE HSCROL;
+extern EMU_TLS UBYTE NMIEN;
+extern EMU_TLS UBYTE NMIST;
+extern EMU_TLS UBYTE PMBASE;
+extern EMU_TLS UBYTE VSCROL;
+
+extern EMU_TLS int break_ypos;
+extern EMU_TLS int ypos;
+extern EMU_TLS UBYTE wsync_halt;
+
+#ifdef TRACE_HOOKS
+/* called at the end of each scanline, see A5200_SetTraceHooks() */
+extern EMU_TLS void (*trace_line_hook)(void);
+#endif
 
 #define NMIST_C	6
 #define NMI_C	12
 
-extern int global_artif_mode;
+extern EMU_TLS int global_artif_mode;
 
-extern UBYTE PENH_input;
-extern UBYTE PENV_input;
+extern EMU_TLS UBYTE PENH_input;
+extern EMU_TLS UBYTE PENV_input;
 
 void ANTIC_Initialise(void);
 void ANTIC_Reset(void);
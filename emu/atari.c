@@ -73,6 +73,8 @@
 #include "pia.h"
 #include "platform.h"
 #include "pokeysnd.h"
+#include "profile.h"
+#include "rewind.h"
 #include "rtime.h"
 #include "sio.h"
 #include "util.h"
@@ -110,20 +112,24 @@
 
 //JGDATARI_t ATARI;
 
-int machine_type = MACHINE_5200;
+EMU_TLS int machine_type = MACHINE_5200;
 //int ram_size = 64;
-int ram_size = 16;
-int tv_mode = TV_PAL;
-int disable_basic = TRUE;
-int enable_sio_patch = TRUE;
+EMU_TLS int ram_size = 16;
+EMU_TLS int tv_mode = TV_PAL;
+EMU_TLS int disable_basic = TRUE;
+EMU_TLS int enable_sio_patch = TRUE;
 
-int verbose = FALSE;
+EMU_TLS int verbose = FALSE;
 
 //unsigned int nframes = 0;
 //int refresh_rate = 1;
-int sprite_collisions_in_skipped_frames = FALSE;
+EMU_TLS int sprite_collisions_in_skipped_frames = FALSE;
 
-int percent_atari_speed = 100;
+EMU_TLS int percent_atari_speed = 100;
+/* when the last Atari800_Frame() started, for percent_atari_speed */
+static EMU_TLS unsigned long long frame_start_ns = 0;
+/* one 5200 frame (NTSC) */
+#define FRAME_NS (1000000000 / 60)
 #ifdef BENCHMARK
 static double benchmark_start_time;
 static double Atari_time(void);
@@ -139,8 +145,8 @@ static double Atari_time(void);
    atari.c/devices.c. Unfortunately it can't be done for patches in Atari OS,
    because the OS in XL/XE can be disabled.
 */
-static UWORD esc_address[256];
-static EscFunctionType esc_function[256];
+static EMU_TLS UWORD esc_address[256];
+static EMU_TLS EscFunctionType esc_function[256];
 
 void Atari800_ClearAllEsc(void) {
 	int i;
@@ -153,6 +159,7 @@ void Atari800_AddEsc(UWORD address, UBYTE esc_code, EscFunctionType function) {
 	esc_function[esc_code] = function;
 	dPutByte(address, 0xf2);			/* ESC */
 	dPutByte(address + 1, esc_code);	/* ESC CODE */
+	ROM_CHANGED(address, address + 1);
 }
 
 void Atari800_AddEscRts(UWORD address, UBYTE esc_code, EscFunctionType function) {
@@ -161,6 +168,7 @@ void Atari800_AddEscRts(UWORD address, UBYTE esc_code, EscFunctionType function)
 	dPutByte(address, 0xf2);			/* ESC */
 	dPutByte(address + 1, esc_code);	/* ESC CODE */
 	dPutByte(address + 2, 0x60);		/* RTS */
+	ROM_CHANGED(address, address + 2);
 }
 
 /* 0xd2 is ESCRTS, which works same as pair of ESC and RTS (I think so...).
@@ -175,6 +183,7 @@ void Atari800_AddEscRts2(UWORD address, UBYTE esc_code, EscFunctionType function
 	esc_function[esc_code] = function;
 	dPutByte(address, 0xd2);			/* ESCRTS */
 	dPutByte(address + 1, esc_code);	/* ESC CODE */
+	ROM_CHANGED(address, address + 1);
 }
 
 void Atari800_RemoveEsc(UBYTE esc_code)
@@ -634,9 +643,19 @@ void Atari800_UpdatePatches(void) {
 
 #ifndef __PLUS
 
-unsigned int refresh_counter;
+EMU_TLS unsigned int refresh_counter;
 
 void Atari800_Frame(unsigned int refresh_rate) {
+	unsigned long long now = Util_time_ns();
+
+	/* the time from the start of one frame to the next, the frontend's
+	   included, against 1/60 s */
+	if (frame_start_ns != 0 && now > frame_start_ns)
+		percent_atari_speed = (int) ((unsigned long long) FRAME_NS * 100 / (now - frame_start_ns));
+	frame_start_ns = now;
+#ifdef FRAME_PROFILE
+	PROFILE_BeginFrame();
+#endif
 	//ALEK Device_Frame();
 #ifndef BASIC
 	INPUT_Frame();
@@ -657,7 +676,11 @@ void Atari800_Frame(unsigned int refresh_rate) {
 		ANTIC_Frame(FALSE);
 	}
   POKEY_Frame();
+	Rewind_Frame();
 	//nframes++;
+#ifdef FRAME_PROFILE
+	PROFILE_EndFrame();
+#endif
 }
 
 #endif /* __PLUS */
@@ -9,6 +9,15 @@
 
 /* Fundamental declarations ---------------------------------------------- */
 
+/* Storage class of every variable that holds machine state.
+   With MULTI_INSTANCE defined the state is thread-local, so each thread
+   of the process emulates its own, independent 5200. */
+#ifdef MULTI_INSTANCE
+#define EMU_TLS __thread
+#else
+#define EMU_TLS
+#endif
+
 //#define DIRTYRECT
 //#define NODIRTYCOMPARE
 
@@ -48,7 +57,7 @@
 #define MACHINE_OSB   1
 #define MACHINE_XLXE  2
 #define MACHINE_5200  3
-extern int machine_type;
+extern EMU_TLS int machine_type;
 
 /* RAM size in kilobytes.
    Valid values for MACHINE_OSA and MACHINE_OSB are: 16, 48, 52.
@@ -57,7 +66,7 @@ extern int machine_type;
    The only valid value for MACHINE_5200 is 16. */
 #define RAM_320_RAMBO       320
 #define RAM_320_COMPY_SHOP  321
-extern int ram_size;
+extern EMU_TLS int ram_size;
 
 /* Always call Atari800_InitialiseMachine() after changing machine_type
    or ram_size! */
@@ -65,13 +74,13 @@ extern int ram_size;
 /* Video system. */
 #define TV_PAL 312
 #define TV_NTSC 262
-extern int tv_mode;
+extern EMU_TLS int tv_mode;
 
 /* TRUE to disable Atari BASIC when booting Atari (hold Option in XL/XE). */
-extern int disable_basic;
+extern EMU_TLS int disable_basic;
 
 /* TRUE to enable patched (fast) Serial I/O. */
-extern int enable_sio_patch;
+extern EMU_TLS int enable_sio_patch;
 
 /* Dimensions of atari_screen.
    atari_screen is ATARI_WIDTH * ATARI_HEIGHT bytes.
@@ -86,14 +95,14 @@ extern unsigned int nframes;
 
 /* You can read it to see how fast is the emulator compared to real Atari
    (100 if running at real Atari speed). */
-extern int percent_atari_speed;
+extern EMU_TLS int percent_atari_speed;
 
 /* How often the screen is updated (1 = every Atari frame). */
 extern int refresh_rate;
 
 /* Set to TRUE for faster emulation with refresh_rate > 1.
    Set to FALSE for accurate emulation with refresh_rate > 1. */
-extern int sprite_collisions_in_skipped_frames;
+extern EMU_TLS int sprite_collisions_in_skipped_frames;
 
 /* Special key codes.
    Store in key_code. */
@@ -216,10 +225,10 @@ struct ATR_Header {
 /* Current clock cycle in a scanline.
    Normally 0 <= xpos && xpos < LINE_C, but in some cases xpos >= LINE_C,
    which means that we are already in line (ypos + 1). */
-extern int xpos;
+extern EMU_TLS int xpos;
 
 /* xpos limit for the currently running 6502 emulation. */
-extern int xpos_limit;
+extern EMU_TLS int xpos_limit;
 
 /* Number of cycles per scanline. */
 #define LINE_C   114
@@ -236,7 +245,7 @@ extern int xpos_limit;
 #define max_ypos tv_mode
 
 /* Main clock value at the beginning of the current scanline. */
-extern unsigned int screenline_cpu_clock;
+extern EMU_TLS unsigned int screenline_cpu_clock;
 
 /* Current main clock value. */
 #define cpu_clock (screenline_cpu_clock + xpos)
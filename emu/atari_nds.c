@@ -25,10 +25,10 @@
 #include "rt-config.h"	/* for refresh_rate */
 #include "screen.h"
 
-unsigned int trig0 = 1;
-unsigned int trig1 = 1;
-unsigned int stick0 = STICK_CENTRE;
-unsigned int stick1 = STICK_CENTRE;
+EMU_TLS unsigned int trig0 = 1;
+EMU_TLS unsigned int trig1 = 1;
+EMU_TLS unsigned int stick0 = STICK_CENTRE;
+EMU_TLS unsigned int stick1 = STICK_CENTRE;
 
 /* this should be variables if we could move 320x200 window, but we can't :) */
 /* static int first_lno = 24;
@@ -35,9 +35,9 @@
 #include "memory.h"
 #include "sio.h"
 
-int start_binloading = FALSE;
-int loading_basic = 0;
-FILE *bin_file = NULL;
+EMU_TLS int start_binloading = FALSE;
+EMU_TLS int loading_basic = 0;
+EMU_TLS FILE *bin_file = NULL;
 
 /* Read a word from file */
 static int BIN_read_word(void)
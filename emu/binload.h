@@ -4,12 +4,12 @@
 #include <stdio.h> /* FILE */
 #include "atari.h" /* UBYTE */
 
-extern FILE *bin_file;
+extern EMU_TLS FILE *bin_file;
 
 int BIN_loader(const char *filename);
 void BIN_loader_cont(void);
-extern int start_binloading;
-extern int loading_basic;
+extern EMU_TLS int start_binloading;
+extern EMU_TLS int loading_basic;
 #define LOADING_BASIC_SAVED              1
 #define LOADING_BASIC_LISTED             2
 #define LOADING_BASIC_LISTED_ATARI       3
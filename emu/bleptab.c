@@ -0,0 +1,972 @@
+/* Generated by tools/mkblep.c (make bleptab), do not edit. */
+
+#include "pokeysnd.h"
+
+const int32 blep_kernel[BLEP_QUALITIES][BLEP_PHASES][BLEP_TAPS_MAX + 1] = {
+	{
+		{
+			59, -472, -287, 17084, 17085, -287, -473, 59, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			56, -442, -400, 16786, 17377, -167, -504, 62, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			54, -413, -509, 16484, 17664, -41, -535, 64, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			51, -384, -611, 16177, 17944, 91, -567, 67, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			49, -357, -706, 15864, 18218, 230, -599, 69, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			47, -331, -796, 15548, 18486, 375, -633, 72, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			44, -304, -881, 15228, 18746, 527, -666, 74, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			42, -280, -960, 14906, 18999, 685, -701, 77, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			40, -256, -1033, 14579, 19245, 849, -735, 79, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			37, -232, -1101, 14250, 19483, 1020, -770, 81, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			35, -209, -1165, 13919, 19713, 1197, -805, 83, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			33, -188, -1222, 13585, 19935, 1381, -842, 86, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			31, -167, -1275, 13249, 20148, 1571, -877, 88, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			29, -148, -1322, 12912, 20352, 1768, -912, 89, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			27, -129, -1366, 12574, 20549, 1971, -949, 91, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			25, -111, -1404, 12235, 20734, 2181, -985, 93, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			24, -94, -1439, 11896, 20911, 2396, -1020, 94, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			22, -78, -1468, 11556, 21078, 2619, -1056, 95, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			20, -62, -1494, 11217, 21235, 2847, -1091, 95, 1, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			19, -48, -1515, 10877, 21382, 3082, -1126, 96, 1, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			17, -33, -1534, 10539, 21519, 3323, -1161, 97, 1, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			16, -21, -1547, 10202, 21645, 3569, -1194, 97, 1, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			15, -10, -1557, 9866, 21762, 3821, -1227, 97, 1, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			13, 2, -1564, 9532, 21867, 4080, -1259, 96, 1, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			12, 12, -1567, 9199, 21962, 4344, -1291, 95, 2, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			11, 22, -1567, 8868, 22046, 4613, -1321, 94, 2, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			10, 31, -1565, 8541, 22119, 4888, -1350, 92, 2, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			9, 40, -1560, 8216, 22181, 5168, -1378, 89, 3, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			8, 48, -1552, 7894, 22231, 5454, -1405, 87, 3, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			7, 55, -1541, 7575, 22271, 5743, -1430, 84, 4, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			7, 60, -1527, 7260, 22299, 6038, -1454, 81, 4, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			6, 66, -1511, 6948, 22315, 6338, -1475, 76, 5, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			5, 72, -1494, 6640, 22322, 6641, -1495, 72, 5, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			5, 76, -1474, 6337, 22315, 6949, -1512, 66, 6, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			4, 81, -1453, 6037, 22299, 7261, -1528, 60, 7, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			4, 84, -1429, 5742, 22271, 7576, -1542, 55, 7, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			3, 87, -1404, 5453, 22231, 7895, -1553, 48, 8, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			3, 89, -1377, 5167, 22181, 8217, -1561, 40, 9, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, 92, -1349, 4887, 22119, 8542, -1566, 31, 10, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, 94, -1320, 4612, 22046, 8869, -1568, 22, 11, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, 95, -1290, 4343, 21962, 9200, -1568, 12, 12, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, 96, -1258, 4079, 21867, 9533, -1565, 2, 13, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, 97, -1226, 3820, 21762, 9867, -1558, -10, 15, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, 97, -1193, 3568, 21645, 10203, -1547, -22, 16, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, 97, -1160, 3322, 21519, 10540, -1534, -34, 17, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, 96, -1125, 3081, 21382, 10878, -1515, -49, 19, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, 95, -1090, 2846, 21235, 11218, -1494, -63, 20, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 95, -1055, 2618, 21078, 11557, -1468, -79, 22, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 94, -1019, 2395, 20911, 11897, -1439, -95, 24, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 93, -984, 2180, 20734, 12236, -1404, -112, 25, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 91, -948, 1970, 20549, 12575, -1366, -130, 27, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 89, -911, 1767, 20352, 12913, -1322, -149, 29, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 88, -876, 1570, 20148, 13250, -1275, -168, 31, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 86, -841, 1380, 19935, 13586, -1222, -189, 33, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 83, -804, 1196, 19713, 13920, -1165, -210, 35, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 81, -769, 1019, 19483, 14251, -1101, -233, 37, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 79, -734, 848, 19245, 14580, -1033, -257, 40, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 77, -700, 684, 18999, 14907, -960, -281, 42, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 74, -665, 527, 18745, 15229, -881, -305, 44, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 72, -632, 375, 18485, 15549, -796, -332, 47, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 69, -598, 230, 18217, 15865, -706, -358, 49, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 67, -566, 91, 17943, 16178, -611, -385, 51, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 64, -534, -41, 17663, 16485, -509, -414, 54, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 62, -503, -167, 17376, 16787, -400, -443, 56, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+	},
+	{
+		{
+			5, -43, 123, -178, 5, 794, -3112, 18790, 18791, -3113, 795,
+			5, -179, 124, -44, 5, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			5, -42, 116, -158, -37, 866, -3211, 18397, 19176, -3005, 722,
+			47, -198, 131, -46, 5, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			5, -41, 110, -140, -76, 933, -3300, 17997, 19555, -2887, 644,
+			90, -217, 137, -47, 5, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			5, -40, 104, -121, -116, 997, -3379, 17591, 19925, -2760, 564,
+			134, -236, 143, -49, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			5, -38, 97, -103, -154, 1058, -3449, 17179, 20287, -2623, 481,
+			179, -256, 149, -50, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			4, -36, 91, -85, -191, 1115, -3510, 16762, 20640, -2476, 395,
+			224, -275, 155, -51, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			4, -34, 84, -68, -226, 1169, -3563, 16340, 20985, -2319, 305,
+			270, -294, 161, -52, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			4, -33, 78, -51, -260, 1219, -3607, 15914, 21320, -2153, 214,
+			317, -314, 167, -53, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			4, -32, 72, -35, -291, 1265, -3642, 15483, 21644, -1975, 119,
+			364, -333, 173, -54, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			4, -30, 65, -18, -323, 1308, -3669, 15050, 21958, -1788, 22,
+			412, -352, 178, -55, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			4, -29, 59, -2, -353, 1348, -3688, 14613, 22262, -1592, -77,
+			460, -371, 184, -56, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			3, -27, 53, 14, -382, 1384, -3698, 14172, 22556, -1385, -179,
+			508, -389, 189, -57, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			3, -25, 47, 28, -408, 1416, -3702, 13731, 22837, -1168, -282,
+			557, -408, 193, -57, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			3, -24, 41, 44, -435, 1446, -3698, 13287, 23107, -941, -387,
+			605, -427, 199, -58, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			3, -23, 36, 57, -458, 1471, -3686, 12842, 23365, -704, -495,
+			653, -443, 202, -58, 6, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			3, -21, 29, 72, -482, 1493, -3666, 12396, 23611, -458, -604,
+			702, -461, 207, -58, 5, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			3, -20, 24, 84, -502, 1512, -3641, 11950, 23844, -201, -714,
+			749, -478, 211, -58, 5, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, -18, 19, 97, -522, 1527, -3609, 11504, 24065, 65, -826,
+			797, -494, 214, -58, 5, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, -16, 14, 108, -541, 1539, -3569, 11058, 24272, 341, -939,
+			845, -510, 217, -58, 5, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, -15, 9, 120, -558, 1548, -3525, 10614, 24466, 626, -1052,
+			891, -525, 220, -58, 5, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, -14, 4, 131, -573, 1553, -3474, 10171, 24647, 920, -1166,
+			937, -539, 222, -57, 4, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, -13, 0, 140, -586, 1556, -3418, 9729, 24815, 1222, -1280,
+			982, -552, 224, -57, 4, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, -12, -5, 151, -599, 1555, -3356, 9290, 24968, 1534, -1394,
+			1026, -565, 226, -57, 4, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			2, -11, -9, 160, -609, 1550, -3288, 8852, 25107, 1856, -1509,
+			1070, -578, 227, -55, 3, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -9, -13, 168, -618, 1543, -3216, 8418, 25233, 2185, -1623,
+			1112, -589, 228, -55, 3, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -8, -17, 176, -626, 1534, -3140, 7988, 25343, 2524, -1737,
+			1152, -599, 228, -54, 3, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -7, -21, 183, -632, 1522, -3060, 7562, 25439, 2870, -1850,
+			1192, -609, 228, -52, 2, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -6, -24, 189, -637, 1507, -2975, 7140, 25520, 3224, -1962,
+			1230, -617, 227, -51, 2, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -5, -28, 196, -641, 1489, -2886, 6722, 25587, 3586, -2073,
+			1266, -624, 226, -49, 1, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -4, -31, 201, -643, 1469, -2794, 6309, 25639, 3955, -2182,
+			1301, -631, 224, -46, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -3, -34, 206, -644, 1446, -2698, 5901, 25677, 4331, -2291,
+			1335, -636, 222, -45, -1, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -2, -38, 211, -643, 1421, -2600, 5499, 25699, 4715, -2397,
+			1366, -640, 219, -42, -2, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -2, -39, 214, -642, 1394, -2498, 5103, 25706, 5104, -2499,
+			1395, -643, 215, -39, -3, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -1, -42, 218, -639, 1365, -2396, 4714, 25699, 5500, -2601,
+			1422, -644, 212, -38, -3, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			1, -1, -44, 221, -635, 1334, -2290, 4330, 25677, 5902, -2699,
+			1447, -645, 207, -34, -4, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 0, -45, 223, -630, 1300, -2181, 3954, 25639, 6310, -2795,
+			1470, -644, 202, -31, -5, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 1, -48, 225, -623, 1265, -2072, 3585, 25587, 6723, -2887,
+			1490, -642, 197, -28, -6, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 2, -50, 226, -616, 1229, -1961, 3223, 25520, 7141, -2976,
+			1508, -638, 190, -24, -7, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 2, -51, 227, -608, 1191, -1849, 2869, 25439, 7563, -3061,
+			1523, -633, 184, -21, -8, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 3, -53, 227, -598, 1151, -1736, 2523, 25343, 7989, -3141,
+			1535, -627, 177, -17, -9, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 3, -54, 227, -588, 1111, -1622, 2184, 25233, 8419, -3217,
+			1544, -619, 169, -13, -10, 1, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 3, -54, 226, -577, 1069, -1508, 1855, 25107, 8853, -3289,
+			1551, -610, 161, -9, -12, 2, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 4, -56, 225, -564, 1025, -1393, 1533, 24968, 9291, -3357,
+			1556, -600, 152, -5, -13, 2, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 4, -56, 223, -551, 981, -1279, 1221, 24815, 9730, -3419,
+			1557, -587, 141, 0, -14, 2, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 4, -56, 221, -538, 936, -1165, 919, 24647, 10172, -3475,
+			1554, -574, 132, 4, -15, 2, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 5, -57, 219, -524, 890, -1051, 625, 24466, 10615, -3526,
+			1549, -559, 121, 9, -16, 2, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 5, -57, 216, -509, 844, -938, 341, 24271, 11059, -3570,
+			1540, -542, 109, 14, -17, 2, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 5, -57, 213, -493, 796, -825, 65, 24064, 11505, -3610,
+			1528, -523, 97, 20, -19, 2, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 5, -57, 210, -477, 748, -713, -201, 23843, 11951, -3642,
+			1513, -503, 84, 25, -21, 3, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 5, -57, 206, -460, 701, -603, -458, 23610, 12397, -3667,
+			1494, -483, 72, 30, -22, 3, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -57, 201, -442, 652, -494, -704, 23364, 12843, -3687,
+			1472, -459, 57, 37, -24, 3, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -57, 198, -426, 604, -386, -941, 23106, 13288, -3699,
+			1447, -436, 44, 42, -25, 3, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -56, 192, -407, 556, -282, -1167, 22836, 13732, -3703,
+			1417, -409, 28, 48, -26, 3, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -56, 188, -388, 507, -179, -1384, 22555, 14173, -3699,
+			1385, -383, 14, 54, -28, 3, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -55, 183, -370, 459, -77, -1591, 22261, 14614, -3689,
+			1349, -354, -2, 60, -30, 4, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -54, 177, -351, 411, 22, -1787, 21957, 15051, -3670,
+			1309, -324, -18, 66, -31, 4, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -53, 172, -332, 363, 119, -1974, 21643, 15484, -3643,
+			1266, -292, -35, 73, -33, 4, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -52, 166, -313, 316, 214, -2152, 21319, 15915, -3608,
+			1220, -260, -52, 79, -34, 4, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -51, 160, -293, 269, 305, -2318, 20984, 16341, -3564,
+			1170, -226, -69, 85, -35, 4, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -50, 154, -274, 223, 395, -2475, 20639, 16763, -3511,
+			1116, -191, -86, 92, -37, 4, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -49, 148, -255, 178, 481, -2622, 20286, 17180, -3450,
+			1059, -154, -104, 98, -39, 5, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 6, -48, 142, -235, 134, 563, -2759, 19924, 17592, -3380,
+			998, -116, -122, 105, -41, 5, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 5, -46, 136, -216, 90, 643, -2886, 19554, 17998, -3301,
+			934, -76, -141, 111, -42, 5, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+		{
+			0, 5, -45, 130, -197, 47, 721, -3004, 19175, 18398, -3212,
+			867, -37, -159, 117, -43, 5, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		},
+	},
+	{
+		{
+			1, -4, 12, -25, 41, -56, 64, -53, 6, 100, -296,
+			625, -1163, 2100, -4159, 19191, 19192, -4160, 2101, -1164, 626, -297,
+			101, 6, -54, 65, -57, 42, -26, 13, -5, 1, 0,
+		},
+		{
+			1, -4, 11, -23, 38, -52, 58, -42, -11, 124, -328,
+			664, -1210, 2154, -4214, 18738, 19636, -4093, 2043, -1114, 585, -265,
+			77, 23, -65, 72, -61, 43, -26, 13, -5, 1, 0,
+		},
+		{
+			1, -4, 11, -22, 36, -48, 50, -30, -28, 147, -358,
+			702, -1254, 2201, -4258, 18278, 20073, -4016, 1980, -1061, 541, -230,
+			51, 41, -77, 79, -65, 46, -27, 13, -5, 1, 0,
+		},
+		{
+			1, -4, 11, -22, 35, -44, 43, -20, -43, 169, -387,
+			737, -1294, 2242, -4290, 17812, 20500, -3927, 1911, -1005, 497, -197,
+			27, 58, -88, 86, -69, 47, -27, 13, -5, 1, 0,
+		},
+		{
+			0, -3, 11, -21, 32, -40, 36, -9, -59, 192, -416,
+			771, -1331, 2278, -4313, 17340, 20919, -3826, 1836, -946, 451, -162,
+			1, 76, -100, 93, -72, 49, -29, 14, -5, 1, 0,
+		},
+		{
+			0, -2, 9, -19, 30, -36, 29, 2, -75, 213, -442,
+			802, -1365, 2309, -4325, 16861, 21328, -3713, 1757, -884, 402, -126,
+			-24, 93, -111, 100, -76, 50, -29, 14, -5, 1, 0,
+		},
+		{
+			0, -2, 9, -18, 27, -32, 23, 12, -90, 233, -468,
+			832, -1395, 2334, -4327, 16378, 21726, -3588, 1672, -819, 353, -89,
+			-51, 111, -122, 106, -79, 52, -30, 14, -5, 1, 0,
+		},
+		{
+			0, -2, 9, -18, 26, -28, 15, 24, -106, 254, -493,
+			860, -1423, 2354, -4319, 15890, 22114, -3451, 1582, -752, 302, -52,
+			-77, 129, -133, 112, -83, 54, -30, 14, -5, 1, 0,
+		},
+		{
+			0, -2, 8, -16, 23, -23, 9, 33, -120, 272, -515,
+			884, -1446, 2368, -4301, 15399, 22490, -3302, 1487, -683, 251, -14,
+			-103, 146, -144, 119, -87, 56, -31, 14, -5, 1, 0,
+		},
+		{
+			0, -2, 8, -15, 21, -20, 3, 43, -134, 290, -537,
+			908, -1466, 2376, -4274, 14904, 22855, -3141, 1388, -611, 198, 24,
+			-130, 163, -154, 125, -90, 57, -31, 14, -5, 1, 0,
+		},
+		{
+			0, -2, 8, -14, 18, -15, -4, 53, -148, 308, -557,
+			928, -1483, 2380, -4237, 14406, 23207, -2967, 1283, -537, 144, 63,
+			-157, 181, -165, 131, -93, 58, -31, 14, -5, 1, 0,
+		},
+		{
+			0, -2, 7, -13, 17, -11, -11, 62, -161, 325, -576,
+			947, -1497, 2379, -4193, 13906, 23548, -2782, 1175, -461, 89, 102,
+			-183, 198, -176, 137, -95, 59, -32, 14, -4, 0, 0,
+		},
+		{
+			0, -2, 7, -12, 14, -7, -17, 72, -174, 341, -594,
+			963, -1506, 2372, -4139, 13404, 23875, -2584, 1061, -382, 33, 141,
+			-210, 215, -185, 142, -98, 60, -32, 14, -4, 0, 0,
+		},
+		{
+			0, -2, 7, -11, 12, -4, -23, 81, -186, 356, -610,
+			977, -1513, 2360, -4077, 12901, 24189, -2373, 943, -302, -23, 180,
+			-236, 231, -195, 147, -100, 61, -32, 14, -4, 0, 0,
+		},
+		{
+			0, -1, 5, -9, 9, 0, -28, 89, -197, 369, -624,
+			989, -1517, 2344, -4008, 12398, 24489, -2151, 821, -219, -81, 220,
+			-262, 248, -205, 152, -103, 62, -32, 14, -4, 0, 0,
+		},
+		{
+			0, -1, 5, -8, 7, 3, -34, 98, -209, 383, -637,
+			999, -1517, 2321, -3930, 11894, 24775, -1916, 696, -136, -138, 258,
+			-287, 263, -214, 158, -105, 63, -33, 14, -4, 0, 0,
+		},
+		{
+			0, -1, 5, -8, 5, 8, -41, 107, -219, 394, -649,
+			1007, -1514, 2295, -3846, 11391, 25047, -1669, 566, -50, -197, 298,
+			-313, 279, -223, 162, -107, 64, -33, 14, -4, 0, 0,
+		},
+		{
+			0, -1, 4, -6, 3, 11, -46, 115, -230, 405, -658,
+			1011, -1507, 2264, -3754, 10888, 25304, -1409, 433, 35, -255, 337,
+			-338, 295, -232, 166, -108, 64, -33, 14, -4, 0, 0,
+		},
+		{
+			0, -1, 4, -5, 2, 13, -51, 122, -239, 415, -666,
+			1014, -1498, 2229, -3657, 10388, 25545, -1137, 297, 122, -313, 376,
+			-363, 309, -239, 169, -109, 64, -33, 14, -4, 0, 0,
+		},
+		{
+			0, -1, 4, -4, -1, 18, -57, 129, -247, 424, -674,
+			1015, -1485, 2189, -3553, 9889, 25772, -854, 158, 211, -372, 414,
+			-387, 323, -247, 173, -111, 65, -33, 14, -4, 0, 0,
+		},
+		{
+			0, -1, 3, -3, -2, 21, -62, 136, -256, 432, -679,
+			1014, -1469, 2144, -3443, 9394, 25983, -560, 16, 300, -431, 452,
+			-410, 337, -254, 176, -112, 64, -32, 13, -3, 0, 0,
+		},
+		{
+			0, -1, 3, -2, -4, 24, -67, 142, -262, 439, -683,
+			1010, -1451, 2097, -3328, 8901, 26178, -254, -128, 389, -489, 490,
+			-434, 351, -261, 179, -113, 64, -32, 13, -3, 0, 0,
+		},
+		{
+			0, -1, 3, -2, -6, 28, -72, 149, -270, 445, -685,
+			1004, -1429, 2045, -3208, 8412, 26357, 64, -275, 479, -546, 526,
+			-456, 363, -267, 182, -114, 64, -31, 12, -3, 0, 0,
+		},
+		{
+			0, 0, 1, -1, -7, 31, -76, 154, -276, 450, -686,
+			996, -1405, 1990, -3082, 7926, 26519, 394, -424, 569, -604, 563,
+			-478, 375, -273, 184, -114, 64, -31, 12, -3, 0, 0,
+		},
+		{
+			0, 0, 1, 0, -9, 33, -80, 159, -280, 453, -685,
+			986, -1378, 1931, -2953, 7446, 26665, 734, -574, 659, -660, 597,
+			-498, 386, -279, 187, -115, 63, -30, 12, -3, 0, 0,
+		},
+		{
+			0, 0, 1, 1, -11, 36, -84, 164, -285, 456, -684,
+			975, -1348, 1868, -2819, 6970, 26795, 1085, -726, 748, -716, 632,
+			-519, 398, -284, 188, -114, 62, -30, 12, -3, 0, 0,
+		},
+		{
+			0, 0, 0, 2, -12, 39, -88, 168, -289, 458, -680,
+			961, -1316, 1802, -2682, 6501, 26907, 1446, -878, 837, -771, 665,
+			-537, 407, -288, 189, -114, 62, -29, 11, -3, 0, 0,
+		},
+		{
+			0, 0, 0, 3, -14, 41, -91, 172, -293, 459, -675,
+			945, -1281, 1734, -2541, 6037, 27001, 1819, -1032, 926, -825, 697,
+			-556, 417, -292, 190, -113, 60, -28, 10, -2, 0, 0,
+		},
+		{
+			0, 0, 0, 4, -16, 44, -95, 176, -296, 459, -668,
+			927, -1244, 1662, -2397, 5579, 27080, 2200, -1186, 1014, -878, 729,
+			-574, 425, -294, 189, -112, 60, -27, 9, -2, 0, 0,
+		},
+		{
+			0, 0, 0, 4, -17, 46, -98, 179, -297, 458, -661,
+			907, -1204, 1588, -2251, 5128, 27141, 2592, -1341, 1101, -929, 758,
+			-589, 432, -297, 190, -111, 58, -26, 9, -2, 0, 0,
+		},
+		{
+			0, 0, 0, 5, -19, 48, -100, 182, -299, 455, -652,
+			887, -1163, 1511, -2103, 4686, 27184, 2994, -1495, 1186, -980, 788,
+			-605, 439, -299, 189, -109, 56, -25, 9, -2, 0, 0,
+		},
+		{
+			0, 0, 0, 5, -20, 50, -102, 184, -300, 452, -641,
+			864, -1120, 1433, -1953, 4250, 27210, 3404, -1649, 1271, -1029, 815,
+			-618, 444, -300, 188, -107, 55, -24, 7, -1, 0, 0,
+		},
+		{
+			0, 0, 0, 6, -22, 52, -104, 185, -299, 448, -630,
+			840, -1075, 1352, -1801, 3823, 27218, 3824, -1802, 1353, -1076, 841,
+			-631, 449, -300, 186, -105, 53, -23, 7, 0, -1, 0,
+		},
+		{
+			0, 0, 0, 6, -23, 54, -106, 187, -299, 443, -617,
+			814, -1028, 1270, -1648, 3403, 27210, 4251, -1954, 1434, -1121, 865,
+			-642, 453, -301, 185, -103, 51, -21, 6, 0, -1, 0,
+		},
+		{
+			0, 0, -1, 8, -24, 55, -108, 188, -298, 438, -604,
+			787, -979, 1185, -1494, 2993, 27184, 4687, -2104, 1512, -1164, 888,
+			-653, 456, -300, 183, -101, 49, -20, 6, 0, -1, 0,
+		},
+		{
+			0, 0, -1, 8, -25, 57, -110, 189, -296, 431, -588,
+			757, -928, 1100, -1340, 2591, 27141, 5129, -2252, 1589, -1205, 908,
+			-662, 459, -298, 180, -99, 47, -18, 4, 1, -1, 0,
+		},
+		{
+			0, 0, -1, 8, -26, 59, -111, 188, -293, 424, -573,
+			728, -877, 1013, -1185, 2199, 27080, 5580, -2398, 1663, -1245, 928,
+			-669, 460, -297, 177, -96, 45, -17, 4, 1, -1, 0,
+		},
+		{
+			0, 0, -1, 9, -27, 59, -112, 189, -291, 416, -555,
+			696, -824, 925, -1031, 1818, 27001, 6038, -2542, 1735, -1282, 946,
+			-676, 460, -294, 173, -92, 42, -15, 3, 1, -1, 0,
+		},
+		{
+			0, 0, -2, 10, -28, 61, -113, 188, -287, 406, -536,
+			664, -770, 836, -877, 1445, 26907, 6502, -2683, 1803, -1317, 962,
+			-681, 459, -290, 169, -89, 40, -13, 2, 1, -1, 0,
+		},
+		{
+			0, 0, -2, 11, -29, 61, -113, 187, -283, 397, -518,
+			631, -715, 747, -725, 1084, 26795, 6971, -2820, 1869, -1349, 976,
+			-685, 457, -286, 165, -85, 37, -12, 1, 2, -1, 0,
+		},
+		{
+			0, 0, -2, 11, -29, 62, -114, 186, -278, 385, -497,
+			596, -659, 658, -573, 733, 26665, 7447, -2954, 1932, -1379, 987,
+			-686, 454, -281, 160, -81, 34, -10, 0, 2, -1, 0,
+		},
+		{
+			0, 0, -2, 11, -30, 63, -113, 183, -272, 374, -477,
+			562, -603, 568, -423, 393, 26519, 7927, -3083, 1991, -1406, 997,
+			-687, 451, -277, 155, -77, 32, -8, -1, 2, -1, 0,
+		},
+		{
+			0, 0, -2, 11, -30, 63, -113, 181, -266, 362, -455,
+			525, -545, 478, -274, 64, 26356, 8413, -3209, 2046, -1430, 1005,
+			-686, 446, -271, 150, -73, 29, -7, -2, 4, -2, 0,
+		},
+		{
+			0, 0, -2, 12, -31, 63, -112, 178, -260, 350, -433,
+			489, -488, 388, -128, -253, 26177, 8902, -3329, 2098, -1452, 1011,
+			-684, 440, -263, 143, -68, 25, -4, -3, 4, -2, 0,
+		},
+		{
+			0, 0, -2, 12, -31, 63, -111, 175, -253, 336, -409,
+			451, -430, 299, 16, -559, 25982, 9395, -3444, 2145, -1470, 1015,
+			-680, 433, -257, 137, -63, 22, -2, -4, 4, -2, 0,
+		},
+		{
+			0, 0, -3, 13, -32, 64, -110, 172, -246, 322, -386,
+			413, -371, 210, 158, -853, 25771, 9890, -3554, 2190, -1486, 1016,
+			-675, 425, -248, 130, -58, 19, -1, -5, 5, -2, 0,
+		},
+		{
+			0, 0, -3, 13, -32, 63, -108, 168, -238, 308, -362,
+			375, -312, 122, 296, -1136, 25544, 10389, -3658, 2230, -1499, 1015,
+			-667, 416, -240, 123, -52, 14, 2, -6, 5, -2, 0,
+		},
+		{
+			0, 0, -3, 13, -32, 63, -107, 165, -231, 294, -337,
+			336, -254, 35, 432, -1408, 25303, 10889, -3755, 2265, -1508, 1012,
+			-659, 406, -231, 116, -47, 11, 4, -7, 5, -2, 0,
+		},
+		{
+			0, 0, -3, 13, -32, 63, -106, 161, -222, 278, -312,
+			297, -196, -50, 565, -1668, 25046, 11392, -3847, 2296, -1515, 1008,
+			-650, 395, -220, 108, -42, 8, 6, -9, 6, -2, 0,
+		},
+		{
+			0, 0, -3, 13, -32, 62, -104, 157, -213, 262, -286,
+			257, -137, -136, 695, -1915, 24774, 11895, -3931, 2322, -1518, 1000,
+			-638, 384, -210, 99, -35, 3, 8, -9, 6, -2, 0,
+		},
+		{
+			0, 0, -3, 13, -31, 61, -102, 151, -204, 247, -261,
+			219, -81, -218, 820, -2150, 24488, 12399, -4009, 2345, -1518, 990,
+			-625, 370, -198, 90, -29, 0, 10, -10, 6, -2, 0,
+		},
+		{
+			0, 0, -3, 13, -31, 60, -99, 146, -194, 230, -235,
+			179, -23, -301, 942, -2372, 24188, 12902, -4078, 2361, -1514, 978,
+			-611, 357, -187, 82, -24, -4, 13, -12, 8, -3, 0,
+		},
+		{
+			0, 0, -3, 13, -31, 59, -97, 141, -184, 214, -209,
+			140, 33, -381, 1060, -2583, 23874, 13405, -4140, 2373, -1507, 964,
+			-595, 342, -175, 73, -17, -8, 15, -13, 8, -3, 0,
+		},
+		{
+			0, 0, -3, 13, -31, 58, -94, 136, -175, 197, -182,
+			101, 89, -460, 1174, -2781, 23547, 13907, -4194, 2380, -1498, 948,
+			-577, 326, -162, 63, -11, -12, 18, -14, 8, -3, 0,
+		},
+		{
+			0, 1, -4, 13, -30, 57, -92, 130, -164, 180, -156,
+			63, 143, -536, 1282, -2966, 23206, 14407, -4238, 2381, -1484, 929,
+			-558, 309, -149, 54, -4, -16, 19, -15, 9, -3, 0,
+		},
+		{
+			0, 1, -4, 13, -30, 56, -89, 124, -153, 162, -129,
+			24, 197, -610, 1387, -3140, 22854, 14905, -4275, 2377, -1467, 909,
+			-538, 291, -135, 44, 3, -21, 22, -16, 9, -3, 0,
+		},
+		{
+			0, 1, -4, 13, -30, 55, -86, 118, -143, 145, -102,
+			-14, 250, -682, 1486, -3301, 22489, 15400, -4302, 2369, -1447, 885,
+			-516, 273, -121, 34, 9, -24, 24, -17, 9, -3, 0,
+		},
+		{
+			0, 1, -4, 13, -29, 53, -82, 111, -132, 128, -76,
+			-52, 301, -751, 1581, -3450, 22113, 15891, -4320, 2355, -1424, 861,
+			-494, 255, -107, 24, 16, -29, 27, -19, 10, -3, 0,
+		},
+		{
+			0, 1, -4, 13, -29, 51, -78, 105, -121, 110, -50,
+			-89, 352, -818, 1671, -3587, 21725, 16379, -4328, 2335, -1396, 833,
+			-469, 234, -91, 12, 24, -33, 28, -19, 10, -3, 0,
+		},
+		{
+			0, 1, -4, 13, -28, 49, -75, 99, -110, 92, -24,
+			-125, 401, -883, 1756, -3712, 21327, 16862, -4326, 2310, -1366, 803,
+			-443, 214, -76, 2, 30, -37, 31, -20, 10, -3, 0,
+		},
+		{
+			0, 1, -4, 13, -28, 48, -71, 92, -99, 75, 1,
+			-161, 450, -945, 1835, -3825, 20918, 17341, -4314, 2279, -1332, 772,
+			-417, 193, -60, -9, 37, -41, 33, -22, 12, -4, 0,
+		},
+		{
+			0, 1, -4, 12, -26, 46, -68, 85, -87, 57, 27,
+			-196, 496, -1004, 1910, -3926, 20499, 17813, -4291, 2243, -1295, 738,
+			-388, 170, -43, -21, 44, -45, 36, -23, 12, -5, 1,
+		},
+		{
+			0, 1, -4, 12, -26, 45, -64, 78, -76, 40, 51,
+			-229, 540, -1060, 1979, -4015, 20072, 18279, -4259, 2202, -1255, 703,
+			-359, 148, -28, -31, 51, -49, 37, -23, 12, -5, 1,
+		},
+		{
+			0, 1, -4, 12, -25, 42, -60, 71, -64, 23, 76,
+			-264, 584, -1113, 2042, -4092, 19635, 18739, -4215, 2155, -1211, 665,
+			-329, 125, -11, -43, 59, -53, 39, -24, 12, -5, 1,
+		},
+	},
+};
@@ -0,0 +1,230 @@
+/*
+ * cartdb.c - cartridge database
+ *
+ * This file is part of the a5200 port of the Atari800 emulator.
+ * See cartdb.h for the file format.
+ */
+
+#include "config.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atari.h"
+#include "cartdb.h"
+#include "cartridge.h"
+
+#define ONE_CHIP	CART_5200_NS_16, CARTDB_UNSET, CARTDB_UNSET, CARTDB_UNSET
+
+/* 16 KB one-chip titles, sorted by crc for CARTDB_Builtin() */
+static const CARTDB_Entry cartdb_builtin[] = {
+	{ 0x0624e6e7, ONE_CHIP },	/* BluePrint */
+	{ 0x0a4ddb1e, ONE_CHIP },	/* Super Pac-Man */
+	{ 0x0ba22ece, ONE_CHIP },	/* Track and Field */
+	{ 0x0e80dbb2, ONE_CHIP },	/* Time Runner (conversion) */
+	{ 0x18a73af3, ONE_CHIP },	/* H.E.R.O. */
+	{ 0x2959d827, ONE_CHIP },	/* Zone Ranger */
+	{ 0x35484751, ONE_CHIP },	/* AE */
+	{ 0x387365dc, ONE_CHIP },	/* Space Shuttle */
+	{ 0x38f4a6a4, ONE_CHIP },	/* Xmas (demo) */
+	{ 0x4252abd9, ONE_CHIP },	/* Robotron 2084 */
+	{ 0x47dc1314, ONE_CHIP },	/* Preppie (conversion) */
+	{ 0x4b910461, ONE_CHIP },	/* Pitfall II */
+	{ 0x7df1adfb, ONE_CHIP },	/* Miner 2049er */
+	{ 0x82e2981f, ONE_CHIP },	/* Super Pac-Man */
+	{ 0x83517703, ONE_CHIP },	/* Last Starfighter */
+	{ 0x969cfe1a, ONE_CHIP },	/* Millipede */
+	{ 0x9ad53bbc, ONE_CHIP },	/* Choplifter */
+	{ 0x9bae58dc, ONE_CHIP },	/* Beamrider */
+	{ 0xab8e035b, ONE_CHIP },	/* Meteorites */
+	{ 0xb5f3402b, ONE_CHIP },	/* Quest for Quintana Roo */
+	{ 0xb8b6a2fd, ONE_CHIP },	/* Missile Command+ */
+	{ 0xb8faaec3, ONE_CHIP },	/* Xari Arena */
+	{ 0xbe3cd348, ONE_CHIP },	/* Berzerk */
+	{ 0xc8f9c094, ONE_CHIP },	/* Blaster */
+	{ 0xd0b2f285, ONE_CHIP },	/* Moon Patrol */
+	{ 0xd3bd3221, ONE_CHIP },	/* Final Legacy */
+	{ 0xd6f7ddfd, ONE_CHIP },	/* Wizard of Wor */
+	{ 0xe8b130c4, ONE_CHIP },	/* PAM Diagnostics 2.0 */
+	{ 0xf1e21530, ONE_CHIP },	/* Preppie (conversion) */
+	{ 0xf43e7cd0, ONE_CHIP },	/* Decathlon */
+	{ 0xfd8f0cd4, ONE_CHIP },	/* Super Pac-Man */
+};
+
+#define CARTDB_BUILTIN (sizeof(cartdb_builtin) / sizeof(cartdb_builtin[0]))
+
+/* What CARTDB_Load() read, the built-in titles included: open addressing
+   on the low bits of the crc, which are as good a hash as any. Shared by
+   all the emulated machines of the process, so not EMU_TLS. */
+typedef struct {
+	int used;
+	CARTDB_Entry entry;
+} cartdb_slot;
+
+static cartdb_slot *cartdb_table = NULL;
+static ULONG cartdb_mask;
+
+static const char *const cartdb_mappings[] = { "32", "ee16", "ns16", "40", "8", "4" };
+static const UBYTE cartdb_types[] = {
+	CART_5200_32, CART_5200_EE_16, CART_5200_NS_16, CART_5200_40, CART_5200_8, CART_5200_4
+};
+static const char *const cartdb_controllers[] = { "digital", "analog" };
+
+static const CARTDB_Entry *CARTDB_Builtin(ULONG crc)
+{
+	int lo = 0;
+	int hi = CARTDB_BUILTIN - 1;
+
+	while (lo <= hi) {
+		int mid = (lo + hi) >> 1;
+		if (cartdb_builtin[mid].crc == crc)
+			return &cartdb_builtin[mid];
+		if (cartdb_builtin[mid].crc < crc)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
+	return NULL;
+}
+
+/* The slot of crc, or the empty one it would go in. */
+static cartdb_slot *CARTDB_Slot(ULONG crc)
+{
+	ULONG i = crc & cartdb_mask;
+
+	while (cartdb_table[i].used && cartdb_table[i].entry.crc != crc)
+		i = (i + 1) & cartdb_mask;
+	return &cartdb_table[i];
+}
+
+/* Sets the fields of src that are set into the slot of src->crc. */
+static void CARTDB_Merge(const CARTDB_Entry *src)
+{
+	cartdb_slot *slot = CARTDB_Slot(src->crc);
+
+	if (!slot->used) {
+		slot->used = TRUE;
+		slot->entry.crc = src->crc;
+		slot->entry.type = CARTDB_UNSET;
+		slot->entry.controller = CARTDB_UNSET;
+		slot->entry.refresh_rate = CARTDB_UNSET;
+		slot->entry.audio_quality = CARTDB_UNSET;
+	}
+	if (src->type != CARTDB_UNSET)
+		slot->entry.type = src->type;
+	if (src->controller != CARTDB_UNSET)
+		slot->entry.controller = src->controller;
+	if (src->refresh_rate != CARTDB_UNSET)
+		slot->entry.refresh_rate = src->refresh_rate;
+	if (src->audio_quality != CARTDB_UNSET)
+		slot->entry.audio_quality = src->audio_quality;
+}
+
+/* The index of s in names, CARTDB_UNSET for "-", -1 if it's neither. */
+static int CARTDB_Name(const char *s, const char *const *names, int count)
+{
+	int i;
+
+	if (strcmp(s, "-") == 0)
+		return CARTDB_UNSET;
+	for (i = 0; i < count; i++)
+		if (strcmp(s, names[i]) == 0)
+			return i;
+	return -1;
+}
+
+/* A number below CARTDB_UNSET, CARTDB_UNSET for "-", -1 otherwise. */
+static int CARTDB_Number(const char *s)
+{
+	char *end;
+	long value;
+
+	if (strcmp(s, "-") == 0)
+		return CARTDB_UNSET;
+	value = strtol(s, &end, 10);
+	if (*end != '\0' || value < 0 || value >= CARTDB_UNSET)
+		return -1;
+	return (int) value;
+}
+
+/* Parses a line of the file into e. Returns FALSE for a comment, an
+   empty line or one that isn't understood. */
+static int CARTDB_Parse(const char *line, CARTDB_Entry *e)
+{
+	unsigned long crc;
+	char mapping[16], controller[16], refresh[16], quality[16];
+	int type, ctl, rate, q;
+
+	while (isspace((unsigned char) *line))
+		line++;
+	if (*line == '\0' || *line == '#')
+		return FALSE;
+	if (sscanf(line, "%lx %15s %15s %15s %15s", &crc, mapping, controller, refresh, quality) != 5)
+		return FALSE;
+	type = CARTDB_Name(mapping, cartdb_mappings, sizeof(cartdb_types) / sizeof(cartdb_types[0]));
+	ctl = CARTDB_Name(controller, cartdb_controllers, 2);
+	rate = CARTDB_Number(refresh);
+	q = CARTDB_Number(quality);
+	if (type < 0 || ctl < 0 || rate < 0 || q < 0)
+		return FALSE;
+	e->crc = (ULONG) crc;
+	e->type = type == CARTDB_UNSET ? CARTDB_UNSET : cartdb_types[type];
+	e->controller = (UBYTE) ctl;
+	e->refresh_rate = (UBYTE) rate;
+	e->audio_quality = (UBYTE) q;
+	return TRUE;
+}
+
+void CARTDB_Free(void)
+{
+	free(cartdb_table);
+	cartdb_table = NULL;
+}
+
+int CARTDB_Load(const char *filename)
+{
+	FILE *fp;
+	char line[256];
+	CARTDB_Entry e;
+	ULONG size = 64;
+	int lines = 0;
+	int count = 0;
+	unsigned int i;
+
+	fp = fopen(filename, "r");
+	if (fp == NULL)
+		return -1;
+	/* at most half full, so a lookup ends after a probe or two */
+	while (fgets(line, sizeof(line), fp) != NULL)
+		lines++;
+	while (size < 2 * (lines + CARTDB_BUILTIN))
+		size <<= 1;
+	CARTDB_Free();
+	cartdb_table = (cartdb_slot *) calloc(size, sizeof(cartdb_slot));
+	if (cartdb_table == NULL) {
+		fclose(fp);
+		return -1;
+	}
+	cartdb_mask = size - 1;
+	for (i = 0; i < CARTDB_BUILTIN; i++)
+		CARTDB_Merge(&cartdb_builtin[i]);
+	rewind(fp);
+	while (fgets(line, sizeof(line), fp) != NULL)
+		if (CARTDB_Parse(line, &e)) {
+			CARTDB_Merge(&e);
+			count++;
+		}
+	fclose(fp);
+	return count;
+}
+
+const CARTDB_Entry *CARTDB_Lookup(ULONG crc)
+{
+	cartdb_slot *slot;
+
+	if (cartdb_table == NULL)
+		return CARTDB_Builtin(crc);
+	slot = CARTDB_Slot(crc);
+	return slot->used ? &slot->entry : NULL;
+}
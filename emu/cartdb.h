@@ -0,0 +1,43 @@
+#ifndef _CARTDB_H_
+#define _CARTDB_H_
+
+#include "atari.h"
+
+/* Cartridge database: what is known of a title by the CRC-32 of its raw
+   image. That is the mapping where the size alone doesn't tell it (16 KB
+   one-chip or two-chip) and the settings the title runs best with.
+
+   A few one-chip titles are built in. CARTDB_Load() adds a text file of
+   more, one title a line:
+
+     # crc     mapping  controller  refresh  quality  title
+     9bae58dc  ns16     digital     -        -        Beamrider
+
+   mapping is 32, ee16, ns16, 40, 8 or 4 (CART_5200_*), controller
+   digital or analog, refresh the refresh_rate for Atari800_Frame() and
+   quality the one for Pokey_set_mzquality(). "-" leaves a field unset,
+   and unset fields of a built-in title keep what is built in. */
+
+#define CARTDB_UNSET	0xff
+
+#define CARTDB_DIGITAL	0
+#define CARTDB_ANALOG	1
+
+typedef struct {
+	ULONG crc;
+	UBYTE type;				/* CART_5200_* */
+	UBYTE controller;		/* CARTDB_DIGITAL or CARTDB_ANALOG */
+	UBYTE refresh_rate;
+	UBYTE audio_quality;
+} CARTDB_Entry;
+
+/* Reads the file into a hash table, replacing what an earlier call read.
+   Not safe while another thread looks up: load before starting them.
+   Returns the number of titles read, -1 if the file can't be read. */
+int CARTDB_Load(const char *filename);
+/* Frees what CARTDB_Load() read; the built-in titles stay. */
+void CARTDB_Free(void);
+/* The title with that CRC, NULL if it is not known. */
+const CARTDB_Entry *CARTDB_Lookup(ULONG crc);
+
+#endif /* _CARTDB_H_ */
@@ -28,13 +28,14 @@
 #include <string.h>
 
 //ALEK #include "main.h"
-#include "shared.h"
 
 #include "atari.h"
 #include "binload.h" /* loading_basic */
+#include "cartdb.h"
 #include "cartridge.h"
 #include "memory.h"
 #include "pia.h"
+#include "rewind.h"
 #include "rtime.h"
 #include "util.h"
 #ifndef BASIC
@@ -103,12 +104,16 @@ int CART_IsFor5200(int type)
 	return FALSE;
 }
 
-UBYTE *cart_image = NULL;		/* For cartridge memory */
-char cart_filename[FILENAME_MAX];
+EMU_TLS UBYTE *cart_image = NULL;		/* For cartridge memory */
+EMU_TLS char cart_filename[FILENAME_MAX];
 //LUDO: int cart_type = CART_NONE;
-int cart_type = CART_5200_32;
+EMU_TLS int cart_type = CART_5200_32;
 
-static int bank;
+static EMU_TLS int bank;
+/* Bounty Bob banks in the two 4 KB windows, -1 if not known. The game
+   selects the same bank again and again (every access to $4ff6-$4ff9
+   selects one): only a different one is mapped in. */
+static EMU_TLS int bountybob_bank[2] = { -1, -1 };
 
 /* DB_32, XEGS_32, XEGS_64, XEGS_128, XEGS_256, XEGS_512, XEGS_1024 */
 /* SWXEGS_32, SWXEGS_64, SWXEGS_128, SWXEGS_256, SWXEGS_512, SWXEGS_1024 */
@@ -122,9 +127,9 @@ static void set_bank_809F(int b, int main)
 		else {
 			Cart809F_Enable();
 			CartA0BF_Enable();
-			CopyROM(0x8000, 0x9fff, cart_image + b * 0x2000);
+			MapROM(0x8000, 0x9fff, cart_image + b * 0x2000);
 			if (bank & 0x80)
-				CopyROM(0xa000, 0xbfff, cart_image + main);
+				MapROM(0xa000, 0xbfff, cart_image + main);
 		}
 		bank = b;
 	}
@@ -138,9 +143,9 @@ static void set_bank_A0AF(int b, int main)
 			CartA0BF_Disable();
 		else {
 			CartA0BF_Enable();
-			CopyROM(0xa000, 0xafff, cart_image + b * 0x1000);
+			MapROM(0xa000, 0xafff, cart_image + b * 0x1000);
 			if (bank < 0)
-				CopyROM(0xb000, 0xbfff, cart_image + main);
+				MapROM(0xb000, 0xbfff, cart_image + main);
 		}
 		bank = b;
 	}
@@ -154,7 +159,7 @@ static void set_bank_A0BF(int b)
 			CartA0BF_Disable();
 		else {
 			CartA0BF_Enable();
-			CopyROM(0xa000, 0xbfff, cart_image + (~b & 7) * 0x2000);
+			MapROM(0xa000, 0xbfff, cart_image + (~b & 7) * 0x2000);
 		}
 		bank = b;
 	}
@@ -167,7 +172,7 @@ static void set_bank_A0BF_WILL64(int b)
 			CartA0BF_Disable();
 		else {
 			CartA0BF_Enable();
-			CopyROM(0xa000, 0xbfff, cart_image + (b & 7) * 0x2000);
+			MapROM(0xa000, 0xbfff, cart_image + (b & 7) * 0x2000);
 		}
 		bank = b;
 	}
@@ -180,7 +185,7 @@ static void set_bank_A0BF_WILL32(int b)
 			CartA0BF_Disable();
 		else {
 			CartA0BF_Enable();
-			CopyROM(0xa000, 0xbfff, cart_image + (b & 3) * 0x2000);
+			MapROM(0xa000, 0xbfff, cart_image + (b & 3) * 0x2000);
 		}
 		bank = b;
 	}
@@ -195,7 +200,7 @@ static void set_bank_A0BF_ATMAX128(int b)
 			CartA0BF_Disable();
 		else {
 			CartA0BF_Enable();
-			CopyROM(0xa000, 0xbfff, cart_image + b * 0x2000);
+			MapROM(0xa000, 0xbfff, cart_image + b * 0x2000);
 		}
 		bank = b;
 	}
@@ -208,7 +213,7 @@ static void set_bank_A0BF_ATMAX1024(int b)
 			CartA0BF_Disable();
 		else {
 			CartA0BF_Enable();
-			CopyROM(0xa000, 0xbfff, cart_image + b * 0x2000);
+			MapROM(0xa000, 0xbfff, cart_image + b * 0x2000);
 		}
 		bank = b;
 	}
@@ -224,7 +229,7 @@ static void set_bank_80BF(int b)
 		else {
 			Cart809F_Enable();
 			CartA0BF_Enable();
-			CopyROM(0x8000, 0xbfff, cart_image + b * 0x4000);
+			MapROM(0x8000, 0xbfff, cart_image + b * 0x4000);
 		}
 		bank = b;
 	}
@@ -361,7 +366,7 @@ void CART_PutByte(UWORD addr, UBYTE byte)
 			int b = byte & 0xf;
 			if (b != bank) {
 				CartA0BF_Enable();
-				CopyROM(0xa000, 0xbfff, cart_image + b * 0x2000);
+				MapROM(0xa000, 0xbfff, cart_image + b * 0x2000);
 				bank = b;
 			}
 		}
@@ -412,94 +417,75 @@ void CART_PutByte(UWORD addr, UBYTE byte)
 }
 
 /* special support of Bounty Bob on Atari5200 */
+
+/* Selects bank b of window 0 (4000-4fff, 8000-8fff on the 800) or
+   window 1 (5000-5fff, 9000-9fff) from addr, an address in the window. */
+static void BountyBob_Select(UWORD addr, int window, int b)
+{
+	if (b != bountybob_bank[window]) {
+		UWORD base = addr & 0xf000;
+		MapROM(base, base + 0xfff, cart_image + window * 0x4000 + b * 0x1000);
+		bountybob_bank[window] = b;
+	}
+}
+
 void CART_BountyBob1(UWORD addr)
 {
 	if (machine_type == MACHINE_5200) {
-		if (addr >= 0x4ff6 && addr <= 0x4ff9) {
-			addr -= 0x4ff6;
-			CopyROM(0x4000, 0x4fff, cart_image + addr * 0x1000);
-		}
+		if (addr >= 0x4ff6 && addr <= 0x4ff9)
+			BountyBob_Select(addr, 0, addr - 0x4ff6);
 	} else {
-		if (addr >= 0x8ff6 && addr <= 0x8ff9) {
-			addr -= 0x8ff6;
-			CopyROM(0x8000, 0x8fff, cart_image + addr * 0x1000);
-		}
+		if (addr >= 0x8ff6 && addr <= 0x8ff9)
+			BountyBob_Select(addr, 0, addr - 0x8ff6);
 	}
 }
 
 void CART_BountyBob2(UWORD addr)
 {
 	if (machine_type == MACHINE_5200) {
-		if (addr >= 0x5ff6 && addr <= 0x5ff9) {
-			addr -= 0x5ff6;
-			CopyROM(0x5000, 0x5fff, cart_image + 0x4000 + addr * 0x1000);
-		}
+		if (addr >= 0x5ff6 && addr <= 0x5ff9)
+			BountyBob_Select(addr, 1, addr - 0x5ff6);
 	}
 	else {
-		if (addr >= 0x9ff6 && addr <= 0x9ff9) {
-			addr -= 0x9ff6;
-			CopyROM(0x9000, 0x9fff, cart_image + 0x4000 + addr * 0x1000);
-		}
+		if (addr >= 0x9ff6 && addr <= 0x9ff9)
+			BountyBob_Select(addr, 1, addr - 0x9ff6);
 	}
 }
 
 #ifdef PAGED_ATTRIB
+/* CART_Start() puts these on the last page of each window, 4f and 5f on
+   the 5200, 8f and 9f on the 800, so the page already tells the machine
+   and the window: only the offset of the registers, f6-f9, is left. */
+#define BOUNTYBOB_REG(addr)		((UBYTE) ((addr) - 0xf6) < 4)
+
 UBYTE BountyBob1_GetByte(UWORD addr)
 {
-	if (machine_type == MACHINE_5200) {
-		if (addr >= 0x4ff6 && addr <= 0x4ff9) {
-			CART_BountyBob1(addr);
-			return 0;
-		}
-	} else {
-		if (addr >= 0x8ff6 && addr <= 0x8ff9) {
-			CART_BountyBob1(addr);
-			return 0;
-		}
+	if (BOUNTYBOB_REG(addr)) {
+		BountyBob_Select(addr, 0, (UBYTE) (addr - 0xf6));
+		return 0;
 	}
-	return dGetByte(addr);
+	return dFetchByte(addr);
 }
 
 UBYTE BountyBob2_GetByte(UWORD addr)
 {
-	if (machine_type == MACHINE_5200) {
-		if (addr >= 0x5ff6 && addr <= 0x5ff9) {
-			CART_BountyBob2(addr);
-			return 0;
-		}
-	} else {
-		if (addr >= 0x9ff6 && addr <= 0x9ff9) {
-			CART_BountyBob2(addr);
-			return 0;
-		}
+	if (BOUNTYBOB_REG(addr)) {
+		BountyBob_Select(addr, 1, (UBYTE) (addr - 0xf6));
+		return 0;
 	}
-	return dGetByte(addr);
+	return dFetchByte(addr);
 }
 
 void BountyBob1_PutByte(UWORD addr, UBYTE value)
 {
-	if (machine_type == MACHINE_5200) {
-		if (addr >= 0x4ff6 && addr <= 0x4ff9) {
-			CART_BountyBob1(addr);
-		}
-	} else {
-		if (addr >= 0x8ff6 && addr <= 0x8ff9) {
-			CART_BountyBob1(addr);
-		}
-	}
+	if (BOUNTYBOB_REG(addr))
+		BountyBob_Select(addr, 0, (UBYTE) (addr - 0xf6));
 }
 
 void BountyBob2_PutByte(UWORD addr, UBYTE value)
 {
-	if (machine_type == MACHINE_5200) {
-		if (addr >= 0x5ff6 && addr <= 0x5ff9) {
-			CART_BountyBob2(addr);
-		}
-	} else {
-		if (addr >= 0x9ff6 && addr <= 0x9ff9) {
-			CART_BountyBob2(addr);
-		}
-	}
+	if (BOUNTYBOB_REG(addr))
+		BountyBob_Select(addr, 1, (UBYTE) (addr - 0xf6));
 }
 #endif
 
@@ -513,7 +499,136 @@ int CART_Checksum(const UBYTE *image, int nbytes)
 	return checksum;
 }
 
-extern unsigned int gameCRC;
+EMU_TLS unsigned int gameCRC;
+
+/*
+#  
+bd52623b  Defender # A5200.A52
+ce07d9ad  Diagnostic Cart.bin
+6a687f9c  Dig Dug # A5200.A52
+d3bd3221  Final Legacy (Prototype) # A5200.A52
+d3bd3221  FinalLegacy.bin
+04b299a4  Frisky Tom (Prototype) # A5200.A52
+0af19345  Frogger 2 - Threedeep! # A5200.A52
+1062ef6a  Frogger.bin
+0fe438b3  frogger2.bin
+04b299a4  frskytom.bin
+97b15243  Gorf.bin
+cfd4a7f9  Gyruss # A5200.A52
+cfd4a7f9  Gyruss.bin
+18a73af3  H.E.R.O. # A5200.A52
+18a73af3  H.E.R.O. (1984) (Activision).a52
+18a73af3  Hero.a52
+d9ae4518  James Bond 007 # A5200.A52
+d9ae4518  JamesBond007.bin
+bfd30c01  Joust # A5200.A52
+7c30592c  Jr Pac-Man # A5200.A52
+2c676662  Jungle Hunt # A5200.A52
+ecfa624f  Kangaroo # A5200.A52
+02cdfc70  KrazyShootOut.bin
+83517703  Last Starfighter # A5200.A52
+84df4925  Looney Tunes Hotel (Prototype # A5200.A52
+ab8e035b  Meteorites # A5200.A52
+931a454a  MICRGAMN.BIN
+931a454a  Microgammon SB (Prototype) # A5200.A52
+969cfe1a  Millipede # A5200.A52
+7df1adfb  Miner 2049 # A5200.A52
+c597c087  Miniature Golf # A5200.A52
+c597c087  MINIGOLF.BIN
+2a640143  Montezuma's Revenge # A5200.A52
+d0b2f285  Moon Patrol # A5200.A52
+457fb9b3  Mr. Do's Castle.bin
+752f5efd  Ms. Pac-Man # A5200.A52
+59983c40  pacjr52.bin
+8873ef51  Pac-Man # A5200.A52
+e9f826bd  pete.bin
+4b910461  Pitfall 2 - the Lost Caverns # A5200.A52
+4b910461  Pitfall II - The Lost Caverns (1984) (Activision).a52
+abc2d1e4  Pole Position # A5200.A52
+abc2d1e4  PolePosition.bin
+a18a9a40  Popeye # A5200.A52
+3c33f26e  Qbert.bin
+aea6d2c2  QIX # A5200.A52
+b5f3402b  Quest for Quintana Roo # A5200.A52
+4336c2cc  Realsports Football # A5200.A52
+ecbd1853  Realsports Soccer # A5200.A52
+10f33c90  Realsports Tennis # A5200.A52
+0f996184  RealsportsBasketballRev1.bin
+4336c2cc  RealsportsFootball.bin
+10f33c90  RealsportsTennis.bin
+a97606ab  Roadrunner # A5200.A52
+4252abd9  Robotron 2084 # A5200.A52
+b68d61e8  Space Dungeon # A5200.A52
+387365dc  Space Shuttle - a Journey Into Space # A5200.A52
+b68d61e8  SpaceDungeon.bin
+73b5b6fb  Sport Goofy (Prototype) # A5200.A52
+7d819a9f  Star Raiders # A5200.A52
+69f23548  Star Trek - Strategic Operations Simulator # A5200.A52
+75f566df  Star Wars - the Arcade Game # A5200.A52
+1d1cee27  Stargate # A5200.A52
+75f566df  StarWarsArcade.bin
+fd8f0cd4  Super Pac Man Final (5200).bin
+0a4ddb1e  Super Pac-Man (Prototype) # A5200.A52
+1187342f  Tempest (Prototype) # A5200.A52
+1187342f  Tempst52.bin
+0ba22ece  Track and Field # A5200.A52
+d6f7ddfd  Wizard of Wor# A5200.A52
+b8faaec3  Xari Arena (Prototype) # A5200.A52
+b8faaec3  xari52.bin
+12cc298f  yellwsub.bin
+2959d827  Zone Ranger # A5200.A52
+*/
+
+/* Finds the type of the raw image in cart_image from its length
+   and starts it. */
+static int CART_StartRaw(int len) {
+	int type;
+	const CARTDB_Entry *db;
+
+	gameCRC = crc32(0, cart_image, len);
+	db = CARTDB_Lookup(gameCRC);
+	cart_type = CART_NONE;
+	len >>= 10;	/* number of kilobytes */
+	if (db != NULL && db->type != CARTDB_UNSET && cart_kb[db->type] == len)
+		cart_type = db->type;
+	else
+		for (type = 1; type <= CART_LAST_SUPPORTED; type++)
+			if (cart_kb[type] == len) {
+				if (cart_type == CART_NONE) {
+					cart_type = type;
+				}
+				else {
+#ifdef NOCASH
+					nocashMessage("multiple cart type");
+#endif
+					/* 16 KB and not a one-chip title of the database */
+					cart_type = CART_5200_EE_16;
+					break;
+				}
+			}
+	if (cart_type != CART_NONE) {
+		CART_Start();
+#ifdef NOCASH
+		nocashMessage("found cart type");
+#endif
+		return 0;
+	}
+	free(cart_image);
+	cart_image = NULL;
+	return CART_BAD_FORMAT;
+}
+
+int CART_InsertImage(const UBYTE *image, int len) {
+	/* remove currently inserted cart */
+	CART_Remove();
+
+	if ((len & 0x3ff) != 0)
+		return CART_BAD_FORMAT;
+	cart_filename[0] = '\0';
+	cart_image = (UBYTE *) Util_malloc(len);
+	memcpy(cart_image, image, len);
+	return CART_StartRaw(len);
+}
 
 int CART_Insert(const char *filename) {
 #ifdef NOCASH
@@ -549,35 +664,7 @@ int CART_Insert(const char *filename) {
 		cart_image = (UBYTE *) Util_malloc(len);
 		fread(cart_image, 1, len, fp);
 		fclose(fp);
-		/* find cart type */
-    unsigned int crccomputed=crc32 (0, cart_image, len);
-		cart_type = CART_NONE;
-		len >>= 10;	/* number of kilobytes */
-		for (type = 1; type <= CART_LAST_SUPPORTED; type++)
-			if (cart_kb[type] == len) {
-				if (cart_type == CART_NONE) {
-					cart_type = type;
-        }
-        else {
-#ifdef NOCASH      
-      nocashMessage("multiple cart type");
-#endif      
-		gameCRC = crccomputed;
-          cart_type = atari_waitoncardtype(crccomputed);
-          cart_type = (cart_type == 1 ? CART_5200_EE_16 : CART_5200_NS_16);
-          break;
-        }
-			}
-		if (cart_type != CART_NONE) {
-			CART_Start();
-#ifdef NOCASH      
-      nocashMessage("found cart type");
-#endif      
-			return 0;	
-		}
-		free(cart_image);
-		cart_image = NULL;
-		return CART_BAD_FORMAT;
+		return CART_StartRaw(len);
 	}
 	/* if not full kilobytes, assume it is CART file */
 	fread(header, 1, 16, fp);
@@ -619,6 +706,7 @@ void CART_Remove(void) {
     char sz[64];sprintf(sz,"CART_Remove %08x\n",cart_image);nocashMessage(sz);
 #endif
 	cart_type = CART_NONE;
+	gameCRC = 0;
 	if (cart_image != NULL) {
 #ifdef NOCASH
     nocashMessage("free cart image\n");
@@ -633,9 +721,12 @@ void CART_Start(void) {
 #ifdef NOCASH
   char sz[64];sprintf(sz,"CART_Start M%d %d\n",machine_type,cart_type);nocashMessage(sz);
 #endif
+	/* the history is of the machine with the cartridge there was */
+	Rewind_Reset();
+	bountybob_bank[0] = bountybob_bank[1] = -1;
 	if (machine_type == MACHINE_5200) {
-		SetROM(0x4ff6, 0x4ff9);		/* disable Bounty Bob bank switching */
-		SetROM(0x5ff6, 0x5ff9);
+		/* no banks mapped, Bounty Bob bank switching disabled */
+		SetROM(0x4000, 0xbfff);
 		switch (cart_type) {
 		case CART_5200_32:
 #ifdef NOCASH
@@ -655,10 +746,11 @@ void CART_Start(void) {
 #ifdef NOCASH
       nocashMessage("patch CART_5200_40");
 #endif      
-			CopyROM(0x4000, 0x4fff, cart_image);
-			CopyROM(0x5000, 0x5fff, cart_image + 0x4000);
+			MapROM(0x4000, 0x4fff, cart_image);
+			MapROM(0x5000, 0x5fff, cart_image + 0x4000);
 			CopyROM(0x8000, 0x9fff, cart_image + 0x8000);
 			CopyROM(0xa000, 0xbfff, cart_image + 0x8000);
+			bountybob_bank[0] = bountybob_bank[1] = 0;
 #ifndef PAGED_ATTRIB
 			SetHARDWARE(0x4ff6, 0x4ff9);
 			SetHARDWARE(0x5ff6, 0x5ff9);
@@ -805,6 +897,7 @@ void CART_Start(void) {
 			CopyROM(0x8000, 0x8fff, cart_image);
 			CopyROM(0x9000, 0x9fff, cart_image + 0x4000);
 			CopyROM(0xa000, 0xbfff, cart_image + 0x8000);
+			bountybob_bank[0] = bountybob_bank[1] = 0;
 #ifndef PAGED_ATTRIB
 			SetHARDWARE(0x8ff6, 0x8ff9);
 			SetHARDWARE(0x9ff6, 0x9ff9);
@@ -877,10 +970,15 @@ void CARTStateRead(void)
 
 	/* Read the cart type from the file.  If there is no cart type, becaused we have
 	   reached the end of the file, this will just default to CART_NONE */
+	/* the memory read later has banks of its own */
+	bountybob_bank[0] = bountybob_bank[1] = -1;
 	ReadINT(&savedCartType, 1);
 	if (savedCartType != CART_NONE) {
 		char filename[FILENAME_MAX];
 		ReadFNAME(filename);
+		/* already in: the banks it had are in the memory read later */
+		if (savedCartType == cart_type && cart_image != NULL && strcmp(filename, cart_filename) == 0)
+			return;
 		if (filename[0]) {
 			/* Insert the cartridge... */
 			if (CART_Insert(filename) >= 0) {
@@ -51,15 +51,22 @@
 
 #define CART_MAX_SIZE	(1024 * 1024)
 extern int cart_kb[CART_LAST_SUPPORTED + 1];
-extern int cart_type;
+extern EMU_TLS int cart_type;
+extern EMU_TLS UBYTE *cart_image;
+extern EMU_TLS char cart_filename[FILENAME_MAX];
 
 int CART_IsFor5200(int type);
+
+/* CRC-32 of the last raw image inserted, its key in the database (cartdb.h). */
+extern EMU_TLS unsigned int gameCRC;
 int CART_Checksum(const UBYTE *image, int nbytes);
 
 #define CART_CANT_OPEN		-1	/* Can't open cartridge image file */
 #define CART_BAD_FORMAT		-2	/* Unknown cartridge format */
 #define CART_BAD_CHECKSUM	-3	/* Warning: bad CART checksum */
 int CART_Insert(const char *filename);
+/* Inserts a copy of the raw image (no CART header) of len bytes. */
+int CART_InsertImage(const UBYTE *image, int len);
 
 void CART_Remove(void);
 
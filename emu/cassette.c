@@ -36,29 +36,29 @@
 
 #define MAX_BLOCKS 2048
 
-static FILE *cassette_file = NULL;
-static int cassette_isCAS;
-UBYTE cassette_buffer[4096];
-static ULONG cassette_block_offset[MAX_BLOCKS];
-static SLONG cassette_elapsedtime;  /* elapsed time since begin of file */
+static EMU_TLS FILE *cassette_file = NULL;
+static EMU_TLS int cassette_isCAS;
+EMU_TLS UBYTE cassette_buffer[4096];
+static EMU_TLS ULONG cassette_block_offset[MAX_BLOCKS];
+static EMU_TLS SLONG cassette_elapsedtime;  /* elapsed time since begin of file */
                                     /* in scanlines */
-static SLONG cassette_nextirqevent; /* timestamp of next irq in scanlines */
-
-char cassette_filename[FILENAME_MAX];
-char cassette_description[CASSETTE_DESCRIPTION_MAX];
-int cassette_current_blockbyte = 0;
-int cassette_current_block;
-int cassette_max_blockbytes = 0;
-int cassette_max_block = 0;
-int cassette_savefile = FALSE;
-int cassette_gapdelay = 0;	/* in ms, includes leader and all gaps */
-int cassette_motor = 0;
-int cassette_baudrate = 600;	/* provisional: 600 baud */
-
-int hold_start_on_reboot = 0;
-int hold_start = 0;
-int press_space = 0;
-int eof_of_tape = 0;
+static EMU_TLS SLONG cassette_nextirqevent; /* timestamp of next irq in scanlines */
+
+EMU_TLS char cassette_filename[FILENAME_MAX];
+EMU_TLS char cassette_description[CASSETTE_DESCRIPTION_MAX];
+EMU_TLS int cassette_current_blockbyte = 0;
+EMU_TLS int cassette_current_block;
+EMU_TLS int cassette_max_blockbytes = 0;
+EMU_TLS int cassette_max_block = 0;
+EMU_TLS int cassette_savefile = FALSE;
+EMU_TLS int cassette_gapdelay = 0;	/* in ms, includes leader and all gaps */
+EMU_TLS int cassette_motor = 0;
+EMU_TLS int cassette_baudrate = 600;	/* provisional: 600 baud */
+
+EMU_TLS int hold_start_on_reboot = 0;
+EMU_TLS int hold_start = 0;
+EMU_TLS int press_space = 0;
+EMU_TLS int eof_of_tape = 0;
 
 typedef struct {
 	char identifier[4];
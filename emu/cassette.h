@@ -13,15 +13,15 @@ int CASSETTE_CheckFile(const char *filename, FILE **fp, char *description, int *
 int CASSETTE_CreateFile(const char *filename, FILE **fp, int *isCAS);
 int CASSETTE_Insert(const char *filename);
 void CASSETTE_Remove(void);
-extern char cassette_filename[FILENAME_MAX];
-extern char cassette_description[CASSETTE_DESCRIPTION_MAX];
+extern EMU_TLS char cassette_filename[FILENAME_MAX];
+extern EMU_TLS char cassette_description[CASSETTE_DESCRIPTION_MAX];
 
-extern int cassette_current_block;
-extern int cassette_max_block;
+extern EMU_TLS int cassette_current_block;
+extern EMU_TLS int cassette_max_block;
 
-extern int hold_start;
-extern int hold_start_on_reboot; /* preserve hold_start after reboot */
-extern int press_space;
+extern EMU_TLS int hold_start;
+extern EMU_TLS int hold_start_on_reboot; /* preserve hold_start after reboot */
+extern EMU_TLS int press_space;
 
 int CASSETTE_AddGap(int gaptime);
 void CASSETTE_LeaderLoad(void);
@@ -33,6 +33,6 @@ int CASSETTE_GetByte(void);
 int CASSETTE_GetInputIRQDelay(void);
 void CASSETTE_TapeMotor(int onoff);
 void CASSETTE_AddScanLine(void);
-extern UBYTE cassette_buffer[4096];
+extern EMU_TLS UBYTE cassette_buffer[4096];
 
 #endif /* _CASSETTE_H_ */
@@ -30,12 +30,12 @@ extern void CPUGET(void);		/* put from CCR, N & Z FLAG into regP */
 extern void CPUPUT(void);		/* put from regP into CCR, N & Z FLAG */
 #endif
 
-extern UWORD regPC;
-extern UBYTE regA;
-extern UBYTE regP;
-extern UBYTE regS;
-extern UBYTE regY;
-extern UBYTE regX;
+extern EMU_TLS UWORD regPC;
+extern EMU_TLS UBYTE regA;
+extern EMU_TLS UBYTE regP;
+extern EMU_TLS UBYTE regS;
+extern EMU_TLS UBYTE regY;
+extern EMU_TLS UBYTE regX;
 
 #define SetN regP |= N_FLAG
 #define ClrN regP &= (~N_FLAG)
@@ -52,11 +52,11 @@ extern UBYTE regX;
 #define SetC regP |= C_FLAG
 #define ClrC regP &= (~C_FLAG)
 
-extern UBYTE IRQ;
+extern EMU_TLS UBYTE IRQ;
 
-extern void (*rts_handler)(void);
+extern EMU_TLS void (*rts_handler)(void);
 
-extern UBYTE cim_encountered;
+extern EMU_TLS UBYTE cim_encountered;
 
 #define REMEMBER_PC_STEPS 64
 extern UWORD remember_PC[REMEMBER_PC_STEPS];
@@ -69,8 +69,29 @@ extern unsigned int remember_jmp_curpos;
 
 /* extern const int cycles[256]; */
 
+extern EMU_TLS ULONG cpu_instructions;
+
+#if defined(CPU_JIT) || defined(CPU_BLOCKS)
+/* Decodes the instruction at addr as part of a block: returns its base
+   cycles, or 0 if it can't be run as part of a block (not in ROM, or past
+   0xffff). *len receives its length and *last is set if the block must
+   end with it (branch, jump, hardware access, ...). */
+int CPU_BlockInsn(UWORD addr, int *len, int *last);
+#endif
+
 #ifdef MONITOR_PROFILE
-extern int instruction_count[256];
+/* while monitor_profile is set GO() counts the executed opcodes
+   and the instructions executed in each 16-byte block of code */
+#define PC_BLOCK_SHIFT 4
+extern EMU_TLS int monitor_profile;
+extern EMU_TLS ULONG instruction_count[256];
+extern EMU_TLS ULONG pc_block_count[0x10000 >> PC_BLOCK_SHIFT];
+#endif
+
+#ifdef TRACE_HOOKS
+/* called before each instruction with regPC, regA... up to date,
+   see A5200_SetTraceHooks() */
+extern EMU_TLS void (*trace_insn_hook)(void);
 #endif
 
 #endif /* _CPU_H_ */
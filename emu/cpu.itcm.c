@@ -27,6 +27,9 @@
 	=====================
 
 	Define CPU65C02 if you don't want 6502 JMP() bug emulation.
+	Define CPU_BLOCKS to run blocks of ROM code pre-decoded (see below and cpu_blocks.c).
+	Define CPU_JIT to translate hot blocks of ROM code to x86-64 code (see below and cpu_jit.c).
+	Define CPU_INSN_COUNT to count the executed instructions in cpu_instructions.
 	Define CYCLES_PER_OPCODE to update xpos in each opcode's emulation.
 	Define MONITOR_BREAK if you want code breakpoints and execution history.
 	Define MONITOR_BREAKPOINTS if you want user-defined breakpoints.
@@ -60,6 +63,12 @@
 #include <stdlib.h>	/* exit() */
 
 #include "cpu.h"
+#ifdef CPU_JIT
+#include "cpu_jit.h"
+#endif
+#ifdef CPU_BLOCKS
+#include "cpu_blocks.h"
+#endif
 #ifdef ASAP /* external project, see http://asap.sf.net */
 #include "asap_internal.h"
 #else
@@ -94,6 +103,15 @@
 /* If PREFETCH_CODE is defined, 2 bytes after the opcode are always fetched. */
 /* #define PREFETCH_CODE */
 
+#if defined(CPU_JIT) || defined(CPU_BLOCKS)
+#if !defined(PAGED_ATTRIB) || defined(CYCLES_PER_OPCODE) || defined(MONITOR_BREAK) || defined(MONITOR_BREAKPOINTS) || defined(MONITOR_TRACE) || defined(NO_V_FLAG_VARIABLE)
+#error CPU_JIT and CPU_BLOCKS need PAGED_ATTRIB, per-instruction cycle accounting without the monitor and the V flag variable
+#endif
+#endif
+#if defined(CPU_JIT) && defined(CPU_BLOCKS)
+#error CPU_JIT and CPU_BLOCKS are alternatives
+#endif
+
 
 /* 6502 stack handling */
 #define PL                  dGetByte(0x0100 + ++S)
@@ -117,9 +135,29 @@
 #define GET_PC()            PC
 #define SET_PC(newpc)       (PC = (newpc))
 #define PHPC                PHW(PC)
-#define GET_CODE_BYTE()     dGetByte(PC++)
-#define PEEK_CODE_BYTE()    dGetByte(PC)
-#define PEEK_CODE_WORD()    dGetWord(PC)
+#define GET_CODE_BYTE()     code[PC++]
+#define PEEK_CODE_BYTE()    code[PC]
+#define PEEK_CODE_WORD()    (code[PC] + (code[PC + 1] << 8))
+/* code is where the instruction at PC is read from (see fetchmap in
+   memory.h), kept from one instruction to the next while fetchmap has
+   it for the page of PC, which keeps the page lookup off the path of
+   the instructions. On the last page of a 4 KB block followed by one
+   mapped elsewhere, each instruction is copied to code_edge instead,
+   as it may run into the next block. */
+#ifndef PAGED_ATTRIB
+#define FETCH_CODE          code = memory
+#else
+#define FETCH_CODE \
+	if (fetchmap[PC >> 8] != code) { \
+		code = fetchmap[PC >> 8]; \
+		if ((PC & 0xf00) == 0xf00 && fetchmap[(UBYTE) ((PC >> 8) + 1)] != code) { \
+			code_edge[0] = code[PC]; \
+			code_edge[1] = dFetchByte(PC + 1); \
+			code_edge[2] = dFetchByte(PC + 2); \
+			code = code_edge - PC; \
+		} \
+	}
+#endif /* PAGED_ATTRIB */
 #endif /* PC_PTR */
 
 /* Cycle-exact Read-Modify-Write instructions.
@@ -156,25 +194,25 @@
 #endif /* NEW_CYCLE_EXACT */
 
 /* 6502 registers. */
-UWORD regPC;
-UBYTE regA;
-UBYTE regX;
-UBYTE regY;
-UBYTE regP;						/* Processor Status Byte (Partial) */
-UBYTE regS;
-UBYTE IRQ;
+EMU_TLS UWORD regPC;
+EMU_TLS UBYTE regA;
+EMU_TLS UBYTE regX;
+EMU_TLS UBYTE regY;
+EMU_TLS UBYTE regP;						/* Processor Status Byte (Partial) */
+EMU_TLS UBYTE regS;
+EMU_TLS UBYTE IRQ;
 
 /* Transfer 6502 registers between global variables and local variables inside GO() */
 #define UPDATE_GLOBAL_REGS  regPC = GET_PC(); regS = S; regA = A; regX = X; regY = Y
 #define UPDATE_LOCAL_REGS   SET_PC(regPC); S = regS; A = regA; X = regX; Y = regY
 
 /* 6502 flags local to this module */
-static UBYTE N;					/* bit7 set => N flag set */
+static EMU_TLS UBYTE N;					/* bit7 set => N flag set */
 #ifndef NO_V_FLAG_VARIABLE
-static UBYTE V;                 /* non-zero => V flag set */
+static EMU_TLS UBYTE V;                 /* non-zero => V flag set */
 #endif
-static UBYTE Z;					/* zero     => Z flag set */
-static UBYTE C;					/* must be 0 or 1 */
+static EMU_TLS UBYTE Z;					/* zero     => Z flag set */
+static EMU_TLS UBYTE C;					/* must be 0 or 1 */
 /* B, D, I are always in regP */
 
 void CPU_GetStatus(void)
@@ -197,14 +235,31 @@ void CPU_PutStatus(void)
 }
 
 /* For Atari Basic loader */
-void (*rts_handler)(void) = NULL;
+EMU_TLS void (*rts_handler)(void) = NULL;
+
+/* Instructions executed since power-on (wraps around), with CPU_INSN_COUNT */
+EMU_TLS ULONG cpu_instructions = 0;
 
-/* 6502 instruction profiling */
+/* 6502 instruction profiling, see profile.h */
 #ifdef MONITOR_PROFILE
-int instruction_count[256];
+EMU_TLS int monitor_profile = FALSE;
+EMU_TLS ULONG instruction_count[256];
+EMU_TLS ULONG pc_block_count[0x10000 >> PC_BLOCK_SHIFT];
+#endif
+
+#ifdef TRACE_HOOKS
+EMU_TLS void (*trace_insn_hook)(void) = NULL;
 #endif
 
-UBYTE cim_encountered = FALSE;
+EMU_TLS UBYTE cim_encountered = FALSE;
+
+#ifdef CPU_JIT
+/* set when an interrupt has moved PC to its handler, see GO() */
+static EMU_TLS UBYTE jit_vector = FALSE;
+#define JIT_VECTOR	jit_vector = TRUE
+#else
+#define JIT_VECTOR
+#endif
 
 /* Execution history */
 #ifdef MONITOR_BREAK
@@ -283,7 +338,7 @@ unsigned int remember_jmp_curpos = 0;
 			xpos++; \
 		xpos++; \
 		SET_PC(addr); \
-		DONE \
+		DONE_JUMP \
 	} \
 	PC++; \
 	DONE
@@ -305,6 +360,7 @@ void NMI(void)
 	regS = S;
 	xpos += 7; /* handling an interrupt by 6502 takes 7 cycles */
 	INC_RET_NESTING;
+	JIT_VECTOR;
 }
 
 /* Check pending IRQ, helps in (not only) Lucasfilm games */
@@ -316,6 +372,7 @@ void NMI(void)
 		SET_PC(dGetWordAligned(0xfffe)); \
 		xpos += 7; \
 		INC_RET_NESTING; \
+		JIT_VECTOR; \
 	}
 
 /* Enter monitor */
@@ -356,6 +413,138 @@ static const int cycles[256] =
 	2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7		/* Fx */
 };
 
+#if defined(CPU_JIT) || defined(CPU_BLOCKS)
+
+/* Blocks
+
+   A block is a straight run of instructions in ROM ending with the first
+   one that may branch, check for an IRQ, or access memory through
+   readmap/writemap. Instructions before the last one therefore touch only
+   plain memory and the registers: nothing that reads xpos runs until the last one,
+   and by then xpos is the same whether the cycles were added one
+   instruction at a time or all at once. So a translated block (cpu_jit.c)
+   or a decoded one (cpu_blocks.c) checks xpos_limit once and adds the
+   base cycles of all its instructions in one go; page crossing and
+   branch cycles are still added where they happen. A block is only run
+   when all of it would have been run anyway - each instruction adds at
+   most one extra cycle, see GO() - so WSYNC and interrupt timing are
+   unchanged.
+
+   The blocks are dropped when ROM contents change (CopyROM(), or
+   MapROM() over pages that were in memory[]: only the pages of the range
+   and the one before) or the memory map does (SetROM(), SetRAM(), state
+   loading: all of them). Code in RAM or in a bank MapROM() put in is
+   never run as a block, so writes to RAM and switching banks need no
+   checks. */
+
+/* block_type[] flags */
+#define BLK_LEN		0x03	/* instruction length */
+#define BLK_END		0x04	/* always ends a block */
+#define BLK_ABS		0x08	/* abcd: quiet if readmap/writemap are NULL for its page */
+#define BLK_IDX		0x10	/* abcd,x or abcd,y: same for the page after it */
+#define BLK_RD		0x20	/* reads from abcd */
+#define BLK_WR		0x40	/* writes to abcd */
+
+#define E1	(BLK_END | 1)
+#define E2	(BLK_END | 2)
+#define E3	(BLK_END | 3)
+#define Q1	1		/* implied, accumulator, stack */
+#define Q2	2		/* immediate, zero page (no memory attributes there) */
+#define AR	(BLK_ABS | BLK_RD | 3)
+#define AW	(BLK_ABS | BLK_WR | 3)
+#define AM	(BLK_ABS | BLK_RD | BLK_WR | 3)
+#define XR	(BLK_ABS | BLK_IDX | BLK_RD | 3)
+#define XW	(BLK_ABS | BLK_IDX | BLK_WR | 3)
+#define XM	(BLK_ABS | BLK_IDX | BLK_RD | BLK_WR | 3)
+
+/* branches, jumps, interrupts, CLI, PLP, CIM/ESC and (zp,x), (zp),y
+   and the unstable SHA/SHS/SHX/SHY/LAS always end a block */
+static const UBYTE block_type[256] =
+{
+	E1, E2, E1, E2, Q2, Q2, Q2, Q2, Q1, Q2, Q1, Q2, AR, AR, AM, AM,		/* 0x */
+	E2, E2, E1, E2, Q2, Q2, Q2, Q2, Q1, XR, Q1, XM, XR, XR, XM, XM,		/* 1x */
+	E3, E2, E1, E2, Q2, Q2, Q2, Q2, E1, Q2, Q1, Q2, AR, AR, AM, AM,		/* 2x */
+	E2, E2, E1, E2, Q2, Q2, Q2, Q2, Q1, XR, Q1, XM, XR, XR, XM, XM,		/* 3x */
+	E1, E2, E1, E2, Q2, Q2, Q2, Q2, Q1, Q2, Q1, Q2, E3, AR, AM, AM,		/* 4x */
+	E2, E2, E1, E2, Q2, Q2, Q2, Q2, E1, XR, Q1, XM, XR, XR, XM, XM,		/* 5x */
+	E1, E2, E1, E2, Q2, Q2, Q2, Q2, Q1, Q2, Q1, Q2, E3, AR, AM, AM,		/* 6x */
+	E2, E2, E1, E2, Q2, Q2, Q2, Q2, Q1, XR, Q1, XM, XR, XR, XM, XM,		/* 7x */
+	Q2, E2, Q2, E2, Q2, Q2, Q2, Q2, Q1, Q2, Q1, Q2, AW, AW, AW, AW,		/* 8x */
+	E2, E2, E1, E2, Q2, Q2, Q2, Q2, Q1, XW, Q1, E3, E3, XW, E3, E3,		/* 9x */
+	Q2, E2, Q2, E2, Q2, Q2, Q2, Q2, Q1, Q2, Q1, Q2, AR, AR, AR, AR,		/* Ax */
+	E2, E2, E1, E2, Q2, Q2, Q2, Q2, Q1, XR, Q1, E3, XR, XR, XR, XR,		/* Bx */
+	Q2, E2, Q2, E2, Q2, Q2, Q2, Q2, Q1, Q2, Q1, Q2, AR, AR, AM, AM,		/* Cx */
+	E2, E2, E2, E2, Q2, Q2, Q2, Q2, Q1, XR, Q1, XM, XR, XR, XM, XM,		/* Dx */
+	Q2, E2, Q2, E2, Q2, Q2, Q2, Q2, Q1, Q2, Q1, Q2, AR, AR, AM, AM,		/* Ex */
+	E2, E2, E2, E2, Q2, Q2, Q2, Q2, Q1, XR, Q1, XM, XR, XR, XM, XM		/* Fx */
+};
+
+#undef E1
+#undef E2
+#undef E3
+#undef Q1
+#undef Q2
+#undef AR
+#undef AW
+#undef AM
+#undef XR
+#undef XW
+#undef XM
+
+#ifdef CPU_JIT
+/* registers passed to and from the translated blocks */
+static EMU_TLS JIT_Context jit_ctx;
+#endif
+
+/* not a page MapROM() put a bank on: blocks are read from memory[] */
+#define ROM_PAGE(addr) (writemap[(addr) >> 8] == ROM_PutByte && readmap[(addr) >> 8] == NULL)
+
+/* TRUE if the instruction at addr can't reach readmap/writemap */
+static int block_quiet(UWORD addr, UBYTE type)
+{
+	int page;
+	if (!(type & BLK_ABS))
+		return TRUE;
+	page = dGetByte(addr + 2);
+	if (((type & BLK_RD) && readmap[page] != NULL) || ((type & BLK_WR) && writemap[page] != NULL))
+		return FALSE;
+	if (type & BLK_IDX) {
+		page = (page + 1) & 0xff;
+		if (((type & BLK_RD) && readmap[page] != NULL) || ((type & BLK_WR) && writemap[page] != NULL))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+int CPU_BlockInsn(UWORD addr, int *len, int *last)
+{
+	UBYTE insn = dGetByte(addr);
+	UBYTE type = block_type[insn];
+	unsigned int next = addr + (type & BLK_LEN);
+
+	/* the code bytes must stay in ROM and below 0x10000 (no wrapping
+	   or PC_PTR fix-ups inside a block) */
+	if (next >= 0x10000 || !ROM_PAGE(addr) || !ROM_PAGE(next - 1))
+		return 0;
+	*len = type & BLK_LEN;
+	*last = (type & BLK_END) || !block_quiet(addr, type);
+	return cycles[insn];
+}
+
+#endif /* defined(CPU_JIT) || defined(CPU_BLOCKS) */
+
+/* The JIT and the blocks run instructions without going through the top
+   of the loop: not while something looks at every instruction. */
+#if defined(MONITOR_PROFILE) && defined(TRACE_HOOKS)
+#define PER_INSN_HOOKS	(monitor_profile || trace_insn_hook != NULL)
+#elif defined(MONITOR_PROFILE)
+#define PER_INSN_HOOKS	monitor_profile
+#elif defined(TRACE_HOOKS)
+#define PER_INSN_HOOKS	(trace_insn_hook != NULL)
+#else
+#define PER_INSN_HOOKS	FALSE
+#endif
+
 /* 6502 emulation routine */
 void GO(int limit)
 {
@@ -364,7 +553,11 @@ void GO(int limit)
 #define DONE				break;
 #else
 #define OPCODE_ALIAS(code)	opcode_##code:
+#ifdef CPU_BLOCKS
+#define DONE				goto block_entry;
+#else
 #define DONE				goto next;
+#endif
 	static const void *opcode[256] =
 	{
 		&&opcode_00, &&opcode_01, &&opcode_02, &&opcode_03,
@@ -447,6 +640,46 @@ void GO(int limit)
 		&&opcode_f8, &&opcode_f9, &&opcode_fa, &&opcode_fb,
 		&&opcode_fc, &&opcode_fd, &&opcode_fe, &&opcode_ff,
 	};
+#ifdef CPU_BLOCKS
+#define BLOCK_LABEL(name)	[BOP_##name] = &&block_##name
+	static const void *block_label[BOP_OPS] =
+	{
+		BLOCK_LABEL(END),
+
+		BLOCK_LABEL(LDA_IMM), BLOCK_LABEL(LDA_MEM), BLOCK_LABEL(LDA_ZPX), BLOCK_LABEL(LDA_ABX), BLOCK_LABEL(LDA_ABY),
+		BLOCK_LABEL(LDX_IMM), BLOCK_LABEL(LDX_MEM), BLOCK_LABEL(LDX_ZPY), BLOCK_LABEL(LDX_ABY),
+		BLOCK_LABEL(LDY_IMM), BLOCK_LABEL(LDY_MEM), BLOCK_LABEL(LDY_ZPX), BLOCK_LABEL(LDY_ABX),
+		BLOCK_LABEL(ORA_IMM), BLOCK_LABEL(ORA_MEM), BLOCK_LABEL(ORA_ZPX), BLOCK_LABEL(ORA_ABX), BLOCK_LABEL(ORA_ABY),
+		BLOCK_LABEL(AND_IMM), BLOCK_LABEL(AND_MEM), BLOCK_LABEL(AND_ZPX), BLOCK_LABEL(AND_ABX), BLOCK_LABEL(AND_ABY),
+		BLOCK_LABEL(EOR_IMM), BLOCK_LABEL(EOR_MEM), BLOCK_LABEL(EOR_ZPX), BLOCK_LABEL(EOR_ABX), BLOCK_LABEL(EOR_ABY),
+		BLOCK_LABEL(ADC_IMM), BLOCK_LABEL(ADC_MEM), BLOCK_LABEL(ADC_ZPX), BLOCK_LABEL(ADC_ABX), BLOCK_LABEL(ADC_ABY),
+		BLOCK_LABEL(SBC_IMM), BLOCK_LABEL(SBC_MEM), BLOCK_LABEL(SBC_ZPX), BLOCK_LABEL(SBC_ABX), BLOCK_LABEL(SBC_ABY),
+		BLOCK_LABEL(CMP_IMM), BLOCK_LABEL(CMP_MEM), BLOCK_LABEL(CMP_ZPX), BLOCK_LABEL(CMP_ABX), BLOCK_LABEL(CMP_ABY),
+		BLOCK_LABEL(CPX_IMM), BLOCK_LABEL(CPX_MEM),
+		BLOCK_LABEL(CPY_IMM), BLOCK_LABEL(CPY_MEM),
+		BLOCK_LABEL(BIT_MEM),
+		BLOCK_LABEL(ASL_ACC), BLOCK_LABEL(LSR_ACC), BLOCK_LABEL(ROL_ACC), BLOCK_LABEL(ROR_ACC),
+		BLOCK_LABEL(TAX), BLOCK_LABEL(TAY), BLOCK_LABEL(TXA), BLOCK_LABEL(TYA), BLOCK_LABEL(TSX), BLOCK_LABEL(TXS),
+		BLOCK_LABEL(INX), BLOCK_LABEL(INY), BLOCK_LABEL(DEX), BLOCK_LABEL(DEY),
+		BLOCK_LABEL(CLC), BLOCK_LABEL(SEC), BLOCK_LABEL(CLV), BLOCK_LABEL(SEI), BLOCK_LABEL(CLD), BLOCK_LABEL(SED), BLOCK_LABEL(NOP),
+		BLOCK_LABEL(PLA),
+
+		BLOCK_LABEL(STA_MEM), BLOCK_LABEL(STA_ZPX), BLOCK_LABEL(STA_ABX), BLOCK_LABEL(STA_ABY),
+		BLOCK_LABEL(STX_MEM), BLOCK_LABEL(STX_ZPY),
+		BLOCK_LABEL(STY_MEM), BLOCK_LABEL(STY_ZPX),
+		BLOCK_LABEL(ASL_MEM), BLOCK_LABEL(ASL_ZPX), BLOCK_LABEL(ASL_ABX),
+		BLOCK_LABEL(LSR_MEM), BLOCK_LABEL(LSR_ZPX), BLOCK_LABEL(LSR_ABX),
+		BLOCK_LABEL(ROL_MEM), BLOCK_LABEL(ROL_ZPX), BLOCK_LABEL(ROL_ABX),
+		BLOCK_LABEL(ROR_MEM), BLOCK_LABEL(ROR_ZPX), BLOCK_LABEL(ROR_ABX),
+		BLOCK_LABEL(INC_MEM), BLOCK_LABEL(INC_ZPX), BLOCK_LABEL(INC_ABX),
+		BLOCK_LABEL(DEC_MEM), BLOCK_LABEL(DEC_ZPX), BLOCK_LABEL(DEC_ABX),
+		BLOCK_LABEL(PHA), BLOCK_LABEL(PHP),
+
+		BLOCK_LABEL(BPL), BLOCK_LABEL(BMI), BLOCK_LABEL(BVC), BLOCK_LABEL(BVS),
+		BLOCK_LABEL(BCC), BLOCK_LABEL(BCS), BLOCK_LABEL(BNE), BLOCK_LABEL(BEQ),
+		BLOCK_LABEL(JMP), BLOCK_LABEL(JSR), BLOCK_LABEL(RTS)
+	};
+#endif /* CPU_BLOCKS */
 #endif	/* NO_GOTO */
 
 #ifdef CYCLES_PER_OPCODE
@@ -455,10 +688,22 @@ void GO(int limit)
 #define OPCODE(code) OPCODE_ALIAS(code)
 #endif
 
+/* ends an instruction that may have jumped: translated code may start
+   at the new PC */
+#ifdef CPU_JIT
+#define DONE_JUMP			goto jit_entry;
+#elif defined(CPU_BLOCKS)
+#define DONE_JUMP			goto block_entry;
+#else
+#define DONE_JUMP			DONE
+#endif
+
 #ifdef PC_PTR
 	const UBYTE *PC;
 #else
 	UWORD PC;
+	const UBYTE *code = NULL;
+	UBYTE code_edge[3];
 #endif
 	UBYTE A;
 	UBYTE X;
@@ -469,6 +714,16 @@ void GO(int limit)
 	UBYTE data;
 #define insn data
 
+#ifdef CPU_BLOCKS
+	const BLOCKS_Block *block;
+	const BLOCKS_Op *bop;
+	/* registers and flags at the start of the last BLOCK_WAIT block run */
+	const BLOCKS_Block *wait_block = NULL;
+	ULONG wait_regs = 0;
+	ULONG wait_flags = 0;
+	int wait_xpos = 0;
+#endif
+
 /*
    This used to be in the main loop but has been removed to improve
    execution speed. It does not seem to have any adverse effect on
@@ -517,6 +772,17 @@ void GO(int limit)
 
 	CPUCHECKIRQ;
 
+#ifdef CPU_JIT
+	/* starting at an interrupt handler */
+	if (jit_vector) {
+		jit_vector = FALSE;
+		goto jit_entry;
+	}
+#endif
+#ifdef CPU_BLOCKS
+	goto block_entry;
+#endif
+
 	while (xpos < xpos_limit) {
 
 #ifdef MONITOR_BREAKPOINTS
@@ -573,6 +839,16 @@ void GO(int limit)
 		memory[0x10000] = memory[0];
 #endif
 
+#ifdef TRACE_HOOKS
+		if (trace_insn_hook != NULL) {
+			UPDATE_GLOBAL_REGS;
+			trace_insn_hook();
+		}
+#endif
+
+#ifndef PC_PTR
+		FETCH_CODE;
+#endif
 		insn = GET_CODE_BYTE();
 
 #ifdef MONITOR_BREAKPOINTS
@@ -737,9 +1013,15 @@ void GO(int limit)
 #ifndef CYCLES_PER_OPCODE
 		xpos += cycles[insn];
 #endif
+#ifdef CPU_INSN_COUNT
+		cpu_instructions++;
+#endif
 
 #ifdef MONITOR_PROFILE
-		instruction_count[insn]++;
+		if (monitor_profile) {
+			instruction_count[insn]++;
+			pc_block_count[(UWORD) (GET_PC() - 1) >> PC_BLOCK_SHIFT]++;
+		}
 #endif
 
 #ifdef PREFETCH_CODE
@@ -767,7 +1049,7 @@ void GO(int limit)
 			SET_PC(dGetWordAligned(0xfffe));
 			INC_RET_NESTING;
 		}
-		DONE
+		DONE_JUMP
 
 	OPCODE(01)				/* ORA (ab,x) */
 		INDIRECT_X;
@@ -956,7 +1238,7 @@ void GO(int limit)
 			PHW(retaddr);
 		}
 		SET_PC(OP_WORD);
-		DONE
+		DONE_JUMP
 
 	OPCODE(21)				/* AND (ab,x) */
 		INDIRECT_X;
@@ -1024,7 +1306,7 @@ void GO(int limit)
 	OPCODE(28)				/* PLP */
 		PLP;
 		CPUCHECKIRQ;
-		DONE
+		DONE_JUMP
 
 	OPCODE(29)				/* AND #ab */
 		AND(IMMEDIATE);
@@ -1135,7 +1417,7 @@ void GO(int limit)
 		if (break_ret && --ret_nesting <= 0)
 			break_step = TRUE;
 #endif
-		DONE
+		DONE_JUMP
 
 	OPCODE(41)				/* EOR (ab,x) */
 		INDIRECT_X;
@@ -1203,7 +1485,7 @@ void GO(int limit)
 		remember_jmp_curpos = (remember_jmp_curpos + 1) % REMEMBER_JMP_STEPS;
 #endif
 		SET_PC(OP_WORD);
-		DONE
+		DONE_JUMP
 
 	OPCODE(4d)				/* EOR abcd */
 		ABSOLUTE;
@@ -1261,7 +1543,7 @@ void GO(int limit)
 	OPCODE(58)				/* CLI */
 		ClrI;
 		CPUCHECKIRQ;
-		DONE
+		DONE_JUMP
 
 	OPCODE(59)				/* EOR abcd,y */
 		ABSOLUTE_Y;
@@ -1303,7 +1585,7 @@ void GO(int limit)
 			rts_handler();
 			rts_handler = NULL;
 		}
-		DONE
+		DONE_JUMP
 
 	OPCODE(61)				/* ADC (ab,x) */
 		INDIRECT_X;
@@ -1410,15 +1692,15 @@ void GO(int limit)
 		ABSOLUTE;
 #ifdef CPU65C02
 		/* XXX: if ((UBYTE) addr == 0xff) xpos++; */
-		SET_PC(dGetWord(addr));
+		SET_PC(dFetchWord(addr));
 #else
 		/* original 6502 had a bug in JMP (addr) when addr crossed page boundary */
 		if ((UBYTE) addr == 0xff)
-			SET_PC((dGetByte(addr - 0xff) << 8) + dGetByte(addr));
+			SET_PC((dFetchByte(addr - 0xff) << 8) + dFetchByte(addr));
 		else
-			SET_PC(dGetWord(addr));
+			SET_PC(dFetchWord(addr));
 #endif
-		DONE
+		DONE_JUMP
 
 	OPCODE(6d)				/* ADC abcd */
 		ABSOLUTE;
@@ -2278,7 +2560,253 @@ void GO(int limit)
 
 #ifdef NO_GOTO
 	}
+#endif
+
+#ifdef CPU_JIT
+#ifdef NO_GOTO
+		continue;
+#endif
+	jit_entry:
+		/* run the translated blocks from PC, one after the other, until
+		   one isn't there or doesn't fit before xpos_limit */
+		while (cpu_jit && !PER_INSN_HOOKS && xpos < xpos_limit) {
+			JIT_Block code = jit_blocks[(UWORD) GET_PC()];
+			if (code == NULL)
+				code = JIT_Compile((UWORD) GET_PC());
+			if (code == JIT_NONE)
+				break;
+			jit_ctx.A = A;
+			jit_ctx.X = X;
+			jit_ctx.Y = Y;
+			jit_ctx.S = S;
+			jit_ctx.N = N;
+			jit_ctx.Z = Z;
+			jit_ctx.C = C;
+			jit_ctx.V = V;
+			jit_ctx.P = regP;
+			jit_ctx.xpos = xpos;
+			jit_ctx.xpos_limit = xpos_limit;
+			jit_ctx.insns = 0;
+			/* not run if it wouldn't fit before xpos_limit
+			   or needs the decimal mode */
+			if (!code(&jit_ctx, memory))
+				break;
+			A = jit_ctx.A;
+			X = jit_ctx.X;
+			Y = jit_ctx.Y;
+			S = jit_ctx.S;
+			N = jit_ctx.N;
+			Z = jit_ctx.Z;
+			C = jit_ctx.C;
+			V = jit_ctx.V;
+			regP = jit_ctx.P;
+			xpos = jit_ctx.xpos;
+#ifdef CPU_INSN_COUNT
+			cpu_instructions += jit_ctx.insns;
+#endif
+			SET_PC(jit_ctx.pc);
+		}
+#endif /* CPU_JIT */
+
+#ifdef CPU_BLOCKS
+#ifdef NO_GOTO
+#define BLOCK_OP(name)		case BOP_##name:
+#define BLOCK_NEXT			break;
+#else
+#define BLOCK_OP(name)		block_##name:
+#define BLOCK_NEXT			goto *block_label[(++bop)->op];
+#endif
+/* an instruction reading its operand, in each of its addressing modes */
+#define BLOCK_READ(name) \
+	BLOCK_OP(name##_IMM) name(bop->data); BLOCK_NEXT \
+	BLOCK_OP(name##_MEM) name(dGetByte(bop->addr)); BLOCK_NEXT \
+	BLOCK_OP(name##_ZPX) name(dGetByte((UBYTE) (bop->addr + X))); BLOCK_NEXT \
+	BLOCK_OP(name##_ABX) addr = bop->addr + X; NCYCLES_X; name(dGetByte(addr)); BLOCK_NEXT \
+	BLOCK_OP(name##_ABY) addr = bop->addr + Y; NCYCLES_Y; name(dGetByte(addr)); BLOCK_NEXT
+/* a read-modify-write instruction on addr */
+#define BLOCK_RMW(name, body) \
+	BLOCK_OP(name##_MEM) addr = bop->addr; body; BLOCK_NEXT \
+	BLOCK_OP(name##_ZPX) addr = (UBYTE) (bop->addr + X); body; BLOCK_NEXT \
+	BLOCK_OP(name##_ABX) addr = bop->addr + X; body; BLOCK_NEXT
+/* ADC and SBC in binary mode: blocks with them aren't run with D set */
+#define ADC(t_data) \
+	data = t_data; \
+	{ \
+		unsigned int tmp = A + data + C; \
+		C = tmp > 0xff; \
+		V = !((A ^ data) & 0x80) && ((data ^ tmp) & 0x80); \
+		Z = N = A = (UBYTE) tmp; \
+	}
+#define SBC(t_data) \
+	data = t_data; \
+	{ \
+		unsigned int tmp = A - data - 1 + C; \
+		C = tmp < 0x100; \
+		V = ((A ^ tmp) & 0x80) && ((A ^ data) & 0x80); \
+		Z = N = A = (UBYTE) tmp; \
+	}
+/* a loop's registers and flags, see BLOCK_WAIT below */
+#define WAIT_REGS	((ULONG) A | (ULONG) X << 8 | (ULONG) Y << 16 | (ULONG) S << 24)
+#define WAIT_FLAGS	((ULONG) N | (ULONG) Z << 8 | (ULONG) C << 16 | (ULONG) V << 24)
+
+	block_entry:
+		/* after each instruction the interpreter runs and at the start:
+		   the decoded blocks from PC, one after the other, until one isn't
+		   there or doesn't fit before xpos_limit */
+		if (!cpu_blocks || PER_INSN_HOOKS)
+			goto block_out;
+	block_lookup:
+		block = block_cache[(UWORD) GET_PC()];
+		if (block == NULL)
+			block = BLOCKS_Decode((UWORD) GET_PC());
+		if (block == BLOCKS_NONE || ((block->flags & BLOCK_DECIMAL) && (regP & D_FLAG)))
+			goto block_out;
+		wait_block = NULL;
+	block_loop:
+		if (xpos + block->span > xpos_limit)
+			goto block_out;
+		xpos += block->cycles;
+#ifdef CPU_INSN_COUNT
+		cpu_instructions += block->insns;
+#endif
+		bop = block->ops;
+#ifdef NO_GOTO
+		for (;; bop++) switch (bop->op) {
 #else
+		goto *block_label[bop->op];
+#endif
+
+	BLOCK_OP(END)
+		SET_PC(block->next);
+		goto block_lookup;
+
+	BLOCK_READ(LDA)
+	BLOCK_OP(LDX_IMM) LDX(bop->data); BLOCK_NEXT
+	BLOCK_OP(LDX_MEM) LDX(dGetByte(bop->addr)); BLOCK_NEXT
+	BLOCK_OP(LDX_ZPY) LDX(dGetByte((UBYTE) (bop->addr + Y))); BLOCK_NEXT
+	BLOCK_OP(LDX_ABY) addr = bop->addr + Y; NCYCLES_Y; LDX(dGetByte(addr)); BLOCK_NEXT
+	BLOCK_OP(LDY_IMM) LDY(bop->data); BLOCK_NEXT
+	BLOCK_OP(LDY_MEM) LDY(dGetByte(bop->addr)); BLOCK_NEXT
+	BLOCK_OP(LDY_ZPX) LDY(dGetByte((UBYTE) (bop->addr + X))); BLOCK_NEXT
+	BLOCK_OP(LDY_ABX) addr = bop->addr + X; NCYCLES_X; LDY(dGetByte(addr)); BLOCK_NEXT
+	BLOCK_READ(ORA)
+	BLOCK_READ(AND)
+	BLOCK_READ(EOR)
+	BLOCK_READ(ADC)
+	BLOCK_READ(SBC)
+	BLOCK_READ(CMP)
+	BLOCK_OP(CPX_IMM) CPX(bop->data); BLOCK_NEXT
+	BLOCK_OP(CPX_MEM) CPX(dGetByte(bop->addr)); BLOCK_NEXT
+	BLOCK_OP(CPY_IMM) CPY(bop->data); BLOCK_NEXT
+	BLOCK_OP(CPY_MEM) CPY(dGetByte(bop->addr)); BLOCK_NEXT
+	BLOCK_OP(BIT_MEM)
+		N = dGetByte(bop->addr);
+		V = N & 0x40;
+		Z = (A & N);
+		BLOCK_NEXT
+	BLOCK_OP(ASL_ACC) C = (A & 0x80) ? 1 : 0; Z = N = A <<= 1; BLOCK_NEXT
+	BLOCK_OP(LSR_ACC) C = A & 1; Z = N = A >>= 1; BLOCK_NEXT
+	BLOCK_OP(ROL_ACC) Z = N = (A << 1) + C; C = (A & 0x80) ? 1 : 0; A = Z; BLOCK_NEXT
+	BLOCK_OP(ROR_ACC) Z = N = (C << 7) + (A >> 1); C = A & 1; A = Z; BLOCK_NEXT
+	BLOCK_OP(TAX) Z = N = X = A; BLOCK_NEXT
+	BLOCK_OP(TAY) Z = N = Y = A; BLOCK_NEXT
+	BLOCK_OP(TXA) Z = N = A = X; BLOCK_NEXT
+	BLOCK_OP(TYA) Z = N = A = Y; BLOCK_NEXT
+	BLOCK_OP(TSX) Z = N = X = S; BLOCK_NEXT
+	BLOCK_OP(TXS) S = X; BLOCK_NEXT
+	BLOCK_OP(INX) Z = N = ++X; BLOCK_NEXT
+	BLOCK_OP(INY) Z = N = ++Y; BLOCK_NEXT
+	BLOCK_OP(DEX) Z = N = --X; BLOCK_NEXT
+	BLOCK_OP(DEY) Z = N = --Y; BLOCK_NEXT
+	BLOCK_OP(CLC) C = 0; BLOCK_NEXT
+	BLOCK_OP(SEC) C = 1; BLOCK_NEXT
+	BLOCK_OP(CLV) V = 0; BLOCK_NEXT
+	BLOCK_OP(SEI) SetI; BLOCK_NEXT
+	BLOCK_OP(CLD) ClrD; BLOCK_NEXT
+	BLOCK_OP(SED) SetD; BLOCK_NEXT
+	BLOCK_OP(NOP) BLOCK_NEXT
+	BLOCK_OP(PLA) Z = N = A = PL; BLOCK_NEXT
+
+	BLOCK_OP(STA_MEM) dPutByte(bop->addr, A); BLOCK_NEXT
+	BLOCK_OP(STA_ZPX) dPutByte((UBYTE) (bop->addr + X), A); BLOCK_NEXT
+	BLOCK_OP(STA_ABX) dPutByte((UWORD) (bop->addr + X), A); BLOCK_NEXT
+	BLOCK_OP(STA_ABY) dPutByte((UWORD) (bop->addr + Y), A); BLOCK_NEXT
+	BLOCK_OP(STX_MEM) dPutByte(bop->addr, X); BLOCK_NEXT
+	BLOCK_OP(STX_ZPY) dPutByte((UBYTE) (bop->addr + Y), X); BLOCK_NEXT
+	BLOCK_OP(STY_MEM) dPutByte(bop->addr, Y); BLOCK_NEXT
+	BLOCK_OP(STY_ZPX) dPutByte((UBYTE) (bop->addr + X), Y); BLOCK_NEXT
+	BLOCK_RMW(ASL, data = dGetByte(addr); C = (data & 0x80) ? 1 : 0; Z = N = data << 1; dPutByte(addr, Z))
+	BLOCK_RMW(LSR, data = dGetByte(addr); C = data & 1; Z = data >> 1; N = 0; dPutByte(addr, Z))
+	BLOCK_RMW(ROL, data = dGetByte(addr); Z = N = (data << 1) + C; C = (data & 0x80) ? 1 : 0; dPutByte(addr, Z))
+	BLOCK_RMW(ROR, data = dGetByte(addr); Z = N = (C << 7) + (data >> 1); C = data & 1; dPutByte(addr, Z))
+	BLOCK_RMW(INC, Z = N = dGetByte(addr) + 1; dPutByte(addr, Z))
+	BLOCK_RMW(DEC, Z = N = dGetByte(addr) - 1; dPutByte(addr, Z))
+	BLOCK_OP(PHA) PH(A); BLOCK_NEXT
+	BLOCK_OP(PHP) PHPB1; BLOCK_NEXT
+
+	BLOCK_OP(BPL) if (!(N & 0x80)) goto block_taken; BLOCK_NEXT
+	BLOCK_OP(BMI) if (N & 0x80) goto block_taken; BLOCK_NEXT
+	BLOCK_OP(BVC) if (!V) goto block_taken; BLOCK_NEXT
+	BLOCK_OP(BVS) if (V) goto block_taken; BLOCK_NEXT
+	BLOCK_OP(BCC) if (!C) goto block_taken; BLOCK_NEXT
+	BLOCK_OP(BCS) if (C) goto block_taken; BLOCK_NEXT
+	BLOCK_OP(BNE) if (Z) goto block_taken; BLOCK_NEXT
+	BLOCK_OP(BEQ) if (!Z) goto block_taken; BLOCK_NEXT
+	BLOCK_OP(JMP) goto block_jump;
+	BLOCK_OP(JSR)
+		{
+			UWORD retaddr = block->next - 1;
+			PHW(retaddr);
+		}
+		goto block_jump;
+	BLOCK_OP(RTS)
+		data = PL;
+		SET_PC((PL << 8) + data + 1);
+		if (rts_handler != NULL) {
+			rts_handler();
+			rts_handler = NULL;
+		}
+		goto block_lookup;
+
+#ifdef NO_GOTO
+		}
+#endif
+
+	block_taken:
+		xpos += bop->data;
+	block_jump:
+		SET_PC(bop->addr);
+		if (bop->addr != block->pc)
+			goto block_lookup;
+		if (block->flags & BLOCK_WAIT) {
+			/* A loop that doesn't write to memory: if a time round left
+			   the registers and flags as it found them, so will all the
+			   others until xpos_limit, which are skipped - their cycles
+			   and instructions only counted. regP can't tell, it only
+			   takes constants in a block. */
+			ULONG regs = WAIT_REGS;
+			ULONG flags = WAIT_FLAGS;
+			if (wait_block == block && regs == wait_regs && flags == wait_flags
+			 && xpos + block->span <= xpos_limit) {
+				int per = xpos - wait_xpos;
+				int n = (xpos_limit - block->span - xpos) / per + 1;
+				xpos += n * per;
+#ifdef CPU_INSN_COUNT
+				cpu_instructions += n * block->insns;
+#endif
+			}
+			wait_block = block;
+			wait_regs = regs;
+			wait_flags = flags;
+			wait_xpos = xpos;
+		}
+		goto block_loop;
+
+	block_out:
+		;
+#endif /* CPU_BLOCKS */
+
+#ifndef NO_GOTO
 	next:
 #endif
 
@@ -2302,10 +2830,6 @@ void CPU_Initialise(void)
 
 void CPU_Reset(void)
 {
-#ifdef MONITOR_PROFILE
-	memset(instruction_count, 0, sizeof(instruction_count));
-#endif
-
 	IRQ = 0;
 
 	regP = 0x34;				/* The unused bit is always 1, I flag set! */
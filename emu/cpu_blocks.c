@@ -0,0 +1,231 @@
+/*
+ * cpu_blocks.c - pre-decoded blocks of 6502 code
+ *
+ * This file is part of the a5200 port of the Atari800 emulator.
+ * See cpu_blocks.h for the interface to GO().
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atari.h"
+#include "cpu.h"
+#include "cpu_blocks.h"
+#include "memory.h"
+
+#ifdef CPU_BLOCKS
+
+/* Decoding
+
+   A decoded block is a block as CPU_BlockInsn() finds it (see the
+   blocks in cpu.itcm.c), cut short before the first instruction not
+   handled here: the official instructions on the registers, the stack
+   and memory without readmap/writemap, and as the last one a branch,
+   JMP abcd, JSR or RTS. Each becomes a BLOCKS_Op with its operand
+   fetched, its addressing mode part of the operation, and for a branch
+   the target and the cycles it takes when taken.
+
+   GO() looks for a block after every instruction the interpreter runs,
+   so a block can start anywhere, e.g. right after a hardware access
+   that ended the one before. Blocks shorter than BLOCKS_MIN cost more
+   than interpreting them and are left to the interpreter, unless they
+   loop. A block with SED ends with it, so that the ADC and SBC of a
+   block always see the D flag it had at the start. */
+
+#define BLOCKS_INSNS	24			/* longest block */
+#define BLOCKS_MIN		2			/* shortest block that doesn't loop */
+#define BLOCKS_SIZE		(256 << 10)	/* decoded blocks, flushed when full */
+
+/* operations of the opcodes, BOP_END for the ones left to the interpreter */
+static const UBYTE block_op[256] =
+{
+	BOP_END, BOP_END, BOP_END, BOP_END, BOP_END, BOP_ORA_MEM, BOP_ASL_MEM, BOP_END,	/* 00 */
+	BOP_PHP, BOP_ORA_IMM, BOP_ASL_ACC, BOP_END, BOP_END, BOP_ORA_MEM, BOP_ASL_MEM, BOP_END,	/* 08 */
+	BOP_BPL, BOP_END, BOP_END, BOP_END, BOP_END, BOP_ORA_ZPX, BOP_ASL_ZPX, BOP_END,	/* 10 */
+	BOP_CLC, BOP_ORA_ABY, BOP_END, BOP_END, BOP_END, BOP_ORA_ABX, BOP_ASL_ABX, BOP_END,	/* 18 */
+	BOP_JSR, BOP_END, BOP_END, BOP_END, BOP_BIT_MEM, BOP_AND_MEM, BOP_ROL_MEM, BOP_END,	/* 20 */
+	BOP_END, BOP_AND_IMM, BOP_ROL_ACC, BOP_END, BOP_BIT_MEM, BOP_AND_MEM, BOP_ROL_MEM, BOP_END,	/* 28 */
+	BOP_BMI, BOP_END, BOP_END, BOP_END, BOP_END, BOP_AND_ZPX, BOP_ROL_ZPX, BOP_END,	/* 30 */
+	BOP_SEC, BOP_AND_ABY, BOP_END, BOP_END, BOP_END, BOP_AND_ABX, BOP_ROL_ABX, BOP_END,	/* 38 */
+	BOP_END, BOP_END, BOP_END, BOP_END, BOP_END, BOP_EOR_MEM, BOP_LSR_MEM, BOP_END,	/* 40 */
+	BOP_PHA, BOP_EOR_IMM, BOP_LSR_ACC, BOP_END, BOP_JMP, BOP_EOR_MEM, BOP_LSR_MEM, BOP_END,	/* 48 */
+	BOP_BVC, BOP_END, BOP_END, BOP_END, BOP_END, BOP_EOR_ZPX, BOP_LSR_ZPX, BOP_END,	/* 50 */
+	BOP_END, BOP_EOR_ABY, BOP_END, BOP_END, BOP_END, BOP_EOR_ABX, BOP_LSR_ABX, BOP_END,	/* 58 */
+	BOP_RTS, BOP_END, BOP_END, BOP_END, BOP_END, BOP_ADC_MEM, BOP_ROR_MEM, BOP_END,	/* 60 */
+	BOP_PLA, BOP_ADC_IMM, BOP_ROR_ACC, BOP_END, BOP_END, BOP_ADC_MEM, BOP_ROR_MEM, BOP_END,	/* 68 */
+	BOP_BVS, BOP_END, BOP_END, BOP_END, BOP_END, BOP_ADC_ZPX, BOP_ROR_ZPX, BOP_END,	/* 70 */
+	BOP_SEI, BOP_ADC_ABY, BOP_END, BOP_END, BOP_END, BOP_ADC_ABX, BOP_ROR_ABX, BOP_END,	/* 78 */
+	BOP_END, BOP_END, BOP_END, BOP_END, BOP_STY_MEM, BOP_STA_MEM, BOP_STX_MEM, BOP_END,	/* 80 */
+	BOP_DEY, BOP_END, BOP_TXA, BOP_END, BOP_STY_MEM, BOP_STA_MEM, BOP_STX_MEM, BOP_END,	/* 88 */
+	BOP_BCC, BOP_END, BOP_END, BOP_END, BOP_STY_ZPX, BOP_STA_ZPX, BOP_STX_ZPY, BOP_END,	/* 90 */
+	BOP_TYA, BOP_STA_ABY, BOP_TXS, BOP_END, BOP_END, BOP_STA_ABX, BOP_END, BOP_END,	/* 98 */
+	BOP_LDY_IMM, BOP_END, BOP_LDX_IMM, BOP_END, BOP_LDY_MEM, BOP_LDA_MEM, BOP_LDX_MEM, BOP_END,	/* a0 */
+	BOP_TAY, BOP_LDA_IMM, BOP_TAX, BOP_END, BOP_LDY_MEM, BOP_LDA_MEM, BOP_LDX_MEM, BOP_END,	/* a8 */
+	BOP_BCS, BOP_END, BOP_END, BOP_END, BOP_LDY_ZPX, BOP_LDA_ZPX, BOP_LDX_ZPY, BOP_END,	/* b0 */
+	BOP_CLV, BOP_LDA_ABY, BOP_TSX, BOP_END, BOP_LDY_ABX, BOP_LDA_ABX, BOP_LDX_ABY, BOP_END,	/* b8 */
+	BOP_CPY_IMM, BOP_END, BOP_END, BOP_END, BOP_CPY_MEM, BOP_CMP_MEM, BOP_DEC_MEM, BOP_END,	/* c0 */
+	BOP_INY, BOP_CMP_IMM, BOP_DEX, BOP_END, BOP_CPY_MEM, BOP_CMP_MEM, BOP_DEC_MEM, BOP_END,	/* c8 */
+	BOP_BNE, BOP_END, BOP_END, BOP_END, BOP_END, BOP_CMP_ZPX, BOP_DEC_ZPX, BOP_END,	/* d0 */
+	BOP_CLD, BOP_CMP_ABY, BOP_END, BOP_END, BOP_END, BOP_CMP_ABX, BOP_DEC_ABX, BOP_END,	/* d8 */
+	BOP_CPX_IMM, BOP_END, BOP_END, BOP_END, BOP_CPX_MEM, BOP_SBC_MEM, BOP_INC_MEM, BOP_END,	/* e0 */
+	BOP_INX, BOP_SBC_IMM, BOP_NOP, BOP_END, BOP_CPX_MEM, BOP_SBC_MEM, BOP_INC_MEM, BOP_END,	/* e8 */
+	BOP_BEQ, BOP_END, BOP_END, BOP_END, BOP_END, BOP_SBC_ZPX, BOP_INC_ZPX, BOP_END,	/* f0 */
+	BOP_SED, BOP_SBC_ABY, BOP_END, BOP_END, BOP_END, BOP_SBC_ABX, BOP_INC_ABX, BOP_END	/* f8 */
+};
+
+EMU_TLS int cpu_blocks = FALSE;
+EMU_TLS const BLOCKS_Block **block_cache = NULL;
+static EMU_TLS UBYTE *block_buf = NULL;		/* the decoded blocks */
+static EMU_TLS UBYTE *block_ptr;			/* next free byte in it */
+
+/* Pages
+
+   BLOCKS_Invalidate() only clears the pages of block_cache[] that have
+   something in them, found in a bitmap, so a bank switch into a window
+   without code costs next to nothing. The blocks dropped stay in
+   block_buf until it fills up and starts over. */
+static EMU_TLS ULONG block_used[256 / 32];	/* pages with entries */
+
+#define SET_PAGE_USED(page)	(block_used[(page) >> 5] |= 1U << ((page) & 31))
+
+static void flush(void)
+{
+	memset(block_cache, 0, 0x10000 * sizeof(const BLOCKS_Block *));
+	memset(block_used, 0, sizeof(block_used));
+	block_ptr = block_buf;
+}
+
+static void drop_page(int page)
+{
+	memset(block_cache + (page << 8), 0, 0x100 * sizeof(const BLOCKS_Block *));
+	block_used[page >> 5] &= ~(1U << (page & 31));
+}
+
+const BLOCKS_Block *BLOCKS_Decode(UWORD pc)
+{
+	BLOCKS_Op ops[BLOCKS_INSNS];
+	BLOCKS_Block *block;
+	size_t size;
+	UWORD addr = pc;
+	int insns = 0;
+	int ncycles = 0;
+	int flags = 0;
+	int jumps = FALSE;
+	int writes = FALSE;
+
+	SET_PAGE_USED(pc >> 8);
+	while (insns < BLOCKS_INSNS) {
+		int len, last;
+		int n = CPU_BlockInsn(addr, &len, &last);
+		UBYTE op = block_op[dGetByte(addr)];
+		BLOCKS_Op *o = &ops[insns];
+		/* a hardware access or an instruction the interpreter handles is
+		   left for it */
+		if (n == 0 || op == BOP_END || (last && op < BOP_BPL))
+			break;
+		o->op = op;
+		o->data = len > 1 ? dGetByte(addr + 1) : 0;
+		o->addr = len > 2 ? dGetWord(addr + 1) : o->data;
+		insns++;
+		ncycles += n;
+		addr += len;
+		if ((op >= BOP_ADC_IMM && op <= BOP_ADC_ABY) || (op >= BOP_SBC_IMM && op <= BOP_SBC_ABY))
+			flags |= BLOCK_DECIMAL;
+		if (op >= BOP_BPL) {
+			if (op < BOP_JMP) {
+				/* as BRANCH() counts it */
+				UWORD target = addr + (SBYTE) o->data;
+				o->data = ((target ^ addr) & 0xff00) ? 2 : 1;
+				o->addr = target;
+			}
+			jumps = op != BOP_RTS;
+			break;
+		}
+		if (op >= BOP_STA_MEM)
+			writes = TRUE;
+		if (op == BOP_SED)
+			break;
+	}
+	if (insns == 0)
+		return block_cache[pc] = BLOCKS_NONE;
+	if (jumps && ops[insns - 1].addr == pc) {
+		/* JSR writes the return address */
+		if (!writes && ops[insns - 1].op != BOP_JSR)
+			flags |= BLOCK_WAIT;
+	}
+	else if (insns < BLOCKS_MIN)
+		return block_cache[pc] = BLOCKS_NONE;
+
+	size = offsetof(BLOCKS_Block, ops) + (insns + 1) * sizeof(BLOCKS_Op);
+	if (block_ptr + size > block_buf + BLOCKS_SIZE) {
+		flush();
+		SET_PAGE_USED(pc >> 8);
+	}
+	block = (BLOCKS_Block *) block_ptr;
+	block_ptr += size;
+
+	block->pc = pc;
+	block->next = addr;
+	block->insns = (UBYTE) insns;
+	block->cycles = (UBYTE) ncycles;
+	block->span = (UBYTE) (ncycles + insns);
+	block->flags = (UBYTE) flags;
+	memcpy(block->ops, ops, insns * sizeof(BLOCKS_Op));
+	block->ops[insns].op = BOP_END;
+	block->ops[insns].data = 0;
+	block->ops[insns].addr = addr;
+	return block_cache[pc] = block;
+}
+
+void BLOCKS_Invalidate(UWORD from, UWORD to)
+{
+	int page;
+
+	if (block_cache == NULL)
+		return;
+	if (from == 0 && to == 0xffff) {
+		/* the memory map changed, start over */
+		flush();
+		return;
+	}
+	/* a block starting before from may run into it */
+	page = from - BLOCKS_INSNS * 3;
+	if (page < 0)
+		page = 0;
+	for (page >>= 8; page <= to >> 8; page++) {
+		ULONG word = block_used[page >> 5] >> (page & 31);
+		if (word == 0)
+			page |= 31;		/* none in the rest of the 32 */
+		else if (word & 1)
+			drop_page(page);
+	}
+}
+
+int BLOCKS_Enable(int enable)
+{
+	if (enable && block_buf == NULL) {
+		block_cache = (const BLOCKS_Block **) calloc(0x10000, sizeof(const BLOCKS_Block *));
+		block_buf = (UBYTE *) malloc(BLOCKS_SIZE);
+		if (block_cache == NULL || block_buf == NULL) {
+			free(block_cache);
+			free(block_buf);
+			block_cache = NULL;
+			block_buf = NULL;
+			return FALSE;
+		}
+		block_ptr = block_buf;
+		memset(block_used, 0, sizeof(block_used));
+	}
+	else if (!enable && block_buf != NULL) {
+		free(block_cache);
+		free(block_buf);
+		block_cache = NULL;
+		block_buf = NULL;
+	}
+	cpu_blocks = enable;
+	return TRUE;
+}
+
+#endif /* CPU_BLOCKS */
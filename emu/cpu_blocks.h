@@ -0,0 +1,94 @@
+#ifndef _CPU_BLOCKS_H_
+#define _CPU_BLOCKS_H_
+
+#include "atari.h"
+
+/* Pre-decoded 6502 blocks, compiled in with CPU_BLOCKS (make BLOCKS=1)
+   and switched on for each machine with BLOCKS_Enable(). Portable C:
+   the engine for hosts without the JIT, e.g. the MIPS handhelds.
+
+   A block is decoded once from ROM into the operations below, each with
+   its operand already fetched, and GO() runs it with a single xpos_limit
+   check, adding the base cycles of all its instructions at once (see
+   the blocks in cpu.itcm.c). */
+
+/* operations, by addressing mode: IMM immediate, MEM zero page or
+   absolute, ZPX/ZPY zero page indexed, ABX/ABY absolute indexed */
+enum {
+	BOP_END,				/* falls through to the next block */
+
+	BOP_LDA_IMM, BOP_LDA_MEM, BOP_LDA_ZPX, BOP_LDA_ABX, BOP_LDA_ABY,
+	BOP_LDX_IMM, BOP_LDX_MEM, BOP_LDX_ZPY, BOP_LDX_ABY,
+	BOP_LDY_IMM, BOP_LDY_MEM, BOP_LDY_ZPX, BOP_LDY_ABX,
+	BOP_ORA_IMM, BOP_ORA_MEM, BOP_ORA_ZPX, BOP_ORA_ABX, BOP_ORA_ABY,
+	BOP_AND_IMM, BOP_AND_MEM, BOP_AND_ZPX, BOP_AND_ABX, BOP_AND_ABY,
+	BOP_EOR_IMM, BOP_EOR_MEM, BOP_EOR_ZPX, BOP_EOR_ABX, BOP_EOR_ABY,
+	BOP_ADC_IMM, BOP_ADC_MEM, BOP_ADC_ZPX, BOP_ADC_ABX, BOP_ADC_ABY,
+	BOP_SBC_IMM, BOP_SBC_MEM, BOP_SBC_ZPX, BOP_SBC_ABX, BOP_SBC_ABY,
+	BOP_CMP_IMM, BOP_CMP_MEM, BOP_CMP_ZPX, BOP_CMP_ABX, BOP_CMP_ABY,
+	BOP_CPX_IMM, BOP_CPX_MEM,
+	BOP_CPY_IMM, BOP_CPY_MEM,
+	BOP_BIT_MEM,
+	BOP_ASL_ACC, BOP_LSR_ACC, BOP_ROL_ACC, BOP_ROR_ACC,
+	BOP_TAX, BOP_TAY, BOP_TXA, BOP_TYA, BOP_TSX, BOP_TXS,
+	BOP_INX, BOP_INY, BOP_DEX, BOP_DEY,
+	BOP_CLC, BOP_SEC, BOP_CLV, BOP_SEI, BOP_CLD, BOP_SED, BOP_NOP,
+	BOP_PLA,
+
+	/* from here on they write to memory */
+	BOP_STA_MEM, BOP_STA_ZPX, BOP_STA_ABX, BOP_STA_ABY,
+	BOP_STX_MEM, BOP_STX_ZPY,
+	BOP_STY_MEM, BOP_STY_ZPX,
+	BOP_ASL_MEM, BOP_ASL_ZPX, BOP_ASL_ABX,
+	BOP_LSR_MEM, BOP_LSR_ZPX, BOP_LSR_ABX,
+	BOP_ROL_MEM, BOP_ROL_ZPX, BOP_ROL_ABX,
+	BOP_ROR_MEM, BOP_ROR_ZPX, BOP_ROR_ABX,
+	BOP_INC_MEM, BOP_INC_ZPX, BOP_INC_ABX,
+	BOP_DEC_MEM, BOP_DEC_ZPX, BOP_DEC_ABX,
+	BOP_PHA, BOP_PHP,
+
+	/* the last operation of a block, if it jumps */
+	BOP_BPL, BOP_BMI, BOP_BVC, BOP_BVS, BOP_BCC, BOP_BCS, BOP_BNE, BOP_BEQ,
+	BOP_JMP, BOP_JSR, BOP_RTS,
+
+	BOP_OPS
+};
+
+typedef struct {
+	UBYTE op;				/* BOP_* */
+	UBYTE data;				/* immediate operand; a branch: its extra cycles when taken */
+	UWORD addr;				/* operand address, or where a branch or jump goes */
+} BLOCKS_Op;
+
+/* BLOCKS_Block flags */
+#define BLOCK_DECIMAL	0x01	/* has ADC or SBC: not run with the D flag set */
+#define BLOCK_WAIT		0x02	/* jumps back to its start and doesn't write to memory */
+
+typedef struct {
+	UWORD pc;				/* first instruction */
+	UWORD next;				/* the one after the last */
+	UBYTE insns;			/* instructions */
+	UBYTE cycles;			/* their base cycles */
+	UBYTE span;				/* cycles + insns: xpos may be that far below xpos_limit */
+	UBYTE flags;
+	BLOCKS_Op ops[1];		/* one for each instruction, then BOP_END */
+} BLOCKS_Block;
+
+/* block_cache[] entry for code that isn't run as a block */
+#define BLOCKS_NONE ((const BLOCKS_Block *) 1)
+
+/* decoded blocks by start address, NULL if not decoded yet */
+extern EMU_TLS const BLOCKS_Block **block_cache;
+/* set while the blocks are switched on */
+extern EMU_TLS int cpu_blocks;
+
+/* Switches the blocks on or off for the machine of the calling thread.
+   Returns FALSE if there's no memory for them. */
+int BLOCKS_Enable(int enable);
+/* Called when GO() gets to a pc without a block: decodes the block
+   starting there, returns BLOCKS_NONE if it's too short to pay. */
+const BLOCKS_Block *BLOCKS_Decode(UWORD pc);
+/* Drops the blocks that may run into from..to (ROM_CHANGED() in memory.h). */
+void BLOCKS_Invalidate(UWORD from, UWORD to);
+
+#endif /* _CPU_BLOCKS_H_ */
@@ -0,0 +1,934 @@
+/*
+ * cpu_jit.c - translation of hot 6502 code to x86-64 code
+ *
+ * This file is part of the a5200 port of the Atari800 emulator.
+ * See cpu_jit.h for the interface to GO().
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atari.h"
+#include "cpu.h"
+#include "cpu_jit.h"
+#include "memory.h"
+
+#ifdef CPU_JIT
+
+#ifndef __x86_64__
+#error CPU_JIT generates x86-64 code
+#endif
+
+#include <sys/mman.h>
+
+/* Translation
+
+   A translated block is a block as CPU_BlockInsn() decodes it (see the
+   blocks in cpu.itcm.c), cut short before the first instruction
+   not handled here. Handled are the official instructions that work on
+   the registers, the stack, and memory without readmap/writemap - so a
+   block never reaches the hardware - and the conditional branches and
+   JMP abcd. A branch forward goes on with the next instruction; taken,
+   it skips to a later instruction of the block, or leaves the block if
+   it goes past the end. The other branches and JMP end the block. A
+   branch or jump back to the start of the block loops in the native
+   code, checking xpos_limit again each time round, so wait and delay
+   loops don't come back to GO() at all. Everything else (JSR/RTS,
+   interrupts, hardware registers, code in RAM) is left to the
+   interpreter, and so are blocks too short to pay for going in and out
+   of the native code, unless they loop.
+
+   Cycles are counted as GO() counts them: the base cycles of the block
+   at once, then the page crossing and branch cycles where they happen;
+   a branch taken forward takes back the base cycles of the instructions
+   it skips.
+   The flags are computed exactly as the interpreter computes them, down
+   to the values it keeps in N, Z and V, so both can take turns freely.
+
+   The code gets the JIT_Context in rdi and the 6502 memory in rsi. It
+   loads the registers, flags, xpos and the instruction count into x86
+   registers (see below) when it starts and stores them back when it
+   leaves, so the loops run without touching the context. */
+
+#define JIT_CODE_SIZE	(1 << 20)	/* code buffer, flushed when full */
+#define JIT_BLOCK_MAX	4096		/* more than the longest translation */
+#define JIT_BLOCK_INSNS	32			/* longest block */
+#define JIT_BLOCK_MIN	6			/* shortest block that doesn't loop */
+#define JIT_HOT			8			/* interpreter starts before translating */
+#define JIT_BACKOFF_MAX	5			/* JIT_HOT << 5 is past the counters */
+
+/* jit_insn[] operations */
+enum {
+	ORA = 1, AND, EOR, ADC, SBC, CMP, CPX, CPY, BIT,
+	LDA, LDX, LDY, STA, STX, STY,
+	ASL, LSR, ROL, ROR, INC, DEC,
+	TAX, TAY, TXA, TYA, TSX, TXS, INX, INY, DEX, DEY,
+	CLC, SEC, CLV, SEI, NOP, PHA, PLA,
+	BPL, BMI, BVC, BVS, BCC, BCS, BNE, BEQ, JMP
+};
+
+/* jit_insn[] addressing modes */
+enum { IMP, ACC, IMM, ZP, ZPX, ZPY, ABS, ABX, ABY, REL };
+
+#define J(op, mode)		((op) << 4 | (mode))
+#define JIT_OP(j)		((j) >> 4)
+#define JIT_MODE(j)		((j) & 0x0f)
+
+/* translated instructions, 0 for the others */
+static const UWORD jit_insn[256] =
+{
+	0, 0, 0, 0, 0, J(ORA, ZP), J(ASL, ZP), 0,	/* 00 */
+	0, J(ORA, IMM), J(ASL, ACC), 0, 0, J(ORA, ABS), J(ASL, ABS), 0,	/* 08 */
+	J(BPL, REL), 0, 0, 0, 0, J(ORA, ZPX), J(ASL, ZPX), 0,	/* 10 */
+	J(CLC, IMP), J(ORA, ABY), 0, 0, 0, J(ORA, ABX), J(ASL, ABX), 0,	/* 18 */
+	0, 0, 0, 0, J(BIT, ZP), J(AND, ZP), J(ROL, ZP), 0,	/* 20 */
+	0, J(AND, IMM), J(ROL, ACC), 0, J(BIT, ABS), J(AND, ABS), J(ROL, ABS), 0,	/* 28 */
+	J(BMI, REL), 0, 0, 0, 0, J(AND, ZPX), J(ROL, ZPX), 0,	/* 30 */
+	J(SEC, IMP), J(AND, ABY), 0, 0, 0, J(AND, ABX), J(ROL, ABX), 0,	/* 38 */
+	0, 0, 0, 0, 0, J(EOR, ZP), J(LSR, ZP), 0,	/* 40 */
+	J(PHA, IMP), J(EOR, IMM), J(LSR, ACC), 0, J(JMP, ABS), J(EOR, ABS), J(LSR, ABS), 0,	/* 48 */
+	J(BVC, REL), 0, 0, 0, 0, J(EOR, ZPX), J(LSR, ZPX), 0,	/* 50 */
+	0, J(EOR, ABY), 0, 0, 0, J(EOR, ABX), J(LSR, ABX), 0,	/* 58 */
+	0, 0, 0, 0, 0, J(ADC, ZP), J(ROR, ZP), 0,	/* 60 */
+	J(PLA, IMP), J(ADC, IMM), J(ROR, ACC), 0, 0, J(ADC, ABS), J(ROR, ABS), 0,	/* 68 */
+	J(BVS, REL), 0, 0, 0, 0, J(ADC, ZPX), J(ROR, ZPX), 0,	/* 70 */
+	J(SEI, IMP), J(ADC, ABY), 0, 0, 0, J(ADC, ABX), J(ROR, ABX), 0,	/* 78 */
+	0, 0, 0, 0, J(STY, ZP), J(STA, ZP), J(STX, ZP), 0,	/* 80 */
+	J(DEY, IMP), 0, J(TXA, IMP), 0, J(STY, ABS), J(STA, ABS), J(STX, ABS), 0,	/* 88 */
+	J(BCC, REL), 0, 0, 0, J(STY, ZPX), J(STA, ZPX), J(STX, ZPY), 0,	/* 90 */
+	J(TYA, IMP), J(STA, ABY), J(TXS, IMP), 0, 0, J(STA, ABX), 0, 0,	/* 98 */
+	J(LDY, IMM), 0, J(LDX, IMM), 0, J(LDY, ZP), J(LDA, ZP), J(LDX, ZP), 0,	/* a0 */
+	J(TAY, IMP), J(LDA, IMM), J(TAX, IMP), 0, J(LDY, ABS), J(LDA, ABS), J(LDX, ABS), 0,	/* a8 */
+	J(BCS, REL), 0, 0, 0, J(LDY, ZPX), J(LDA, ZPX), J(LDX, ZPY), 0,	/* b0 */
+	J(CLV, IMP), J(LDA, ABY), J(TSX, IMP), 0, J(LDY, ABX), J(LDA, ABX), J(LDX, ABY), 0,	/* b8 */
+	J(CPY, IMM), 0, 0, 0, J(CPY, ZP), J(CMP, ZP), J(DEC, ZP), 0,	/* c0 */
+	J(INY, IMP), J(CMP, IMM), J(DEX, IMP), 0, J(CPY, ABS), J(CMP, ABS), J(DEC, ABS), 0,	/* c8 */
+	J(BNE, REL), 0, 0, 0, 0, J(CMP, ZPX), J(DEC, ZPX), 0,	/* d0 */
+	0, J(CMP, ABY), 0, 0, 0, J(CMP, ABX), J(DEC, ABX), 0,	/* d8 */
+	J(CPX, IMM), 0, 0, 0, J(CPX, ZP), J(SBC, ZP), J(INC, ZP), 0,	/* e0 */
+	J(INX, IMP), J(SBC, IMM), J(NOP, IMP), 0, J(CPX, ABS), J(SBC, ABS), J(INC, ABS), 0,	/* e8 */
+	J(BEQ, REL), 0, 0, 0, 0, J(SBC, ZPX), J(INC, ZPX), 0,	/* f0 */
+	0, J(SBC, ABY), 0, 0, 0, J(SBC, ABX), J(INC, ABX), 0	/* f8 */
+};
+
+#undef J
+
+EMU_TLS int cpu_jit = FALSE;
+EMU_TLS JIT_Block *jit_blocks = NULL;
+static EMU_TLS UBYTE *jit_hot = NULL;		/* interpreter starts by address */
+static EMU_TLS UBYTE *jit_code = NULL;		/* code buffer */
+static EMU_TLS UBYTE *jit_ptr;				/* next free byte in it */
+static EMU_TLS int jit_live;				/* translated blocks in it */
+
+/* Pages
+
+   JIT_Invalidate() only clears the pages that have something in
+   jit_blocks[] or jit_hot[], found in a bitmap, so a bank switch into a
+   window without code costs next to nothing. Each time a page is cleared
+   that had blocks, its code is taken to be changing (bank switching) and
+   has to be twice as hot before it is translated again. */
+typedef struct {
+	UBYTE backoff;		/* the page's threshold is JIT_HOT << backoff */
+	UWORD blocks;		/* translated blocks */
+} jit_page_t;
+
+static EMU_TLS jit_page_t *jit_pages = NULL;	/* by address >> 8 */
+static EMU_TLS ULONG jit_used[256 / 32];		/* pages with entries */
+
+#define SET_PAGE_USED(page)	(jit_used[(page) >> 5] |= 1U << ((page) & 31))
+
+/* x86 registers */
+#define EAX		0
+#define ECX		1
+#define EDX		2			/* address of the indexed modes */
+#define EBX		3
+#define EBP		5
+#define ESI		6			/* 6502 memory */
+#define EDI		7			/* JIT_Context */
+#define R11		11
+#define NO_INDEX	(-1)
+
+/* where the 6502 registers are kept, always zero-extended bytes */
+#define RA		8
+#define RX		9
+#define RY		10
+#define RS		R11
+#define RN		EBX
+#define RZ		EBP
+#define RC		12
+#define RV		13
+#define RXPOS	14
+#define RINSNS	15
+
+#define CTX(field)	((int) offsetof(JIT_Context, field))
+
+/* condition codes */
+#define CC_B	0x2
+#define CC_AE	0x3
+#define CC_E	0x4
+#define CC_NE	0x5
+#define CC_A	0x7
+#define CC_LE	0xe
+#define CC_G	0xf
+
+/* opcodes of the 01/09/21/29/31/39/85/89 group and /digit of 81/83 */
+#define ADD_	0x01
+#define OR_		0x09
+#define AND_	0x21
+#define SUB_	0x29
+#define XOR_	0x31
+#define CMP_	0x39
+#define TEST_	0x85
+#define MOV_	0x89
+#define ADD_I	0
+#define AND_I	4
+#define CMP_I	7
+
+#define B(x)	(*jit_ptr++ = (UBYTE) (x))
+
+/* spl, bpl, sil and dil need a REX prefix, ah to bh don't */
+#define REX8(r)	((r) >= 4 && (r) < 8)
+
+static void emit32(unsigned int value)
+{
+	B(value);
+	B(value >> 8);
+	B(value >> 16);
+	B(value >> 24);
+}
+
+/* reserves the rel32 of a jump, set with patch() */
+static UBYTE *emit_fixup(void)
+{
+	UBYTE *fixup = jit_ptr;
+	emit32(0);
+	return fixup;
+}
+
+static void patch(UBYTE *fixup, const UBYTE *target)
+{
+	int rel = (int) (target - (fixup + 4));
+	memcpy(fixup, &rel, 4);
+}
+
+static void rex(int reg, int index, int rm, int byte)
+{
+	int bits = (reg & 8) >> 1 | (index >= 0 ? (index & 8) >> 2 : 0) | (rm & 8) >> 3;
+	if (bits != 0 || byte)
+		B(0x40 | bits);
+}
+
+static void modrm_rr(int reg, int rm)
+{
+	B(0xc0 | (reg & 7) << 3 | (rm & 7));
+}
+
+/* [base + index + disp], with disp8 for the context */
+static void modrm_mem(int reg, int base, int index, int disp)
+{
+	if (index >= 0) {
+		B((disp != 0 ? 0x80 : 0x00) | (reg & 7) << 3 | 4);
+		B((index & 7) << 3 | (base & 7));
+		if (disp != 0)
+			emit32(disp);
+	}
+	else if (base == EDI) {
+		B(0x40 | (reg & 7) << 3 | 7);
+		B(disp);
+	}
+	else {
+		B(0x80 | (reg & 7) << 3 | (base & 7));
+		emit32(disp);
+	}
+}
+
+/* op rm, reg (32-bit) */
+static void op_rr(int op, int rm, int reg)
+{
+	rex(reg, NO_INDEX, rm, FALSE);
+	B(op);
+	modrm_rr(reg, rm);
+}
+
+/* op rm, imm (32-bit, 81/83 /digit) */
+static void op_ri(int digit, int rm, int imm)
+{
+	rex(0, NO_INDEX, rm, FALSE);
+	if (imm >= -128 && imm < 128) {
+		B(0x83);
+		modrm_rr(digit, rm);
+		B(imm);
+	}
+	else {
+		B(0x81);
+		modrm_rr(digit, rm);
+		emit32(imm);
+	}
+}
+
+/* one operand groups: FE (8-bit), FF, F7, D1 /digit */
+static void op_r(int op, int digit, int rm)
+{
+	rex(0, NO_INDEX, rm, op == 0xfe && REX8(rm));
+	B(op);
+	modrm_rr(digit, rm);
+}
+
+/* shl (4) or shr (5) rm, count */
+static void shift_ri(int digit, int rm, int count)
+{
+	rex(0, NO_INDEX, rm, FALSE);
+	B(0xc1);
+	modrm_rr(digit, rm);
+	B(count);
+}
+
+/* movzx dst, src8 */
+static void movzx_rr(int dst, int src)
+{
+	rex(dst, NO_INDEX, src, REX8(src));
+	B(0x0f); B(0xb6);
+	modrm_rr(dst, src);
+}
+
+/* setcc rm8: the upper bits of rm must be zero already */
+static void setcc_r(int cc, int rm)
+{
+	rex(0, NO_INDEX, rm, REX8(rm));
+	B(0x0f); B(0x90 | cc);
+	modrm_rr(0, rm);
+}
+
+/* movzx dst, byte [base + index + disp] */
+static void load8(int dst, int base, int index, int disp)
+{
+	rex(dst, index, base, FALSE);
+	B(0x0f); B(0xb6);
+	modrm_mem(dst, base, index, disp);
+}
+
+/* mov byte [base + index + disp], src8 */
+static void store8(int src, int base, int index, int disp)
+{
+	rex(src, index, base, REX8(src));
+	B(0x88);
+	modrm_mem(src, base, index, disp);
+}
+
+/* mov dword between a register and the context */
+static void load32_ctx(int dst, int field)
+{
+	rex(dst, NO_INDEX, EDI, FALSE);
+	B(0x8b);
+	modrm_mem(dst, EDI, NO_INDEX, field);
+}
+
+static void store32_ctx(int src, int field)
+{
+	rex(src, NO_INDEX, EDI, FALSE);
+	B(0x89);
+	modrm_mem(src, EDI, NO_INDEX, field);
+}
+
+/* Z = N = reg */
+static void set_nz(int reg)
+{
+	op_rr(MOV_, RN, reg);
+	op_rr(MOV_, RZ, reg);
+}
+
+/* Puts the address of the indexed modes in edx, adding the page crossing
+   cycle if page_cycle is set. Returns the index register of the operand,
+   [rsi + rdx] or [rsi + addr] for NO_INDEX. */
+static int emit_ea(int mode, UWORD addr, int page_cycle)
+{
+	switch (mode) {
+	case ZPX:
+	case ZPY:
+		op_rr(MOV_, EDX, mode == ZPX ? RX : RY);
+		B(0x80); B(0xc2); B(addr);					/* add dl, zp */
+		return EDX;
+	case ABX:
+	case ABY:
+		op_rr(MOV_, EDX, mode == ABX ? RX : RY);
+		if (page_cycle && (addr & 0xff) != 0) {
+			op_ri(CMP_I, EDX, 0xff - (addr & 0xff));
+			B(0x76); B(3);							/* jbe +3 */
+			op_r(0xff, 0, RXPOS);					/* inc xpos */
+		}
+		op_ri(ADD_I, EDX, addr);
+		B(0x0f); B(0xb7); B(0xd2);					/* movzx edx, dx */
+		return EDX;
+	default:
+		return NO_INDEX;
+	}
+}
+
+#define EA_DISP(index, addr)	((index) == NO_INDEX ? (addr) : 0)
+
+/* loads the operand of a read into ecx */
+static void emit_read(int mode, UWORD addr)
+{
+	int index;
+
+	if (mode == IMM) {
+		B(0xb9); emit32(addr);						/* mov ecx, #ab */
+		return;
+	}
+	index = emit_ea(mode, addr, TRUE);
+	load8(ECX, ESI, index, EA_DISP(index, addr));
+}
+
+/* Compares xpos + block_cycles with xpos_limit: with one extra cycle
+   per instruction, all the instructions of the block start before
+   xpos_limit if it's not greater (see the blocks in cpu.itcm.c).
+   Returns the fixup of the jump taken on cc. */
+static UBYTE *emit_limit_check(int xpos, int block_cycles, int cc)
+{
+	if (xpos == EAX)
+		load32_ctx(EAX, CTX(xpos));
+	else
+		op_rr(MOV_, EAX, xpos);
+	B(0x05); emit32(block_cycles);					/* add eax, cycles */
+	B(0x3b);										/* cmp eax, [rdi+xpos_limit] */
+	modrm_mem(EAX, EDI, NO_INDEX, CTX(xpos_limit));
+	B(0x0f); B(0x80 | cc);							/* jcc */
+	return emit_fixup();
+}
+
+#define BLOCK_EXITS	(JIT_BLOCK_INSNS + 1)
+
+/* a block being translated */
+typedef struct {
+	UWORD pc;
+	int cycles;					/* base cycles plus one per instruction */
+	int insns;
+	const UWORD *addrs;			/* of its instructions */
+	const UBYTE *insn_cycles;	/* their base cycles */
+	int i;						/* the one being translated */
+	UBYTE *forward[JIT_BLOCK_INSNS];	/* branches to later instructions */
+	int forward_to[JIT_BLOCK_INSNS];
+	int nforward;
+	const UBYTE *body;			/* where its instructions start */
+	UBYTE *exits[BLOCK_EXITS];	/* jumps to the epilogue */
+	int nexits;
+} block_t;
+
+/* leaves the block, continuing at pc */
+static void emit_exit(block_t *block, UWORD pc)
+{
+	B(0x66); B(0xc7); B(0x47); B(CTX(pc)); B(pc); B(pc >> 8);	/* mov word [rdi+pc], pc */
+	B(0xe9);										/* jmp epilogue */
+	block->exits[block->nexits++] = emit_fixup();
+}
+
+/* continues at target, looping if it's the start of the block */
+static void emit_goto(block_t *block, UWORD target)
+{
+	if (target == block->pc)
+		patch(emit_limit_check(RXPOS, block->cycles, CC_LE), block->body);
+	/* not looping, or the next round would pass xpos_limit */
+	emit_exit(block, target);
+}
+
+/* Translates the instruction at addr and returns the address after it.
+   A branch or jump ends the code of the block itself. */
+static UWORD emit_insn(block_t *block, UWORD addr)
+{
+	UWORD j = jit_insn[dGetByte(addr)];
+	int op = JIT_OP(j);
+	int mode = JIT_MODE(j);
+	UWORD operand = dGetByte(addr + 1);
+	int index = NO_INDEX;
+	int reg;
+
+	if (mode >= ABS && mode <= ABY)
+		operand += dGetByte(addr + 2) << 8;
+
+	switch (op) {
+	case ORA:
+	case AND:
+	case EOR:
+		emit_read(mode, operand);
+		op_rr(op == ORA ? OR_ : op == AND ? AND_ : XOR_, RA, ECX);
+		set_nz(RA);
+		break;
+	case ADC:
+		/* tmp = A + data + C; C = tmp > 0xff;
+		   V = !((A ^ data) & 0x80) && ((data ^ tmp) & 0x80) */
+		emit_read(mode, operand);
+		op_rr(MOV_, EDX, RC);
+		op_rr(ADD_, EDX, RA);
+		op_rr(ADD_, EDX, ECX);
+		op_ri(CMP_I, EDX, 0xff);
+		setcc_r(CC_A, RC);
+		op_rr(MOV_, EAX, RA);
+		op_rr(XOR_, EAX, ECX);
+		op_rr(XOR_, ECX, EDX);
+		op_r(0xf7, 2, EAX);							/* not eax */
+		op_rr(AND_, EAX, ECX);
+		op_rr(XOR_, RV, RV);						/* before the test: xor sets ZF */
+		B(0xa9); emit32(0x80);						/* test eax, 0x80 */
+		setcc_r(CC_NE, RV);
+		movzx_rr(RA, EDX);
+		set_nz(RA);
+		break;
+	case SBC:
+		/* tmp = A - data - 1 + C; C = tmp < 0x100;
+		   V = ((A ^ tmp) & 0x80) && ((A ^ data) & 0x80) */
+		emit_read(mode, operand);
+		op_rr(MOV_, EDX, RC);
+		op_rr(ADD_, EDX, RA);
+		op_rr(SUB_, EDX, ECX);
+		op_r(0xff, 1, EDX);							/* dec edx */
+		op_ri(CMP_I, EDX, 0x100);
+		setcc_r(CC_B, RC);
+		op_rr(XOR_, ECX, RA);
+		op_rr(MOV_, EAX, RA);
+		op_rr(XOR_, EAX, EDX);
+		op_rr(AND_, EAX, ECX);
+		op_rr(XOR_, RV, RV);						/* before the test: xor sets ZF */
+		B(0xa9); emit32(0x80);						/* test eax, 0x80 */
+		setcc_r(CC_NE, RV);
+		movzx_rr(RA, EDX);
+		set_nz(RA);
+		break;
+	case CMP:
+	case CPX:
+	case CPY:
+		emit_read(mode, operand);
+		reg = op == CMP ? RA : op == CPX ? RX : RY;
+		op_rr(MOV_, EDX, reg);
+		op_rr(SUB_, EDX, ECX);
+		movzx_rr(EDX, EDX);
+		set_nz(EDX);
+		op_rr(CMP_, reg, ECX);
+		setcc_r(CC_AE, RC);
+		break;
+	case BIT:
+		emit_read(mode, operand);
+		op_rr(MOV_, RN, ECX);
+		op_rr(MOV_, RV, ECX);
+		op_ri(AND_I, RV, 0x40);
+		op_rr(MOV_, RZ, RA);
+		op_rr(AND_, RZ, ECX);
+		break;
+	case LDA:
+	case LDX:
+	case LDY:
+		emit_read(mode, operand);
+		reg = op == LDA ? RA : op == LDX ? RX : RY;
+		op_rr(MOV_, reg, ECX);
+		set_nz(reg);
+		break;
+	case STA:
+	case STX:
+	case STY:
+		index = emit_ea(mode, operand, FALSE);
+		store8(op == STA ? RA : op == STX ? RX : RY, ESI, index, EA_DISP(index, operand));
+		break;
+	case ASL:
+	case LSR:
+	case ROL:
+	case ROR:
+	case INC:
+	case DEC:
+		if (mode == ACC)
+			op_rr(MOV_, EAX, RA);
+		else {
+			index = emit_ea(mode, operand, FALSE);
+			load8(EAX, ESI, index, EA_DISP(index, operand));
+		}
+		switch (op) {
+		case ROL:
+			op_rr(ADD_, EAX, EAX);
+			op_rr(ADD_, EAX, RC);
+			op_rr(MOV_, RC, EAX);
+			shift_ri(5, RC, 8);
+			movzx_rr(EAX, EAX);
+			break;
+		case ASL:
+			op_rr(ADD_, EAX, EAX);
+			op_rr(MOV_, RC, EAX);
+			shift_ri(5, RC, 8);
+			movzx_rr(EAX, EAX);
+			break;
+		case ROR:
+			op_rr(MOV_, ECX, RC);
+			shift_ri(4, ECX, 8);
+			op_rr(OR_, EAX, ECX);
+			/* fall through */
+		case LSR:
+			op_rr(MOV_, RC, EAX);
+			op_ri(AND_I, RC, 1);
+			op_r(0xd1, 5, EAX);						/* shr eax, 1 */
+			break;
+		case INC:
+			op_r(0xfe, 0, EAX);						/* inc al */
+			break;
+		case DEC:
+			op_r(0xfe, 1, EAX);						/* dec al */
+			break;
+		}
+		if (mode == ACC)
+			op_rr(MOV_, RA, EAX);
+		else
+			store8(EAX, ESI, index, EA_DISP(index, operand));
+		if (op == LSR && mode != ACC) {
+			/* LSR ab: Z = data >> 1; N = 0 */
+			op_rr(MOV_, RZ, EAX);
+			op_rr(XOR_, RN, RN);
+		}
+		else
+			set_nz(EAX);
+		break;
+	case TAX:
+		op_rr(MOV_, RX, RA);
+		set_nz(RX);
+		break;
+	case TAY:
+		op_rr(MOV_, RY, RA);
+		set_nz(RY);
+		break;
+	case TXA:
+		op_rr(MOV_, RA, RX);
+		set_nz(RA);
+		break;
+	case TYA:
+		op_rr(MOV_, RA, RY);
+		set_nz(RA);
+		break;
+	case TSX:
+		op_rr(MOV_, RX, RS);
+		set_nz(RX);
+		break;
+	case TXS:
+		op_rr(MOV_, RS, RX);
+		break;
+	case INX:
+	case INY:
+	case DEX:
+	case DEY:
+		reg = op == INX || op == DEX ? RX : RY;
+		op_r(0xfe, op == INX || op == INY ? 0 : 1, reg);	/* inc/dec reg8 */
+		set_nz(reg);
+		break;
+	case CLC:
+		op_rr(XOR_, RC, RC);
+		break;
+	case SEC:
+		op_rr(XOR_, RC, RC);
+		op_r(0xff, 0, RC);							/* inc */
+		break;
+	case CLV:
+		op_rr(XOR_, RV, RV);
+		break;
+	case SEI:
+		B(0x80); B(0x4f); B(CTX(P)); B(I_FLAG);		/* or byte [rdi+P], I_FLAG */
+		break;
+	case NOP:
+		break;
+	case PHA:
+		store8(RA, ESI, RS, 0x100);
+		op_r(0xfe, 1, RS);							/* dec S */
+		break;
+	case PLA:
+		op_r(0xfe, 0, RS);							/* inc S */
+		load8(RA, ESI, RS, 0x100);
+		set_nz(RA);
+		break;
+	case JMP:
+		emit_goto(block, operand);
+		break;
+	default: {
+		/* conditional branches: leave for the next instruction unless taken */
+		static const UBYTE flag[] = { RN, RN, RV, RV, RC, RC, RZ, RZ };
+		static const UBYTE skip[] = { CC_NE, CC_E, CC_NE, CC_E, CC_NE, CC_E, CC_E, CC_NE };
+		int b = op - BPL;
+		UWORD next = addr + 2;
+		UWORD target = next + (SBYTE) dGetByte(addr + 1);
+		/* taken: one more cycle, two if to another page */
+		int taken = (target ^ next) & 0xff00 ? 2 : 1;
+		UBYTE *fixup;
+
+		if (flag[b] == RN) {
+			B(0xf6); B(0xc3); B(0x80);				/* test bl, 0x80 */
+		}
+		else
+			op_rr(TEST_, flag[b], flag[b]);
+		B(0x0f); B(0x80 | skip[b]);
+		fixup = emit_fixup();
+		if (block->i + 1 < block->insns) {
+			/* forward, in the middle of the block: to the instruction
+			   at target, or out of the block, skipping the ones before */
+			int t = block->i + 1;
+			int skipped = 0;
+			while (t < block->insns && block->addrs[t] != target)
+				skipped += block->insn_cycles[t++];
+			if (t == block->i + 1) {
+				/* to the next one: taken it can be two cycles more than
+				   counted for the limit, so out of the block */
+				while (t < block->insns)
+					skipped += block->insn_cycles[t++];
+			}
+			op_ri(ADD_I, RXPOS, taken - skipped);
+			op_ri(ADD_I, RINSNS, block->i + 1 - t);
+			if (t < block->insns) {
+				B(0xe9);								/* jmp insn */
+				block->forward[block->nforward] = emit_fixup();
+				block->forward_to[block->nforward++] = t;
+			}
+			else
+				emit_exit(block, target);
+			patch(fixup, jit_ptr);
+			break;
+		}
+		op_ri(ADD_I, RXPOS, taken);
+		emit_goto(block, target);
+		patch(fixup, jit_ptr);
+		emit_exit(block, next);
+		break;
+	}
+	}
+	return addr + (mode == IMP || mode == ACC ? 1 : mode >= ABS && mode <= ABY ? 3 : 2);
+}
+
+/* callee-saved registers used by the blocks */
+static const UBYTE saved_regs[] = { EBX, EBP, RC, RV, RXPOS, RINSNS };
+
+static void emit_prologue(void)
+{
+	int i;
+
+	for (i = 0; i < (int) sizeof(saved_regs); i++) {
+		rex(0, NO_INDEX, saved_regs[i], FALSE);
+		B(0x50 | (saved_regs[i] & 7));				/* push */
+	}
+	load8(RA, EDI, NO_INDEX, CTX(A));
+	load8(RX, EDI, NO_INDEX, CTX(X));
+	load8(RY, EDI, NO_INDEX, CTX(Y));
+	load8(RS, EDI, NO_INDEX, CTX(S));
+	load8(RN, EDI, NO_INDEX, CTX(N));
+	load8(RZ, EDI, NO_INDEX, CTX(Z));
+	load8(RC, EDI, NO_INDEX, CTX(C));
+	load8(RV, EDI, NO_INDEX, CTX(V));
+	load32_ctx(RXPOS, CTX(xpos));
+	load32_ctx(RINSNS, CTX(insns));
+}
+
+static void emit_epilogue(void)
+{
+	int i;
+
+	store8(RA, EDI, NO_INDEX, CTX(A));
+	store8(RX, EDI, NO_INDEX, CTX(X));
+	store8(RY, EDI, NO_INDEX, CTX(Y));
+	store8(RS, EDI, NO_INDEX, CTX(S));
+	store8(RN, EDI, NO_INDEX, CTX(N));
+	store8(RZ, EDI, NO_INDEX, CTX(Z));
+	store8(RC, EDI, NO_INDEX, CTX(C));
+	store8(RV, EDI, NO_INDEX, CTX(V));
+	store32_ctx(RXPOS, CTX(xpos));
+	store32_ctx(RINSNS, CTX(insns));
+	for (i = (int) sizeof(saved_regs) - 1; i >= 0; i--) {
+		rex(0, NO_INDEX, saved_regs[i], FALSE);
+		B(0x58 | (saved_regs[i] & 7));				/* pop */
+	}
+	B(0xb8); emit32(1);								/* mov eax, 1 */
+	B(0xc3);										/* ret */
+}
+
+/* where the branch or JMP abcd at addr goes when taken */
+static UWORD jump_target(UWORD addr)
+{
+	if (dGetByte(addr) == 0x4c)
+		return dGetWord(addr + 1);
+	return addr + 2 + (SBYTE) dGetByte(addr + 1);
+}
+
+static void flush(void)
+{
+	int page;
+	memset(jit_blocks, 0, 0x10000 * sizeof(JIT_Block));
+	memset(jit_hot, 0, 0x10000);
+	memset(jit_used, 0, sizeof(jit_used));
+	for (page = 0; page < 0x100; page++)
+		jit_pages[page].blocks = 0;
+	jit_ptr = jit_code;
+	jit_live = 0;
+}
+
+static void drop_page(int page)
+{
+	jit_page_t *p = &jit_pages[page];
+	memset(jit_blocks + (page << 8), 0, 0x100 * sizeof(JIT_Block));
+	memset(jit_hot + (page << 8), 0, 0x100);
+	if (p->blocks != 0) {
+		if (p->backoff < JIT_BACKOFF_MAX)
+			p->backoff++;
+		jit_live -= p->blocks;
+		p->blocks = 0;
+	}
+	jit_used[page >> 5] &= ~(1U << (page & 31));
+	/* nothing translated is left: the whole buffer is free again */
+	if (jit_live == 0)
+		jit_ptr = jit_code;
+}
+
+JIT_Block JIT_Compile(UWORD pc)
+{
+	UBYTE *code;
+	UBYTE *not_run[2];
+	int nnot_run = 0;
+	block_t block;
+	UWORD addrs[JIT_BLOCK_INSNS];
+	UBYTE insn_cycles[JIT_BLOCK_INSNS];
+	UWORD addr = pc;
+	int insns = 0;
+	int ncycles = 0;
+	int decimal = FALSE;
+	int jumps = FALSE;
+	int hot = JIT_HOT << jit_pages[pc >> 8].backoff;
+	int i;
+
+	SET_PAGE_USED(pc >> 8);
+	if (jit_hot[pc] < (hot > 0xff ? 0xff : hot)) {
+		jit_hot[pc]++;
+		return JIT_NONE;
+	}
+
+	/* find where the block ends */
+	while (insns < JIT_BLOCK_INSNS) {
+		int len, last;
+		int n = CPU_BlockInsn(addr, &len, &last);
+		UWORD j = jit_insn[dGetByte(addr)];
+		if (n == 0 || j == 0 || (last && JIT_MODE(j) != REL && JIT_OP(j) != JMP))
+			break;
+		addrs[insns] = addr;
+		insn_cycles[insns++] = (UBYTE) n;
+		ncycles += n;
+		if (JIT_OP(j) == ADC || JIT_OP(j) == SBC)
+			decimal = TRUE;
+		/* a block ending with a branch or JMP leaves by itself */
+		jumps = last;
+		if (last && (JIT_OP(j) == JMP || jump_target(addr) <= addr))
+			break;
+		addr += len;
+	}
+	/* going in and out of the native code costs about as much as
+	   interpreting a few instructions: a short block only pays if it
+	   loops */
+	if (insns < JIT_BLOCK_MIN && !(jumps && jump_target(addrs[insns - 1]) == pc))
+		return jit_blocks[pc] = JIT_NONE;
+
+	if (jit_ptr + JIT_BLOCK_MAX > jit_code + JIT_CODE_SIZE) {
+		flush();
+		SET_PAGE_USED(pc >> 8);
+	}
+	code = jit_ptr;
+
+	if (decimal) {
+		B(0xf6); B(0x47); B(CTX(P)); B(D_FLAG);		/* test byte [rdi+P], D_FLAG */
+		B(0x0f); B(0x80 | CC_NE);					/* jnz not_run */
+		not_run[nnot_run++] = emit_fixup();
+	}
+	not_run[nnot_run++] = emit_limit_check(EAX, ncycles + insns, CC_G);
+	emit_prologue();
+
+	block.pc = pc;
+	block.cycles = ncycles + insns;
+	block.body = jit_ptr;
+	block.nexits = 0;
+	block.insns = insns;
+	block.addrs = addrs;
+	block.insn_cycles = insn_cycles;
+	block.nforward = 0;
+	op_ri(ADD_I, RXPOS, ncycles);
+	op_ri(ADD_I, RINSNS, insns);
+	for (block.i = 0; block.i < insns; block.i++) {
+		for (i = 0; i < block.nforward; i++)
+			if (block.forward_to[i] == block.i)
+				patch(block.forward[i], jit_ptr);
+		addr = emit_insn(&block, addrs[block.i]);
+	}
+		emit_exit(&block, addr);
+
+	for (i = 0; i < block.nexits; i++)
+		patch(block.exits[i], jit_ptr);
+	emit_epilogue();
+
+	for (i = 0; i < nnot_run; i++)
+		patch(not_run[i], jit_ptr);
+	B(0x31); B(0xc0);								/* xor eax, eax */
+	B(0xc3);										/* ret */
+
+	jit_pages[pc >> 8].blocks++;
+	jit_live++;
+	return jit_blocks[pc] = (JIT_Block) code;
+}
+
+void JIT_Invalidate(UWORD from, UWORD to)
+{
+	int page;
+
+	if (jit_blocks == NULL)
+		return;
+	if (from == 0 && to == 0xffff) {
+		/* the memory map changed, start over */
+		flush();
+		return;
+	}
+	/* a block starting before from may run into it */
+	page = from - JIT_BLOCK_INSNS * 3;
+	if (page < 0)
+		page = 0;
+	for (page >>= 8; page <= to >> 8; page++) {
+		ULONG word = jit_used[page >> 5] >> (page & 31);
+		if (word == 0)
+			page |= 31;		/* none in the rest of the 32 */
+		else if (word & 1)
+			drop_page(page);
+	}
+}
+
+int JIT_Enable(int enable)
+{
+	if (enable && jit_code == NULL) {
+		void *buf = mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (buf == MAP_FAILED)
+			return FALSE;
+		jit_blocks = (JIT_Block *) calloc(0x10000, sizeof(JIT_Block));
+		jit_hot = (UBYTE *) calloc(0x10000, 1);
+		jit_pages = (jit_page_t *) calloc(0x100, sizeof(jit_page_t));
+		if (jit_blocks == NULL || jit_hot == NULL || jit_pages == NULL) {
+			free(jit_blocks);
+			free(jit_hot);
+			free(jit_pages);
+			jit_blocks = NULL;
+			jit_hot = NULL;
+			jit_pages = NULL;
+			munmap(buf, JIT_CODE_SIZE);
+			return FALSE;
+		}
+		jit_code = jit_ptr = (UBYTE *) buf;
+		jit_live = 0;
+		memset(jit_used, 0, sizeof(jit_used));
+	}
+	else if (!enable && jit_code != NULL) {
+		munmap(jit_code, JIT_CODE_SIZE);
+		free(jit_blocks);
+		free(jit_hot);
+		free(jit_pages);
+		jit_code = NULL;
+		jit_blocks = NULL;
+		jit_hot = NULL;
+		jit_pages = NULL;
+	}
+	cpu_jit = enable;
+	return TRUE;
+}
+
+#endif /* CPU_JIT */
@@ -0,0 +1,47 @@
+#ifndef _CPU_JIT_H_
+#define _CPU_JIT_H_
+
+#include "atari.h"
+
+/* Translation of hot 6502 blocks to x86-64 code, compiled in with CPU_JIT
+   (make JIT=1) and switched on for each machine with JIT_Enable().
+
+   A translated block does what GO() would do with the registers in a
+   JIT_Context and the 6502 memory: it checks that all its instructions
+   would start before xpos_limit, runs them and returns nonzero with pc
+   set to the next instruction. It returns 0 without changing anything
+   if they wouldn't fit, or if the block has an ADC or SBC and the D flag
+   is set; GO() then interprets the code as usual. */
+
+typedef struct {
+	UBYTE A, X, Y, S;
+	UBYTE N, Z, C, V;			/* flags, kept as GO() does */
+	UBYTE P;					/* regP, for the I and D flags */
+	UWORD pc;
+	int xpos;
+	int xpos_limit;
+	unsigned int insns;			/* instructions run */
+} JIT_Context;
+
+typedef int (*JIT_Block)(JIT_Context *ctx, UBYTE *memory);
+
+/* jit_blocks[] entry for code that isn't translated */
+#define JIT_NONE ((JIT_Block) 1)
+
+/* translated blocks by start address, NULL if not translated yet */
+extern EMU_TLS JIT_Block *jit_blocks;
+/* set while the translation is switched on */
+extern EMU_TLS int cpu_jit;
+
+/* Switches the translation on or off for the machine of the calling
+   thread. Returns FALSE if there's no memory for the code. */
+int JIT_Enable(int enable);
+/* Called when GO() gets to an entry point without a translated block - a
+   branch or jump target, a return, an interrupt vector or the end of a
+   block: translates the block once pc is hot, returns JIT_NONE until then
+   and for code that can't be translated. */
+JIT_Block JIT_Compile(UWORD pc);
+/* Drops the blocks that may run into from..to (ROM_CHANGED() in memory.h). */
+void JIT_Invalidate(UWORD from, UWORD to);
+
+#endif /* _CPU_JIT_H_ */
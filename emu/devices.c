@@ -475,44 +475,44 @@ static UBYTE Device_RemoveDirectory(const char *filename)
 static int devbug = FALSE;
 
 /* host path for each H: unit */
-char atari_h_dir[4][FILENAME_MAX] = { "", "", "", "" };
+EMU_TLS char atari_h_dir[4][FILENAME_MAX] = { "", "", "", "" };
 
 /* read only mode for H: device */
-int h_read_only = TRUE;
+EMU_TLS int h_read_only = TRUE;
 
 /* ';'-separated list of Atari paths checked by the "load executable"
    command. if a path does not start with "Hn:", then the selected device
    is used. */
-char h_exe_path[FILENAME_MAX] = DEFAULT_H_PATH;
+EMU_TLS char h_exe_path[FILENAME_MAX] = DEFAULT_H_PATH;
 
 /* h_current_dir must be empty or terminated with DIR_SEP_CHAR;
    only DIR_SEP_CHAR can be used as a directory separator here */
-char h_current_dir[4][FILENAME_MAX];
+EMU_TLS char h_current_dir[4][FILENAME_MAX];
 
 /* stream open via H: device per IOCB */
-static FILE *h_fp[8] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+static EMU_TLS FILE *h_fp[8] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
 
 /* H: text mode per IOCB */
-static int h_textmode[8];
+static EMU_TLS int h_textmode[8];
 
 /* last read character was CR, per IOCB */
-static int h_wascr[8];
+static EMU_TLS int h_wascr[8];
 
 /* last operation: 'o': open, 'r': read, 'w': write, per IOCB */
 /* (this is needed to apply fseek(fp, 0, SEEK_CUR) between reads and writes
    in update (12) mode) */
-static char h_lastop[8];
+static EMU_TLS char h_lastop[8];
 
 Util_tmpbufdef(static, h_tmpbuf[8])
 
 /* IOCB #, 0-7 */
-static int h_iocb;
+static EMU_TLS int h_iocb;
 
 /* H: device number, 0-3 */
-static int h_devnum;
+static EMU_TLS int h_devnum;
 
 /* filename as specified after "Hn:" */
-static char atari_filename[FILENAME_MAX];
+static EMU_TLS char atari_filename[FILENAME_MAX];
 
 #ifdef DO_RENAME
 /* new filename (no directories!) */
@@ -520,10 +520,10 @@ static char new_filename[FILENAME_MAX];
 #endif
 
 /* atari_filename applied to H:'s current dir, with DIR_SEP_CHARs only */
-static char atari_path[FILENAME_MAX];
+static EMU_TLS char atari_path[FILENAME_MAX];
 
 /* full filename for the current operation */
-static char host_path[FILENAME_MAX];
+static EMU_TLS char host_path[FILENAME_MAX];
 
 int Device_H_CountOpen(void)
 {
@@ -1258,9 +1258,9 @@ static void Device_H_Point(void)
 	}
 }
 
-static FILE *binf = NULL;
-static int runBinFile;
-static int initBinFile;
+static EMU_TLS FILE *binf = NULL;
+static EMU_TLS int runBinFile;
+static EMU_TLS int initBinFile;
 
 /* Read a word from file */
 static int Device_H_BinReadWord(void)
@@ -1547,7 +1547,7 @@ static void Device_H_ChangeDirectory(void)
 
 static void Device_H_DiskInfo(void)
 {
-	static UBYTE info[16] = {
+	static EMU_TLS UBYTE info[16] = {
 		0x20,                                                  /* disk version: Sparta >= 2.0 */
 		0x00,                                                  /* sector size: 0x100 */
 		0xff, 0xff,                                            /* total sectors: 0xffff */
@@ -1674,7 +1674,7 @@ static void Device_H_Special(void)
 
 /* P: device emulation --------------------------------------------------- */
 
-char print_command[256] = "lpr %s";
+EMU_TLS char print_command[256] = "lpr %s";
 
 int Device_SetPrintCommand(const char *command)
 {
@@ -1861,10 +1861,10 @@ static void Device_K_Read(void)
 
 /* Atari BASIC loader ---------------------------------------------------- */
 
-static UWORD ehopen_addr = 0;
-static UWORD ehclos_addr = 0;
-static UWORD ehread_addr = 0;
-static UWORD ehwrit_addr = 0;
+static EMU_TLS UWORD ehopen_addr = 0;
+static EMU_TLS UWORD ehclos_addr = 0;
+static EMU_TLS UWORD ehread_addr = 0;
+static EMU_TLS UWORD ehwrit_addr = 0;
 
 static void Device_IgnoreReady(void);
 static void Device_GetBasicCommand(void);
@@ -1916,9 +1916,9 @@ static void Device_InstallIgnoreReady(void)
 
 static const UBYTE * const ready_prompt = (const UBYTE *) "\x9bREADY\x9b";
 
-static const UBYTE *ready_ptr = NULL;
+static EMU_TLS const UBYTE *ready_ptr = NULL;
 
-static const UBYTE *basic_command_ptr = NULL;
+static EMU_TLS const UBYTE *basic_command_ptr = NULL;
 
 static void Device_IgnoreReady(void)
 {
@@ -2111,9 +2111,9 @@ static void Device_CloseBasicFile(void)
 
 /* Patches management ---------------------------------------------------- */
 
-int enable_h_patch = TRUE;
-int enable_p_patch = TRUE;
-int enable_r_patch = FALSE;
+EMU_TLS int enable_h_patch = TRUE;
+EMU_TLS int enable_p_patch = TRUE;
+EMU_TLS int enable_r_patch = FALSE;
 
 /* Device_PatchOS is called by Atari800_PatchOS to modify standard device
    handlers in Atari OS. It puts escape codes at beginnings of OS routines,
@@ -2253,7 +2253,7 @@ void Device_RemoveHATABSEntry(char device, UWORD entry_address,
 	}
 }
 
-static UWORD h_entry_address = 0;
+static EMU_TLS UWORD h_entry_address = 0;
 #ifdef R_IO_DEVICE
 static UWORD r_entry_address = 0;
 #endif
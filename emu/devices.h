@@ -11,22 +11,22 @@ void Device_UpdatePatches(void);
 
 UWORD Device_SkipDeviceName(void);
 
-extern int enable_h_patch;
-extern int enable_p_patch;
-extern int enable_r_patch;
+extern EMU_TLS int enable_h_patch;
+extern EMU_TLS int enable_p_patch;
+extern EMU_TLS int enable_r_patch;
 
-extern char atari_h_dir[4][FILENAME_MAX];
-extern int h_read_only;
+extern EMU_TLS char atari_h_dir[4][FILENAME_MAX];
+extern EMU_TLS int h_read_only;
 
 #define DEFAULT_H_PATH  "H1:>DOS;>DOS"
-extern char h_exe_path[FILENAME_MAX];
+extern EMU_TLS char h_exe_path[FILENAME_MAX];
 
-char h_current_dir[4][FILENAME_MAX];
+extern EMU_TLS char h_current_dir[4][FILENAME_MAX];
 
 int Device_H_CountOpen(void);
 void Device_H_CloseAll(void);
 
-extern char print_command[256];
+extern EMU_TLS char print_command[256];
 
 int Device_SetPrintCommand(const char *command);
 
@@ -36,54 +36,54 @@
 
 /* GTIA Registers ---------------------------------------------------------- */
 
-UBYTE M0PL;
-UBYTE M1PL;
-UBYTE M2PL;
-UBYTE M3PL;
-UBYTE P0PL;
-UBYTE P1PL;
-UBYTE P2PL;
-UBYTE P3PL;
-UBYTE HPOSP0;
-UBYTE HPOSP1;
-UBYTE HPOSP2;
-UBYTE HPOSP3;
-UBYTE HPOSM0;
-UBYTE HPOSM1;
-UBYTE HPOSM2;
-UBYTE HPOSM3;
-UBYTE SIZEP0;
-UBYTE SIZEP1;
-UBYTE SIZEP2;
-UBYTE SIZEP3;
-UBYTE SIZEM;
-UBYTE GRAFP0;
-UBYTE GRAFP1;
-UBYTE GRAFP2;
-UBYTE GRAFP3;
-UBYTE GRAFM;
-UBYTE COLPM0;
-UBYTE COLPM1;
-UBYTE COLPM2;
-UBYTE COLPM3;
-UBYTE COLPF0;
-UBYTE COLPF1;
-UBYTE COLPF2;
-UBYTE COLPF3;
-UBYTE COLBK;
-UBYTE PRIOR;
-UBYTE VDELAY;
-UBYTE GRACTL;
-UBYTE POTENA;
+EMU_TLS UBYTE M0PL;
+EMU_TLS UBYTE M1PL;
+EMU_TLS UBYTE M2PL;
+EMU_TLS UBYTE M3PL;
+EMU_TLS UBYTE P0PL;
+EMU_TLS UBYTE P1PL;
+EMU_TLS UBYTE P2PL;
+EMU_TLS UBYTE P3PL;
+EMU_TLS UBYTE HPOSP0;
+EMU_TLS UBYTE HPOSP1;
+EMU_TLS UBYTE HPOSP2;
+EMU_TLS UBYTE HPOSP3;
+EMU_TLS UBYTE HPOSM0;
+EMU_TLS UBYTE HPOSM1;
+EMU_TLS UBYTE HPOSM2;
+EMU_TLS UBYTE HPOSM3;
+EMU_TLS UBYTE SIZEP0;
+EMU_TLS UBYTE SIZEP1;
+EMU_TLS UBYTE SIZEP2;
+EMU_TLS UBYTE SIZEP3;
+EMU_TLS UBYTE SIZEM;
+EMU_TLS UBYTE GRAFP0;
+EMU_TLS UBYTE GRAFP1;
+EMU_TLS UBYTE GRAFP2;
+EMU_TLS UBYTE GRAFP3;
+EMU_TLS UBYTE GRAFM;
+EMU_TLS UBYTE COLPM0;
+EMU_TLS UBYTE COLPM1;
+EMU_TLS UBYTE COLPM2;
+EMU_TLS UBYTE COLPM3;
+EMU_TLS UBYTE COLPF0;
+EMU_TLS UBYTE COLPF1;
+EMU_TLS UBYTE COLPF2;
+EMU_TLS UBYTE COLPF3;
+EMU_TLS UBYTE COLBK;
+EMU_TLS UBYTE PRIOR;
+EMU_TLS UBYTE VDELAY;
+EMU_TLS UBYTE GRACTL;
+EMU_TLS UBYTE POTENA;
 
 /* Internal GTIA state ----------------------------------------------------- */
 
-int atari_speaker;
-int consol_index = 0;
-UBYTE consol_table[3];
-UBYTE consol_mask;
-UBYTE TRIG[4];
-UBYTE TRIG_latch[4];
+EMU_TLS int atari_speaker;
+EMU_TLS int consol_index = 0;
+EMU_TLS UBYTE consol_table[3];
+EMU_TLS UBYTE consol_mask;
+EMU_TLS UBYTE TRIG[4];
+EMU_TLS UBYTE TRIG_latch[4];
 
 #if defined(BASIC) || defined(CURSES_BASIC)
 
@@ -103,10 +103,10 @@ void set_prior(UBYTE byte);			/* in antic.c */
 /* Player/Missile stuff ---------------------------------------------------- */
 
 /* change to 0x00 to disable collisions */
-UBYTE collisions_mask_missile_playfield = 0x0f;
-UBYTE collisions_mask_player_playfield = 0x0f;
-UBYTE collisions_mask_missile_player = 0x0f;
-UBYTE collisions_mask_player_player = 0x0f;
+EMU_TLS UBYTE collisions_mask_missile_playfield = 0x0f;
+EMU_TLS UBYTE collisions_mask_player_playfield = 0x0f;
+EMU_TLS UBYTE collisions_mask_missile_player = 0x0f;
+EMU_TLS UBYTE collisions_mask_player_player = 0x0f;
 
 #ifdef NEW_CYCLE_EXACT
 /* temporary collision registers for the current scanline only */
@@ -136,20 +136,20 @@ int hitclr_pos;
 #define M3PL_T M3PL
 #endif /* NEW_CYCLE_EXACT */
 
-extern UBYTE player_dma_enabled;
-extern UBYTE missile_dma_enabled;
-extern UBYTE player_gra_enabled;
-extern UBYTE missile_gra_enabled;
-extern UBYTE player_flickering;
-extern UBYTE missile_flickering;
+extern EMU_TLS UBYTE player_dma_enabled;
+extern EMU_TLS UBYTE missile_dma_enabled;
+extern EMU_TLS UBYTE player_gra_enabled;
+extern EMU_TLS UBYTE missile_gra_enabled;
+extern EMU_TLS UBYTE player_flickering;
+extern EMU_TLS UBYTE missile_flickering;
 
-static UBYTE *hposp_ptr[4];
-static UBYTE *hposm_ptr[4];
-static ULONG hposp_mask[4];
+static EMU_TLS UBYTE *hposp_ptr[4];
+static EMU_TLS UBYTE *hposm_ptr[4];
+static EMU_TLS ULONG hposp_mask[4];
 
-static ULONG grafp_lookup[4][256];
-static ULONG *grafp_ptr[4];
-static int global_sizem[4];
+static EMU_TLS ULONG grafp_lookup[4][256];
+static EMU_TLS ULONG *grafp_ptr[4];
+static EMU_TLS int global_sizem[4];
 
 static const UBYTE PM_Width[4] = {1, 2, 1, 4};
 
@@ -164,8 +164,8 @@ bit 6 - Missile 2
 bit 7 - Missile 3
 */
 
-UBYTE pm_scanline[ATARI_WIDTH / 2 + 8];	/* there's a byte for every *pair* of pixels */
-UBYTE pm_dirty = TRUE;
+EMU_TLS UBYTE pm_scanline[ATARI_WIDTH / 2 + 8];	/* there's a byte for every *pair* of pixels */
+EMU_TLS UBYTE pm_dirty = TRUE;
 
 #define C_PM0	0x01
 #define C_PM1	0x02
@@ -188,7 +188,7 @@ UBYTE pm_dirty = TRUE;
 #define C_PF2	0x60
 #define C_PF3	0x70
 
-extern UWORD cl_lookup[128];
+extern EMU_TLS UWORD cl_lookup[128];
 
 #define PF0PM (*(UBYTE *) &cl_lookup[C_PF0 | C_COLLS])
 #define PF1PM (*(UBYTE *) &cl_lookup[C_PF1 | C_COLLS])
@@ -200,11 +200,11 @@ extern UWORD cl_lookup[128];
 #ifdef USE_COLOUR_TRANSLATION_TABLE
 UWORD colour_translation_table[256];
 #else
-extern UWORD hires_lookup_l[128];
+extern EMU_TLS UWORD hires_lookup_l[128];
 #endif /* USE_COLOUR_TRANSLATION_TABLE */
 
-extern ULONG lookup_gtia9[16];
-extern ULONG lookup_gtia11[16];
+extern EMU_TLS ULONG lookup_gtia9[16];
+extern EMU_TLS ULONG lookup_gtia11[16];
 
 void setup_gtia9_11(void) {
 	int i;
@@ -340,18 +340,76 @@ void update_pmpl_colls(void)
 
 #if !defined(BASIC) && !defined(CURSES_BASIC)
 
+#ifndef NEW_CYCLE_EXACT
+/* Most lines draw the same players and missiles as the line before: the
+   graphics come from the same DMA bytes and positions and sizes change a
+   few times per frame at most. new_pm_scanline() keeps the last line in
+   pm_scanline while the GRAFPx and GRAFM values are those it was built
+   from and no HPOSx, SIZEx write came in between (pm_changed), and only
+   adds the collisions that line made again. A rebuild clears just the
+   span the previous line drew. (With NEW_CYCLE_EXACT the line is also
+   redrawn in the middle by GTIA_PutByte(), so it is rebuilt each time.) */
+static EMU_TLS UBYTE pm_changed = TRUE;
+static EMU_TLS ULONG pm_last_grafp;
+static EMU_TLS UBYTE pm_last_grafm;
+/* P1PL..P3PL, M0PL..M3PL bits set by the line in pm_scanline */
+static EMU_TLS UBYTE pm_colls[7];
+/* pm_scanline + pm_left .. pm_scanline + pm_right may be non-zero */
+static EMU_TLS int pm_left;
+static EMU_TLS int pm_right = ATARI_WIDTH / 2;
+#endif
+
 void new_pm_scanline(void)
 {
 #ifdef NEW_CYCLE_EXACT
 /* reset temporary pm->pl collisions */
 	P1PL_T = P2PL_T = P3PL_T = 0;
 	M0PL_T = M1PL_T = M2PL_T = M3PL_T = 0;
-#endif /* NEW_CYCLE_EXACT */
 /* Clear if necessary */
 	if (pm_dirty) {
 		memset(pm_scanline, 0, ATARI_WIDTH / 2);
 		pm_dirty = FALSE;
 	}
+#define PM_SPAN(l, r)
+#else
+	UBYTE colls[7];
+	ULONG grafp = GRAFP0 | (GRAFP1 << 8) | (GRAFP2 << 16) | ((ULONG) GRAFP3 << 24);
+	if (!pm_changed && grafp == pm_last_grafp && GRAFM == pm_last_grafm) {
+		if (pm_dirty) {
+			P1PL |= pm_colls[0];
+			P2PL |= pm_colls[1];
+			P3PL |= pm_colls[2];
+			M0PL |= pm_colls[3];
+			M1PL |= pm_colls[4];
+			M2PL |= pm_colls[5];
+			M3PL |= pm_colls[6];
+		}
+		return;
+	}
+	pm_changed = FALSE;
+	pm_last_grafp = grafp;
+	pm_last_grafm = GRAFM;
+	if (pm_dirty) {
+		if (pm_left < 0)
+			pm_left = 0;
+		if (pm_right > ATARI_WIDTH / 2)
+			pm_right = ATARI_WIDTH / 2;
+		if (pm_right > pm_left)
+			memset(pm_scanline + pm_left, 0, pm_right - pm_left);
+		pm_dirty = FALSE;
+	}
+	pm_left = ATARI_WIDTH / 2;
+	pm_right = 0;
+#define PM_SPAN(l, r) \
+	if ((l) - pm_scanline < pm_left)	\
+		pm_left = (l) - pm_scanline;	\
+	if ((r) - pm_scanline > pm_right)	\
+		pm_right = (r) - pm_scanline;
+	/* collect this line's collisions on their own for pm_colls */
+	colls[0] = P1PL; colls[1] = P2PL; colls[2] = P3PL;
+	colls[3] = M0PL; colls[4] = M1PL; colls[5] = M2PL; colls[6] = M3PL;
+	P1PL = P2PL = P3PL = M0PL = M1PL = M2PL = M3PL = 0;
+#endif /* NEW_CYCLE_EXACT */
 
 /* Draw Players */
 
@@ -366,6 +424,7 @@ void new_pm_scanline(void)
 			ptr++;											\
 			grafp >>= 1;									\
 		} while (grafp);									\
+		PM_SPAN(hposp_ptr[n], ptr)							\
 	}														\
 }
 
@@ -381,6 +440,7 @@ void new_pm_scanline(void)
 				ptr++;
 				grafp >>= 1;
 			} while (grafp);
+			PM_SPAN(hposp_ptr[0], ptr)
 		}
 	}
 
@@ -405,10 +465,12 @@ void new_pm_scanline(void)
 	}												\
 	else if (ptr + j > pm_scanline + ATARI_WIDTH / 2 - 2)	\
 		j = pm_scanline + ATARI_WIDTH / 2 - 2 - ptr;		\
-	if (j > 0)										\
+	if (j > 0) {									\
+		PM_SPAN(ptr, ptr + j)						\
 		do											\
 			M##n##PL_T |= *ptr++ |= p;				\
 		while (--j);								\
+	}												\
 }
 
 	if (GRAFM) {
@@ -418,6 +480,13 @@ void new_pm_scanline(void)
 		DO_MISSILE(1, 0x20, 0x0c, 0x08, 0x04)
 		DO_MISSILE(0, 0x10, 0x03, 0x02, 0x01)
 	}
+
+#ifndef NEW_CYCLE_EXACT
+	pm_colls[0] = P1PL; pm_colls[1] = P2PL; pm_colls[2] = P3PL;
+	pm_colls[3] = M0PL; pm_colls[4] = M1PL; pm_colls[5] = M2PL; pm_colls[6] = M3PL;
+	P1PL |= colls[0]; P2PL |= colls[1]; P3PL |= colls[2];
+	M0PL |= colls[3]; M1PL |= colls[4]; M2PL |= colls[5]; M3PL |= colls[6];
+#endif
 }
 
 #endif /* !defined(BASIC) && !defined(CURSES_BASIC) */
@@ -565,7 +634,8 @@ void GTIA_PutByte(UWORD addr, UBYTE byte)
 	}
 #define UPDATE_PM_CYCLE_EXACT if(DRAWING_SCREEN) new_pm_scanline();
 #else
-#define UPDATE_PM_CYCLE_EXACT
+/* the next line's players and missiles differ from the last one */
+#define UPDATE_PM_CYCLE_EXACT pm_changed = TRUE;
 #endif
 
 #endif /* !defined(BASIC) && !defined(CURSES_BASIC) */
@@ -1073,7 +1143,7 @@ void GTIA_PutByte(UWORD addr, UBYTE byte)
 		GRAFP##n = save_graf;\
 	}
 #else
-#define CYCLE_EXACT_HPOSP(n)
+#define CYCLE_EXACT_HPOSP(n) UPDATE_PM_CYCLE_EXACT
 #endif /* NEW_CYCLE_EXACT */
 #define DO_HPOSP(n)	case _HPOSP##n:								\
 	hposp_ptr[n] = pm_scanline + byte - 0x20;					\
@@ -57,45 +57,45 @@
 #define _HITCLR 0x1e
 #define _CONSOL 0x1f
 
-extern UBYTE GRAFM;
-extern UBYTE GRAFP0;
-extern UBYTE GRAFP1;
-extern UBYTE GRAFP2;
-extern UBYTE GRAFP3;
-extern UBYTE HPOSP0;
-extern UBYTE HPOSP1;
-extern UBYTE HPOSP2;
-extern UBYTE HPOSP3;
-extern UBYTE HPOSM0;
-extern UBYTE HPOSM1;
-extern UBYTE HPOSM2;
-extern UBYTE HPOSM3;
-extern UBYTE SIZEP0;
-extern UBYTE SIZEP1;
-extern UBYTE SIZEP2;
-extern UBYTE SIZEP3;
-extern UBYTE SIZEM;
-extern UBYTE COLPM0;
-extern UBYTE COLPM1;
-extern UBYTE COLPM2;
-extern UBYTE COLPM3;
-extern UBYTE COLPF0;
-extern UBYTE COLPF1;
-extern UBYTE COLPF2;
-extern UBYTE COLPF3;
-extern UBYTE COLBK;
-extern UBYTE GRACTL;
-extern UBYTE M0PL;
-extern UBYTE M1PL;
-extern UBYTE M2PL;
-extern UBYTE M3PL;
-extern UBYTE P0PL;
-extern UBYTE P1PL;
-extern UBYTE P2PL;
-extern UBYTE P3PL;
-extern UBYTE PRIOR;
-extern UBYTE VDELAY;
-extern UBYTE POTENA;
+extern EMU_TLS UBYTE GRAFM;
+extern EMU_TLS UBYTE GRAFP0;
+extern EMU_TLS UBYTE GRAFP1;
+extern EMU_TLS UBYTE GRAFP2;
+extern EMU_TLS UBYTE GRAFP3;
+extern EMU_TLS UBYTE HPOSP0;
+extern EMU_TLS UBYTE HPOSP1;
+extern EMU_TLS UBYTE HPOSP2;
+extern EMU_TLS UBYTE HPOSP3;
+extern EMU_TLS UBYTE HPOSM0;
+extern EMU_TLS UBYTE HPOSM1;
+extern EMU_TLS UBYTE HPOSM2;
+extern EMU_TLS UBYTE HPOSM3;
+extern EMU_TLS UBYTE SIZEP0;
+extern EMU_TLS UBYTE SIZEP1;
+extern EMU_TLS UBYTE SIZEP2;
+extern EMU_TLS UBYTE SIZEP3;
+extern EMU_TLS UBYTE SIZEM;
+extern EMU_TLS UBYTE COLPM0;
+extern EMU_TLS UBYTE COLPM1;
+extern EMU_TLS UBYTE COLPM2;
+extern EMU_TLS UBYTE COLPM3;
+extern EMU_TLS UBYTE COLPF0;
+extern EMU_TLS UBYTE COLPF1;
+extern EMU_TLS UBYTE COLPF2;
+extern EMU_TLS UBYTE COLPF3;
+extern EMU_TLS UBYTE COLBK;
+extern EMU_TLS UBYTE GRACTL;
+extern EMU_TLS UBYTE M0PL;
+extern EMU_TLS UBYTE M1PL;
+extern EMU_TLS UBYTE M2PL;
+extern EMU_TLS UBYTE M3PL;
+extern EMU_TLS UBYTE P0PL;
+extern EMU_TLS UBYTE P1PL;
+extern EMU_TLS UBYTE P2PL;
+extern EMU_TLS UBYTE P3PL;
+extern EMU_TLS UBYTE PRIOR;
+extern EMU_TLS UBYTE VDELAY;
+extern EMU_TLS UBYTE POTENA;
 
 #ifdef USE_COLOUR_TRANSLATION_TABLE
 
@@ -110,16 +110,16 @@ extern UWORD colour_translation_table[256];
 
 #endif /* USE_COLOUR_TRANSLATION_TABLE */
 
-extern UBYTE collisions_mask_missile_playfield;
-extern UBYTE collisions_mask_player_playfield;
-extern UBYTE collisions_mask_missile_player;
-extern UBYTE collisions_mask_player_player;
+extern EMU_TLS UBYTE collisions_mask_missile_playfield;
+extern EMU_TLS UBYTE collisions_mask_player_playfield;
+extern EMU_TLS UBYTE collisions_mask_missile_player;
+extern EMU_TLS UBYTE collisions_mask_player_player;
 
-extern UBYTE TRIG[4];
-extern UBYTE TRIG_latch[4];
+extern EMU_TLS UBYTE TRIG[4];
+extern EMU_TLS UBYTE TRIG_latch[4];
 
-extern int consol_index;
-extern UBYTE consol_table[3];
+extern EMU_TLS int consol_index;
+extern EMU_TLS UBYTE consol_table[3];
 
 void GTIA_Initialise(void);
 void GTIA_Frame(void);
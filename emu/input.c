@@ -49,31 +49,32 @@ extern int Atari_POT(int);
 #define Atari_POT(x) 228
 #endif
 
-extern UBYTE PCPOT_input[8];
-extern unsigned int atari_analog;
+extern EMU_TLS UBYTE PCPOT_input[8];
 
-int key_code = AKEY_NONE;
-int key_shift = 0;
-int key_consol = CONSOL_NONE;
+EMU_TLS unsigned int atari_analog = 0;
 
-int joy_autofire[4] = {AUTOFIRE_OFF, AUTOFIRE_OFF, AUTOFIRE_OFF, AUTOFIRE_OFF};
+EMU_TLS int key_code = AKEY_NONE;
+EMU_TLS int key_shift = 0;
+EMU_TLS int key_consol = CONSOL_NONE;
 
-int joy_block_opposite_directions = 1;
+EMU_TLS int joy_autofire[4] = {AUTOFIRE_OFF, AUTOFIRE_OFF, AUTOFIRE_OFF, AUTOFIRE_OFF};
 
-int joy_multijoy = 0;
+EMU_TLS int joy_block_opposite_directions = 1;
+
+EMU_TLS int joy_multijoy = 0;
 
 #define joy_5200_min    6
 #define joy_5200_center 114
 #define joy_5200_max    220
 
-int mouse_mode = MOUSE_OFF;
-int mouse_port = 0;
-int mouse_delta_x = 0;
-int mouse_delta_y = 0;
-int mouse_buttons = 0;
-int mouse_speed = 3;
-int mouse_pot_min = 1;
-int mouse_pot_max = 228;
+EMU_TLS int mouse_mode = MOUSE_OFF;
+EMU_TLS int mouse_port = 0;
+EMU_TLS int mouse_delta_x = 0;
+EMU_TLS int mouse_delta_y = 0;
+EMU_TLS int mouse_buttons = 0;
+EMU_TLS int mouse_speed = 3;
+EMU_TLS int mouse_pot_min = 1;
+EMU_TLS int mouse_pot_max = 228;
 /* There should be UI or options for light pen/gun offsets.
    Below are best offsets for different programs:
    AtariGraphics: H = 0..32, V = 0 (there's calibration in the program)
@@ -81,16 +82,16 @@ int mouse_pot_max = 228;
    Barnyard Blaster: H = 40, V = 0
    Operation Blood (light gun version): H = 40, V = 4
  */
-int mouse_pen_ofs_h = 42;
-int mouse_pen_ofs_v = 2;
-int mouse_joy_inertia = 10;
+EMU_TLS int mouse_pen_ofs_h = 42;
+EMU_TLS int mouse_pen_ofs_v = 2;
+EMU_TLS int mouse_joy_inertia = 10;
 
 #ifndef MOUSE_SHIFT
 #define MOUSE_SHIFT 4
 #endif
 
-static UBYTE STICK[4], OLDSTICK[4];
-static UBYTE TRIG_input[4];
+static EMU_TLS UBYTE STICK[4], OLDSTICK[4];
+static EMU_TLS UBYTE TRIG_input[4];
 
 //static int max_scanline_counter;
 //static int scanline_counter;
@@ -100,9 +101,9 @@ void INPUT_Initialise(void) {
 
 void INPUT_Frame(void) {
 	int i;
-	static int last_key_code = AKEY_NONE;
-	static int last_key_break = 0;
-  static UBYTE last_stick[4] = {STICK_CENTRE, STICK_CENTRE, STICK_CENTRE, STICK_CENTRE};
+	static EMU_TLS int last_key_code = AKEY_NONE;
+	static EMU_TLS int last_key_break = 0;
+  static EMU_TLS UBYTE last_stick[4] = {STICK_CENTRE, STICK_CENTRE, STICK_CENTRE, STICK_CENTRE};
 //ALEK static int last_mouse_buttons = 0;
 
 	//scanline_counter = 10000;	/* do nothing in INPUT_Scanline() */
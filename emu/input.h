@@ -222,9 +222,9 @@
 #define CONSOL_SELECT	0x02
 #define CONSOL_OPTION	0x04
 
-extern int key_code;	/* regular Atari key code */
-extern int key_shift;	/* Shift key pressed */
-extern int key_consol;	/* Start, Select and Option keys */
+extern EMU_TLS int key_code;	/* regular Atari key code */
+extern EMU_TLS int key_shift;	/* Shift key pressed */
+extern EMU_TLS int key_consol;	/* Start, Select and Option keys */
 
 /* Joysticks ----------------------------------------------------------- */
 
@@ -245,12 +245,14 @@ extern int key_consol;	/* Start, Select and Option keys */
 #define AUTOFIRE_FIRE	1	/* Fire dependent */
 #define AUTOFIRE_CONT	2	/* Continuous */
 
-extern int joy_autofire[4];		/* autofire mode for each Atari port */
+extern EMU_TLS unsigned int atari_analog;	/* TRUE: 5200 pots follow the analog stick */
 
-extern int joy_block_opposite_directions;	/* can't move joystick left
+extern EMU_TLS int joy_autofire[4];		/* autofire mode for each Atari port */
+
+extern EMU_TLS int joy_block_opposite_directions;	/* can't move joystick left
 											   and right simultaneously */
 
-extern int joy_multijoy;	/* emulate MultiJoy4 interface */
+extern EMU_TLS int joy_multijoy;	/* emulate MultiJoy4 interface */
 
 /* 5200 joysticks values */
 extern int joy_5200_min;
@@ -271,17 +273,17 @@ extern int joy_5200_max;
 #define MOUSE_TRAK		8	/* Atari CX22 Trak-Ball */
 #define MOUSE_JOY		9	/* Joystick */
 
-extern int mouse_mode;			/* device emulated with mouse */
-extern int mouse_port;			/* Atari port, to which the emulated device is attached */
-extern int mouse_delta_x;		/* x motion since last frame */
-extern int mouse_delta_y;		/* y motion since last frame */
-extern int mouse_buttons;		/* buttons (b0=1: first button pressed, b1=1: 2nd pressed, etc. */
-extern int mouse_speed;			/* how fast the mouse pointer moves */
-extern int mouse_pot_min;		/* min. value of POKEY's POT register */
-extern int mouse_pot_max;		/* max. value of POKEY's POT register */
-extern int mouse_pen_ofs_h;		/* light pen/gun horizontal offset (for calibration) */
-extern int mouse_pen_ofs_v;		/* light pen/gun vertical offset (for calibration) */
-extern int mouse_joy_inertia;	/* how long the mouse pointer can move (time in Atari frames)
+extern EMU_TLS int mouse_mode;			/* device emulated with mouse */
+extern EMU_TLS int mouse_port;			/* Atari port, to which the emulated device is attached */
+extern EMU_TLS int mouse_delta_x;		/* x motion since last frame */
+extern EMU_TLS int mouse_delta_y;		/* y motion since last frame */
+extern EMU_TLS int mouse_buttons;		/* buttons (b0=1: first button pressed, b1=1: 2nd pressed, etc. */
+extern EMU_TLS int mouse_speed;			/* how fast the mouse pointer moves */
+extern EMU_TLS int mouse_pot_min;		/* min. value of POKEY's POT register */
+extern EMU_TLS int mouse_pot_max;		/* max. value of POKEY's POT register */
+extern EMU_TLS int mouse_pen_ofs_h;		/* light pen/gun horizontal offset (for calibration) */
+extern EMU_TLS int mouse_pen_ofs_v;		/* light pen/gun vertical offset (for calibration) */
+extern EMU_TLS int mouse_joy_inertia;	/* how long the mouse pointer can move (time in Atari frames)
 								   after a fast motion of mouse */
 
 /* Functions ----------------------------------------------------------- */
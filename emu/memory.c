@@ -42,16 +42,25 @@
 #include "statesav.h"
 #endif
 
-UBYTE memory[65536 + 2] __attribute__ ((aligned (4)));
+EMU_TLS UBYTE memory[65536 + 2] __attribute__ ((aligned (4)));
 
 #ifndef PAGED_ATTRIB
 
 UBYTE attrib[65536];
 
+#define UnmapROM(addr1, addr2)
+
 #else /* PAGED_ATTRIB */
 
-rdfunc readmap[256];
-wrfunc writemap[256];
+EMU_TLS rdfunc readmap[256];
+EMU_TLS wrfunc writemap[256];
+#ifdef MONITOR_PROFILE
+EMU_TLS ULONG readmap_count[256];
+EMU_TLS ULONG writemap_count[256];
+#endif
+#ifdef TRACE_HOOKS
+EMU_TLS void (*trace_write_hook)(UWORD addr, UBYTE byte) = NULL;
+#endif
 
 typedef struct map_save {
 	int     code;
@@ -68,16 +77,78 @@ map_save save_map[2] = {
 	{1, NULL, ROM_PutByte}    /* ROM */
 };
 
+EMU_TLS const UBYTE *fetchmap[256];
+
+/* a data read of a page MapROM() put a bank on */
+UBYTE MEMORY_BankGetByte(UWORD addr)
+{
+	return dFetchByte(addr);
+}
+
+/* the pages go back to memory[] */
+static void UnmapROM(UWORD addr1, UWORD addr2)
+{
+	int i;
+	for (i = addr1 >> 8; i <= addr2 >> 8; i++) {
+		if (FETCH_MAPPED(i)) {
+			fetchmap[i] = memory;
+			if (readmap[i] == MEMORY_BankGetByte)
+				readmap[i] = NULL;
+		}
+	}
+}
+
+void CopyROM(UWORD addr1, UWORD addr2, const UBYTE *src)
+{
+	memcpy(memory + addr1, src, addr2 - addr1 + 1);
+	UnmapROM(addr1, addr2);
+	ROM_CHANGED(addr1, addr2);
+}
+
+void MapROM(UWORD addr1, UWORD addr2, const UBYTE *src)
+{
+#ifdef PC_PTR
+	/* the CPU fetches through a pointer into memory[] */
+	CopyROM(addr1, addr2, src);
+#else
+	int i;
+	int was_flat = FALSE;
+	for (i = addr1 >> 8; i <= addr2 >> 8; i++) {
+		if (!FETCH_MAPPED(i))
+			was_flat = TRUE;
+		fetchmap[i] = src - addr1;
+		/* the Bounty Bob pages keep their routine, which reads the bank */
+		if (readmap[i] == NULL)
+			readmap[i] = MEMORY_BankGetByte;
+	}
+	/* the JIT and the blocks only take code read from memory[], so
+	   switching between two banks leaves them nothing to forget; a page
+	   that was in memory[] gets a readmap[] entry, which any of them may
+	   have read it without */
+	if (was_flat)
+		MAP_CHANGED;
+#endif
+}
+
+/* copies the mapped banks into memory[], for whoever reads it whole */
+void MEMORY_SyncROM(void)
+{
+	int i;
+	for (i = 0; i < 256; i++)
+		if (FETCH_MAPPED(i))
+			memcpy(memory + (i << 8), fetchmap[i] + (i << 8), 256);
+}
+
 #endif /* PAGED_ATTRIB */
 
-static UBYTE under_atarixl_os[16384];
-static UBYTE under_atari_basic[8192];
-static UBYTE *atarixe_memory = NULL;
-static ULONG atarixe_memory_size = 0;
+static EMU_TLS UBYTE under_atarixl_os[16384];
+static EMU_TLS UBYTE under_atari_basic[8192];
+static EMU_TLS UBYTE *atarixe_memory = NULL;
+static EMU_TLS ULONG atarixe_memory_size = 0;
 
-int have_basic = FALSE; /* Atari BASIC image has been successfully read (Atari 800 only) */
+EMU_TLS int have_basic = FALSE; /* Atari BASIC image has been successfully read (Atari 800 only) */
 
-extern const UBYTE *antic_xe_ptr;	/* Separate ANTIC access to extended memory */
+extern EMU_TLS const UBYTE *antic_xe_ptr;	/* Separate ANTIC access to extended memory */
 
 static void AllocXEMemory(void)
 {
@@ -103,6 +174,13 @@ static void AllocXEMemory(void)
 
 void MEMORY_InitialiseMachine(void) {
 	antic_xe_ptr = NULL;
+#ifdef PAGED_ATTRIB
+	{
+		int i;
+		for (i = 0; i < 256; i++)
+			fetchmap[i] = memory;
+	}
+#endif
 #if 0
 	switch (machine_type) {
 	case MACHINE_OSA:
@@ -211,6 +289,7 @@ void MEMORY_InitialiseMachine(void) {
 
 void MemStateSave(UBYTE SaveVerbose)
 {
+	MEMORY_SyncROM();
 	SaveUBYTE(&memory[0], 65536);
 #ifndef PAGED_ATTRIB
 	SaveUBYTE(&attrib[0], 65536);
@@ -277,6 +356,8 @@ void MemStateRead(UBYTE SaveVerbose) {
 		int i;
 		for (i = 0; i < 256; i++) {
 			ReadUBYTE(&attrib_page[0], 256);
+			/* the banks that were mapped are in memory[] now */
+			fetchmap[i] = memory;
 			/* note: 0x40 is intentional here:
 			   we want ROM on page 0xd1 if H: patches are enabled */
 			switch (attrib_page[0x40]) {
@@ -317,6 +398,7 @@ void MemStateRead(UBYTE SaveVerbose) {
 				case 0xeb:
 					readmap[i] = POKEY_GetByte;
 					writemap[i] = POKEY_PutByte;
+					break;
 				case 0xd3:
 					readmap[i] = PIA_GetByte;
 					writemap[i] = PIA_PutByte;
@@ -349,6 +431,7 @@ void MemStateRead(UBYTE SaveVerbose) {
 		}
 	}
 #endif
+	MAP_CHANGED;
 
 	if (machine_type == MACHINE_XLXE) {
 		if (SaveVerbose != 0)
@@ -559,14 +642,15 @@ void MEMORY_HandlePORTB(UBYTE byte, UBYTE oldval)
 	}
 }
 
-static int cart809F_enabled = FALSE;
-int cartA0BF_enabled = FALSE;
-static UBYTE under_cart809F[8192];
-static UBYTE under_cartA0BF[8192];
+static EMU_TLS int cart809F_enabled = FALSE;
+EMU_TLS int cartA0BF_enabled = FALSE;
+static EMU_TLS UBYTE under_cart809F[8192];
+static EMU_TLS UBYTE under_cartA0BF[8192];
 
 void Cart809F_Disable(void)
 {
 	if (cart809F_enabled) {
+		UnmapROM(0x8000, 0x9fff);
 		if (ram_size > 32) {
 			memcpy(memory + 0x8000, under_cart809F, 0x2000);
 			SetRAM(0x8000, 0x9fff);
@@ -591,6 +675,7 @@ void Cart809F_Enable(void)
 void CartA0BF_Disable(void)
 {
 	if (cartA0BF_enabled) {
+		UnmapROM(0xa000, 0xbfff);
 		/* No BASIC if not XL/XE or bit 1 of PORTB set */
 		/* or accessing extended 576K or 1088K memory */
 		if ((machine_type != MACHINE_XLXE) || basic_disabled((UBYTE) (PORTB | PORTB_mask))) {
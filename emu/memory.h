@@ -35,12 +35,26 @@
 #define dCopyToMem(from, to, size)		memcpy(memory + (to), from, size)
 #define dFillMem(addr1, value, length)	memset(memory + (addr1), value, length)
 
-extern UBYTE memory[65536 + 2];
+extern EMU_TLS UBYTE memory[65536 + 2];
 
 #define RAM       0
 #define ROM       1
 #define HARDWARE  2
 
+/* the 6502 JIT (cpu_jit.c) and the decoded blocks (cpu_blocks.c) must
+   forget code in ROM that changed and, when the memory map changes, all
+   of it */
+#ifdef CPU_JIT
+#include "cpu_jit.h"
+#define ROM_CHANGED(addr1, addr2)	JIT_Invalidate(addr1, addr2)
+#elif defined(CPU_BLOCKS)
+#include "cpu_blocks.h"
+#define ROM_CHANGED(addr1, addr2)	BLOCKS_Invalidate(addr1, addr2)
+#else
+#define ROM_CHANGED(addr1, addr2)
+#endif
+#define MAP_CHANGED		ROM_CHANGED(0x0000, 0xffff)
+
 #ifndef PAGED_ATTRIB
 
 extern UBYTE attrib[65536];
@@ -54,30 +68,66 @@ extern UBYTE attrib[65536];
 
 typedef UBYTE (*rdfunc)(UWORD addr);
 typedef void (*wrfunc)(UWORD addr, UBYTE value);
-extern rdfunc readmap[256];
-extern wrfunc writemap[256];
+extern EMU_TLS rdfunc readmap[256];
+extern EMU_TLS wrfunc writemap[256];
 void ROM_PutByte(UWORD addr, UBYTE byte);
-#define GetByte(addr)		(readmap[(addr) >> 8] ? (*readmap[(addr) >> 8])(addr) : memory[addr])
-#define PutByte(addr,byte)	(writemap[(addr) >> 8] ? (*writemap[(addr) >> 8])(addr, byte) : (memory[addr] = byte))
+#ifdef MONITOR_PROFILE
+/* readmap/writemap dispatches per page, counted while monitor_profile is set */
+extern EMU_TLS int monitor_profile;
+extern EMU_TLS ULONG readmap_count[256];
+extern EMU_TLS ULONG writemap_count[256];
+#define READMAP_COUNT(addr)		((void) (monitor_profile && readmap_count[(addr) >> 8]++))
+#define WRITEMAP_COUNT(addr)	((void) (monitor_profile && writemap_count[(addr) >> 8]++))
+#else
+#define READMAP_COUNT(addr)		((void) 0)
+#define WRITEMAP_COUNT(addr)	((void) 0)
+#endif
+#ifdef TRACE_HOOKS
+/* called before each writemap dispatch, see A5200_SetTraceHooks() */
+extern EMU_TLS void (*trace_write_hook)(UWORD addr, UBYTE byte);
+#define WRITEMAP_TRACE(addr, byte)	(trace_write_hook != NULL ? trace_write_hook(addr, byte) : (void) 0)
+#else
+#define WRITEMAP_TRACE(addr, byte)	((void) 0)
+#endif
+#define GetByte(addr)		(readmap[(addr) >> 8] ? (READMAP_COUNT(addr), (*readmap[(addr) >> 8])(addr)) : memory[addr])
+#define PutByte(addr,byte)	(writemap[(addr) >> 8] ? (WRITEMAP_COUNT(addr), WRITEMAP_TRACE(addr, byte), (*writemap[(addr) >> 8])(addr, byte)) : (memory[addr] = byte))
 #define SetRAM(addr1, addr2) do { \
 		int i; \
 		for (i = (addr1) >> 8; i <= (addr2) >> 8; i++) { \
 			readmap[i] = NULL; \
 			writemap[i] = NULL; \
+			fetchmap[i] = memory; \
 		} \
+		MAP_CHANGED; \
 	} while (0)
 #define SetROM(addr1, addr2) do { \
 		int i; \
 		for (i = (addr1) >> 8; i <= (addr2) >> 8; i++) { \
 			readmap[i] = NULL; \
 			writemap[i] = ROM_PutByte; \
+			fetchmap[i] = memory; \
 		} \
+		MAP_CHANGED; \
 	} while (0)
 
+/* Where each page is read from by instruction fetch and ANTIC DMA,
+   less the address of the page: memory, or for a cartridge bank put
+   there by MapROM() without copying it, the bank less the address it
+   is at. Banks are mapped in aligned blocks of 4 KB or more, so a
+   pointer from dFetchPtr() is good up to the end of its 4 KB block.
+   Data reads of a mapped page go through its readmap handler;
+   dGetByte() stays memory[], for RAM and the ROM copied in. */
+extern EMU_TLS const UBYTE *fetchmap[256];
+#define dFetchByte(x)			(fetchmap[((x) >> 8) & 0xff][(x) & 0xffff])
+#define dFetchWord(x)			(dFetchByte(x) + (dFetchByte((x) + 1) << 8))
+#define dFetchPtr(x)			(fetchmap[((x) >> 8) & 0xff] + ((x) & 0xffff))
+#define FETCH_MAPPED(page)		(fetchmap[page] != memory)
+UBYTE MEMORY_BankGetByte(UWORD addr);
+
 #endif /* PAGED_ATTRIB */
 
-extern int have_basic;
-extern int cartA0BF_enabled;
+extern EMU_TLS int have_basic;
+extern EMU_TLS int cartA0BF_enabled;
 
 void MEMORY_InitialiseMachine(void);
 void MemStateSave(UBYTE SaveVerbose);
@@ -89,7 +139,21 @@ void Cart809F_Disable(void);
 void Cart809F_Enable(void);
 void CartA0BF_Disable(void);
 void CartA0BF_Enable(void);
+#ifdef PAGED_ATTRIB
+/* CopyROM() copies a ROM image into memory[], MapROM() points the pages
+   at it instead (4 KB aligned blocks), so switching a bank costs a few
+   pointers; addr1 and addr2 are the first and last address */
+void CopyROM(UWORD addr1, UWORD addr2, const UBYTE *src);
+void MapROM(UWORD addr1, UWORD addr2, const UBYTE *src);
+void MEMORY_SyncROM(void);
+#else
 #define CopyROM(addr1, addr2, src) memcpy(memory + (addr1), src, (addr2) - (addr1) + 1)
+#define MapROM(addr1, addr2, src) CopyROM(addr1, addr2, src)
+#define MEMORY_SyncROM()
+#define dFetchByte(x)			dGetByte(x)
+#define dFetchWord(x)			dGetWord(x)
+#define dFetchPtr(x)			(memory + (x))
+#endif
 void get_charset(UBYTE *cs);
 
 #endif /* _MEMORY_H_ */
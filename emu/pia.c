@@ -35,20 +35,20 @@
 #include "statesav.h"
 #endif
 
-UBYTE PACTL;
-UBYTE PBCTL;
-UBYTE PORTA;
-UBYTE PORTB;
-UBYTE PORT_input[2];
+EMU_TLS UBYTE PACTL;
+EMU_TLS UBYTE PBCTL;
+EMU_TLS UBYTE PORTA;
+EMU_TLS UBYTE PORTB;
+EMU_TLS UBYTE PORT_input[2];
 
-int xe_bank = 0;
-int selftest_enabled = 0;
+EMU_TLS int xe_bank = 0;
+EMU_TLS int selftest_enabled = 0;
 
-UBYTE atari_basic[8192];
-UBYTE atari_os[16384];
+EMU_TLS UBYTE atari_basic[8192];
+EMU_TLS UBYTE atari_os[16384];
 
-UBYTE PORTA_mask;
-UBYTE PORTB_mask;
+EMU_TLS UBYTE PORTA_mask;
+EMU_TLS UBYTE PORTB_mask;
 
 void PIA_Initialise(void) {
 	PACTL = 0x3f;
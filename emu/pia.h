@@ -8,19 +8,19 @@
 #define _PACTL 0x02
 #define _PBCTL 0x03
 
-extern UBYTE PACTL;
-extern UBYTE PBCTL;
-extern UBYTE PORTA;
-extern UBYTE PORTB;
-extern UBYTE PORTA_mask;
-extern UBYTE PORTB_mask;
-extern UBYTE PORT_input[2];
+extern EMU_TLS UBYTE PACTL;
+extern EMU_TLS UBYTE PBCTL;
+extern EMU_TLS UBYTE PORTA;
+extern EMU_TLS UBYTE PORTB;
+extern EMU_TLS UBYTE PORTA_mask;
+extern EMU_TLS UBYTE PORTB_mask;
+extern EMU_TLS UBYTE PORT_input[2];
 
-extern int xe_bank;
-extern int selftest_enabled;
+extern EMU_TLS int xe_bank;
+extern EMU_TLS int selftest_enabled;
 
-extern UBYTE atari_basic[8192];
-extern UBYTE atari_os[16384];
+extern EMU_TLS UBYTE atari_basic[8192];
+extern EMU_TLS UBYTE atari_os[16384];
 
 extern void PIA_Initialise(void);
 extern void PIA_Reset(void);
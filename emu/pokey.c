@@ -51,39 +51,120 @@
 void pokey_update(void);
 #endif
 
-UBYTE KBCODE;
-UBYTE SERIN;
-UBYTE IRQST;
-UBYTE IRQEN;
-UBYTE SKSTAT;
-UBYTE SKCTLS;
-int DELAYED_SERIN_IRQ;
-int DELAYED_SEROUT_IRQ;
-int DELAYED_XMTDONE_IRQ;
+EMU_TLS UBYTE KBCODE;
+EMU_TLS UBYTE SERIN;
+EMU_TLS UBYTE IRQST;
+EMU_TLS UBYTE IRQEN;
+EMU_TLS UBYTE SKSTAT;
+EMU_TLS UBYTE SKCTLS;
+EMU_TLS int DELAYED_SERIN_IRQ;
+EMU_TLS int DELAYED_SEROUT_IRQ;
+EMU_TLS int DELAYED_XMTDONE_IRQ;
 
 /* structures to hold the 9 pokey control bytes */
-UBYTE AUDF[4 * MAXPOKEYS];	/* AUDFx (D200, D202, D204, D206) */
-UBYTE AUDC[4 * MAXPOKEYS];	/* AUDCx (D201, D203, D205, D207) */
-UBYTE AUDCTL[MAXPOKEYS];	/* AUDCTL (D208) */
-int DivNIRQ[4], DivNMax[4];
-int Base_mult[MAXPOKEYS];		/* selects either 64Khz or 15Khz clock mult */
+EMU_TLS UBYTE AUDF[4 * MAXPOKEYS];	/* AUDFx (D200, D202, D204, D206) */
+EMU_TLS UBYTE AUDC[4 * MAXPOKEYS];	/* AUDCx (D201, D203, D205, D207) */
+EMU_TLS UBYTE AUDCTL[MAXPOKEYS];	/* AUDCTL (D208) */
+EMU_TLS int DivNIRQ[4], DivNMax[4];
+EMU_TLS int Base_mult[MAXPOKEYS];		/* selects either 64Khz or 15Khz clock mult */
+
+EMU_TLS UBYTE POT_input[8] = {228, 228, 228, 228, 228, 228, 228, 228};
+EMU_TLS UBYTE PCPOT_input[8] = {112, 112, 112, 112, 112, 112,112, 112};
+EMU_TLS UBYTE POT_all;
+EMU_TLS UBYTE pot_scanline;
+
+static EMU_TLS ULONG random_scanline_counter;
+
+/* ANTIC leaves out POKEY_Scanline() on the lines where nothing is due
+   (POKEY_LINE_DUE() in pokey.h) and counts them in pokey_pending_lines;
+   POKEY_CatchUp() applies them at once before anything looks at the
+   state they change. pokey_quiet_lines is how many lines from the last
+   catch-up can pass like that: up to the first underflow of a timer with
+   its IRQ enabled. The serial IRQ delays count every line, ANTIC doesn't
+   leave out any while one is set. */
+EMU_TLS int pokey_pending_lines = 0;
+EMU_TLS int pokey_quiet_lines = 0;
+
+/* Runs timer chan over lines on which its IRQ would be left out. */
+static void POKEY_AdvanceTimer(int chan, int lines)
+{
+	int count = DivNIRQ[chan];
+
+	while (lines > 0) {
+		if (count >= LINE_C) {
+			/* the lines before the next underflow */
+			int n = count / LINE_C;
+			if (n > lines)
+				n = lines;
+			count -= n * LINE_C;
+			lines -= n;
+		}
+		else if (count < 0 && DivNMax[chan] <= LINE_C) {
+			/* never set, or as fast as the lines: same every line */
+			count -= (LINE_C - DivNMax[chan]) * lines;
+			break;
+		}
+		else {
+			if ((count -= LINE_C) < 0)
+				count += DivNMax[chan];
+			lines--;
+		}
+	}
+	DivNIRQ[chan] = count;
+}
 
-UBYTE POT_input[8] = {228, 228, 228, 228, 228, 228, 228, 228};
-UBYTE PCPOT_input[8] = {112, 112, 112, 112, 112, 112,112, 112};
-UBYTE POT_all;
-UBYTE pot_scanline;
+static void POKEY_CatchUp(void)
+{
+	int lines = pokey_pending_lines;
+
+	if (lines == 0)
+		return;
+	pokey_pending_lines = 0;
+	pokey_quiet_lines -= lines;
+
+	if (pot_scanline < 228)
+		pot_scanline = pot_scanline + lines < 228 ? pot_scanline + lines : 228;
+	POT_input[0] = PCPOT_input[0]; POT_input[1] = PCPOT_input[1]; POT_input[2] = PCPOT_input[2]; POT_input[3] = PCPOT_input[3];
+	random_scanline_counter += lines * LINE_C;
+	POKEY_AdvanceTimer(CHAN1, lines);
+	POKEY_AdvanceTimer(CHAN2, lines);
+	POKEY_AdvanceTimer(CHAN4, lines);
+}
+
+/* Sets pokey_quiet_lines from the current state. */
+static void POKEY_Schedule(void)
+{
+#if defined(POKEY_UPDATE) || defined(CONSOLE_SOUND)
+	/* something to do on every line */
+	pokey_quiet_lines = 0;
+#else
+	static const UBYTE timer_chan[3] = { CHAN1, CHAN2, CHAN4 };
+	int quiet = 0x7fffffff;
+	int i;
 
-UBYTE poly9_lookup[511];
-UBYTE poly17_lookup[16385];
-static ULONG random_scanline_counter;
+	for (i = 0; i < 3; i++) {
+		int chan = timer_chan[i];
+		/* IRQEN bits 0, 1 and 2 for timers 1, 2 and 4 */
+		if (IRQEN & (1 << i)) {
+			/* the line that underflows has to be run */
+			int lines = DivNIRQ[chan] >= 0 ? DivNIRQ[chan] / LINE_C : 0;
+			if (lines < quiet)
+				quiet = lines;
+		}
+	}
+	pokey_quiet_lines = quiet;
+#endif
+}
 
 ULONG POKEY_GetRandomCounter(void)
 {
+	POKEY_CatchUp();
 	return random_scanline_counter;
 }
 
 void POKEY_SetRandomCounter(ULONG value)
 {
+	POKEY_CatchUp();
 	random_scanline_counter = value;
 }
 
@@ -91,6 +172,8 @@ UBYTE POKEY_GetByte(UWORD addr)
 {
 	UBYTE byte = 0xff;
 
+	POKEY_CatchUp();
+
 #ifdef STEREO_SOUND
 	if (addr & 0x0010 && stereo_enabled)
 		return 0;
@@ -132,15 +215,17 @@ UBYTE POKEY_GetByte(UWORD addr)
 	case _RANDOM:
 		if ((SKCTLS & 0x03) != 0) {
 			int i = random_scanline_counter + XPOS;
-			if (AUDCTL[0] & POLY9)
-				byte = poly9_lookup[i % POLY9_SIZE];
+			const UBYTE *ptr;
+			if (AUDCTL[0] & POLY9) {
+				i %= POLY9_SIZE;
+				ptr = poly9_lookup + (i >> 3);
+			}
 			else {
-				const UBYTE *ptr;
 				i %= POLY17_SIZE;
 				ptr = poly17_lookup + (i >> 3);
-				i &= 7;
-				byte = (UBYTE) ((ptr[0] >> i) + (ptr[1] << (8 - i)));
 			}
+			i &= 7;
+			byte = (UBYTE) ((ptr[0] >> i) + (ptr[1] << (8 - i)));
 		}
 		break;
 	case _SERIN:
@@ -182,6 +267,7 @@ static int POKEY_siocheck(void)
 
 void POKEY_PutByte(UWORD addr, UBYTE byte)
 {
+	POKEY_CatchUp();
 #ifdef STEREO_SOUND
 	addr &= stereo_enabled ? 0x1f : 0x0f;
 #else
@@ -336,12 +422,12 @@ void POKEY_PutByte(UWORD addr, UBYTE byte)
 		break;
 #endif
 	}
+	POKEY_Schedule();
 }
 
 void POKEY_Initialise(void)
 {
 	int i;
-	ULONG reg;
 
 	/* Initialise Serial Port Interrupts */
 	DELAYED_SERIN_IRQ = 0;
@@ -369,19 +455,8 @@ void POKEY_Initialise(void)
 		DivNIRQ[i] = DivNMax[i] = 0;
 
 	pot_scanline = 0;
-
-	/* initialise poly9_lookup */
-	reg = 0x1ff;
-	for (i = 0; i < 511; i++) {
-		reg = ((((reg >> 5) ^ reg) & 1) << 8) + (reg >> 1);
-		poly9_lookup[i] = (UBYTE) reg;
-	}
-	/* initialise poly17_lookup */
-	reg = 0x1ffff;
-	for (i = 0; i < 16385; i++) {
-		reg = ((((reg >> 5) ^ reg) & 0xff) << 9) + (reg >> 8);
-		poly17_lookup[i] = (UBYTE) (reg >> 1);
-	}
+	pokey_pending_lines = 0;
+	pokey_quiet_lines = 0;
 
 	random_scanline_counter =
 #ifdef WIN32
@@ -394,6 +469,7 @@ void POKEY_Initialise(void)
 }
 
 void POKEY_Frame(void) {
+	POKEY_CatchUp();
 	random_scanline_counter %= (AUDCTL[0] & POLY9) ? POLY9_SIZE : POLY17_SIZE;
 }
 
@@ -404,6 +480,7 @@ void POKEY_Frame(void) {
  ***************************************************************************/
 
 void POKEY_Scanline(void) {
+	POKEY_CatchUp();
 #ifdef POKEY_UPDATE
 	pokey_update();
 #endif
@@ -512,6 +589,7 @@ void POKEY_Scanline(void) {
 			GenerateIRQ();
 		}
 	}
+	POKEY_Schedule();
 }
 
 /*****************************************************************************/
@@ -592,7 +670,9 @@ void POKEYStateSave(void)
 {
 	int SHIFT_KEY = 0;
 	int KEYPRESSED = 0;
+	int random_counter;
 
+	POKEY_CatchUp();
 	SaveUBYTE(&KBCODE, 1);
 	SaveUBYTE(&IRQST, 1);
 	SaveUBYTE(&IRQEN, 1);
@@ -611,6 +691,11 @@ void POKEYStateSave(void)
 	SaveINT(&DivNIRQ[0], 4);
 	SaveINT(&DivNMax[0], 4);
 	SaveINT(&Base_mult[0], 1);
+
+	/* what RANDOM and the pots read next */
+	random_counter = (int) random_scanline_counter;
+	SaveINT(&random_counter, 1);
+	SaveUBYTE(&pot_scanline, 1);
 }
 
 void POKEYStateRead(void)
@@ -618,7 +703,10 @@ void POKEYStateRead(void)
 	int i;
 	int SHIFT_KEY;
 	int KEYPRESSED;
+	int random_counter;
 
+	/* the lines left out belong to the state replaced */
+	pokey_pending_lines = 0;
 	ReadUBYTE(&KBCODE, 1);
 	ReadUBYTE(&IRQST, 1);
 	ReadUBYTE(&IRQEN, 1);
@@ -642,6 +730,11 @@ void POKEYStateRead(void)
 	ReadINT(&DivNIRQ[0], 4);
 	ReadINT(&DivNMax[0], 4);
 	ReadINT(&Base_mult[0], 1);
+
+	ReadINT(&random_counter, 1);
+	random_scanline_counter = random_counter;
+	ReadUBYTE(&pot_scanline, 1);
+	POKEY_Schedule();
 }
 
 #endif
@@ -42,15 +42,24 @@
 
 #ifndef ASAP
 
-extern UBYTE KBCODE;
-extern UBYTE IRQST;
-extern UBYTE IRQEN;
-extern UBYTE SKSTAT;
-extern int DELAYED_SERIN_IRQ;
-extern int DELAYED_SEROUT_IRQ;
-extern int DELAYED_XMTDONE_IRQ;
+extern EMU_TLS UBYTE KBCODE;
+extern EMU_TLS UBYTE IRQST;
+extern EMU_TLS UBYTE IRQEN;
+extern EMU_TLS UBYTE SKSTAT;
+extern EMU_TLS int DELAYED_SERIN_IRQ;
+extern EMU_TLS int DELAYED_SEROUT_IRQ;
+extern EMU_TLS int DELAYED_XMTDONE_IRQ;
 
-extern UBYTE POT_input[8];
+extern EMU_TLS UBYTE POT_input[8];
+
+/* scanlines left out of POKEY_Scanline() (see pokey.c) */
+extern EMU_TLS int pokey_pending_lines;
+extern EMU_TLS int pokey_quiet_lines;
+
+/* Whether POKEY_Scanline() has anything to do on this line; if not,
+   the caller counts the line in pokey_pending_lines instead. */
+#define POKEY_LINE_DUE() (pokey_pending_lines >= pokey_quiet_lines \
+	|| (DELAYED_SERIN_IRQ | DELAYED_SEROUT_IRQ | DELAYED_XMTDONE_IRQ) != 0)
 
 ULONG POKEY_GetRandomCounter(void);
 void POKEY_SetRandomCounter(ULONG value);
@@ -106,14 +115,17 @@ void POKEY_Scanline(void);
 #define SAMPLE    127
 
 /* structures to hold the 9 pokey control bytes */
-extern UBYTE AUDF[4 * MAXPOKEYS];	/* AUDFx (D200, D202, D204, D206) */
-extern UBYTE AUDC[4 * MAXPOKEYS];	/* AUDCx (D201, D203, D205, D207) */
-extern UBYTE AUDCTL[MAXPOKEYS];		/* AUDCTL (D208) */
-
-extern int DivNIRQ[4], DivNMax[4];
-extern int Base_mult[MAXPOKEYS];	/* selects either 64Khz or 15Khz clock mult */
-
-extern UBYTE poly9_lookup[POLY9_SIZE];
-extern UBYTE poly17_lookup[16385];
+extern EMU_TLS UBYTE AUDF[4 * MAXPOKEYS];	/* AUDFx (D200, D202, D204, D206) */
+extern EMU_TLS UBYTE AUDC[4 * MAXPOKEYS];	/* AUDCx (D201, D203, D205, D207) */
+extern EMU_TLS UBYTE AUDCTL[MAXPOKEYS];		/* AUDCTL (D208) */
+
+extern EMU_TLS int DivNIRQ[4], DivNMax[4];
+extern EMU_TLS int Base_mult[MAXPOKEYS];	/* selects either 64Khz or 15Khz clock mult */
+
+/* The 9 and 17-bit polynomial sequences, a bit per step: bit (i & 7) of
+   byte i >> 3 (emu/polytab.c, generated by tools/mkpoly.c). Both go on
+   for 8 bits past their end, so 8 bits from any step are in two bytes. */
+extern const UBYTE poly9_lookup[65];
+extern const UBYTE poly17_lookup[16385];
 
 #endif
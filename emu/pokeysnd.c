@@ -22,6 +22,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 */
 #include "config.h"
+#include <string.h>
 
 #ifdef ASAP /* external project, see http://asap.sf.net */
 #include "asap_internal.h"
@@ -50,47 +51,43 @@
 /* GLOBAL VARIABLE DEFINITIONS */
 
 /* number of pokey chips currently emulated */
-static uint8 Num_pokeys;
+static EMU_TLS uint8 Num_pokeys;
 
-static uint8 AUDV[4 * MAXPOKEYS];	/* Channel volume - derived */
+static EMU_TLS uint8 AUDV[4 * MAXPOKEYS];	/* Channel volume - derived */
 
 static uint8 Outbit[4 * MAXPOKEYS];		/* current state of the output (high or low) */
 
-static uint8 Outvol[4 * MAXPOKEYS];		/* last output volume for each channel */
+static EMU_TLS uint8 Outvol[4 * MAXPOKEYS];		/* last output volume for each channel */
 
 /* Initialze the bit patterns for the polynomials. */
 
 /* The 4bit and 5bit patterns are the identical ones used in the pokey chip. */
-/* Though the patterns could be packed with 8 bits per byte, using only a */
-/* single bit per byte keeps the math simple, which is important for */
-/* efficient processing. */
+/* They are kept a bit per step in a constant, bit P4 of POLY4_BITS and bit */
+/* P5 of POLY5_BITS; the 9 and 17 bit ones are bit tables as well (see      */
+/* poly9_lookup and poly17_lookup in pokey.h).                               */
 
-static uint8 bit4[POLY4_SIZE] =
 #ifndef POKEY23_POLY
-{1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 0};	/* new table invented by Perry */
+#define POLY4_BITS 0x2c8f		/* new table invented by Perry */
+#define POLY5_BITS 0x289c196fUL
 #else
-{1, 1, 0, 1, 1, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0};	/* original POKEY 2.3 table */
+#define POLY4_BITS 0x143b		/* original POKEY 2.3 table */
+#define POLY5_BITS 0x4176a78cUL
 #endif
 
-static uint8 bit5[POLY5_SIZE] =
-#ifndef POKEY23_POLY
-{1, 1, 1, 1, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 1, 0, 1, 0};
-#else
-{0, 0, 1, 1, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 1, 0, 1, 1, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0, 1};
-#endif
+#define POLY_BIT(table, p) (((table)[(p) >> 3] >> ((p) & 7)) & 1)
 
-static uint32 P4 = 0,			/* Global position pointer for the 4-bit  POLY array */
+static EMU_TLS uint32 P4 = 0,			/* Global position pointer for the 4-bit  POLY array */
  P5 = 0,						/* Global position pointer for the 5-bit  POLY array */
  P9 = 0,						/* Global position pointer for the 9-bit  POLY array */
  P17 = 0;						/* Global position pointer for the 17-bit POLY array */
 
-static uint32 Div_n_cnt[4 * MAXPOKEYS],		/* Divide by n counter. one for each channel */
+static EMU_TLS uint32 Div_n_cnt[4 * MAXPOKEYS],		/* Divide by n counter. one for each channel */
  Div_n_max[4 * MAXPOKEYS];		/* Divide by n maximum, one for each channel */
 
-static uint32 Samp_n_max,		/* Sample max.  For accuracy, it is *256 */
+static EMU_TLS uint32 Samp_n_max,		/* Sample max.  For accuracy, it is *256 */
  Samp_n_cnt[2] __attribute__ ((aligned (4)));					/* Sample cnt. */
 
-extern int atari_speaker;
+extern EMU_TLS int atari_speaker;
 
 #ifdef INTERPOLATE_SOUND
 static uint16 last_val = 0;		/* last output value */
@@ -100,41 +97,41 @@ static uint16 last_val = 0;		/* last output value */
 #ifdef VOL_ONLY_SOUND
 
 #define	SAMPBUF_MAX	2000
-int	sampbuf_val[SAMPBUF_MAX];	/* volume values */
-int	sampbuf_cnt[SAMPBUF_MAX];	/* relative start time */
-int	sampbuf_ptr = 0;		/* pointer to sampbuf */
-int	sampbuf_rptr = 0;		/* pointer to read from sampbuf */
-int	sampbuf_last = 0;		/* last absolute time */
-int	sampbuf_AUDV[4 * MAXPOKEYS];	/* prev. channel volume */
-int	sampbuf_lastval = 0;		/* last volume */
-int	sampout;			/* last out volume */
-uint16 samp_freq;
-int	samp_consol_val = 0;		/* actual value of console sound */
+EMU_TLS int	sampbuf_val[SAMPBUF_MAX];	/* volume values */
+EMU_TLS int	sampbuf_cnt[SAMPBUF_MAX];	/* relative start time */
+EMU_TLS int	sampbuf_ptr = 0;		/* pointer to sampbuf */
+EMU_TLS int	sampbuf_rptr = 0;		/* pointer to read from sampbuf */
+EMU_TLS int	sampbuf_last = 0;		/* last absolute time */
+EMU_TLS int	sampbuf_AUDV[4 * MAXPOKEYS];	/* prev. channel volume */
+EMU_TLS int	sampbuf_lastval = 0;		/* last volume */
+EMU_TLS int	sampout;			/* last out volume */
+EMU_TLS uint16 samp_freq;
+EMU_TLS int	samp_consol_val = 0;		/* actual value of console sound */
 #endif  /* VOL_ONLY_SOUND */
 
-static uint32 snd_freq17 = FREQ_17_EXACT;
-int32 snd_playback_freq = 44100;
-uint8 snd_num_pokeys = 1;
-static int snd_flags = 0;
-static int mz_quality = 0;		/* default quality for mzpokeysnd */
+static EMU_TLS uint32 snd_freq17 = FREQ_17_EXACT;
+EMU_TLS int32 snd_playback_freq = 44100;
+EMU_TLS uint8 snd_num_pokeys = 1;
+static EMU_TLS int snd_flags = 0;
+static EMU_TLS int mz_quality = 0;	/* default quality for mzpokeysnd */
 
 # if 0 //LUDO:
-int enable_new_pokey = TRUE;
+EMU_TLS int enable_new_pokey = TRUE;
 #ifndef ASAP
-int stereo_enabled = FALSE;
+EMU_TLS int stereo_enabled = FALSE;
 #endif
 # else
-int enable_new_pokey = FALSE;
-int stereo_enabled   = FALSE;
+EMU_TLS int enable_new_pokey = FALSE;
+EMU_TLS int stereo_enabled   = FALSE;
 # endif
 
 /* multiple sound engine interface */
 static void null_pokey_process(void *sndbuffer, unsigned int sndn) {}
-void (*Pokey_process_ptr)(void *sndbuffer, unsigned int sndn) = null_pokey_process;
+EMU_TLS void (*Pokey_process_ptr)(void *sndbuffer, unsigned int sndn) = null_pokey_process;
 
 static void Update_pokey_sound_rf(uint16, uint8, uint8, uint8);
 static void null_pokey_sound(uint16 addr, uint8 val, uint8 chip, uint8 gain) {}
-void (*Update_pokey_sound) (uint16 addr, uint8 val, uint8 chip, uint8 gain)
+EMU_TLS void (*Update_pokey_sound) (uint16 addr, uint8 val, uint8 chip, uint8 gain)
   = null_pokey_sound;
 
 #ifdef SERIO_SOUND
@@ -154,9 +151,56 @@ int console_sound_enabled = 1;
 #ifdef VOL_ONLY_SOUND
 static void Update_vol_only_sound_rf(void);
 static void null_vol_only_sound(void) {}
-void (*Update_vol_only_sound)(void) = null_vol_only_sound;
+EMU_TLS void (*Update_vol_only_sound)(void) = null_vol_only_sound;
 #endif
 
+/* Timed register writes (Pokey_set_timed()): instead of taking effect at
+   whatever point the output buffer happens to be filled, each write is
+   queued with the cpu_clock it happened at, and Pokey_process_frame()
+   applies it at the matching sample of the frame. */
+#define SND_EVENTS_MAX 4096
+typedef struct {
+	unsigned int clock;
+	uint16 addr;
+	uint8 val;
+	uint8 chip;
+	uint8 gain;
+} snd_event_t;
+static EMU_TLS snd_event_t snd_events[SND_EVENTS_MAX];
+static EMU_TLS int snd_nevents = 0;
+static EMU_TLS int snd_timed = FALSE;
+static EMU_TLS unsigned int snd_frame_clock;	/* cpu_clock at the first sample of the frame */
+static EMU_TLS int snd_rendering = FALSE;
+static EMU_TLS unsigned int snd_render_clock;	/* cpu_clock of the write being applied */
+
+static void Update_pokey_sound_timed(uint16 addr, uint8 val, uint8 chip, uint8 gain);
+
+/* the time of the volume only output samples */
+#define SND_CLOCK (snd_rendering ? snd_render_clock : cpu_clock)
+
+/* Band-limited synthesis, see Pokey_process() */
+#define POKEY_BLOCK 256
+
+static EMU_TLS int blep_taps = 0;		/* 0: output taken at the sample cycles */
+static EMU_TLS const int32 (*blep_steps)[BLEP_TAPS_MAX + 1];
+static EMU_TLS int32 blep_buf[POKEY_BLOCK + BLEP_TAPS_MAX + 4];
+static EMU_TLS int32 blep_sum;			/* sum of blep_buf[] up to the last sample */
+static EMU_TLS int blep_level;			/* output level all the steps added reach */
+static EMU_TLS int blep_started = FALSE;
+
+/* Band-limited synthesis for the calling thread's machine, see
+   Pokey_set_mzquality(). */
+static void Pokey_blep_select(int quality)
+{
+	if (quality > 0) {
+		blep_taps = 8 << (quality - 1);
+		blep_steps = blep_kernel[quality - 1];
+	}
+	else
+		blep_taps = 0;
+	blep_started = FALSE;
+}
+
 /*****************************************************************************/
 /* In my routines, I treat the sample output as another divide by N counter  */
 /* For better accuracy, the Samp_n_cnt has a fixed binary decimal point      */
@@ -205,7 +249,9 @@ static int Pokey_sound_init_rf(uint32 freq17, uint16 playback_freq,
 {
 	uint8 chan;
 
-	Update_pokey_sound = Update_pokey_sound_rf;
+	Update_pokey_sound = snd_timed ? Update_pokey_sound_timed : Update_pokey_sound_rf;
+	snd_nevents = 0;
+	snd_frame_clock = cpu_clock;
 #ifdef SERIO_SOUND
 	Update_serio_sound = Update_serio_sound_rf;
 #endif
@@ -248,6 +294,8 @@ static int Pokey_sound_init_rf(uint32 freq17, uint16 playback_freq,
 	/* set the number of pokey chips currently emulated */
 	Num_pokeys = num_pokeys;
 
+	Pokey_blep_select(mz_quality);
+
 	return 0; /* OK */
 }
 
@@ -279,9 +327,18 @@ Pokey_sound_init(uint32 freq17, uint16 playback_freq, uint8 num_pokeys,
 	return Pokey_DoInit();
 }
 
+/* 0 takes the output at the cycle of each sample, 1 to 3 band-limit it with
+   steps 8, 16 or 32 samples wide, each twice the work of the one before.
+   Sets the quality of the calling thread's machine, kept when it is
+   initialised again. */
 void Pokey_set_mzquality(int quality)	/* specially for win32, perhaps not needed? */
 {
+	if (quality < 0)
+		quality = 0;
+	if (quality > BLEP_QUALITIES)
+		quality = BLEP_QUALITIES;
 	mz_quality = quality;
+	Pokey_blep_select(quality);
 }
 /*
 void Pokey_process(void *sndbuffer, unsigned int sndn)
@@ -469,8 +526,8 @@ static void Update_pokey_sound_rf(uint16 addr, uint8 val, uint8 chip, uint8 gain
 					sampbuf_val[sampbuf_ptr] = sampbuf_lastval;
 					sampbuf_AUDV[chan + chip_offs] = AUDV[chan + chip_offs];
 					sampbuf_cnt[sampbuf_ptr] =
-						(cpu_clock - sampbuf_last) * 128 * samp_freq / 178979;
-					sampbuf_last = cpu_clock;
+						(SND_CLOCK - sampbuf_last) * 128 * samp_freq / 178979;
+					sampbuf_last = SND_CLOCK;
 					sampbuf_ptr++;
 					if (sampbuf_ptr >= SAMPBUF_MAX)
 						sampbuf_ptr = 0;
@@ -534,6 +591,11 @@ static void Update_pokey_sound_rf(uint16 addr, uint8 val, uint8 chip, uint8 gain
 /*                                                                           */
 /*****************************************************************************/
 
+#ifdef INTERPOLATE_SOUND
+
+/* Interpolation needs the position of each output change within its
+   sample, so it keeps the original event at a time loop. */
+
 //void Pokey_process(void *sndbuffer) 
 //void Pokey_process_8(void *sndbuffer, unsigned sndn)
 void Pokey_process(void *sndbuffer, unsigned sndn)
@@ -681,7 +743,7 @@ void Pokey_process(void *sndbuffer, unsigned sndn)
 			if (!(audc & VOL_ONLY)) {
 				/* if the output is pure or the output is poly5 and the poly5 bit */
 				/* is set */
-				if ((audc & NOTPOLY5) || bit5[P5]) {
+				if ((audc & NOTPOLY5) || ((POLY5_BITS >> P5) & 1)) {
 					/* if the PURETONE bit is set */
 					if (audc & PURETONE) {
 						/* then simply toggle the output */
@@ -690,17 +752,17 @@ void Pokey_process(void *sndbuffer, unsigned sndn)
 					/* otherwise if POLY4 is selected */
 					else if (audc & POLY4) {
 						/* then compare to the poly4 bit */
-						toggle = (bit4[P4] == !(*out_ptr));
+						toggle = (((POLY4_BITS >> P4) & 1) == !(*out_ptr));
 					}
 					else {
 						/* if 9-bit poly is selected on this chip */
 						if (AUDCTL[next_event >> 2] & POLY9) {
 							/* compare to the poly9 bit */
-							toggle = ((poly9_lookup[P9] & 1) == !(*out_ptr));
+							toggle = (POLY_BIT(poly9_lookup, P9) == !(*out_ptr));
 						}
 						else {
 							/* otherwise compare to the poly17 bit */
-							toggle = (((poly17_lookup[P17 >> 3] >> (P17 & 7)) & 1) == !(*out_ptr));
+							toggle = (POLY_BIT(poly17_lookup, P17) == !(*out_ptr));
 						}
 					}
 				}
@@ -816,10 +878,387 @@ void Pokey_process(void *sndbuffer, unsigned sndn)
 #ifdef VOL_ONLY_SOUND
 	{
 		if (sampbuf_rptr == sampbuf_ptr)
-			sampbuf_last = cpu_clock;
+			sampbuf_last = SND_CLOCK;
 	}
 #endif  /* VOL_ONLY_SOUND */
 }
+#else /* INTERPOLATE_SOUND */
+
+/* Pokey_process() renders the samples a block at a time: each channel pair
+   is run over the whole block on its own, its output as runs of samples
+   added into a mix buffer, and the mix is then clipped into the output in a
+   single pass. The loops over the samples have no dependencies between
+   iterations, so the compiler can vectorise them, and a channel that stays
+   the same over a block (off, silent, at volume only or too high for the
+   playback frequency) costs nothing per sample. The samples are exactly
+   those of the event at a time loop it replaces.
+
+   That loop takes the output at the cycle each sample falls on, so every
+   tone above half the playback frequency folds back as a false one. With
+   Pokey_set_mzquality() above 0 each change of the output is instead added
+   as a band-limited step at its exact position between two samples: a
+   windowed sinc integrated into a step, 8, 16 or 32 samples wide, stored as
+   its differences from sample to sample for 64 positions (BLEP_PHASES).
+   The differences go into a buffer that is summed up into the samples,
+   which come out 2 + width / 2 samples later. */
+
+typedef struct {
+	const uint32 *time;			/* cycle of each sample */
+	int n;
+	int16 *mix;
+	int base;					/* added to all samples of the block */
+	uint32 samp;				/* Samp_n_cnt of the first sample */
+} pokey_block_t;
+
+/* Adds a step of delta at pos, in 1/BLEP_PHASES samples from two samples
+   before the first of the block. */
+static void Pokey_blep_step(int32 pos, int delta)
+{
+	const int32 *kernel = blep_steps[pos & (BLEP_PHASES - 1)];
+	int32 *buf = blep_buf + (pos >> BLEP_PHASE_BITS) + 1;
+	int j;
+
+	for (j = 0; j <= blep_taps; j++)
+		buf[j] += delta * kernel[j];
+	blep_level += delta;
+}
+
+/* Adds a step of delta at cycle t of the block. */
+static void Pokey_blep_cycle(const pokey_block_t *b, uint32 t, int delta)
+{
+	long long pos = (((long long) t << 8) - b->samp + 2 * Samp_n_max) * BLEP_PHASES / Samp_n_max;
+
+	/* a clock comes after the sample before the block */
+	if (pos < 0)
+		pos = 0;
+	Pokey_blep_step((int32) pos, delta);
+}
+
+/* Whether chan, clocked at cycle t of the block, changes its output. */
+static int Pokey_toggle(int chan, uint32 t)
+{
+	uint8 audc = AUDC[chan];
+	uint32 p;
+
+	if (audc & VOL_ONLY)
+		return FALSE;
+	if (!(audc & NOTPOLY5) && !((POLY5_BITS >> ((P5 + t) % POLY5_SIZE)) & 1))
+		return FALSE;
+	if (audc & PURETONE)
+		return TRUE;
+	if (audc & POLY4)
+		return ((POLY4_BITS >> ((P4 + t) % POLY4_SIZE)) & 1) == !Outvol[chan];
+	if (AUDCTL[chan >> 2] & POLY9) {
+		p = (P9 + t) % POLY9_SIZE;
+		return POLY_BIT(poly9_lookup, p) == !Outvol[chan];
+	}
+	p = (P17 + t) % POLY17_SIZE;
+	return POLY_BIT(poly17_lookup, p) == !Outvol[chan];
+}
+
+/* Adds the output of chan over samples from..to-1 of the block. */
+static void Pokey_mix(pokey_block_t *b, int chan, int from, int to)
+{
+	int16 vol = AUDV[chan];
+	int16 *mix = b->mix;
+	int i;
+
+	if (!Outvol[chan] || vol == 0 || from == to)
+		return;
+	if (from == 0 && to == b->n) {
+		b->base += vol;
+		return;
+	}
+	for (i = from; i < to; i++)
+		mix[i] += vol;
+}
+
+/* Flips the output of chan at cycle t, before sample k of the block;
+   *from is the first sample of chan not mixed yet. */
+static void Pokey_flip(pokey_block_t *b, int chan, uint32 t, int k, int *from)
+{
+	if (blep_taps)
+		Pokey_blep_cycle(b, t, Outvol[chan] ? -AUDV[chan] : AUDV[chan]);
+	else {
+		Pokey_mix(b, chan, *from, k);
+		*from = k;
+	}
+	Outvol[chan] ^= 1;
+}
+
+/* Runs channel lo (CHAN1 or CHAN2 of a chip) and the channel clocking its
+   high pass filter, lo + 2, over the block. A channel is clocked before a
+   sample at the same cycle, and on a tie the filter clock comes first, as
+   in the event loop. Leaves the counters relative to the start of the
+   block, returns the cycle of the last clock, 0 if there was none. */
+static uint32 Pokey_pair(pokey_block_t *b, int lo)
+{
+	int hi = lo + 2;
+	int filter = AUDCTL[lo >> 2] & ((lo & 3) == CHAN1 ? CH1_FILTER : CH2_FILTER);
+	const uint32 *time = b->time;
+	uint32 end = time[b->n - 1];
+	uint32 last = 0;
+	int from_lo = 0, from_hi = 0;	/* first sample not mixed yet */
+	int k = 0;						/* first sample at or after the clock */
+
+	for (;;) {
+		int chan;
+		uint32 t;
+
+		if (Div_n_cnt[hi] <= Div_n_cnt[lo])
+			chan = hi;
+		else
+			chan = lo;
+		t = Div_n_cnt[chan];
+		if (t > end)
+			break;
+		while (time[k] < t)
+			k++;
+		last = t;
+		Div_n_cnt[chan] += Div_n_max[chan];
+
+		if (chan == hi && filter && Outvol[lo])
+			Pokey_flip(b, lo, t, k, &from_lo);
+		if (Pokey_toggle(chan, t))
+			Pokey_flip(b, chan, t, k, chan == hi ? &from_hi : &from_lo);
+	}
+	if (!blep_taps) {
+		Pokey_mix(b, lo, from_lo, b->n);
+		Pokey_mix(b, hi, from_hi, b->n);
+	}
+	return last;
+}
+
+static void Pokey_process_block(uint8 *buffer, int n)
+{
+	uint32 time[POKEY_BLOCK];
+	int16 mix[POKEY_BLOCK];
+	pokey_block_t b;
+	uint32 end = 0;
+	uint32 samp = Samp_n_cnt[0];
+	int chan;
+	int i;
+
+	b.time = time;
+	b.n = n;
+	b.mix = mix;
+	b.base = SAMP_MIN;
+	b.samp = samp;
+
+	/* Samp_n_cnt is 24.8; the whole part is where each sample falls */
+	for (i = 0; i < n; i++) {
+		time[i] = samp >> 8;
+		samp += Samp_n_max;
+		mix[i] = 0;
+	}
+
+	if (blep_taps) {
+		/* the level the channels are at, and register writes since the
+		   last block were heard from its end */
+		int level = SAMP_MIN;
+		for (chan = 0; chan < 4 * Num_pokeys; chan++)
+			if (Outvol[chan])
+				level += AUDV[chan];
+#ifdef VOL_ONLY_SOUND
+		level += sampout;
+#endif
+		if (!blep_started) {
+			memset(blep_buf, 0, sizeof(blep_buf));
+			blep_sum = level << BLEP_FRAC;
+			blep_level = level;
+			blep_started = TRUE;
+		}
+		else if (level != blep_level)
+			Pokey_blep_step(2 * BLEP_PHASES, level - blep_level);
+	}
+
+	for (chan = 0; chan < 4 * Num_pokeys; chan += 4) {
+		uint32 last = Pokey_pair(&b, chan + CHAN1);
+		if (last > end)
+			end = last;
+		last = Pokey_pair(&b, chan + CHAN2);
+		if (last > end)
+			end = last;
+	}
+
+	/* everything counts from the last clock again */
+	for (chan = 0; chan < 4 * Num_pokeys; chan++)
+		Div_n_cnt[chan] -= end;
+	Samp_n_cnt[0] = samp - (end << 8);
+	P4 = (P4 + end) % POLY4_SIZE;
+	P5 = (P5 + end) % POLY5_SIZE;
+	P9 = (P9 + end) % POLY9_SIZE;
+	P17 = (P17 + end) % POLY17_SIZE;
+
+#ifdef VOL_ONLY_SOUND
+	if (sampbuf_rptr != sampbuf_ptr) {
+		/* volume only writes to play back, one sample at a time */
+		for (i = 0; i < n; i++) {
+			if (sampbuf_rptr != sampbuf_ptr) {
+				int l;
+				int prev = sampout;
+				if (sampbuf_cnt[sampbuf_rptr] > 0)
+					sampbuf_cnt[sampbuf_rptr] -= 1280;
+				while ((l = sampbuf_cnt[sampbuf_rptr]) <= 0) {
+					sampout = sampbuf_val[sampbuf_rptr];
+					sampbuf_rptr++;
+					if (sampbuf_rptr >= SAMPBUF_MAX)
+						sampbuf_rptr = 0;
+					if (sampbuf_rptr != sampbuf_ptr)
+						sampbuf_cnt[sampbuf_rptr] += l;
+					else
+						break;
+				}
+				if (blep_taps && sampout != prev)
+					Pokey_blep_step((i + 2) * BLEP_PHASES, sampout - prev);
+			}
+			mix[i] += sampout;
+		}
+	}
+	else
+		b.base += sampout;
+#endif  /* VOL_ONLY_SOUND */
+
+	if (blep_taps) {
+		int32 sum = blep_sum;
+		for (i = 0; i < n; i++) {
+			int iout;
+			sum += blep_buf[i];
+			iout = (sum + (1 << (BLEP_FRAC - 1))) >> BLEP_FRAC;
+#ifdef CLIP_SOUND
+			if (iout > SAMP_MAX)
+				iout = SAMP_MAX;
+			else if (iout < SAMP_MIN)
+				iout = SAMP_MIN;
+			buffer[i] = (uint8) iout;
+#else /* CLIP_SOUND */
+			buffer[i] = (uint8) ((char) iout + 128);
+#endif /* CLIP_SOUND */
+		}
+		blep_sum = sum;
+		/* the steps reaching past the block go on in the next one */
+		memmove(blep_buf, blep_buf + n, (blep_taps + 4) * sizeof(int32));
+		memset(blep_buf + blep_taps + 4, 0, n * sizeof(int32));
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		int iout = mix[i] + b.base;
+#ifdef CLIP_SOUND
+		if (iout > SAMP_MAX)
+			iout = SAMP_MAX;
+		else if (iout < SAMP_MIN)
+			iout = SAMP_MIN;
+		buffer[i] = (uint8) iout;
+#else /* CLIP_SOUND */
+		buffer[i] = (uint8) ((char) iout + 128);	/* clipping not selected, use value */
+#endif /* CLIP_SOUND */
+	}
+}
+
+void Pokey_process(void *sndbuffer, unsigned sndn)
+{
+	uint8 *buffer = (uint8 *) sndbuffer;
+	uint16 n = sndn;
+
+	while (n) {
+		int block = n < POKEY_BLOCK ? n : POKEY_BLOCK;
+		/* a block ends before the sample counter wraps around */
+		uint32 before_wrap = (0xffffffffU - Samp_n_cnt[0]) / Samp_n_max + 1;
+		if ((uint32) block > before_wrap)
+			block = before_wrap;
+		Pokey_process_block(buffer, block);
+		buffer += block;
+		n -= block;
+	}
+#ifdef VOL_ONLY_SOUND
+	{
+		if (sampbuf_rptr == sampbuf_ptr)
+			sampbuf_last = SND_CLOCK;
+	}
+#endif  /* VOL_ONLY_SOUND */
+}
+
+#endif /* INTERPOLATE_SOUND */
+
+/*****************************************************************************/
+/* Module:  Pokey_process_frame()                                            */
+/* Purpose: To render the sound of the frame just emulated, with the timed   */
+/*          register writes queued during it spread over the frame's         */
+/*          samples as they were over its cycles.                            */
+/*                                                                           */
+/* Inputs:  *sndbuffer - where the samples will be placed                    */
+/*          sndn - the samples the frame lasts at the playback frequency     */
+/*                                                                           */
+/* Outputs: the buffer will be filled with sndn bytes of audio               */
+/*                                                                           */
+/*****************************************************************************/
+
+static void Update_pokey_sound_timed(uint16 addr, uint8 val, uint8 chip, uint8 gain)
+{
+	snd_event_t *ev;
+
+	/* can't happen in a frame of real code, but a frame's worth of
+	   writes in a loop is at most late */
+	if (snd_nevents == SND_EVENTS_MAX) {
+		Update_pokey_sound_rf(addr, val, chip, gain);
+		return;
+	}
+	ev = &snd_events[snd_nevents++];
+	ev->clock = cpu_clock;
+	ev->addr = addr;
+	ev->val = val;
+	ev->chip = chip;
+	ev->gain = gain;
+}
+
+void Pokey_set_timed(int timed)
+{
+	int i;
+
+	if (timed == snd_timed)
+		return;
+	/* what is queued takes effect now */
+	for (i = 0; i < snd_nevents; i++)
+		Update_pokey_sound_rf(snd_events[i].addr, snd_events[i].val, snd_events[i].chip,
+			snd_events[i].gain);
+	snd_nevents = 0;
+	snd_timed = timed;
+	snd_frame_clock = cpu_clock;
+	if (Update_pokey_sound != null_pokey_sound)
+		Update_pokey_sound = timed ? Update_pokey_sound_timed : Update_pokey_sound_rf;
+}
+
+void Pokey_process_frame(void *sndbuffer, unsigned int sndn)
+{
+	uint8 *buffer = (uint8 *) sndbuffer;
+	unsigned int end = cpu_clock;
+	unsigned int cycles = end - snd_frame_clock;
+	unsigned int done = 0;
+	int i;
+
+	snd_rendering = TRUE;
+	for (i = 0; i < snd_nevents; i++) {
+		snd_event_t *ev = &snd_events[i];
+		/* a frame's 36000 cycles times the samples fit */
+		unsigned int n = cycles ? (ev->clock - snd_frame_clock) * sndn / cycles : 0;
+		if (n > sndn)
+			n = sndn;
+		if (n > done) {
+			Pokey_process(buffer + done, n - done);
+			done = n;
+		}
+		snd_render_clock = ev->clock;
+		Update_pokey_sound_rf(ev->addr, ev->val, ev->chip, ev->gain);
+	}
+	snd_nevents = 0;
+	snd_frame_clock = end;
+
+	snd_render_clock = end;
+	if (sndn > done)
+		Pokey_process(buffer + done, sndn - done);
+	snd_rendering = FALSE;
+}
 
 #ifdef SERIO_SOUND
 static void Update_serio_sound_rf(int out, UBYTE data)
@@ -862,8 +1301,8 @@ static void Update_serio_sound_rf(int out, UBYTE data)
 static void Update_consol_sound_rf(int set)
 {
 #ifdef VOL_ONLY_SOUND
-	static int prev_atari_speaker = 0;
-	static unsigned int prev_cpu_clock = 0;
+	static EMU_TLS int prev_atari_speaker = 0;
+	static EMU_TLS unsigned int prev_cpu_clock = 0;
 	int d;
 	if (!console_sound_enabled)
 		return;
@@ -102,27 +102,45 @@ extern "C" {
 #define SND_BIT16	1
 #define SND_STEREO	2
 
-extern int32 snd_playback_freq;
-extern uint8 snd_num_pokeys;
+extern EMU_TLS int32 snd_playback_freq;
+extern EMU_TLS uint8 snd_num_pokeys;
 
-extern int enable_new_pokey;
-extern int stereo_enabled;
+extern EMU_TLS int enable_new_pokey;
+extern EMU_TLS int stereo_enabled;
 extern int serio_sound_enabled;
 extern int console_sound_enabled;
 
-extern void (*Pokey_process_ptr)(void *sndbuffer, unsigned int sndn);
-extern void (*Update_pokey_sound)(uint16 addr, uint8 val, uint8 /*chip*/, uint8 gain);
+extern EMU_TLS void (*Pokey_process_ptr)(void *sndbuffer, unsigned int sndn);
+extern EMU_TLS void (*Update_pokey_sound)(uint16 addr, uint8 val, uint8 /*chip*/, uint8 gain);
 extern void (*Update_serio_sound)(int out, UBYTE data);
 extern void (*Update_consol_sound)(int set);
-extern void (*Update_vol_only_sound)(void);
+extern EMU_TLS void (*Update_vol_only_sound)(void);
 
 int Pokey_sound_init(uint32 freq17, uint16 playback_freq, uint8 num_pokeys,
                      unsigned int flags
                      );
-//void Pokey_process(void *sndbuffer, unsigned int sndn);
+void Pokey_process(void *sndbuffer, unsigned int sndn);
+/* Timed register writes: the writes are queued with their cpu_clock and
+   Pokey_process_frame(), called once per emulated frame, renders sndn
+   samples for that frame with each write at the sample matching its
+   cycle. Switching them off applies what is queued. */
+void Pokey_set_timed(int timed);
+void Pokey_process_frame(void *sndbuffer, unsigned int sndn);
 int Pokey_DoInit(void);
 void Pokey_set_mzquality(int quality);
 
+/* Band-limited steps of Pokey_set_mzquality() 1 to 3: for each of
+   BLEP_PHASES positions of a step between two samples, the part of it
+   each of the next 8, 16 or 32 samples takes, in fixed point of
+   BLEP_FRAC bits (emu/bleptab.c, generated by tools/mkblep.c). */
+#define BLEP_PHASE_BITS 6
+#define BLEP_PHASES (1 << BLEP_PHASE_BITS)
+#define BLEP_QUALITIES 3
+#define BLEP_TAPS_MAX (8 << (BLEP_QUALITIES - 1))
+#define BLEP_FRAC 15
+
+extern const int32 blep_kernel[BLEP_QUALITIES][BLEP_PHASES][BLEP_TAPS_MAX + 1];
+
 #ifdef __cplusplus
 }
 
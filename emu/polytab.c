@@ -0,0 +1,1382 @@
+/* Generated by tools/mkpoly.c (make polytab), do not edit. */
+
+#include "atari.h"
+#include "pokey.h"
+
+const UBYTE poly9_lookup[65] = {
+	0xff, 0xf0, 0x0e, 0xcd, 0xf6, 0xc2, 0x19, 0x12, 0x75, 0x3d, 0xe9, 0x1c,
+	0xb8, 0xcb, 0x2b, 0x05, 0xaa, 0xbe, 0x16, 0xec, 0xb6, 0x06, 0xdd, 0xc7,
+	0xb3, 0xac, 0x63, 0xd1, 0x5f, 0x1a, 0x65, 0x0c, 0x98, 0xa9, 0xc9, 0x6f,
+	0x49, 0xf6, 0xd3, 0x0a, 0x45, 0x6e, 0x7a, 0xc3, 0x2a, 0x27, 0x8c, 0x10,
+	0x20, 0x62, 0xe2, 0x6a, 0xe3, 0x48, 0xc5, 0xe6, 0xf3, 0x68, 0xa7, 0x04,
+	0x99, 0x8b, 0xef, 0xc1, 0x3f,
+};
+
+const UBYTE poly17_lookup[16385] = {
+	0xff, 0x00, 0xf0, 0x01, 0xff, 0xf3, 0xc1, 0xf8, 0x0f, 0x0e, 0xff, 0xec,
+	0x31, 0xc7, 0x10, 0x82, 0x00, 0x0c, 0xc1, 0x08, 0x0e, 0xf1, 0x0c, 0x2d,
+	0xc9, 0xc8, 0x1e, 0x7d, 0xec, 0x3d, 0x06, 0x18, 0x8c, 0xf1, 0x00, 0xec,
+	0xc1, 0xc6, 0xef, 0x71, 0xc1, 0xf4, 0xce, 0x06, 0xf1, 0x1d, 0x3d, 0xea,
+	0xd9, 0x4a, 0x1e, 0x71, 0x2d, 0x35, 0x08, 0xe9, 0x80, 0xdc, 0xc9, 0x24,
+	0xdf, 0xbb, 0x03, 0x4c, 0xc7, 0xec, 0x42, 0xf7, 0xf1, 0xf1, 0xfc, 0x2c,
+	0x36, 0x3b, 0xdf, 0x85, 0xe3, 0x33, 0xf9, 0xf4, 0xbd, 0x36, 0x10, 0x6e,
+	0xc1, 0xca, 0x2e, 0x79, 0xcf, 0x05, 0xc2, 0x2b, 0x38, 0xd5, 0x23, 0x97,
+	0x35, 0x77, 0x18, 0x69, 0xa1, 0xc4, 0x08, 0x05, 0x41, 0x1a, 0x26, 0x55,
+	0x1e, 0x4f, 0xcd, 0x4a, 0x36, 0xf1, 0x7f, 0x1d, 0x28, 0xbb, 0xe2, 0x5d,
+	0x1b, 0x0e, 0xd7, 0x6c, 0x63, 0xef, 0x30, 0xd0, 0x62, 0x8d, 0x13, 0x22,
+	0x06, 0x26, 0x6c, 0x8e, 0x3e, 0xf4, 0x3e, 0x07, 0x0e, 0xee, 0xfc, 0x12,
+	0xd6, 0x44, 0xe1, 0x9d, 0x1c, 0xf2, 0x18, 0x6b, 0x80, 0xd0, 0x08, 0x2c,
+	0xd1, 0x4a, 0x0f, 0x61, 0x0e, 0x24, 0x5c, 0x8a, 0x1d, 0xcc, 0xfa, 0x34,
+	0xba, 0xca, 0xdf, 0x69, 0x22, 0xf5, 0x16, 0x85, 0x7c, 0xc2, 0xde, 0x68,
+	0x30, 0xd7, 0x13, 0x93, 0x16, 0x4f, 0xdc, 0x5a, 0x15, 0xe0, 0x2b, 0x7e,
+	0xb5, 0xab, 0xd1, 0x4d, 0x7e, 0x7f, 0x0b, 0x49, 0x86, 0xf6, 0x64, 0xa2,
+	0xef, 0xbe, 0x31, 0x66, 0x00, 0xca, 0xa0, 0x98, 0xcb, 0x88, 0x1b, 0xa9,
+	0xa6, 0x38, 0xc7, 0x02, 0xa2, 0x25, 0x1e, 0xa9, 0xad, 0x88, 0xd1, 0x09,
+	0x3e, 0xf3, 0x4f, 0x19, 0x0b, 0x83, 0x26, 0x6e, 0xaf, 0x2a, 0xf4, 0x17,
+	0x97, 0x5e, 0xc7, 0xc8, 0x02, 0xbd, 0xd5, 0x21, 0xb6, 0x21, 0x77, 0x31,
+	0xf9, 0xf1, 0xed, 0x3c, 0x15, 0x2a, 0x8b, 0xe6, 0x7e, 0x23, 0xca, 0xe4,
+	0xd8, 0x47, 0xcc, 0x4b, 0x24, 0xd3, 0x7a, 0x0b, 0x42, 0x36, 0xe0, 0x6f,
+	0x3e, 0x39, 0xef, 0x81, 0xc0, 0x0b, 0x3d, 0xc7, 0x09, 0x12, 0x33, 0x15,
+	0x35, 0x7b, 0xd9, 0x61, 0xaf, 0x35, 0x04, 0x28, 0x88, 0xd2, 0x38, 0x28,
+	0xf2, 0x72, 0xcb, 0x52, 0xba, 0x00, 0x7f, 0xf1, 0xe9, 0x7d, 0x0d, 0x2c,
+	0xda, 0xfa, 0x19, 0x6a, 0x92, 0xf2, 0x0d, 0x3a, 0xbb, 0xc7, 0x0d, 0x53,
+	0x2b, 0x13, 0x64, 0x67, 0xbe, 0x28, 0xf7, 0x23, 0xd1, 0x55, 0xff, 0x5e,
+	0x11, 0xa8, 0xa3, 0x6a, 0xed, 0x03, 0xe4, 0x47, 0xb6, 0xeb, 0xd7, 0xa9,
+	0x32, 0x79, 0xf6, 0x95, 0xb3, 0x12, 0x4c, 0xe4, 0xdc, 0x06, 0xd4, 0x4d,
+	0x75, 0xcf, 0x1d, 0x42, 0x1a, 0x20, 0x35, 0x12, 0x49, 0xb5, 0xc6, 0x01,
+	0x91, 0x13, 0x1b, 0x96, 0x57, 0x55, 0xfa, 0x0f, 0x0b, 0xaf, 0xe6, 0x34,
+	0x83, 0x5a, 0xae, 0x50, 0x56, 0xc4, 0xe9, 0x14, 0x9d, 0xf8, 0xb3, 0xce,
+	0x8c, 0x51, 0x01, 0xb6, 0x62, 0x47, 0xb3, 0xba, 0xcd, 0xae, 0x77, 0x27,
+	0x98, 0xcc, 0xf9, 0x05, 0xac, 0xcb, 0xe2, 0xbb, 0x7b, 0xcc, 0x30, 0x94,
+	0x22, 0x01, 0x57, 0x72, 0x8b, 0x53, 0x2e, 0x42, 0x7e, 0x60, 0xfb, 0x76,
+	0x99, 0x7a, 0x9b, 0x42, 0x1f, 0x71, 0x2f, 0x15, 0x0c, 0xeb, 0xa8, 0x58,
+	0xdb, 0x04, 0xfb, 0xb9, 0x69, 0xe8, 0x55, 0x8e, 0x4e, 0xf4, 0xd9, 0x77,
+	0xce, 0x08, 0x10, 0x11, 0x31, 0x33, 0x51, 0x75, 0xf7, 0x9d, 0x31, 0x22,
+	0x40, 0x46, 0xe4, 0xc8, 0x46, 0xfd, 0x59, 0x65, 0xe6, 0xac, 0x02, 0x73,
+	0x35, 0xb1, 0x79, 0xf9, 0x64, 0xbd, 0x1f, 0x81, 0x2e, 0xea, 0xff, 0x2a,
+	0x50, 0x57, 0xd5, 0xfb, 0x17, 0x88, 0xae, 0xf8, 0xd7, 0x8e, 0x42, 0x35,
+	0xd1, 0x79, 0x3f, 0x04, 0x3d, 0xd8, 0xf9, 0x2d, 0x2c, 0x99, 0xca, 0x9b,
+	0x29, 0xae, 0xb1, 0x46, 0x08, 0x09, 0x80, 0x12, 0x28, 0xa4, 0x12, 0x62,
+	0x04, 0x82, 0x28, 0x8c, 0x93, 0x20, 0x2e, 0xa3, 0x6e, 0xac, 0x1b, 0xe2,
+	0x16, 0xaa, 0x8c, 0x9e, 0xf1, 0x24, 0xac, 0x8b, 0xe2, 0x3f, 0x3b, 0xcc,
+	0xb5, 0xc4, 0x20, 0x85, 0x13, 0x32, 0x06, 0x07, 0x7c, 0xce, 0x1f, 0x60,
+	0x3e, 0x26, 0x1f, 0xbe, 0xdf, 0x87, 0xc2, 0x27, 0xf9, 0xdd, 0x2d, 0x66,
+	0x39, 0x5a, 0xd1, 0xa1, 0xbf, 0xb9, 0xe4, 0x38, 0x47, 0x02, 0xaa, 0xa4,
+	0x1e, 0xa3, 0x0c, 0x8c, 0xd9, 0x80, 0xbe, 0xe9, 0xe6, 0xbd, 0x13, 0x40,
+	0x26, 0xe4, 0x0e, 0x26, 0x7d, 0x9e, 0x1d, 0xe5, 0x6a, 0x64, 0x93, 0xfe,
+	0xcf, 0x02, 0xb3, 0x35, 0x3d, 0xb8, 0xf9, 0xeb, 0x4c, 0x19, 0x0d, 0xe3,
+	0x2a, 0x68, 0xd7, 0xa6, 0xc3, 0x77, 0xfb, 0x58, 0x79, 0x24, 0xb5, 0x1a,
+	0xc1, 0x24, 0xce, 0xab, 0x20, 0x5d, 0x93, 0x8f, 0xdf, 0xe7, 0xc2, 0xe1,
+	0x99, 0x5d, 0xea, 0x1e, 0x3a, 0x9c, 0xb7, 0x41, 0x74, 0xc7, 0x9f, 0x72,
+	0x16, 0x82, 0x0d, 0xdc, 0xdb, 0x05, 0xea, 0xab, 0x6a, 0xfd, 0x03, 0xc5,
+	0x57, 0xf6, 0xca, 0x43, 0xa9, 0x13, 0x68, 0xa6, 0xb6, 0x26, 0x06, 0x2f,
+	0xfc, 0x9c, 0x37, 0x40, 0x6c, 0x44, 0x9e, 0x6c, 0xf5, 0x8f, 0x15, 0x47,
+	0x5a, 0x2a, 0x11, 0x46, 0x43, 0xb8, 0x02, 0x5b, 0xb5, 0xe3, 0x51, 0xd9,
+	0x36, 0xdf, 0x9e, 0x53, 0x04, 0xe2, 0x28, 0x4a, 0xf3, 0xa0, 0xe9, 0xdb,
+	0x6d, 0x6a, 0x7d, 0x02, 0xdd, 0xd4, 0xf7, 0xd4, 0xa0, 0xa4, 0x0b, 0xf3,
+	0x27, 0x99, 0xdd, 0xeb, 0x06, 0xb9, 0x9d, 0xa9, 0xa2, 0x79, 0xdf, 0x04,
+	0xf3, 0x39, 0x79, 0xe0, 0xf5, 0x9e, 0x04, 0x74, 0x49, 0x7f, 0x66, 0x99,
+	0x5a, 0x9b, 0x00, 0x3f, 0xf1, 0x6d, 0x3d, 0x0d, 0xa9, 0x8a, 0xf8, 0x9d,
+	0x2e, 0xd2, 0x7f, 0x59, 0x68, 0x37, 0xa6, 0x0d, 0x96, 0x7b, 0x95, 0xa0,
+	0x23, 0x7b, 0xf5, 0xa1, 0xf5, 0x19, 0x74, 0x72, 0xcf, 0x13, 0xa2, 0x06,
+	0x2e, 0xed, 0x8e, 0x34, 0x55, 0x3a, 0x0f, 0x87, 0x6e, 0xe6, 0xbb, 0x72,
+	0x5c, 0x22, 0x9d, 0x96, 0x53, 0x14, 0xe2, 0x09, 0x5a, 0xb3, 0x81, 0x7d,
+	0xdb, 0x4c, 0x7b, 0x2d, 0x21, 0x48, 0xc0, 0x94, 0xcc, 0xe0, 0x95, 0x9f,
+	0xd2, 0x16, 0xc8, 0xac, 0x5c, 0x93, 0x8c, 0xef, 0xe1, 0xc1, 0xdd, 0x5f,
+	0x46, 0xda, 0x28, 0x39, 0xc3, 0x41, 0x9a, 0x27, 0x4d, 0x9d, 0x4e, 0xd3,
+	0xa9, 0x3b, 0xe9, 0xe4, 0x9c, 0x07, 0x40, 0x0f, 0x74, 0x5e, 0x0f, 0x49,
+	0x8e, 0x76, 0x74, 0xaa, 0x4f, 0xae, 0x7b, 0xe6, 0x90, 0xc2, 0x08, 0x09,
+	0x81, 0x02, 0x2a, 0xa5, 0x06, 0x20, 0x0d, 0x92, 0x3a, 0x8d, 0xa6, 0x72,
+	0x67, 0x92, 0xe8, 0xad, 0x0f, 0xa1, 0x0f, 0xb8, 0x9f, 0x8b, 0x86, 0x7f,
+	0xf5, 0xa8, 0x65, 0x0b, 0x7d, 0xc6, 0x9d, 0x50, 0x32, 0x84, 0x27, 0x70,
+	0x4d, 0x37, 0xee, 0x8d, 0x02, 0x33, 0x35, 0x35, 0x39, 0xf9, 0xe1, 0xed,
+	0x1d, 0x05, 0x6a, 0xaa, 0x72, 0x7e, 0x02, 0xdb, 0xb4, 0xfb, 0xd2, 0xd8,
+	0x28, 0x3c, 0x93, 0x4b, 0x9f, 0x63, 0x07, 0xb1, 0x1e, 0x89, 0xac, 0xda,
+	0xf3, 0x88, 0x68, 0x99, 0x47, 0x4b, 0x3b, 0x22, 0x55, 0x16, 0xcf, 0xdd,
+	0x42, 0x96, 0xe1, 0x35, 0x9d, 0xb8, 0xb3, 0x4a, 0xcc, 0x51, 0x84, 0xe6,
+	0x60, 0xc3, 0xf7, 0xfa, 0x40, 0xfa, 0x25, 0xab, 0xf9, 0xcc, 0x3c, 0x55,
+	0x2a, 0x0f, 0xa6, 0x7e, 0xa6, 0x9a, 0xe6, 0x5c, 0x03, 0x8c, 0xc6, 0x70,
+	0x81, 0xf6, 0x6a, 0x42, 0xf3, 0xb0, 0xe9, 0xfa, 0x7d, 0x2a, 0x5c, 0x96,
+	0xdd, 0xf5, 0xe6, 0x84, 0x83, 0x31, 0x1f, 0x90, 0x3f, 0xd9, 0xec, 0x7f,
+	0x27, 0x88, 0xcc, 0xd8, 0x15, 0xec, 0xea, 0x76, 0xbb, 0x5a, 0xdd, 0x60,
+	0xb7, 0xb7, 0x15, 0x34, 0x6a, 0xcb, 0x62, 0xba, 0x63, 0x4f, 0x31, 0x8a,
+	0xc1, 0x0c, 0x4f, 0xe9, 0x0a, 0x7c, 0xd5, 0xaf, 0x57, 0x25, 0xfa, 0xe8,
+	0x7b, 0x6f, 0x00, 0xd8, 0x80, 0xbd, 0xd9, 0xe0, 0xbe, 0x2f, 0x86, 0x3d,
+	0xd4, 0x38, 0x25, 0x22, 0x68, 0xc6, 0xb6, 0xe0, 0x66, 0xaf, 0x3b, 0xe4,
+	0x34, 0x86, 0x0a, 0xa4, 0x55, 0x12, 0x8e, 0xc5, 0x44, 0xc7, 0xfd, 0x52,
+	0xd4, 0xe0, 0xa5, 0x9f, 0xb1, 0x26, 0x08, 0xcf, 0xe0, 0x92, 0xef, 0xdc,
+	0x11, 0xa4, 0x62, 0x62, 0xe3, 0xf2, 0xe8, 0x6a, 0x7f, 0x23, 0xc9, 0xd4,
+	0xde, 0x44, 0xf0, 0x8d, 0x3f, 0xe3, 0x4c, 0x08, 0x1d, 0xc0, 0x3b, 0x3c,
+	0xb4, 0x3b, 0xd3, 0x44, 0xeb, 0x3d, 0x08, 0xf8, 0x90, 0xff, 0xd8, 0x70,
+	0xbc, 0x26, 0x13, 0x7f, 0xd7, 0x89, 0x33, 0x2b, 0xd4, 0x14, 0xe5, 0x78,
+	0x44, 0xb6, 0xec, 0xa7, 0xa7, 0x35, 0x15, 0x38, 0xab, 0xc3, 0x6c, 0x4b,
+	0x6f, 0x62, 0xf8, 0x42, 0xdf, 0x71, 0xa3, 0xd4, 0x0c, 0x64, 0x59, 0x5e,
+	0x57, 0xc9, 0x3b, 0x2e, 0x94, 0x1e, 0xc1, 0x2c, 0x4e, 0xbb, 0x28, 0xfd,
+	0x83, 0xc5, 0x5f, 0x77, 0xca, 0x49, 0x08, 0x17, 0x60, 0x2f, 0x36, 0x3c,
+	0xaf, 0x8b, 0xe4, 0x5f, 0x37, 0xca, 0xcd, 0x48, 0x17, 0xe5, 0x7f, 0x34,
+	0xb8, 0xeb, 0xcb, 0x69, 0x0b, 0x65, 0x46, 0xac, 0x48, 0xd2, 0xb5, 0xf9,
+	0xf0, 0xfc, 0x2e, 0x16, 0x3f, 0xdd, 0xad, 0x67, 0x21, 0xd9, 0xd0, 0xbf,
+	0x5c, 0xb4, 0xfc, 0xa3, 0xc6, 0x2d, 0x51, 0x49, 0x37, 0xe6, 0x0d, 0x12,
+	0x3b, 0x95, 0x25, 0x73, 0x79, 0x71, 0xe5, 0xb5, 0x94, 0x20, 0x20, 0x43,
+	0x72, 0xa2, 0xc3, 0x7e, 0x6b, 0x4a, 0x70, 0x90, 0xe7, 0x59, 0x51, 0xa6,
+	0xc7, 0x36, 0xe3, 0x5e, 0x28, 0x38, 0xd2, 0x53, 0x99, 0x32, 0x1b, 0xd6,
+	0x57, 0xd1, 0xba, 0x0f, 0x8e, 0xff, 0xe4, 0xb0, 0xc7, 0x1a, 0x23, 0x04,
+	0x04, 0x48, 0x88, 0x14, 0x58, 0xa8, 0x35, 0x0a, 0xc8, 0x94, 0xdc, 0xe0,
+	0xb4, 0x8f, 0x92, 0x37, 0x5c, 0xac, 0x7d, 0x82, 0xdc, 0xcc, 0x74, 0xd5,
+	0xbe, 0x47, 0x06, 0xeb, 0xbc, 0x18, 0xf2, 0x10, 0xeb, 0x90, 0xd8, 0xa8,
+	0x3c, 0x9b, 0xca, 0x9f, 0x69, 0xa6, 0xb5, 0x16, 0x00, 0x2c, 0xc0, 0x5a,
+	0x2c, 0x70, 0x5a, 0x47, 0xc1, 0x9a, 0x2e, 0xdc, 0x9f, 0x45, 0x66, 0xef,
+	0x3a, 0x70, 0x76, 0x87, 0x9b, 0xb6, 0x5e, 0x86, 0xd8, 0x84, 0xfc, 0xc1,
+	0xe6, 0xef, 0x33, 0xe1, 0x74, 0x8c, 0x2e, 0xf0, 0x5f, 0x1f, 0x4a, 0x9f,
+	0x60, 0x37, 0xb7, 0x1d, 0xb5, 0x6a, 0xc1, 0xc3, 0xbe, 0x6b, 0xc6, 0xb1,
+	0x90, 0x68, 0xa8, 0x57, 0x2a, 0x0a, 0xf6, 0x74, 0xa3, 0xde, 0xac, 0x70,
+	0x53, 0xd6, 0xc3, 0x91, 0x9b, 0x9a, 0x9e, 0xdc, 0xf4, 0xf4, 0xa6, 0x86,
+	0x27, 0x75, 0x1d, 0x3d, 0xeb, 0xc9, 0x48, 0x1f, 0x65, 0x6f, 0x3c, 0x18,
+	0xfb, 0x81, 0xe9, 0x9b, 0x6d, 0xee, 0x3d, 0x02, 0x58, 0x84, 0xf5, 0x50,
+	0xe4, 0xe4, 0x86, 0xa7, 0x75, 0x15, 0xbc, 0xeb, 0xc3, 0xe9, 0x1b, 0x6d,
+	0xe6, 0xbc, 0x02, 0x52, 0x25, 0xf1, 0x58, 0x6d, 0x64, 0x9c, 0x0e, 0xd1,
+	0x0d, 0x7f, 0xeb, 0x49, 0x48, 0x17, 0xe4, 0x6f, 0x36, 0xb9, 0xff, 0x89,
+	0x60, 0x1b, 0x77, 0x47, 0x99, 0x1a, 0x9b, 0x84, 0x7f, 0xf1, 0xe8, 0x6d,
+	0x0f, 0x2d, 0xce, 0xb8, 0x10, 0x7a, 0x80, 0xf3, 0x38, 0x68, 0xf2, 0xf6,
+	0x8b, 0x52, 0x3f, 0x50, 0x7d, 0x75, 0xad, 0x3d, 0x80, 0x78, 0x88, 0x76,
+	0x78, 0x6a, 0x57, 0xa2, 0x8b, 0xfe, 0xff, 0x02, 0xd0, 0x05, 0xfd, 0xdb,
+	0x45, 0xea, 0x2f, 0x2a, 0xfd, 0x86, 0x95, 0x55, 0x72, 0x8e, 0x03, 0x24,
+	0x47, 0x3a, 0x2a, 0xd7, 0x26, 0xc3, 0x7f, 0x7a, 0x58, 0x73, 0x85, 0xb1,
+	0x12, 0x48, 0xa4, 0xd4, 0x02, 0x84, 0x45, 0x50, 0x8f, 0x55, 0x46, 0xce,
+	0x68, 0x10, 0xd7, 0x51, 0xb3, 0x96, 0x0d, 0xf4, 0x5b, 0x57, 0xc2, 0x8b,
+	0x38, 0x9f, 0x82, 0x17, 0x7d, 0xfe, 0x1d, 0x23, 0x0a, 0xe4, 0x54, 0x86,
+	0xcc, 0xc4, 0xd5, 0xd5, 0xf6, 0xc6, 0x82, 0xa1, 0x1d, 0x99, 0xaa, 0x9b,
+	0xef, 0xce, 0x31, 0x81, 0x70, 0x0a, 0x46, 0x74, 0xc8, 0x6f, 0x6c, 0x19,
+	0x4e, 0xd3, 0xa8, 0x2b, 0xeb, 0xe5, 0x88, 0x45, 0x49, 0x1f, 0x66, 0x5f,
+	0x3a, 0x1b, 0xc7, 0x47, 0xf2, 0xab, 0x5b, 0xed, 0x62, 0xf4, 0x83, 0xd7,
+	0x7f, 0x52, 0xd8, 0x21, 0xad, 0x91, 0x40, 0x2a, 0x25, 0x06, 0x28, 0x8c,
+	0x92, 0x30, 0x2c, 0xa2, 0x7a, 0xee, 0x12, 0xf2, 0x04, 0xab, 0xb9, 0xcc,
+	0xb8, 0x15, 0x2a, 0x8a, 0xf6, 0x7c, 0x22, 0xde, 0xa6, 0xd1, 0x57, 0xde,
+	0x4a, 0x11, 0x81, 0x33, 0x3a, 0xc4, 0x37, 0xf4, 0x2c, 0x27, 0x2b, 0xfc,
+	0x94, 0xb7, 0x50, 0x64, 0xe4, 0x8e, 0x26, 0x75, 0x1f, 0x1d, 0xef, 0xcb,
+	0x60, 0x9b, 0x77, 0x4f, 0x18, 0x1a, 0x91, 0x25, 0x7b, 0xf9, 0x61, 0xed,
+	0x15, 0x84, 0x6a, 0xa0, 0xd3, 0x7a, 0x0a, 0x52, 0x34, 0xe1, 0x7b, 0x7c,
+	0x30, 0xff, 0x93, 0xc1, 0x3e, 0x6f, 0x8e, 0x38, 0x94, 0x32, 0x01, 0x76,
+	0x62, 0xcb, 0x72, 0xba, 0x42, 0x5f, 0x71, 0xab, 0x55, 0x0c, 0x6e, 0xf8,
+	0x5a, 0x5f, 0x40, 0xbb, 0x34, 0x3d, 0xba, 0xd9, 0xef, 0x4e, 0x31, 0x89,
+	0xf1, 0x0a, 0x4c, 0xd5, 0xcc, 0x67, 0xe5, 0x99, 0x54, 0x7a, 0x0c, 0x33,
+	0x28, 0xe5, 0x02, 0xe4, 0x45, 0x96, 0xef, 0xd5, 0x81, 0xb6, 0x6b, 0xd6,
+	0xb1, 0xb1, 0x78, 0xe8, 0x76, 0xbe, 0x0a, 0xd7, 0x65, 0xf3, 0xfd, 0x39,
+	0x64, 0x30, 0xce, 0x83, 0xa0, 0x0f, 0xbb, 0xaf, 0x8d, 0x85, 0x43, 0x33,
+	0xb3, 0x55, 0x3d, 0x7e, 0x99, 0x6b, 0x8b, 0x61, 0x0e, 0x25, 0x4c, 0x88,
+	0x1c, 0xd8, 0xb8, 0x3d, 0xaa, 0xd8, 0xde, 0x5c, 0x70, 0xbc, 0x27, 0x03,
+	0x7d, 0xd6, 0x9d, 0x71, 0x22, 0xc4, 0x06, 0xe4, 0x4d, 0x16, 0xff, 0xdd,
+	0x21, 0xa6, 0x21, 0x56, 0x21, 0xb9, 0xd0, 0x79, 0x3c, 0x34, 0x3b, 0xdb,
+	0xc5, 0xeb, 0x37, 0xa9, 0xfc, 0x98, 0x76, 0x58, 0x6a, 0x15, 0x82, 0x0b,
+	0xbc, 0xd7, 0x03, 0x92, 0x27, 0x5d, 0x9d, 0x6f, 0xc3, 0xe9, 0x1a, 0x7d,
+	0xe4, 0xbd, 0x16, 0x10, 0x2c, 0xe1, 0x4a, 0x6c, 0x51, 0xce, 0x47, 0xe0,
+	0x8b, 0x7e, 0xff, 0x0a, 0x51, 0x05, 0xf7, 0x7a, 0x41, 0xe2, 0xa6, 0xaa,
+	0xe7, 0x2f, 0x31, 0x4d, 0xb1, 0x8e, 0x89, 0x85, 0x4b, 0xb3, 0xa3, 0x5d,
+	0x9d, 0x6e, 0xd3, 0xeb, 0x1b, 0x69, 0xa6, 0xb4, 0x06, 0x02, 0x2d, 0xd4,
+	0x18, 0x25, 0x60, 0x48, 0x46, 0xf4, 0xc8, 0x67, 0xed, 0x19, 0x44, 0x72,
+	0xac, 0x23, 0x62, 0x65, 0x92, 0xec, 0xed, 0x07, 0xa5, 0x5f, 0xb0, 0xba,
+	0xcb, 0xce, 0x7b, 0x21, 0xe0, 0x40, 0xce, 0x65, 0xc0, 0xcd, 0x5c, 0x57,
+	0xcc, 0x6b, 0x24, 0x91, 0x5a, 0x8b, 0x00, 0x1e, 0xe1, 0x2d, 0x1c, 0x99,
+	0xa9, 0xab, 0xe9, 0xcd, 0x0d, 0x47, 0x6b, 0x3a, 0x70, 0x77, 0x97, 0x99,
+	0xb7, 0x4a, 0xc4, 0xd1, 0x94, 0xee, 0xc0, 0xd3, 0xbd, 0x7a, 0xd0, 0xf2,
+	0x8d, 0x3a, 0xb3, 0x46, 0x0d, 0x59, 0x8a, 0x17, 0x6c, 0xee, 0x3e, 0x32,
+	0x5e, 0x87, 0xc9, 0x96, 0xff, 0xd4, 0xb0, 0xa4, 0x2a, 0xe3, 0x67, 0xb8,
+	0x49, 0xeb, 0x27, 0xa8, 0xcd, 0x8a, 0x37, 0x6d, 0xbc, 0x1c, 0xb3, 0x08,
+	0xed, 0xc1, 0xc4, 0xcf, 0x75, 0xc3, 0xdc, 0x4a, 0x14, 0xd1, 0x39, 0x3f,
+	0x80, 0x7d, 0xd8, 0x7c, 0x7d, 0x2e, 0x1d, 0x8e, 0xdb, 0xa4, 0xfa, 0xe3,
+	0xca, 0x69, 0x09, 0x45, 0x42, 0xae, 0x60, 0x56, 0xa7, 0xd9, 0xd4, 0xfe,
+	0x44, 0xb2, 0xad, 0xbf, 0xa1, 0x64, 0x09, 0x5f, 0xe2, 0x9b, 0x7a, 0x9e,
+	0x12, 0x15, 0x74, 0x6b, 0x5f, 0x20, 0xbb, 0xf2, 0x5d, 0x3a, 0x1e, 0x97,
+	0x4d, 0xf7, 0xef, 0x11, 0xc1, 0x32, 0xae, 0x86, 0x36, 0x65, 0x3e, 0x2c,
+	0xbf, 0xaa, 0xd5, 0x0f, 0x56, 0x7f, 0x59, 0x69, 0x27, 0xa4, 0x0c, 0x82,
+	0x39, 0x9c, 0xb0, 0x31, 0x7a, 0xc0, 0xf3, 0xbc, 0x28, 0xf2, 0x73, 0xdb,
+	0x50, 0xbb, 0x14, 0x3d, 0xf8, 0xf9, 0x6f, 0x0c, 0x19, 0x88, 0xb3, 0x28,
+	0xec, 0x93, 0xe6, 0x4e, 0x23, 0xa9, 0xd4, 0x18, 0x24, 0x70, 0x4a, 0x47,
+	0xe0, 0x8a, 0x6e, 0xfd, 0x0b, 0x45, 0x47, 0xfe, 0x6a, 0x53, 0xe3, 0x93,
+	0xf8, 0xae, 0x1e, 0xb7, 0x4c, 0xa5, 0xcd, 0x90, 0x97, 0x58, 0xa6, 0xd4,
+	0x06, 0xc4, 0x4d, 0x54, 0xdf, 0x5d, 0x63, 0x8e, 0x20, 0x14, 0x03, 0x19,
+	0x96, 0x53, 0x15, 0xf2, 0x0b, 0x5b, 0xa7, 0xc3, 0x74, 0xcb, 0x5e, 0x7a,
+	0x18, 0x73, 0x01, 0xf1, 0x12, 0xcd, 0xf4, 0xd6, 0x86, 0xc0, 0x05, 0xdd,
+	0xdb, 0x07, 0xca, 0xaf, 0x68, 0xd5, 0x87, 0xd7, 0x77, 0xd2, 0xc8, 0x29,
+	0x0d, 0x81, 0x0a, 0xaa, 0xb5, 0x0e, 0x80, 0x1d, 0xd8, 0xba, 0x1d, 0xae,
+	0xda, 0xf6, 0xd8, 0x62, 0x9c, 0x03, 0x01, 0x17, 0x72, 0x0f, 0x13, 0x2e,
+	0xc7, 0x2e, 0x62, 0x7f, 0x32, 0xd9, 0xf7, 0xcf, 0x10, 0x93, 0x10, 0x2f,
+	0xd0, 0x5c, 0x6d, 0x6c, 0x1c, 0x1e, 0xd9, 0xad, 0x6f, 0xa1, 0xc9, 0xd8,
+	0x1f, 0x4c, 0xfe, 0x7c, 0x33, 0xce, 0x85, 0xc0, 0x03, 0xbd, 0xd7, 0x01,
+	0xb2, 0x23, 0x5f, 0xb5, 0xeb, 0xd1, 0xc9, 0x3e, 0x7f, 0x8e, 0x19, 0x84,
+	0x72, 0x20, 0xe2, 0x62, 0xea, 0x63, 0xea, 0x61, 0xca, 0x65, 0xc8, 0x4d,
+	0x4c, 0x5f, 0x6c, 0x7b, 0x6e, 0x11, 0xca, 0x83, 0xa8, 0x8f, 0xab, 0xa7,
+	0x2d, 0x95, 0x09, 0xb3, 0x23, 0x5d, 0x95, 0xef, 0xd3, 0xe1, 0xba, 0x6d,
+	0xae, 0x3d, 0x86, 0x18, 0x84, 0x70, 0x00, 0xe6, 0x60, 0xc2, 0xe7, 0xf8,
+	0x41, 0xee, 0x67, 0xa2, 0xe9, 0xde, 0x3d, 0x60, 0x78, 0x46, 0x97, 0xf8,
+	0xa7, 0x8e, 0xa5, 0x45, 0x11, 0x9f, 0xd3, 0x07, 0xda, 0xaf, 0x49, 0xc5,
+	0xc7, 0xf6, 0xe3, 0xd2, 0xe9, 0x38, 0x5d, 0xa2, 0x9f, 0xbe, 0xd6, 0x16,
+	0xc0, 0x2c, 0x4c, 0x9b, 0x2c, 0xff, 0xab, 0x41, 0x4d, 0x57, 0xee, 0x4b,
+	0x62, 0xb3, 0xf2, 0x4d, 0x3a, 0x3f, 0x87, 0x0d, 0xd6, 0x7b, 0x11, 0xe0,
+	0x23, 0xfe, 0xa5, 0xa3, 0x71, 0x5d, 0x34, 0xff, 0x9b, 0x41, 0x2e, 0x67,
+	0x2e, 0x28, 0xde, 0xb2, 0x91, 0x7e, 0xca, 0x5a, 0x38, 0x30, 0x73, 0x53,
+	0xd1, 0xb3, 0x9f, 0x9c, 0xf6, 0x50, 0xe2, 0x84, 0x8a, 0xa1, 0x0d, 0x99,
+	0x8b, 0x8b, 0xaf, 0xef, 0xa5, 0x81, 0x51, 0x1b, 0x16, 0x57, 0x5d, 0x7b,
+	0x0f, 0x01, 0x0e, 0xe2, 0x3c, 0x0a, 0xda, 0xb4, 0xf9, 0xf2, 0xdc, 0x2a,
+	0x14, 0x17, 0x59, 0xbf, 0x47, 0x05, 0xdb, 0xba, 0x1b, 0xce, 0xd6, 0xf0,
+	0xa0, 0xee, 0xab, 0x63, 0x6d, 0x11, 0xcc, 0xe3, 0xa4, 0x89, 0xd3, 0x2b,
+	0x1a, 0xf5, 0x65, 0xb5, 0x9d, 0xb1, 0x22, 0x48, 0xc7, 0xe4, 0xc2, 0xe7,
+	0xf9, 0x51, 0xec, 0x66, 0xb6, 0xab, 0xd7, 0x2d, 0x72, 0x79, 0x73, 0xc5,
+	0xb1, 0x96, 0x08, 0xa4, 0x51, 0x52, 0x86, 0xc1, 0x14, 0xcf, 0xd8, 0x12,
+	0x9c, 0xe4, 0x71, 0xd7, 0x94, 0xe3, 0x10, 0xc9, 0xb0, 0x9e, 0x8a, 0x94,
+	0x5d, 0xf0, 0xbe, 0x0f, 0x86, 0x7f, 0xf4, 0xb8, 0x67, 0x0a, 0x69, 0x84,
+	0x94, 0x40, 0x20, 0x85, 0x12, 0x22, 0x04, 0x06, 0x68, 0x8c, 0x16, 0x70,
+	0x2c, 0x27, 0x2a, 0xec, 0x96, 0xb6, 0x44, 0x26, 0xed, 0x9e, 0x34, 0x74,
+	0x2a, 0x4f, 0xa6, 0xfa, 0xe6, 0x9a, 0x63, 0x0c, 0x01, 0x08, 0x82, 0x30,
+	0x0c, 0xa2, 0x38, 0xce, 0x92, 0xb0, 0x2c, 0xaa, 0xfb, 0xee, 0x18, 0x53,
+	0x00, 0xa3, 0x30, 0x4c, 0xa2, 0xbc, 0x8e, 0x92, 0x35, 0x7c, 0xa8, 0x7f,
+	0xaa, 0x58, 0xde, 0x54, 0xf1, 0xbc, 0x2d, 0xa2, 0x79, 0xde, 0x14, 0xf1,
+	0x38, 0x6d, 0xa2, 0xfc, 0x8e, 0x16, 0x75, 0x7c, 0x2d, 0x2f, 0xa8, 0xdc,
+	0x9a, 0x14, 0x7c, 0xe8, 0x7f, 0x2e, 0x18, 0xde, 0xd1, 0xa1, 0xbe, 0xa9,
+	0xe6, 0x39, 0x53, 0x40, 0xa3, 0xb4, 0x0c, 0xa2, 0x39, 0xde, 0x90, 0xb1,
+	0x38, 0xe8, 0xf2, 0xfe, 0x0a, 0x52, 0x35, 0xf1, 0x79, 0x7d, 0x24, 0xbd,
+	0x9a, 0xd1, 0x2c, 0x6e, 0xbb, 0x6a, 0xdd, 0x03, 0x87, 0x77, 0x76, 0x88,
+	0x6b, 0xa8, 0x51, 0x4a, 0x06, 0xf0, 0x0c, 0x2f, 0xe9, 0xcc, 0x1c, 0x55,
+	0x68, 0x2f, 0x26, 0x3c, 0x8e, 0x9b, 0xa4, 0x7e, 0xa3, 0xca, 0xec, 0x59,
+	0x47, 0xc6, 0xea, 0x20, 0xdb, 0xf3, 0x8b, 0x58, 0x9f, 0x44, 0x77, 0xfd,
+	0x39, 0x65, 0x20, 0xcc, 0x82, 0xb4, 0x4d, 0xb2, 0xbf, 0x9f, 0x84, 0x76,
+	0x61, 0xfa, 0x64, 0xbb, 0x7f, 0x8d, 0x28, 0x92, 0x73, 0x1d, 0x30, 0x3b,
+	0xd3, 0x45, 0xfb, 0x3f, 0x09, 0xec, 0xd2, 0xf6, 0xc8, 0x62, 0xbd, 0x13,
+	0x41, 0x36, 0xe6, 0x0f, 0x32, 0x3f, 0x97, 0x0d, 0xf7, 0x6b, 0x51, 0xc1,
+	0xb7, 0xfe, 0x84, 0xb2, 0x21, 0x7e, 0xa1, 0xeb, 0xf8, 0x59, 0x6e, 0x56,
+	0xba, 0x09, 0xef, 0xe3, 0xe0, 0xc9, 0x5f, 0x6f, 0x4a, 0x78, 0x10, 0xf7,
+	0x51, 0xf1, 0xb6, 0x8d, 0xb6, 0x73, 0x56, 0x80, 0xa9, 0x98, 0xd9, 0xa8,
+	0x3e, 0xbb, 0xce, 0x9d, 0x41, 0x22, 0xa7, 0x36, 0x24, 0x2e, 0xaa, 0xfe,
+	0xbe, 0x12, 0x56, 0x44, 0xe9, 0x1c, 0x1c, 0xf8, 0xb9, 0x6f, 0x88, 0x59,
+	0x88, 0x36, 0x78, 0xee, 0x17, 0xa2, 0x0e, 0xae, 0xfd, 0x86, 0x94, 0x45,
+	0x70, 0x8f, 0x17, 0x66, 0x4e, 0x2a, 0x38, 0xd6, 0x13, 0x91, 0x36, 0x4b,
+	0xde, 0x72, 0x91, 0xf2, 0x0b, 0x5a, 0xb7, 0xc1, 0x75, 0xdf, 0x1c, 0x73,
+	0x08, 0x61, 0x00, 0xc4, 0x40, 0x84, 0xc5, 0x50, 0x87, 0xd4, 0x46, 0xc4,
+	0xc9, 0x14, 0xdf, 0xd8, 0x33, 0x8c, 0xa4, 0x50, 0x43, 0x94, 0xc2, 0x01,
+	0x99, 0x93, 0x0b, 0x9e, 0xf7, 0x45, 0xb0, 0x8f, 0x9b, 0xa7, 0x4e, 0xa5,
+	0xc9, 0xd0, 0x9f, 0x5c, 0xf6, 0xdc, 0x23, 0x84, 0x05, 0x50, 0x0b, 0x15,
+	0x46, 0x4b, 0x38, 0x12, 0x53, 0x15, 0xf3, 0x1b, 0x59, 0xa6, 0xd7, 0x36,
+	0xc2, 0x4e, 0x68, 0x19, 0x46, 0x53, 0xb8, 0x23, 0x4b, 0xf5, 0xc2, 0xc5,
+	0xd9, 0x17, 0xce, 0xce, 0x70, 0x91, 0xf6, 0x4b, 0x52, 0xb3, 0x91, 0x7d,
+	0xfa, 0x5c, 0x3b, 0x0c, 0xb5, 0x48, 0xe1, 0x85, 0x9c, 0xc3, 0x00, 0x8b,
+	0xb1, 0x0e, 0x88, 0x9d, 0xc8, 0xb2, 0xbd, 0xbe, 0x90, 0x76, 0x48, 0x6a,
+	0x34, 0x92, 0x4b, 0x9d, 0x43, 0x03, 0xb3, 0x36, 0x0d, 0xbe, 0xfa, 0xd7,
+	0x8a, 0x02, 0x3d, 0xd5, 0x29, 0x37, 0x21, 0x7d, 0x90, 0xfd, 0xf9, 0x64,
+	0xbc, 0x0f, 0x83, 0x2f, 0xfe, 0xbd, 0x23, 0x40, 0x45, 0xd4, 0xce, 0x45,
+	0xc1, 0x9f, 0x7e, 0xd6, 0x9a, 0x01, 0x2c, 0xc3, 0x6a, 0x2a, 0x73, 0x66,
+	0x81, 0xda, 0xaa, 0x18, 0xdf, 0xc0, 0xb3, 0xbd, 0xbc, 0xb0, 0x72, 0x4a,
+	0x42, 0xb0, 0x80, 0x6b, 0xb9, 0x41, 0x69, 0x17, 0xa4, 0x6f, 0xb2, 0xf9,
+	0xff, 0x0c, 0x30, 0x19, 0xf3, 0x03, 0xd9, 0x97, 0xcf, 0xd6, 0xf3, 0x90,
+	0xe8, 0xa8, 0x5f, 0xab, 0x0a, 0xfc, 0xd5, 0xa7, 0xd6, 0x25, 0xf0, 0x49,
+	0x7f, 0x67, 0x89, 0x58, 0x9a, 0x14, 0x7d, 0xf8, 0x7d, 0x2f, 0x0c, 0x9c,
+	0xd8, 0xb1, 0xac, 0xa8, 0xd3, 0x6b, 0x1a, 0x71, 0x25, 0xb5, 0x18, 0xe1,
+	0x20, 0xcc, 0x83, 0xa4, 0x4f, 0xb3, 0xab, 0xdd, 0x8d, 0x66, 0x73, 0xfb,
+	0x51, 0xe9, 0x36, 0xbc, 0xae, 0x93, 0x67, 0x5e, 0x29, 0x29, 0xc0, 0x50,
+	0x8c, 0x64, 0x50, 0xcf, 0x55, 0xc2, 0x8e, 0x68, 0x95, 0x87, 0x53, 0x37,
+	0xd2, 0x4d, 0x79, 0x0f, 0x05, 0x4e, 0xea, 0x38, 0x5a, 0xd2, 0x91, 0xb9,
+	0xba, 0xd8, 0xfe, 0x5c, 0x32, 0x9c, 0xa7, 0x41, 0x55, 0xd7, 0xdf, 0x53,
+	0x82, 0x82, 0x2c, 0xcd, 0x8b, 0x26, 0x7f, 0xbf, 0x09, 0xe5, 0x43, 0xf4,
+	0xc3, 0xd7, 0xfb, 0x12, 0xd8, 0xa4, 0xfd, 0x93, 0xc4, 0x6e, 0x65, 0x8b,
+	0x7c, 0xde, 0x1e, 0x51, 0x2c, 0x67, 0x2a, 0x68, 0xd6, 0xb6, 0xc1, 0x76,
+	0xef, 0x1a, 0x70, 0x34, 0xa7, 0x1b, 0xf4, 0x76, 0x87, 0x9a, 0xa6, 0x5c,
+	0x87, 0xcc, 0xc6, 0xf5, 0xd1, 0xf4, 0xee, 0x06, 0xb3, 0x3d, 0xbd, 0xa8,
+	0xf1, 0x4b, 0x5c, 0x53, 0x8d, 0x73, 0x22, 0xc0, 0x46, 0xec, 0x49, 0x46,
+	0xf7, 0xf8, 0x61, 0xee, 0x25, 0x82, 0x69, 0x9c, 0x15, 0x61, 0x3a, 0x64,
+	0x37, 0xbe, 0x8d, 0xa7, 0x63, 0x75, 0x91, 0xfd, 0xfb, 0x44, 0xb8, 0x0d,
+	0xab, 0xab, 0xec, 0x9d, 0x07, 0x42, 0x2f, 0x70, 0x5c, 0x27, 0xcd, 0x9c,
+	0x56, 0x50, 0xa8, 0x25, 0x0a, 0xe9, 0x84, 0x9c, 0xc1, 0x20, 0x8f, 0xb3,
+	0x26, 0x0c, 0x8f, 0xe8, 0x96, 0xbf, 0xd4, 0x34, 0xe4, 0x2a, 0x66, 0x37,
+	0xba, 0xcd, 0xaf, 0x67, 0x25, 0x99, 0xd8, 0xbb, 0x0c, 0xbc, 0xd9, 0xe3,
+	0x8e, 0x29, 0x85, 0x01, 0x12, 0x23, 0x15, 0x14, 0x6b, 0x99, 0x40, 0x3b,
+	0x35, 0x25, 0x39, 0xd8, 0xf1, 0xad, 0x3c, 0x91, 0x6a, 0x8b, 0x63, 0x2e,
+	0x21, 0x4e, 0xa0, 0x98, 0xca, 0x98, 0x19, 0xa8, 0xb2, 0x7a, 0xce, 0x12,
+	0xb0, 0x24, 0x2b, 0xfb, 0xe4, 0xb9, 0x57, 0x08, 0x2a, 0xb0, 0x56, 0x0b,
+	0x18, 0x96, 0x51, 0x35, 0xf6, 0x09, 0x73, 0x23, 0xd1, 0x54, 0xef, 0x5c,
+	0x10, 0xbc, 0xe1, 0x63, 0xfd, 0x11, 0xe5, 0x72, 0xe4, 0xa2, 0xe6, 0x2f,
+	0x33, 0x6d, 0xb5, 0x8c, 0xa1, 0x01, 0x59, 0x93, 0x87, 0x5f, 0xf7, 0xca,
+	0x41, 0x89, 0x17, 0x6a, 0x8e, 0x32, 0x34, 0x26, 0x0b, 0xfe, 0xf6, 0x93,
+	0xd2, 0x0e, 0x48, 0x9d, 0x44, 0x73, 0xbd, 0x31, 0x61, 0x70, 0xc4, 0xa7,
+	0xf4, 0x05, 0xb6, 0x6b, 0xd7, 0xa1, 0xb3, 0x79, 0xfc, 0x34, 0xb7, 0x1a,
+	0xc5, 0x64, 0xc6, 0xaf, 0x70, 0x55, 0xb6, 0xcf, 0x97, 0xe3, 0x16, 0xa9,
+	0xbc, 0x98, 0xf2, 0x18, 0x6a, 0x90, 0xd2, 0x09, 0x38, 0x93, 0x43, 0x1f,
+	0x73, 0x0f, 0x11, 0x0e, 0xc3, 0x2c, 0x4a, 0xfb, 0x20, 0xf9, 0xd3, 0xcd,
+	0x7a, 0x37, 0x82, 0x4d, 0xdc, 0x5f, 0x45, 0xea, 0x2e, 0x3a, 0xff, 0x87,
+	0x81, 0x17, 0x7b, 0x9e, 0x11, 0x25, 0x72, 0x68, 0x63, 0xe6, 0xa0, 0xc2,
+	0x6b, 0x39, 0x41, 0x61, 0x96, 0xa4, 0x65, 0x13, 0xfd, 0xf7, 0x85, 0xb0,
+	0x03, 0x5a, 0xa7, 0xc1, 0x54, 0xcf, 0x5c, 0x52, 0x9c, 0x61, 0x21, 0xd5,
+	0x10, 0xa7, 0x50, 0x44, 0xe4, 0xcc, 0x06, 0xf5, 0x5d, 0x35, 0xee, 0x89,
+	0x42, 0x3b, 0x31, 0x65, 0x31, 0xdc, 0xa1, 0xa5, 0x19, 0xd1, 0x22, 0x8f,
+	0xb7, 0x66, 0x04, 0x8b, 0xb8, 0x9e, 0x9a, 0x94, 0x7c, 0xe0, 0xfe, 0x2e,
+	0x12, 0x7f, 0xd5, 0xa9, 0x37, 0x29, 0xfc, 0x90, 0xf7, 0x58, 0x60, 0xb4,
+	0x86, 0x03, 0x35, 0x57, 0x19, 0x3b, 0x83, 0x45, 0x5e, 0x6f, 0x49, 0x48,
+	0x16, 0xf4, 0x6d, 0x37, 0xad, 0xbd, 0x80, 0x70, 0x09, 0x76, 0x72, 0xcb,
+	0x53, 0xaa, 0x02, 0x7e, 0xe5, 0xab, 0x74, 0x1d, 0x3e, 0xdb, 0xcf, 0x4b,
+	0x23, 0xa3, 0x74, 0x0c, 0x2e, 0xf8, 0xde, 0x1f, 0x40, 0x3e, 0x64, 0x3f,
+	0x3e, 0x9d, 0xaf, 0xc3, 0x65, 0xdb, 0x7d, 0x6b, 0x4c, 0x10, 0x9c, 0xe1,
+	0x21, 0xdd, 0x91, 0xa7, 0x5a, 0xe5, 0xe0, 0xc4, 0x8f, 0x75, 0x47, 0x9c,
+	0x4a, 0x91, 0x81, 0x3b, 0xbb, 0xc4, 0x3d, 0x55, 0x28, 0x2f, 0xa2, 0x7c,
+	0x8e, 0x1e, 0xf4, 0x7c, 0x27, 0x8e, 0xac, 0xd4, 0x13, 0x94, 0x66, 0x41,
+	0xdb, 0x36, 0xdb, 0xde, 0x5b, 0x00, 0xb2, 0x20, 0x6f, 0xb3, 0xe8, 0xed,
+	0x0f, 0x25, 0x4f, 0xb8, 0x1a, 0xdb, 0x84, 0xfb, 0xb1, 0xe8, 0xe8, 0x5f,
+	0x2f, 0x4a, 0xfc, 0x50, 0xf7, 0xd4, 0xa1, 0xb4, 0x09, 0xf2, 0x33, 0xdb,
+	0xd4, 0xfb, 0x14, 0xb8, 0xa8, 0xfb, 0xeb, 0x48, 0x59, 0x05, 0xe7, 0x7a,
+	0x60, 0xf2, 0xe6, 0x8b, 0x73, 0x2f, 0x10, 0x5c, 0xe1, 0xad, 0x1c, 0x91,
+	0x28, 0xab, 0xe3, 0x6c, 0x09, 0x4f, 0xe2, 0xba, 0x6a, 0xde, 0x33, 0x81,
+	0x74, 0x4a, 0x4e, 0x70, 0x98, 0x67, 0x49, 0x59, 0x06, 0xd7, 0x7c, 0x63,
+	0xce, 0x20, 0x90, 0x43, 0x19, 0x13, 0x03, 0x17, 0x76, 0x4f, 0x1b, 0x2a,
+	0x97, 0x26, 0x47, 0x3f, 0x7a, 0xdd, 0x23, 0x87, 0x35, 0x56, 0x08, 0x29,
+	0x80, 0x50, 0x08, 0x24, 0x50, 0x4a, 0x05, 0xc0, 0x0a, 0x2c, 0xd5, 0x0a,
+	0x07, 0x65, 0x5e, 0x2c, 0x79, 0xca, 0x55, 0xc8, 0x2e, 0x7c, 0x9f, 0x0f,
+	0xc7, 0x6f, 0x72, 0xf9, 0x73, 0xcd, 0x30, 0x96, 0x02, 0x05, 0x55, 0x5a,
+	0x0f, 0x41, 0x0e, 0x66, 0x7c, 0x0a, 0x5f, 0xe4, 0xfb, 0x76, 0x98, 0x6a,
+	0x99, 0x43, 0x0b, 0x33, 0x26, 0x05, 0x1e, 0xea, 0x9d, 0x0a, 0x92, 0x35,
+	0x7d, 0xb8, 0x7d, 0xab, 0x4c, 0x9c, 0x5d, 0xe1, 0xae, 0x2c, 0x97, 0x2b,
+	0x97, 0x25, 0x77, 0x39, 0x79, 0xe1, 0xe5, 0x9c, 0x05, 0x60, 0x0b, 0x76,
+	0x76, 0x8b, 0x5b, 0xae, 0x52, 0x76, 0xc0, 0xeb, 0x3c, 0x19, 0xea, 0x93,
+	0xea, 0x8e, 0x3b, 0xa5, 0x24, 0x00, 0x4b, 0xb0, 0x92, 0x4b, 0x9c, 0x53,
+	0x01, 0xb2, 0x22, 0x4f, 0xb7, 0xea, 0xc5, 0x8b, 0x37, 0x6f, 0x9c, 0x18,
+	0xb1, 0x20, 0x69, 0xd3, 0xe4, 0xeb, 0x77, 0xa9, 0x78, 0xd8, 0x76, 0xdd,
+	0x3a, 0x17, 0x06, 0x4f, 0xfc, 0x5a, 0x57, 0xc0, 0xab, 0x3c, 0x9d, 0xaa,
+	0x93, 0x6f, 0xde, 0x39, 0x21, 0x60, 0x40, 0xc6, 0xe4, 0xc0, 0xc7, 0xfd,
+	0x53, 0xc4, 0xe2, 0xa4, 0x8b, 0xf3, 0x2f, 0x18, 0xdd, 0xe1, 0xa7, 0xbd,
+	0x95, 0x20, 0x22, 0x63, 0x76, 0xa0, 0xeb, 0xfa, 0x79, 0x6a, 0x54, 0x92,
+	0x8d, 0xfd, 0xc3, 0xc4, 0xcb, 0x35, 0xcb, 0xd8, 0x1a, 0x1c, 0xf4, 0x79,
+	0x77, 0x84, 0xa9, 0x90, 0x59, 0xb8, 0x36, 0x1b, 0xde, 0xd7, 0xc1, 0xb2,
+	0xaf, 0x9e, 0xb5, 0x64, 0x20, 0xcf, 0xb2, 0xb2, 0x4e, 0x8e, 0x79, 0x84,
+	0xb4, 0x40, 0x62, 0xa5, 0x92, 0x60, 0x2c, 0x07, 0x2a, 0xae, 0xb6, 0x36,
+	0x06, 0x0e, 0xec, 0xdc, 0x16, 0xd4, 0x6c, 0x65, 0x8f, 0x3c, 0xd6, 0x1a,
+	0x01, 0x24, 0x42, 0x6a, 0x20, 0xd2, 0x62, 0x89, 0x53, 0x2a, 0x02, 0x76,
+	0x64, 0xab, 0x7e, 0xbc, 0x3a, 0xd3, 0x46, 0xcb, 0x39, 0x0a, 0xd0, 0x14,
+	0xed, 0xf8, 0x54, 0xbe, 0x4c, 0xb7, 0xed, 0xb5, 0x85, 0x30, 0x03, 0x52,
+	0x26, 0xc1, 0x5e, 0x6e, 0x58, 0x5a, 0x15, 0xe1, 0x3b, 0x7c, 0xb4, 0xbf,
+	0x93, 0x44, 0x6e, 0x6d, 0x0a, 0x7c, 0xd4, 0xbf, 0x55, 0x24, 0xee, 0xaa,
+	0x72, 0x7f, 0x12, 0xd9, 0xb5, 0xef, 0x90, 0xd1, 0x38, 0x2e, 0x92, 0x7e,
+	0xcd, 0x2a, 0x36, 0x37, 0x1f, 0x9d, 0xef, 0xc3, 0xe1, 0x9b, 0x7d, 0xee,
+	0x1c, 0x12, 0x18, 0xa5, 0x61, 0x50, 0xc5, 0xf5, 0xd6, 0x84, 0xe0, 0x01,
+	0xdf, 0xf3, 0x83, 0xd8, 0x8f, 0x4c, 0xd7, 0xed, 0x73, 0xe5, 0xb0, 0xc4,
+	0x2a, 0x25, 0x07, 0x38, 0x8e, 0x93, 0x24, 0x6e, 0xab, 0x6a, 0xfc, 0x13,
+	0xc7, 0x56, 0xe2, 0x88, 0x4a, 0xb9, 0x01, 0x69, 0x93, 0xe4, 0x6f, 0x37,
+	0xa9, 0xfd, 0x88, 0x74, 0x59, 0x7e, 0x57, 0x8b, 0x1b, 0xae, 0xd6, 0x36,
+	0xc0, 0x6e, 0x6c, 0x1b, 0x6e, 0xd7, 0xaa, 0x03, 0x6f, 0xf7, 0xa8, 0x61,
+	0x4b, 0x75, 0xc2, 0xcd, 0x58, 0x17, 0xc4, 0x6f, 0x74, 0x99, 0x7f, 0xcb,
+	0x48, 0x1a, 0x35, 0x65, 0x39, 0x5c, 0xb1, 0xad, 0xb9, 0xc1, 0x68, 0x0f,
+	0x27, 0x6e, 0xac, 0x1a, 0xf2, 0x14, 0xab, 0x98, 0xdc, 0xf8, 0x34, 0xbe,
+	0x8a, 0xd7, 0x6d, 0x72, 0xfd, 0x33, 0xc5, 0x34, 0xc6, 0x0a, 0x20, 0x15,
+	0x12, 0x0b, 0x95, 0x46, 0x43, 0xb9, 0x12, 0x59, 0xb4, 0xf7, 0x13, 0xd0,
+	0x26, 0xcd, 0x9f, 0x66, 0x56, 0xab, 0x19, 0xcc, 0xf2, 0xb4, 0xaa, 0xc2,
+	0x7f, 0x79, 0x68, 0x75, 0x86, 0x8d, 0xd4, 0x53, 0x94, 0xe2, 0x01, 0xdb,
+	0xb3, 0x8b, 0xdc, 0xdf, 0x44, 0xf2, 0xad, 0x3b, 0xe1, 0x64, 0x8c, 0x0f,
+	0xe0, 0x1f, 0x3e, 0xde, 0x9f, 0x41, 0x26, 0xe7, 0x3e, 0x20, 0x7e, 0xa2,
+	0xdb, 0xfe, 0x5a, 0x52, 0x90, 0xa1, 0x39, 0xd9, 0xe0, 0xbf, 0x3f, 0x84,
+	0x3c, 0xc0, 0x7a, 0x2c, 0x32, 0x7a, 0xc7, 0x83, 0xb2, 0x2f, 0x9e, 0xbd,
+	0xe5, 0x20, 0xc5, 0x13, 0xb6, 0x46, 0x07, 0xf9, 0x9e, 0x1d, 0xe4, 0x7a,
+	0x66, 0x92, 0xea, 0x8d, 0x0b, 0xa3, 0x27, 0x3c, 0x8d, 0xab, 0xa2, 0x7d,
+	0x9f, 0x0c, 0xf7, 0x69, 0x71, 0xc5, 0xb5, 0xd6, 0x00, 0xa0, 0x01, 0x5a,
+	0xa3, 0x81, 0x5c, 0xcb, 0x0c, 0x5a, 0xb9, 0x21, 0x69, 0xd1, 0xc4, 0xef,
+	0x75, 0x81, 0xfc, 0xca, 0x56, 0xf9, 0x38, 0x7d, 0xa2, 0xdd, 0x9e, 0x56,
+	0x54, 0xe8, 0x2d, 0x0e, 0xb9, 0x8c, 0xb9, 0x81, 0x68, 0x8b, 0x67, 0x6e,
+	0x29, 0x4a, 0xf0, 0x90, 0xef, 0xd8, 0x51, 0xac, 0x66, 0x32, 0xeb, 0xd7,
+	0xa8, 0x22, 0x7b, 0xf7, 0x81, 0xf1, 0x1b, 0x5c, 0xf6, 0xdd, 0x33, 0x86,
+	0x04, 0x44, 0x49, 0x1c, 0x56, 0x59, 0x39, 0x27, 0x01, 0x5c, 0xc2, 0x9d,
+	0x58, 0xb2, 0x94, 0x2f, 0xd0, 0x5d, 0x7d, 0x6e, 0x1d, 0x0a, 0x9b, 0xa4,
+	0x7f, 0xb3, 0xc8, 0xed, 0x4d, 0x05, 0xcf, 0xfa, 0x32, 0xda, 0xc6, 0xd9,
+	0x11, 0xae, 0xc2, 0x76, 0xe9, 0x7a, 0x7c, 0x32, 0xdf, 0x97, 0xc3, 0x16,
+	0xeb, 0x9c, 0x18, 0xb0, 0x30, 0x6b, 0xd2, 0xf0, 0xa9, 0x7e, 0xb9, 0x6a,
+	0xd9, 0x43, 0x8f, 0x73, 0x26, 0x80, 0x4e, 0xe8, 0x19, 0x4e, 0xd2, 0xb8,
+	0x29, 0xea, 0xf1, 0xca, 0x4c, 0x59, 0x0d, 0x67, 0x6a, 0x68, 0x52, 0xf6,
+	0xc1, 0xf3, 0xbf, 0x18, 0xf4, 0x70, 0xe7, 0x96, 0xa0, 0x24, 0x0b, 0xfb,
+	0xa6, 0x99, 0xd7, 0x4a, 0x02, 0xb1, 0x14, 0x29, 0xb8, 0xd0, 0x7b, 0x1c,
+	0x30, 0x39, 0xf3, 0x41, 0xf9, 0x17, 0x8d, 0xfe, 0xf2, 0xd2, 0xca, 0x08,
+	0x19, 0x81, 0x23, 0x3a, 0xe5, 0x27, 0xb4, 0x0d, 0xb3, 0x2b, 0xdd, 0x85,
+	0xe7, 0x73, 0xf1, 0xf0, 0xed, 0x3e, 0x35, 0x2e, 0x89, 0xce, 0xfa, 0x31,
+	0xea, 0xc0, 0xda, 0x2d, 0x68, 0xd9, 0x46, 0xdf, 0x79, 0x23, 0xc4, 0x04,
+	0xc4, 0x49, 0x14, 0xd7, 0x59, 0x33, 0x86, 0x05, 0x54, 0x4b, 0x1d, 0x42,
+	0x1b, 0x30, 0x37, 0x13, 0x5d, 0xf7, 0xcf, 0x11, 0x83, 0x12, 0x2e, 0xc4,
+	0x1e, 0x64, 0x7c, 0x0e, 0x1f, 0xec, 0xff, 0x26, 0x90, 0x4f, 0xd9, 0x0b,
+	0x0f, 0xe7, 0x6e, 0x20, 0xdb, 0xf2, 0x9b, 0x5a, 0x9e, 0x50, 0x35, 0xf4,
+	0x29, 0x77, 0x21, 0xf9, 0xd0, 0xfd, 0x7c, 0x34, 0xbe, 0x8b, 0xc7, 0x6f,
+	0x73, 0xe9, 0x71, 0xcc, 0x24, 0xd4, 0x0b, 0x15, 0x47, 0x5b, 0x3a, 0x13,
+	0x47, 0x57, 0xfa, 0x0b, 0x4b, 0xa7, 0xe2, 0x64, 0x8b, 0x7f, 0xee, 0x18,
+	0x52, 0x10, 0xa1, 0x31, 0x58, 0xe0, 0xb5, 0x9e, 0x80, 0x34, 0x49, 0xfa,
+	0x36, 0x9b, 0xde, 0xdf, 0x40, 0xb2, 0xa5, 0x3f, 0xb1, 0x6c, 0xa9, 0x4f,
+	0xa8, 0x1b, 0xea, 0x96, 0xba, 0x84, 0x3e, 0xe1, 0x6e, 0x2c, 0x1b, 0xea,
+	0x97, 0xaa, 0x86, 0x3f, 0xf5, 0x2c, 0x25, 0x0b, 0xf8, 0x96, 0x9f, 0xd4,
+	0x76, 0xc4, 0xaa, 0x24, 0x1f, 0xbb, 0x8f, 0x8d, 0xc7, 0x63, 0xb3, 0xf1,
+	0x7d, 0x3c, 0x3c, 0xbb, 0xcb, 0xcd, 0x4b, 0x27, 0xe3, 0x7c, 0x08, 0x7e,
+	0xf0, 0xfb, 0x5f, 0x08, 0x3a, 0xb0, 0x77, 0x1b, 0x58, 0xb7, 0xc5, 0x35,
+	0xd7, 0x18, 0x23, 0x00, 0x44, 0x40, 0x8c, 0x44, 0x50, 0x8d, 0x75, 0x42,
+	0xcc, 0x40, 0x94, 0xc5, 0x71, 0x97, 0x94, 0x67, 0x50, 0xc9, 0x35, 0xce,
+	0x88, 0x10, 0x19, 0xb0, 0x33, 0x5b, 0xd4, 0xf3, 0x95, 0xb8, 0xa2, 0x5a,
+	0xef, 0x40, 0xd0, 0x85, 0xfd, 0xd3, 0xc4, 0xea, 0x25, 0x8b, 0xf9, 0x8e,
+	0x1c, 0xd5, 0x68, 0x27, 0xa7, 0x3c, 0x84, 0x3a, 0xa0, 0x76, 0x2a, 0x4a,
+	0xf6, 0xf0, 0xe3, 0xde, 0x29, 0x20, 0x51, 0x52, 0x87, 0xd1, 0x16, 0xce,
+	0xcc, 0x50, 0x95, 0xf4, 0x63, 0xd6, 0xa1, 0xb1, 0x59, 0xf8, 0x36, 0x9f,
+	0x9e, 0xd7, 0x44, 0xe2, 0xad, 0x1a, 0xf1, 0x24, 0xad, 0x9b, 0xe0, 0x3e,
+	0x2f, 0x8e, 0xbc, 0xd4, 0x32, 0x84, 0x26, 0x60, 0x4f, 0x36, 0xfa, 0xcf,
+	0x0b, 0x23, 0x27, 0x34, 0x0c, 0xab, 0xa8, 0xdc, 0x9b, 0x04, 0x7e, 0xe9,
+	0x6b, 0x6c, 0x11, 0xce, 0xc3, 0xa0, 0x8b, 0xfb, 0xaf, 0x08, 0xd5, 0x41,
+	0xb7, 0xf7, 0x15, 0xb0, 0x2a, 0xcb, 0xe7, 0xea, 0x61, 0xcb, 0x75, 0xca,
+	0x4c, 0x58, 0x1d, 0x65, 0x6b, 0x7c, 0x10, 0xff, 0xd1, 0xe1, 0xbe, 0x2d,
+	0xa6, 0x39, 0xd6, 0x10, 0xa1, 0x30, 0x48, 0xe2, 0xb4, 0x8a, 0xc2, 0x3d,
+	0x59, 0xe8, 0x37, 0xae, 0x8c, 0x96, 0x71, 0x34, 0xa4, 0x2b, 0xf2, 0x75,
+	0xbb, 0x5c, 0xbd, 0x6c, 0xb1, 0xcf, 0x99, 0x03, 0x0a, 0xa7, 0x64, 0x04,
+	0x8f, 0xf8, 0x96, 0x9e, 0xc4, 0x74, 0xc5, 0xbe, 0x66, 0x16, 0xab, 0x9d,
+	0x8c, 0xf2, 0x31, 0xfa, 0xc0, 0xfb, 0x3d, 0x28, 0xf8, 0xd2, 0xdf, 0x58,
+	0x32, 0x94, 0x27, 0x51, 0x5d, 0x77, 0xcf, 0x19, 0x02, 0x12, 0x24, 0x65,
+	0x1a, 0x6c, 0xf5, 0x8e, 0x05, 0x45, 0x5b, 0x3e, 0x53, 0x4f, 0x53, 0xaa,
+	0x03, 0x6e, 0xe7, 0xaa, 0x60, 0x5f, 0x37, 0xcb, 0xdd, 0x4a, 0x16, 0xf1,
+	0x3d, 0x3d, 0xa8, 0xf9, 0xca, 0x5c, 0x59, 0x2c, 0x77, 0x2a, 0x49, 0xc6,
+	0xf6, 0xe0, 0xe2, 0xef, 0x3b, 0x61, 0x64, 0x84, 0x8e, 0xe0, 0x15, 0x9f,
+	0xda, 0x97, 0xc8, 0xa6, 0xfd, 0x97, 0x84, 0x66, 0x61, 0xdb, 0x74, 0xfb,
+	0x5e, 0x19, 0x28, 0xb3, 0x62, 0x4d, 0x13, 0xae, 0xc7, 0x26, 0xe3, 0x7f,
+	0x38, 0x78, 0xf3, 0xc7, 0x99, 0x13, 0x0a, 0x86, 0x74, 0x44, 0xae, 0x6c,
+	0x96, 0xbf, 0xd5, 0x24, 0xe6, 0x2b, 0x72, 0x75, 0xb3, 0xdd, 0xbd, 0x66,
+	0x10, 0xcb, 0x91, 0x8a, 0x8a, 0xbd, 0xcd, 0xa0, 0x97, 0x3b, 0x96, 0x14,
+	0x65, 0x78, 0x4c, 0x37, 0xec, 0xad, 0x06, 0x31, 0x1d, 0xb1, 0x2b, 0xd9,
+	0xc5, 0xef, 0x77, 0xa1, 0xf8, 0xc8, 0x7e, 0x7d, 0x2a, 0x5d, 0x86, 0xdf,
+	0xf4, 0xf2, 0xc6, 0x8a, 0x21, 0x0d, 0x91, 0x0a, 0x8b, 0xa5, 0x4e, 0xa1,
+	0x89, 0xd8, 0x9b, 0x0c, 0xfe, 0xf9, 0x63, 0xcc, 0x01, 0x84, 0x43, 0x30,
+	0x83, 0x53, 0x3e, 0x42, 0x5f, 0x70, 0xbb, 0x57, 0x0d, 0x7a, 0xba, 0x53,
+	0x4f, 0x52, 0xba, 0x01, 0x6f, 0xf3, 0xe8, 0x69, 0x4f, 0x25, 0xca, 0xe8,
+	0x18, 0x5f, 0xc0, 0xbb, 0x3c, 0xbc, 0xba, 0xd3, 0x4e, 0x4a, 0x39, 0x00,
+	0x71, 0x10, 0xe5, 0x71, 0xd4, 0xa4, 0xe5, 0x13, 0xf5, 0x76, 0x85, 0xba,
+	0xa2, 0x5e, 0xaf, 0x48, 0xd4, 0xd5, 0xf5, 0xf6, 0x84, 0xa2, 0x21, 0x5f,
+	0xb1, 0xab, 0xd9, 0xcd, 0x6e, 0x77, 0xab, 0x59, 0xcc, 0x76, 0xf4, 0xaa,
+	0x47, 0x2f, 0x7b, 0xec, 0x31, 0xc6, 0x00, 0x80, 0x01, 0x18, 0x83, 0x01,
+	0x1e, 0xe3, 0x0d, 0x18, 0x9b, 0x81, 0x2f, 0xfb, 0xed, 0x29, 0x45, 0x01,
+	0x9e, 0xe2, 0x15, 0x9b, 0x9a, 0x9f, 0xcc, 0xf6, 0xf5, 0xb2, 0xc4, 0x2e,
+	0x65, 0x0f, 0x3c, 0xde, 0x9b, 0x01, 0x2e, 0xe3, 0x6e, 0x28, 0x5b, 0xe2,
+	0x93, 0xfa, 0x8e, 0x1a, 0xb5, 0x64, 0x21, 0xdf, 0xb0, 0xb3, 0x5a, 0xcc,
+	0x70, 0x94, 0xa6, 0x41, 0x57, 0xf7, 0xdb, 0x51, 0xaa, 0x06, 0x3e, 0xed,
+	0xaf, 0x24, 0x15, 0x1b, 0x9b, 0x87, 0x4f, 0xf7, 0xeb, 0x51, 0xc9, 0x36,
+	0xfe, 0x8e, 0x13, 0x25, 0x76, 0x28, 0x6b, 0xe2, 0xf0, 0xca, 0x4e, 0x79,
+	0x09, 0x65, 0x42, 0xec, 0x40, 0xd6, 0xe5, 0xf1, 0xd5, 0xbc, 0x66, 0x12,
+	0xeb, 0x95, 0x88, 0xa2, 0x39, 0xdf, 0x80, 0xb3, 0x39, 0xfc, 0xb0, 0xf7,
+	0x1a, 0x40, 0x34, 0xc4, 0x2b, 0x34, 0x15, 0x3b, 0x9b, 0xc5, 0x6f, 0x77,
+	0xa9, 0x79, 0xc8, 0x74, 0xdc, 0x2e, 0x55, 0x0f, 0x5f, 0xee, 0x5b, 0x62,
+	0x92, 0xe2, 0x0d, 0x1b, 0xab, 0x87, 0x2c, 0xc7, 0x2b, 0x32, 0x75, 0x37,
+	0x9d, 0xbd, 0xe3, 0x40, 0xc9, 0x15, 0xce, 0xca, 0x30, 0x99, 0xf2, 0x1b,
+	0x5a, 0x96, 0xd1, 0x35, 0xfe, 0x88, 0x73, 0x29, 0x70, 0x50, 0xe7, 0xd5,
+	0x90, 0xa6, 0x48, 0xc7, 0xe5, 0xd2, 0xe5, 0xf8, 0x45, 0xae, 0x6f, 0xa6,
+	0xb9, 0xd6, 0x18, 0x20, 0x30, 0x42, 0x43, 0xb0, 0x82, 0x4b, 0xbd, 0x43,
+	0x41, 0x93, 0xb6, 0x4f, 0x96, 0xfb, 0x95, 0xa8, 0xa2, 0x7b, 0xff, 0x00,
+	0xf1, 0x11, 0xfd, 0xf2, 0xd5, 0xba, 0x06, 0x1e, 0xed, 0xed, 0x04, 0x95,
+	0x59, 0xb3, 0x86, 0x0d, 0xd5, 0x4b, 0x17, 0xe3, 0x1f, 0x38, 0xbe, 0x93,
+	0x47, 0x5e, 0x6b, 0x09, 0x40, 0x12, 0xa4, 0x65, 0x12, 0xed, 0xf5, 0x84,
+	0xa4, 0x41, 0x53, 0xb7, 0xd3, 0x55, 0xfa, 0x0e, 0x1b, 0xad, 0xe7, 0x20,
+	0xc1, 0x53, 0xbe, 0x42, 0x57, 0xf1, 0xbb, 0x5d, 0xac, 0x7e, 0xb2, 0xda,
+	0xcf, 0x48, 0x13, 0xa5, 0x77, 0x30, 0xe8, 0xe3, 0xee, 0x29, 0x43, 0x61,
+	0x92, 0xe4, 0x6d, 0x17, 0xad, 0xff, 0xa0, 0xf0, 0x4b, 0x5e, 0x73, 0x89,
+	0x71, 0x0a, 0x44, 0x54, 0xcc, 0x6d, 0x44, 0x9d, 0x5c, 0xf3, 0x8c, 0x29,
+	0x81, 0x41, 0x1a, 0x27, 0x45, 0x1c, 0x4e, 0xd9, 0x08, 0x3f, 0xe1, 0x6d,
+	0x1c, 0x1d, 0xe9, 0xab, 0x6c, 0x9d, 0x0f, 0xc3, 0x2f, 0x7a, 0xfd, 0x23,
+	0xc5, 0x15, 0xd6, 0x4a, 0x01, 0x81, 0x12, 0x2a, 0x84, 0x16, 0x60, 0x2c,
+	0x06, 0x3a, 0xac, 0xb7, 0x22, 0x44, 0x07, 0xfc, 0xce, 0x17, 0xe1, 0x3e,
+	0x2c, 0xbe, 0xba, 0xd7, 0x0e, 0x42, 0x3d, 0x50, 0x79, 0x35, 0xa5, 0x39,
+	0xd0, 0x70, 0xad, 0x36, 0x30, 0x6e, 0x83, 0xea, 0xae, 0x3b, 0xe7, 0x04,
+	0x80, 0x09, 0x98, 0x93, 0x09, 0xbe, 0xf3, 0x47, 0x98, 0x0b, 0x89, 0x87,
+	0x6a, 0xa7, 0xa3, 0x74, 0x0d, 0x3e, 0xfa, 0xdf, 0x0b, 0x02, 0x37, 0x74,
+	0x2d, 0x3f, 0xa8, 0xfd, 0x8a, 0x54, 0x5d, 0x7c, 0x7f, 0x0f, 0x09, 0x8e,
+	0xf2, 0x34, 0xaa, 0xca, 0xfe, 0x79, 0x62, 0xd4, 0x82, 0x85, 0x5d, 0xd3,
+	0x8e, 0x4b, 0xa5, 0xc3, 0x70, 0x8b, 0x56, 0x7e, 0x48, 0x7b, 0x24, 0xb1,
+	0x5a, 0xc9, 0x20, 0x9e, 0xa3, 0x05, 0x1d, 0xdb, 0x8b, 0x0b, 0xaf, 0xe7,
+	0x24, 0x81, 0x5b, 0xba, 0x12, 0x5f, 0xd4, 0xfb, 0x15, 0xa8, 0xaa, 0xfa,
+	0xff, 0x0a, 0x50, 0x15, 0xf5, 0x7b, 0x55, 0xa0, 0xaf, 0xba, 0xf5, 0x2e,
+	0x04, 0x1f, 0xf8, 0xbf, 0x0f, 0x84, 0x5f, 0xf0, 0xba, 0x4f, 0x8e, 0x7b,
+	0xa4, 0xb0, 0x42, 0x4a, 0x21, 0x80, 0x40, 0x08, 0x05, 0x40, 0x0a, 0x24,
+	0x54, 0x0a, 0x0d, 0xc4, 0x5a, 0x24, 0xf0, 0x4a, 0x4f, 0x61, 0x8a, 0x64,
+	0x5c, 0x0f, 0x4d, 0xce, 0x7e, 0x70, 0xfa, 0x47, 0x8b, 0x3b, 0xae, 0x94,
+	0x16, 0x40, 0x2c, 0x44, 0x1a, 0x2c, 0xf5, 0x0a, 0x45, 0x45, 0xde, 0x6e,
+	0x51, 0xcb, 0x17, 0xea, 0x8e, 0x3a, 0xb5, 0x26, 0x01, 0x5f, 0xf2, 0x9b,
+	0x5b, 0x8e, 0x52, 0x34, 0xe0, 0x6b, 0x7e, 0x31, 0xeb, 0xd1, 0xc8, 0x2e,
+	0x7d, 0x8f, 0x0d, 0xc6, 0x7b, 0x30, 0xf0, 0x63, 0xdf, 0x31, 0xa3, 0x50,
+	0x4c, 0x64, 0xdc, 0x0e, 0x55, 0x4d, 0x7f, 0x6e, 0x19, 0x4a, 0x93, 0xa0,
+	0x2f, 0xbb, 0xed, 0xad, 0x05, 0x01, 0x1b, 0xb2, 0x17, 0x1f, 0xde, 0xdf,
+	0x41, 0xa2, 0xa7, 0x3e, 0xa5, 0x2e, 0xa0, 0x5f, 0xba, 0x1a, 0xdf, 0xc4,
+	0xf3, 0xb5, 0xb8, 0xe0, 0x7a, 0x6f, 0x02, 0xf8, 0x84, 0xbf, 0xf1, 0x64,
+	0xac, 0x0f, 0xa2, 0x3f, 0xbe, 0x9c, 0xb7, 0x40, 0x64, 0xc5, 0x9e, 0x66,
+	0x54, 0x8b, 0x1d, 0xce, 0xda, 0x30, 0xb8, 0xe2, 0x5b, 0x7b, 0x02, 0xd1,
+	0x14, 0xef, 0xd8, 0x50, 0xbc, 0x64, 0x33, 0xff, 0x95, 0xa1, 0x32, 0x69,
+	0xf6, 0xb4, 0xa3, 0x52, 0x6d, 0x70, 0xdc, 0x27, 0xc5, 0x1d, 0x56, 0x5a,
+	0x09, 0x21, 0x02, 0x60, 0x04, 0x86, 0x68, 0x84, 0x97, 0x70, 0x26, 0x86,
+	0x2e, 0xe4, 0x1f, 0x36, 0x5e, 0x8f, 0x49, 0x86, 0xf7, 0x74, 0xa0, 0xee,
+	0xaa, 0x73, 0x6f, 0x10, 0xd8, 0xa1, 0xad, 0x99, 0xc1, 0x2a, 0x2f, 0xa7,
+	0x2c, 0x84, 0x1b, 0xb0, 0x36, 0x0b, 0xde, 0xf6, 0xd1, 0xf2, 0x8e, 0x0a,
+	0xb5, 0x45, 0x31, 0x9f, 0x91, 0x27, 0x5a, 0xed, 0x61, 0xc4, 0x85, 0xd4,
+	0x43, 0x94, 0xc3, 0x11, 0x9b, 0x92, 0x1f, 0xdc, 0xfe, 0x55, 0xa2, 0x8e,
+	0xae, 0xf5, 0x07, 0x94, 0x4f, 0xd1, 0x8b, 0x1f, 0xef, 0xce, 0x30, 0x91,
+	0x72, 0x0b, 0x52, 0x36, 0xc1, 0x7f, 0x7e, 0x18, 0x7b, 0x81, 0xe1, 0x1a,
+	0x6d, 0xe4, 0x9c, 0x06, 0x50, 0x0d, 0x75, 0x4a, 0x4d, 0x40, 0x9e, 0x64,
+	0x75, 0x9f, 0x1d, 0xe7, 0x4a, 0x60, 0x91, 0xd6, 0x4b, 0x10, 0x93, 0x11,
+	0x3f, 0xd2, 0x5d, 0x79, 0x2e, 0x15, 0x0e, 0xcb, 0xac, 0x5a, 0xf3, 0x80,
+	0xe9, 0x99, 0x4d, 0xea, 0x3f, 0x2a, 0xdc, 0x96, 0xd5, 0x74, 0xe6, 0x8e,
+	0x22, 0x35, 0x17, 0x19, 0xbf, 0xc3, 0x45, 0xdb, 0x3f, 0x4b, 0xcc, 0x52,
+	0xb4, 0xe0, 0x63, 0xff, 0x31, 0xe1, 0x70, 0xcc, 0x26, 0xf4, 0x0f, 0x17,
+	0x6f, 0xdf, 0x28, 0x33, 0x63, 0x55, 0x90, 0xaf, 0xd9, 0xc5, 0xee, 0x67,
+	0xa3, 0xf9, 0xdc, 0x3c, 0x74, 0x3a, 0x4f, 0x87, 0xea, 0xa6, 0xbb, 0xf7,
+	0x0c, 0x20, 0x19, 0xd2, 0x13, 0x99, 0xb6, 0x5b, 0xd6, 0xd2, 0x81, 0xb8,
+	0x8b, 0xca, 0xbf, 0x69, 0xe4, 0x95, 0x96, 0x42, 0x04, 0xc1, 0x18, 0x0e,
+	0xd0, 0x1c, 0x6d, 0xe8, 0x5c, 0x1e, 0x5c, 0xfd, 0x6d, 0x25, 0x8d, 0x98,
+	0x92, 0x18, 0xac, 0xf0, 0x52, 0xce, 0x40, 0x90, 0x85, 0x79, 0x93, 0xc4,
+	0x6f, 0x75, 0x89, 0x7d, 0xca, 0x5c, 0x58, 0x3c, 0x75, 0x2b, 0x5d, 0x84,
+	0xff, 0xf0, 0xf0, 0xee, 0x0e, 0x33, 0x2d, 0xb5, 0x08, 0xe1, 0x01, 0xdc,
+	0xc3, 0x85, 0xdb, 0xb3, 0x8a, 0xcc, 0xdd, 0x45, 0xe6, 0xef, 0x32, 0xf1,
+	0x76, 0x8d, 0x3a, 0xb2, 0x56, 0x0f, 0x58, 0x9e, 0x55, 0x65, 0xfe, 0x2c,
+	0x33, 0x6b, 0xd5, 0x80, 0xa7, 0x79, 0xd5, 0xa4, 0xe7, 0x33, 0xf1, 0x74,
+	0xad, 0x3e, 0xb0, 0x7e, 0x8b, 0x4a, 0xbe, 0x71, 0x67, 0x94, 0x88, 0xa1,
+	0x09, 0xd9, 0x83, 0x8f, 0xff, 0xe7, 0x80, 0xc1, 0x19, 0x1f, 0xc2, 0x1f,
+	0x78, 0xbe, 0x17, 0x07, 0x5e, 0xee, 0x59, 0x42, 0x96, 0xe0, 0x25, 0x9f,
+	0xb9, 0xa7, 0x08, 0xc5, 0x41, 0x96, 0xe7, 0x55, 0x91, 0xbe, 0xcb, 0xc6,
+	0xfb, 0x31, 0xe8, 0xe0, 0xde, 0x2f, 0x40, 0x5d, 0x54, 0xff, 0x5d, 0x21,
+	0xae, 0xa0, 0x56, 0x2b, 0x18, 0xd4, 0x71, 0xb5, 0xb4, 0x21, 0x72, 0x61,
+	0xf3, 0xf4, 0xa9, 0x76, 0x39, 0x7a, 0xd1, 0xe3, 0x9f, 0x39, 0xa6, 0x10,
+	0x46, 0x40, 0x88, 0x04, 0x58, 0x89, 0x25, 0x4a, 0xe9, 0x00, 0xdc, 0xc1,
+	0xa5, 0xdf, 0xb1, 0xa2, 0x48, 0xcf, 0x65, 0xc2, 0xed, 0x58, 0x55, 0xe4,
+	0xef, 0x36, 0xb1, 0x7e, 0x89, 0x6a, 0xba, 0x73, 0x4f, 0x10, 0x9a, 0x81,
+	0x2d, 0xdb, 0xe9, 0x2b, 0x6d, 0x85, 0x8c, 0xc2, 0x31, 0x99, 0xf0, 0x3b,
+	0x5e, 0x94, 0xf9, 0xb1, 0xec, 0xa8, 0x57, 0x2b, 0x1a, 0xf4, 0x75, 0xb7,
+	0x9c, 0xa5, 0x60, 0x41, 0xd7, 0xf6, 0xc3, 0xd2, 0xab, 0x18, 0xdd, 0xe0,
+	0xb7, 0xbf, 0x94, 0x34, 0x60, 0x6a, 0x66, 0xb2, 0xea, 0xcf, 0x2b, 0x23,
+	0x65, 0x14, 0x8c, 0xe9, 0x80, 0xdd, 0xd9, 0x26, 0xde, 0xaf, 0x41, 0x45,
+	0xd7, 0xfe, 0x43, 0xc2, 0xa3, 0xb8, 0xcd, 0xaa, 0x37, 0x2f, 0x9c, 0x9c,
+	0xf1, 0x20, 0xec, 0x83, 0xe6, 0x6f, 0x33, 0xe9, 0xf5, 0x8c, 0x24, 0x51,
+	0x5b, 0x17, 0xc3, 0x1f, 0x7a, 0x9e, 0x13, 0x05, 0x76, 0x6a, 0x4b, 0x62,
+	0xb2, 0xe2, 0x4f, 0x3b, 0x2b, 0xc5, 0x04, 0xc6, 0x69, 0x10, 0xd5, 0x71,
+	0xb7, 0x94, 0x25, 0x70, 0x49, 0x77, 0xe6, 0x89, 0x52, 0x3b, 0x10, 0x75,
+	0x71, 0xfd, 0x35, 0xa5, 0x38, 0xc0, 0x72, 0xac, 0x22, 0x72, 0x67, 0x93,
+	0xf8, 0xaf, 0x0e, 0xb5, 0x4d, 0xb1, 0x8f, 0x99, 0x87, 0x4a, 0xa7, 0xe1,
+	0x54, 0x8d, 0x7c, 0xd2, 0xde, 0x49, 0x20, 0x97, 0x32, 0x07, 0x16, 0x6e,
+	0xcd, 0x0a, 0x36, 0x75, 0x3f, 0x1d, 0xad, 0xeb, 0xe0, 0xd9, 0x5f, 0x4e,
+	0x5a, 0x38, 0x31, 0x63, 0x51, 0xd0, 0xa7, 0xdd, 0x95, 0xe6, 0x42, 0xe3,
+	0xb1, 0xd8, 0xe8, 0x3c, 0x1f, 0x8a, 0x9f, 0xec, 0xf6, 0xb7, 0x92, 0x44,
+	0x6c, 0x4d, 0x0e, 0x7e, 0xfc, 0x3b, 0x47, 0x04, 0xca, 0xa8, 0x18, 0xdb,
+	0x80, 0xbb, 0xb9, 0xec, 0xb8, 0x57, 0x0a, 0x0a, 0xb4, 0x54, 0x23, 0x9c,
+	0x84, 0x71, 0x11, 0xf4, 0x63, 0xd7, 0xb1, 0xb3, 0x58, 0xec, 0x74, 0x96,
+	0x8e, 0xc5, 0x45, 0xd7, 0xff, 0x53, 0xc0, 0xa2, 0xac, 0x8f, 0xa3, 0x27,
+	0x3d, 0x9d, 0xa9, 0xa3, 0x69, 0xdd, 0x05, 0xe7, 0x7b, 0x70, 0xf0, 0xe7,
+	0x9f, 0x31, 0x26, 0x00, 0x4e, 0xe0, 0x98, 0x4e, 0xd8, 0x19, 0x2d, 0xe2,
+	0x78, 0x4a, 0x56, 0xf0, 0xa9, 0x7f, 0xa9, 0x68, 0xd8, 0x57, 0xcd, 0x7a,
+	0x36, 0x92, 0x4f, 0xdd, 0x4b, 0x07, 0xe3, 0x3e, 0x28, 0xfe, 0xb2, 0xd3,
+	0x5e, 0x4a, 0x18, 0x10, 0x31, 0x31, 0x71, 0x71, 0xf5, 0xb5, 0xb5, 0x30,
+	0x60, 0x62, 0xe6, 0xa2, 0xe2, 0x6f, 0x3b, 0x69, 0xe5, 0x84, 0x84, 0x41,
+	0x11, 0x97, 0x53, 0x17, 0xd2, 0x0f, 0x59, 0x8f, 0x47, 0x66, 0xeb, 0x7a,
+	0x78, 0x72, 0xd7, 0x93, 0x93, 0x1e, 0xce, 0xdc, 0x50, 0xb4, 0xe4, 0x23,
+	0xf7, 0x35, 0xb1, 0x78, 0xe9, 0x66, 0xbc, 0x0b, 0xc3, 0x27, 0xfa, 0xed,
+	0x2b, 0x65, 0x05, 0x9c, 0xca, 0x91, 0x89, 0xba, 0xbb, 0xce, 0x9c, 0x51,
+	0x20, 0xa6, 0x22, 0x66, 0x27, 0xba, 0xec, 0xbf, 0x27, 0x04, 0x0d, 0xd8,
+	0x9a, 0x1d, 0xec, 0xfa, 0x76, 0x9a, 0x4a, 0x9d, 0x41, 0x23, 0xb7, 0x34,
+	0x25, 0x3a, 0xe8, 0xf7, 0xae, 0x00, 0x57, 0x71, 0xbb, 0x55, 0x2d, 0x7e,
+	0xb8, 0x7b, 0xcb, 0x40, 0x9a, 0x25, 0x6d, 0x99, 0x4c, 0xfb, 0x2d, 0x29,
+	0xc9, 0xc0, 0x9e, 0x6d, 0xe4, 0x9d, 0x16, 0x52, 0x0c, 0x61, 0x08, 0x44,
+	0x50, 0x8c, 0x65, 0x40, 0xcd, 0x54, 0xd6, 0xcc, 0x61, 0x85, 0x95, 0x52,
+	0x02, 0x80, 0x04, 0x48, 0x89, 0x04, 0x5a, 0xa9, 0x21, 0x48, 0xc1, 0x84,
+	0xce, 0xe1, 0x81, 0xdd, 0xdb, 0x06, 0xda, 0xad, 0x69, 0xc1, 0xc5, 0xde,
+	0x67, 0xc0, 0xc9, 0x1c, 0x5f, 0xc8, 0x3b, 0x2c, 0xb4, 0x1a, 0xc3, 0x04,
+	0xca, 0xa9, 0x08, 0xd9, 0x81, 0xaf, 0xfb, 0xe5, 0xa8, 0x45, 0x0b, 0x3f,
+	0xe6, 0x1d, 0x12, 0x1a, 0x85, 0x65, 0x52, 0xed, 0x71, 0xc4, 0xa4, 0xc4,
+	0x03, 0xb5, 0x57, 0x11, 0xba, 0x83, 0x4f, 0xff, 0x6b, 0x41, 0xc1, 0x96,
+	0xee, 0xc4, 0x93, 0xb5, 0x7e, 0x80, 0xfa, 0xa8, 0x7a, 0xfb, 0x42, 0xd9,
+	0x11, 0xaf, 0xd2, 0x74, 0xe8, 0x6e, 0x3e, 0x3b, 0xcf, 0x85, 0xc2, 0x23,
+	0xb9, 0xd5, 0x29, 0x36, 0x31, 0x7f, 0x91, 0xe9, 0xbb, 0x6d, 0xac, 0x1d,
+	0x82, 0x1a, 0xac, 0xf4, 0x12, 0xc6, 0x44, 0xc0, 0x8d, 0x5c, 0xd3, 0x8c,
+	0x6b, 0xa1, 0xc1, 0x58, 0x0f, 0x44, 0x5e, 0x6c, 0x79, 0x4e, 0x15, 0xc8,
+	0xab, 0x2c, 0x9d, 0x8b, 0x83, 0x2f, 0xff, 0xad, 0x21, 0x41, 0x51, 0x96,
+	0xc7, 0x55, 0xd3, 0x9e, 0x4b, 0x84, 0xd3, 0x30, 0xaa, 0xc2, 0x7e, 0x69,
+	0x6a, 0x74, 0x92, 0xcf, 0xdd, 0x43, 0x86, 0xe3, 0x34, 0x89, 0xfa, 0xba,
+	0x5a, 0xde, 0x50, 0xb1, 0xb4, 0x29, 0xf2, 0x71, 0xfb, 0x54, 0xb9, 0x3c,
+	0xb9, 0xea, 0xd9, 0x4b, 0x0e, 0x73, 0x2c, 0x21, 0x4a, 0xe0, 0x90, 0xce,
+	0xc8, 0x11, 0x8d, 0xf2, 0x32, 0xca, 0xc6, 0xf8, 0x01, 0xee, 0xe3, 0xe2,
+	0xe9, 0x5b, 0x6d, 0x62, 0xfc, 0x02, 0xd7, 0x75, 0xf3, 0xdc, 0x29, 0x24,
+	0x11, 0x5a, 0x83, 0x81, 0x1e, 0xeb, 0x8c, 0x18, 0x91, 0x20, 0x2b, 0xf3,
+	0x64, 0xa9, 0x5f, 0xa8, 0x3a, 0xfa, 0xd6, 0x9b, 0x10, 0x3e, 0xc0, 0x7f,
+	0x7c, 0x38, 0x7f, 0x83, 0xc9, 0x9e, 0x7f, 0xc4, 0xb8, 0x04, 0x3a, 0xa9,
+	0xe7, 0x28, 0x41, 0x43, 0xb6, 0xe2, 0x47, 0xbb, 0x3b, 0xcd, 0xa4, 0xd6,
+	0x23, 0x90, 0x45, 0x79, 0x1f, 0x05, 0x6f, 0xfa, 0x78, 0x7b, 0x46, 0x91,
+	0x98, 0xab, 0x88, 0xdd, 0xc9, 0x26, 0xff, 0xbf, 0x01, 0x64, 0x43, 0xfe,
+	0x62, 0xd3, 0xf3, 0x9b, 0x58, 0xbe, 0x54, 0x37, 0xdc, 0xad, 0x65, 0x01,
+	0xdd, 0xd2, 0x97, 0xd8, 0xa6, 0xdc, 0x87, 0xc4, 0x47, 0xf5, 0xdb, 0x55,
+	0xea, 0x0e, 0x3a, 0xbd, 0xa7, 0x01, 0x55, 0x53, 0x9f, 0x53, 0x07, 0xd2,
+	0x2e, 0x49, 0xcf, 0x66, 0xf2, 0xeb, 0x5b, 0x69, 0x22, 0xf4, 0x06, 0x87,
+	0x7d, 0xd6, 0x9c, 0x61, 0x20, 0xc5, 0x12, 0xa6, 0x44, 0x06, 0xed, 0xdc,
+	0x14, 0xf4, 0x68, 0x67, 0xa7, 0xb8, 0xc4, 0x3a, 0x25, 0x26, 0x28, 0xce,
+	0xb2, 0xb0, 0x6e, 0x8a, 0x7b, 0xac, 0x30, 0x52, 0x42, 0x81, 0x90, 0x0a,
+	0x88, 0x95, 0x48, 0xa2, 0xb5, 0x1e, 0x80, 0x3c, 0xc8, 0xfa, 0x3c, 0x3a,
+	0xda, 0xd7, 0xc9, 0x32, 0xbf, 0x96, 0x15, 0x74, 0x6a, 0x4f, 0x22, 0xba,
+	0xe6, 0x1f, 0x33, 0x0e, 0x85, 0x4c, 0xc2, 0xbd, 0x58, 0xf0, 0xb4, 0xaf,
+	0x92, 0x75, 0x7c, 0x2c, 0x3f, 0xaa, 0xdd, 0x8e, 0x56, 0x75, 0xf8, 0x6d,
+	0x2f, 0x2d, 0x8c, 0x98, 0x90, 0x38, 0xa8, 0xf2, 0x7a, 0x4a, 0x52, 0xb0,
+	0xa1, 0x7b, 0xf9, 0x60, 0xfd, 0x17, 0x85, 0x7e, 0xe2, 0xda, 0x6a, 0x18,
+	0x53, 0x01, 0xb3, 0x32, 0x4d, 0xb6, 0xfe, 0x87, 0x82, 0x27, 0x7d, 0x9d,
+	0x2d, 0xe3, 0x69, 0x58, 0x55, 0xe5, 0xff, 0x34, 0xb0, 0x6a, 0xcb, 0x63,
+	0xaa, 0x61, 0x4e, 0x25, 0xc8, 0xc8, 0x1c, 0x5d, 0xe8, 0x3f, 0x2e, 0x9c,
+	0x9e, 0xd1, 0x24, 0xee, 0xab, 0x62, 0x7d, 0x13, 0xcd, 0xf7, 0xe6, 0x80,
+	0xc3, 0x39, 0x1b, 0xc0, 0x37, 0xfc, 0xac, 0x37, 0x23, 0x5c, 0x84, 0xfd,
+	0xd0, 0xf4, 0xec, 0x26, 0xb7, 0x3f, 0x95, 0x2c, 0xe3, 0x6b, 0x78, 0x51,
+	0xe7, 0xd7, 0xb0, 0xa2, 0x4a, 0xef, 0x61, 0xc0, 0xc5, 0xdc, 0x47, 0xc4,
+	0xcb, 0x34, 0xdb, 0xda, 0x1b, 0x08, 0xb6, 0x70, 0x67, 0x96, 0xa8, 0xa5,
+	0x0b, 0xf1, 0x07, 0x9d, 0xdf, 0xc3, 0x82, 0xab, 0xbd, 0x8d, 0xa0, 0x13,
+	0x7b, 0x96, 0x91, 0x35, 0x7a, 0xc8, 0x73, 0xac, 0x20, 0x52, 0x63, 0x91,
+	0xd0, 0x2b, 0x1c, 0x95, 0x69, 0xb3, 0xe5, 0x3d, 0x15, 0x28, 0xab, 0xe2,
+	0x7c, 0x0b, 0x4e, 0xf6, 0xf8, 0x63, 0xce, 0x21, 0x80, 0x41, 0x18, 0x07,
+	0x41, 0x1e, 0x66, 0x5d, 0x1a, 0x1f, 0xc5, 0x6f, 0x76, 0xb9, 0x7b, 0xc9,
+	0x60, 0x9e, 0x27, 0x45, 0x1d, 0x5e, 0xdb, 0x09, 0x2b, 0xa3, 0x64, 0x0c,
+	0x0f, 0xe8, 0x9e, 0x3e, 0xd4, 0x3e, 0x45, 0x2e, 0x6e, 0xbe, 0x3a, 0xd7,
+	0x06, 0xc3, 0x3d, 0x5a, 0xd8, 0x31, 0xad, 0xb0, 0x50, 0x6a, 0x04, 0x92,
+	0x28, 0xad, 0x83, 0x60, 0x0f, 0x37, 0x6e, 0x8d, 0x0a, 0xb2, 0x35, 0x3f,
+	0x98, 0xfd, 0xe9, 0x64, 0x9d, 0x1f, 0xc3, 0x0e, 0x6a, 0xbd, 0x02, 0x51,
+	0x15, 0xf7, 0x5b, 0x51, 0xa2, 0x87, 0x3e, 0xe7, 0x0e, 0x20, 0x1d, 0x92,
+	0x1b, 0x9d, 0xe6, 0x53, 0xf3, 0x92, 0xc9, 0xbc, 0x5f, 0x82, 0x9a, 0xac,
+	0xfc, 0x93, 0xc6, 0x4e, 0x61, 0x89, 0x54, 0x5a, 0x0c, 0x71, 0x08, 0x65,
+	0x40, 0xcc, 0x44, 0xd4, 0xcd, 0x75, 0xc7, 0x9c, 0x42, 0x10, 0x81, 0x31,
+	0x1a, 0xc0, 0x35, 0xdc, 0xa8, 0x35, 0x0b, 0xd8, 0x96, 0xdd, 0xf4, 0xf6,
+	0x86, 0x82, 0x25, 0x5d, 0x99, 0x2f, 0xcb, 0xed, 0x4a, 0x75, 0xc1, 0xfd,
+	0x5e, 0x14, 0xf8, 0xa9, 0x6f, 0xa9, 0x49, 0xc8, 0x17, 0xec, 0xee, 0x36,
+	0xb3, 0x5e, 0x8d, 0x68, 0x92, 0xf7, 0x5d, 0x30, 0xbe, 0x83, 0x47, 0x7f,
+	0x7b, 0x49, 0x61, 0x86, 0xa4, 0x44, 0x03, 0xbd, 0xd6, 0x11, 0xb0, 0x22,
+	0x4b, 0xf7, 0xe2, 0xc1, 0xdb, 0x3f, 0x4a, 0xdc, 0x50, 0xb5, 0xf4, 0x21,
+	0xf6, 0x21, 0xf3, 0x71, 0xf9, 0x74, 0xbd, 0x3e, 0x91, 0x6e, 0xcb, 0x6b,
+	0x2a, 0x71, 0x46, 0x85, 0xd8, 0x82, 0x9c, 0xcd, 0xe0, 0x97, 0xbf, 0xd6,
+	0x14, 0xe0, 0x28, 0x4e, 0xb3, 0xa8, 0xed, 0x8b, 0x65, 0x4f, 0x3d, 0x4a,
+	0xd9, 0x00, 0xbf, 0xf1, 0x65, 0xbc, 0x0d, 0xa3, 0x2b, 0xfc, 0x95, 0xa7,
+	0x52, 0x65, 0xf0, 0xcc, 0x2f, 0x65, 0x0d, 0x1c, 0xda, 0x99, 0x29, 0xaa,
+	0xf1, 0x4e, 0x0c, 0x59, 0x88, 0x37, 0x68, 0xec, 0x16, 0xb6, 0x4c, 0xa7,
+	0xed, 0x94, 0x95, 0x70, 0x22, 0xc6, 0x26, 0xe0, 0x4f, 0x3e, 0x7b, 0xcf,
+	0x01, 0x82, 0x23, 0x3c, 0x85, 0x2b, 0xb2, 0x75, 0x3f, 0x1c, 0xbd, 0xe9,
+	0xe1, 0xcd, 0x1d, 0x47, 0x4a, 0x2a, 0x30, 0x56, 0x03, 0x99, 0x96, 0x5b,
+	0x94, 0xf2, 0x01, 0xfa, 0xa3, 0xcb, 0xfd, 0x4b, 0x44, 0xd3, 0xbc, 0x6b,
+	0xc2, 0xf1, 0x98, 0x6c, 0xf8, 0x5f, 0x0f, 0x4a, 0xbe, 0x70, 0x77, 0x96,
+	0x89, 0xb5, 0x4b, 0xd0, 0x93, 0x9d, 0xfe, 0xd2, 0xd2, 0x88, 0x28, 0x99,
+	0xc3, 0x0b, 0x3b, 0xa7, 0x05, 0x14, 0x4b, 0x99, 0x02, 0x1b, 0xb5, 0x67,
+	0x11, 0xd9, 0xb3, 0x8f, 0x9c, 0xd7, 0x40, 0xa2, 0xa5, 0x1e, 0xa1, 0x2c,
+	0x88, 0xdb, 0xa8, 0x3a, 0xfb, 0xc6, 0x99, 0x11, 0x2a, 0x82, 0x76, 0x6c,
+	0x2a, 0x7e, 0xb6, 0x9b, 0xd7, 0x4e, 0x42, 0xb9, 0x10, 0x79, 0xb0, 0xf5,
+	0x3b, 0x54, 0x34, 0xed, 0xbb, 0x64, 0x3c, 0x0f, 0x8b, 0xae, 0xfe, 0xb7,
+	0x82, 0x44, 0x4d, 0x5d, 0x4e, 0x5f, 0x68, 0x3b, 0x66, 0x15, 0x9a, 0x8b,
+	0x8d, 0xcf, 0xe3, 0xa3, 0xf9, 0xdd, 0x2c, 0x76, 0x3b, 0x5b, 0xc5, 0xe3,
+	0xb6, 0xa9, 0xf6, 0x39, 0x72, 0x50, 0xe3, 0x95, 0x98, 0xa2, 0x18, 0xcf,
+	0xc0, 0x92, 0xad, 0xfc, 0x91, 0xe6, 0x4a, 0x63, 0xa1, 0xd0, 0x48, 0x2c,
+	0x55, 0x0a, 0x0f, 0xe4, 0x5e, 0x26, 0xd8, 0xce, 0x5d, 0x41, 0xae, 0x66,
+	0x36, 0xab, 0xdf, 0xac, 0x72, 0x73, 0xd2, 0xc1, 0xb9, 0x1f, 0x88, 0xbe,
+	0xf8, 0xf6, 0x9e, 0x02, 0x14, 0x45, 0x79, 0x1e, 0x15, 0x6d, 0xfb, 0x6c,
+	0x39, 0x4f, 0x81, 0x8a, 0xaa, 0xbd, 0x8f, 0x80, 0x17, 0x79, 0xbe, 0x15,
+	0x27, 0x5a, 0xec, 0x71, 0xc6, 0x84, 0xc0, 0x01, 0x9d, 0xd3, 0x03, 0x9a,
+	0xa7, 0x4d, 0x95, 0xcf, 0xd3, 0xa3, 0x9a, 0xed, 0xec, 0x15, 0x87, 0x5a,
+	0xa6, 0xd0, 0x46, 0xcc, 0x49, 0x04, 0xd7, 0x78, 0x23, 0xc6, 0x24, 0xc0,
+	0x4b, 0x3c, 0x53, 0x4b, 0x13, 0xa2, 0x07, 0x3e, 0xef, 0x8f, 0x20, 0x17,
+	0x33, 0x1f, 0x95, 0x6f, 0xd3, 0xe9, 0x3b, 0x6d, 0xa4, 0x9c, 0x82, 0x10,
+	0x0d, 0xf0, 0x1a, 0x4f, 0xc4, 0xda, 0x24, 0xf8, 0xcb, 0x4f, 0x6b, 0x2b,
+	0x60, 0x54, 0x86, 0xcd, 0xd4, 0xd7, 0xd4, 0xe2, 0x84, 0x8b, 0xb1, 0x0f,
+	0x98, 0x9f, 0xc9, 0xa6, 0xff, 0xb7, 0x80, 0x64, 0x49, 0x5f, 0x66, 0xdb,
+	0x7a, 0x1b, 0x42, 0x17, 0xf0, 0x2f, 0x1f, 0xad, 0xef, 0xa0, 0xd1, 0x5b,
+	0x1e, 0x52, 0x1d, 0x71, 0x2b, 0x55, 0x04, 0xef, 0xf8, 0x50, 0xfe, 0x44,
+	0xb3, 0xbd, 0xbd, 0xa0, 0x70, 0x4b, 0x56, 0xf2, 0x89, 0x7b, 0xab, 0x40,
+	0x5c, 0x45, 0xed, 0x5e, 0x34, 0xf8, 0xeb, 0x4f, 0x29, 0x0b, 0xe0, 0x16,
+	0xae, 0xcc, 0x96, 0xf5, 0x74, 0xa4, 0xae, 0xa2, 0x77, 0x3f, 0x18, 0xfd,
+	0xe1, 0xe5, 0x9d, 0x15, 0x62, 0x0a, 0x62, 0x34, 0x82, 0x4b, 0xbc, 0x53,
+	0x43, 0x92, 0xa2, 0x0d, 0x9f, 0xeb, 0x87, 0xa9, 0x97, 0x29, 0xb6, 0x31,
+	0x77, 0x10, 0xe9, 0xb1, 0xcc, 0xa8, 0x15, 0x0b, 0x9a, 0xb6, 0x5d, 0xb6,
+	0xde, 0x87, 0xc0, 0x07, 0xfd, 0xdf, 0x05, 0xe2, 0x2b, 0x7a, 0xf5, 0xa3,
+	0xd5, 0x1d, 0x76, 0x5a, 0x4b, 0x01, 0x82, 0x22, 0x2c, 0x87, 0x2a, 0xa6,
+	0x37, 0x36, 0x0c, 0xaf, 0xe8, 0xd4, 0x9f, 0x54, 0x76, 0xcc, 0x2b, 0x24,
+	0x15, 0x1a, 0x8b, 0x85, 0x4e, 0xe3, 0xa9, 0x58, 0xd9, 0x24, 0xff, 0xbb,
+	0x41, 0x6c, 0x47, 0xae, 0x6a, 0xf6, 0xb3, 0xd3, 0x5c, 0x6a, 0x1c, 0x12,
+	0x19, 0xb5, 0x63, 0x51, 0xd1, 0xb7, 0xdf, 0x94, 0xf2, 0x00, 0xea, 0xa1,
+	0xca, 0xe9, 0x09, 0x4d, 0xc3, 0xae, 0x6a, 0xf7, 0xa3, 0xd1, 0x5d, 0x7e,
+	0x5e, 0x1b, 0x09, 0xa7, 0x62, 0x64, 0x83, 0xfe, 0xee, 0x12, 0xf3, 0x14,
+	0xa9, 0xb8, 0xd8, 0xfa, 0x1c, 0x3a, 0x98, 0xf7, 0x49, 0x70, 0x97, 0x97,
+	0x57, 0x56, 0xca, 0x09, 0x08, 0x93, 0x20, 0x2f, 0xb3, 0x6c, 0xad, 0x0f,
+	0xa0, 0x1f, 0xba, 0x9e, 0x9f, 0xc4, 0x76, 0xe5, 0xba, 0x64, 0x3e, 0x2f,
+	0x8f, 0xac, 0xd6, 0x33, 0x90, 0x64, 0x69, 0x5f, 0x24, 0xfb, 0xfa, 0x59,
+	0x6a, 0x16, 0xb2, 0x0d, 0xbf, 0xeb, 0xc5, 0x89, 0x17, 0x6b, 0x9e, 0x30,
+	0x35, 0x32, 0x49, 0xf7, 0xe6, 0x81, 0xd3, 0x3b, 0x1a, 0xd4, 0x75, 0xf5,
+	0xbc, 0x25, 0x22, 0x69, 0xd6, 0xb4, 0xe1, 0x72, 0xed, 0x32, 0xf4, 0x26,
+	0x87, 0x3f, 0xf6, 0x1c, 0x23, 0x08, 0xc4, 0x50, 0x84, 0xe4, 0x40, 0xc7,
+	0xf5, 0xd2, 0xc4, 0xe8, 0x05, 0x8f, 0xfb, 0xa6, 0x98, 0xc7, 0x48, 0x03,
+	0xa5, 0x56, 0x20, 0xa8, 0xc2, 0x7a, 0x29, 0x62, 0x70, 0xc2, 0xc7, 0xf8,
+	0x03, 0xce, 0xe7, 0xe0, 0xc1, 0xdf, 0x7f, 0x42, 0xd8, 0x00, 0xbd, 0xd1,
+	0x61, 0xbe, 0x25, 0x27, 0x39, 0xdc, 0xb1, 0xa5, 0x38, 0xc1, 0x62, 0xae,
+	0x23, 0x66, 0x25, 0x9a, 0xe8, 0xbd, 0x0f, 0x80, 0x1f, 0xf8, 0xbe, 0x1f,
+	0x86, 0x5e, 0xe4, 0xf8, 0x46, 0x9e, 0x69, 0xa5, 0x85, 0x10, 0x03, 0x10,
+	0x06, 0x41, 0x1c, 0x46, 0x59, 0x18, 0x37, 0x41, 0x7d, 0x56, 0x9d, 0x79,
+	0xa3, 0xc4, 0x0c, 0x45, 0x49, 0x1e, 0x76, 0x5d, 0x3b, 0x0f, 0x85, 0x4e,
+	0xe2, 0xb9, 0x5a, 0xd8, 0x30, 0xbd, 0xb2, 0x51, 0x7e, 0x46, 0x9b, 0x38,
+	0xbf, 0x82, 0x55, 0x5d, 0x7e, 0x5f, 0x0b, 0x0b, 0xa6, 0x76, 0x26, 0x8a,
+	0xee, 0xfc, 0x13, 0xc6, 0x46, 0xe0, 0x89, 0x5e, 0xfb, 0x08, 0x79, 0x81,
+	0xe5, 0x5a, 0x65, 0xe0, 0xcc, 0x0e, 0x75, 0x4d, 0x3d, 0x4e, 0x99, 0x08,
+	0xbb, 0xa1, 0x6d, 0x99, 0x4d, 0xeb, 0x2f, 0x28, 0xdd, 0x82, 0x97, 0x7d,
+	0xf6, 0x9c, 0x23, 0x00, 0x45, 0x50, 0x8e, 0x45, 0x44, 0xcf, 0x7c, 0x52,
+	0xde, 0x41, 0xa1, 0x97, 0x38, 0xa6, 0x12, 0x66, 0x44, 0x8a, 0x2c, 0xdc,
+	0x9b, 0x05, 0x6e, 0xeb, 0x6a, 0x78, 0x53, 0xc7, 0xd3, 0xb2, 0x8a, 0xce,
+	0xfd, 0x41, 0xe4, 0xc7, 0xb6, 0xe3, 0x56, 0xa9, 0x38, 0xd8, 0xf2, 0x9d,
+	0x3a, 0x92, 0x56, 0x4d, 0x78, 0x1e, 0x17, 0x4d, 0xff, 0x6e, 0x11, 0xcb,
+	0x93, 0xaa, 0x8e, 0xbf, 0xe5, 0x24, 0x85, 0x1b, 0xb2, 0x16, 0x0f, 0xdc,
+	0xde, 0x55, 0xe0, 0xae, 0x2e, 0xb7, 0x2f, 0x95, 0x0d, 0xf3, 0x2b, 0x59,
+	0xc5, 0xe7, 0xf6, 0xa1, 0xf2, 0x69, 0x7a, 0x75, 0xa3, 0xdd, 0x9c, 0x76,
+	0x50, 0xea, 0x05, 0x8a, 0xab, 0xac, 0x9d, 0x83, 0x02, 0x2f, 0xf5, 0x0c,
+	0x25, 0x49, 0xd8, 0x16, 0xdd, 0xfc, 0x77, 0x86, 0x88, 0x84, 0x59, 0x91,
+	0xa6, 0x4b, 0xf7, 0xe3, 0xd1, 0xd9, 0x3e, 0x5e, 0x9e, 0x59, 0xa5, 0xe6,
+	0x20, 0xc3, 0x73, 0xba, 0x40, 0x7f, 0x75, 0xa9, 0x7d, 0x88, 0x7c, 0xd8,
+	0x7e, 0x5d, 0x2a, 0x1f, 0xa6, 0x5f, 0xb6, 0xda, 0xc7, 0xc8, 0x03, 0xad,
+	0xd7, 0x20, 0xa2, 0x63, 0x7e, 0x21, 0xeb, 0xf0, 0xd8, 0x6e, 0x5c, 0x1b,
+	0x0d, 0xe7, 0x6a, 0x60, 0xd3, 0xf6, 0xcb, 0x52, 0xbb, 0x10, 0x7d, 0xf0,
+	0xfd, 0x3f, 0x04, 0x3c, 0xc8, 0xfb, 0x2c, 0x38, 0xdb, 0xc3, 0x8b, 0x3b,
+	0xaf, 0x84, 0x14, 0x41, 0x38, 0x06, 0x13, 0x3c, 0xe7, 0x0b, 0x70, 0x17,
+	0x97, 0x5f, 0xd7, 0xca, 0x03, 0xa9, 0x97, 0x28, 0xa6, 0x33, 0x76, 0x04,
+	0xab, 0xb8, 0xdc, 0xba, 0x14, 0x3e, 0xc8, 0xff, 0x6c, 0x30, 0xdf, 0x93,
+	0x83, 0x1e, 0xef, 0xcc, 0x10, 0x95, 0x70, 0x23, 0xd6, 0x24, 0xe1, 0x5b,
+	0x7c, 0x72, 0xdf, 0x13, 0x83, 0x16, 0x6e, 0xcc, 0x1a, 0x34, 0x74, 0x2b,
+	0x5f, 0xa4, 0xfb, 0xf2, 0xd8, 0x6a, 0x1c, 0x13, 0x09, 0xb7, 0x62, 0x45,
+	0x93, 0xbe, 0xcf, 0x86, 0xf3, 0x35, 0xb8, 0xe8, 0xfb, 0x6f, 0x08, 0x59,
+	0x80, 0xb7, 0x78, 0xe4, 0xb6, 0xa6, 0x06, 0x27, 0x7d, 0x9c, 0x3d, 0xe1,
+	0x68, 0x4c, 0x17, 0xec, 0xef, 0x26, 0xb1, 0x5f, 0x99, 0x2a, 0x9b, 0xe7,
+	0x4f, 0x31, 0x8b, 0xd1, 0x0e, 0x4e, 0xfd, 0x48, 0x75, 0xc5, 0xbd, 0x56,
+	0x10, 0xa8, 0xa1, 0x4a, 0xe9, 0x01, 0xcc, 0xc3, 0xa4, 0xcb, 0xf3, 0xab,
+	0x58, 0xdd, 0x64, 0xf7, 0xbf, 0x11, 0x64, 0x62, 0xee, 0x22, 0xf2, 0x67,
+	0x9b, 0x79, 0xaf, 0x04, 0x14, 0x49, 0xb9, 0x06, 0x19, 0x9d, 0xe3, 0x03,
+	0xf9, 0x97, 0x8d, 0xf6, 0x73, 0xd2, 0xc0, 0xa9, 0x1d, 0x89, 0xaa, 0xba,
+	0xff, 0x8e, 0x10, 0x15, 0x70, 0x2b, 0x57, 0x24, 0xeb, 0xfa, 0x78, 0x7a,
+	0x56, 0x93, 0x99, 0xbf, 0xca, 0xd4, 0xd9, 0x34, 0xfe, 0x8a, 0x53, 0x2d,
+	0x72, 0x78, 0x63, 0xc7, 0xb0, 0x82, 0x4a, 0xad, 0x41, 0x40, 0x87, 0xf4,
+	0x46, 0x86, 0xe9, 0x94, 0x9d, 0xf0, 0x32, 0xce, 0x86, 0xf0, 0x05, 0xbe,
+	0xeb, 0xc7, 0xa9, 0x13, 0x69, 0xb6, 0xb4, 0x27, 0x12, 0x6d, 0xf5, 0x8c,
+	0x25, 0x41, 0x59, 0x16, 0xd7, 0x5d, 0x73, 0x8e, 0x01, 0x04, 0x43, 0x38,
+	0x02, 0x53, 0x34, 0xe3, 0x5b, 0x78, 0x32, 0xd7, 0x17, 0xd3, 0x1e, 0x4b,
+	0x8c, 0x52, 0x30, 0xa0, 0x63, 0x7a, 0x61, 0xe3, 0xf4, 0x88, 0x66, 0x79,
+	0x5b, 0x45, 0xe3, 0xbe, 0x28, 0xf6, 0x33, 0xd3, 0x54, 0xeb, 0x1c, 0x18,
+	0xb8, 0xb1, 0x6b, 0xd8, 0x51, 0xad, 0x76, 0x30, 0xea, 0xc3, 0xea, 0x2b,
+	0x6b, 0xe5, 0x80, 0xc4, 0x49, 0x15, 0xc7, 0x5b, 0x32, 0x92, 0x47, 0x5d,
+	0x5b, 0x0f, 0x43, 0x2e, 0x62, 0x7e, 0x22, 0xdb, 0xf6, 0xdb, 0x52, 0x9a,
+	0x00, 0x3d, 0xd1, 0x69, 0x3f, 0x25, 0x2d, 0x98, 0xd8, 0xb9, 0x2c, 0xb8,
+	0xdb, 0xcb, 0x0a, 0x3b, 0xa5, 0x25, 0x10, 0x49, 0xb1, 0x86, 0x09, 0x95,
+	0x43, 0x13, 0xb3, 0x17, 0x1d, 0xfe, 0xdb, 0x43, 0x8a, 0x23, 0x2c, 0x85,
+	0x0a, 0xa2, 0x35, 0x1e, 0x88, 0xbd, 0xc8, 0xf0, 0x9d, 0x3e, 0xd2, 0x5e,
+	0x49, 0x28, 0x16, 0x32, 0x0d, 0xb7, 0x6a, 0xc5, 0x83, 0xb6, 0x6f, 0x96,
+	0xb9, 0xb5, 0x28, 0xe0, 0x53, 0xfe, 0x42, 0xd3, 0xb1, 0xbb, 0xd8, 0xfc,
+	0x7c, 0x36, 0x9e, 0x8f, 0xc5, 0x47, 0xf7, 0xfb, 0x51, 0xe8, 0x26, 0xbe,
+	0xaf, 0x87, 0x25, 0x57, 0x39, 0x3b, 0xc1, 0x65, 0xde, 0x2d, 0x61, 0x49,
+	0x54, 0xd6, 0xcd, 0x71, 0x87, 0x94, 0x46, 0x40, 0x89, 0x14, 0x5a, 0x88,
+	0x31, 0x08, 0xe0, 0x10, 0xce, 0xc0, 0x90, 0x8d, 0xf8, 0x93, 0xce, 0xce,
+	0x71, 0x81, 0xf4, 0x4a, 0x46, 0xf1, 0x98, 0x6d, 0xe8, 0x5d, 0x0e, 0x5e,
+	0xfc, 0x79, 0x67, 0x84, 0x88, 0x80, 0x19, 0x99, 0xa2, 0x1b, 0xff, 0xc6,
+	0x91, 0x91, 0x3a, 0x8a, 0xd6, 0x7c, 0x60, 0xfe, 0x26, 0x93, 0x7f, 0xdf,
+	0x08, 0x33, 0x21, 0x75, 0x10, 0xed, 0xf1, 0xc4, 0xac, 0x45, 0x03, 0xbf,
+	0xf6, 0x15, 0xb2, 0x0a, 0xcf, 0xe5, 0xc2, 0xe5, 0xd9, 0x55, 0xee, 0x4e,
+	0x32, 0xb9, 0xf7, 0x09, 0x70, 0x13, 0xd7, 0x57, 0xd3, 0x9a, 0x0b, 0x8c,
+	0xd7, 0x60, 0xa2, 0xe7, 0x3e, 0x21, 0x6e, 0xa0, 0xda, 0xea, 0x18, 0x5b,
+	0x80, 0xb3, 0x38, 0xec, 0xb2, 0xf6, 0x0e, 0x02, 0x3d, 0xd4, 0x39, 0x35,
+	0x20, 0x69, 0xd2, 0xf4, 0xe9, 0x76, 0xbd, 0x3a, 0xd1, 0x66, 0xcf, 0x3b,
+	0x22, 0x54, 0x06, 0xcd, 0xdc, 0x56, 0xd4, 0xe8, 0x25, 0x8f, 0xb9, 0x86,
+	0x18, 0x85, 0x60, 0x02, 0xe7, 0x74, 0x80, 0xee, 0xe8, 0x53, 0xef, 0x52,
+	0xf0, 0xa0, 0xef, 0xbb, 0x61, 0x6c, 0x05, 0x8e, 0xea, 0xb4, 0x9b, 0xd2,
+	0x1e, 0x48, 0xbc, 0x54, 0x33, 0x9c, 0xa5, 0x61, 0x51, 0xd5, 0xf7, 0xd7,
+	0x90, 0xa2, 0x08, 0xcf, 0xe1, 0x82, 0xed, 0xdd, 0x05, 0xe6, 0x6b, 0x72,
+	0xf1, 0xf3, 0xdd, 0x38, 0x36, 0x12, 0x4f, 0xd5, 0xca, 0x07, 0xe9, 0x9f,
+	0x2c, 0xf6, 0x3b, 0x53, 0x44, 0xe3, 0xbc, 0x08, 0xf2, 0x31, 0xfb, 0xd0,
+	0xf9, 0x3c, 0x3c, 0xba, 0xdb, 0xcf, 0x4a, 0x33, 0xa1, 0x75, 0x18, 0x6c,
+	0xf1, 0xce, 0x0d, 0x41, 0x0b, 0x36, 0x76, 0x0f, 0x1b, 0xae, 0xd7, 0x26,
+	0xc2, 0x6f, 0x78, 0x59, 0x67, 0xc7, 0xb8, 0x02, 0x5a, 0xa5, 0xe1, 0x50,
+	0xcd, 0x74, 0xd6, 0x8e, 0x41, 0x05, 0xd7, 0x7a, 0x03, 0xc2, 0x26, 0xe8,
+	0xcf, 0x2e, 0x73, 0x6f, 0x11, 0xc8, 0xa3, 0xac, 0x8d, 0x83, 0x23, 0x3f,
+	0xb5, 0x2d, 0xb1, 0x49, 0xf9, 0x07, 0x8d, 0xdf, 0xe2, 0x92, 0xeb, 0x9c,
+	0x19, 0xa0, 0x32, 0x6a, 0xc6, 0xb2, 0xa0, 0x6e, 0xab, 0x6b, 0xec, 0x11,
+	0xc6, 0x42, 0xa0, 0x81, 0x5a, 0xab, 0x00, 0x5c, 0xc1, 0xad, 0x5e, 0xb1,
+	0xa8, 0xe9, 0xcb, 0x6d, 0x4b, 0x6d, 0x42, 0xfc, 0x40, 0xf7, 0xf5, 0xb1,
+	0xf4, 0x28, 0x66, 0x33, 0xfa, 0xc5, 0xab, 0x37, 0x2d, 0xbc, 0x98, 0xf3,
+	0x08, 0x68, 0x91, 0xc6, 0x4b, 0x31, 0x83, 0x51, 0x1e, 0x46, 0x5d, 0x58,
+	0x3f, 0x45, 0x2d, 0x5e, 0xb8, 0x39, 0xeb, 0xc0, 0xd8, 0x0d, 0x6c, 0xdb,
+	0x6e, 0x5b, 0x6b, 0x03, 0xe0, 0x06, 0xae, 0xed, 0x86, 0xb5, 0x55, 0x30,
+	0xae, 0x83, 0x66, 0x6f, 0x3b, 0x68, 0xf5, 0x86, 0x85, 0x55, 0x53, 0x9e,
+	0x43, 0x05, 0xd3, 0x3a, 0x0b, 0xc6, 0x76, 0xe0, 0xea, 0x6e, 0x3b, 0x6b,
+	0xc5, 0x80, 0x86, 0x69, 0x95, 0x85, 0x73, 0x33, 0xd0, 0x65, 0xfd, 0x1d,
+	0x25, 0x6a, 0xe8, 0x52, 0xfe, 0x40, 0xf3, 0xb5, 0xb9, 0xf0, 0x78, 0x6e,
+	0x16, 0xba, 0x8d, 0xaf, 0xe3, 0x65, 0x99, 0x5d, 0xeb, 0x0e, 0x38, 0x9d,
+	0xa3, 0x03, 0x7d, 0xd7, 0x8d, 0x73, 0x23, 0xd0, 0x44, 0xed, 0x5d, 0x04,
+	0xfe, 0xe8, 0x73, 0xef, 0x10, 0xd0, 0x20, 0xad, 0x93, 0x60, 0x2e, 0x27,
+	0x2e, 0xac, 0x9e, 0xb2, 0x14, 0x2e, 0xc8, 0xde, 0x7c, 0x70, 0xfe, 0x07,
+	0x83, 0x3f, 0xfe, 0x9c, 0x33, 0x00, 0x64, 0x40, 0xce, 0x64, 0xd0, 0xcf,
+	0x5d, 0x43, 0x8e, 0x62, 0x34, 0x83, 0x5b, 0xbe, 0x52, 0x57, 0xd0, 0xab,
+	0x1d, 0x8d, 0xea, 0xb2, 0xfb, 0xde, 0x18, 0x30, 0x30, 0x63, 0x53, 0xf0,
+	0xa3, 0xdf, 0xbd, 0x62, 0x50, 0xc3, 0x95, 0xda, 0x82, 0x98, 0x8d, 0xe8,
+	0x93, 0xef, 0xde, 0x31, 0xa0, 0x60, 0x4a, 0x67, 0xe0, 0xc8, 0x4e, 0x7d,
+	0x49, 0x6d, 0x46, 0xbc, 0x48, 0xf3, 0xa5, 0xb9, 0xd1, 0x68, 0x2e, 0x37,
+	0x2e, 0x8d, 0x8e, 0xf2, 0x35, 0xba, 0xc8, 0xff, 0x6d, 0x20, 0xdd, 0x92,
+	0x97, 0x5c, 0xe6, 0xdc, 0x02, 0x94, 0x45, 0x71, 0x9f, 0x15, 0x67, 0x5a,
+	0x68, 0x31, 0xc6, 0x01, 0x90, 0x03, 0x19, 0x97, 0x43, 0x17, 0xf3, 0x1f,
+	0x19, 0xae, 0xd3, 0x66, 0xca, 0x6b, 0x28, 0x51, 0x42, 0x87, 0xf0, 0x06,
+	0x8e, 0xed, 0xc4, 0x95, 0xd5, 0x72, 0x86, 0x82, 0x24, 0x4d, 0x9b, 0x2e,
+	0xdf, 0xaf, 0x43, 0x65, 0xd3, 0xfc, 0x6b, 0x46, 0xb1, 0x98, 0xe9, 0xa8,
+	0x5d, 0x8b, 0x0e, 0xfe, 0xfd, 0x23, 0xc4, 0x05, 0xd4, 0x4b, 0x15, 0xc3,
+	0x1b, 0x3a, 0x96, 0x17, 0x55, 0x7e, 0x4f, 0x0b, 0x2a, 0xb6, 0x36, 0x07,
+	0x1e, 0xee, 0xdd, 0x02, 0x96, 0x65, 0x75, 0x9d, 0x3d, 0xe3, 0x48, 0x48,
+	0x15, 0xc4, 0x6b, 0x34, 0x91, 0x7b, 0x9b, 0x40, 0x3f, 0x75, 0x2d, 0x3d,
+	0x88, 0xf9, 0x88, 0x7c, 0xd9, 0x6e, 0x5f, 0x2b, 0x0b, 0xe4, 0x56, 0xa6,
+	0xc8, 0xc6, 0xfd, 0x51, 0xe4, 0xe6, 0xa6, 0xa3, 0x77, 0x3d, 0x38, 0xf9,
+	0xe3, 0xcd, 0x19, 0x07, 0x42, 0x2e, 0x60, 0x5e, 0x26, 0xd9, 0xde, 0x5f,
+	0x40, 0xba, 0x24, 0x3f, 0xbb, 0xcd, 0xad, 0x47, 0x21, 0x9b, 0xf0, 0x3f,
+	0x1e, 0x9c, 0xfd, 0xe1, 0xe4, 0x8d, 0x17, 0x63, 0x1e, 0x20, 0x3d, 0x92,
+	0x59, 0xbd, 0x66, 0x11, 0xdb, 0x93, 0x8b, 0x9e, 0xff, 0xc4, 0xb0, 0x85,
+	0x3a, 0xa3, 0x46, 0x2c, 0x49, 0xca, 0x36, 0xf8, 0xee, 0x1f, 0x23, 0x0e,
+	0xa4, 0x5c, 0x82, 0x9c, 0xcc, 0xf0, 0x95, 0xbe, 0xc2, 0x56, 0xe9, 0x38,
+	0x5c, 0xb2, 0x9d, 0xbf, 0xc2, 0x54, 0xc9, 0x3c, 0x5e, 0x9a, 0x19, 0xad,
+	0xe2, 0x70, 0xcb, 0x56, 0xfa, 0x08, 0x7b, 0xa1, 0xe1, 0x58, 0x4d, 0x64,
+	0xde, 0x2e, 0x51, 0x4f, 0x57, 0xea, 0x0b, 0x6a, 0xb7, 0xa2, 0x45, 0x1f,
+	0x7f, 0xcf, 0x09, 0x02, 0x33, 0x34, 0x25, 0x3b, 0xf8, 0xf5, 0xaf, 0x14,
+	0x15, 0x78, 0xab, 0x47, 0x2c, 0x4b, 0xea, 0x32, 0xfa, 0xc6, 0x9b, 0x31,
+	0x2e, 0x80, 0x5e, 0xe8, 0x38, 0x5e, 0x92, 0x99, 0xbd, 0xea, 0xd0, 0xdb,
+	0x1c, 0x7a, 0x98, 0x73, 0x09, 0x70, 0x12, 0xc7, 0x55, 0xd2, 0x8e, 0x49,
+	0x85, 0xc7, 0x72, 0xa3, 0xd2, 0x6c, 0x68, 0x5f, 0x26, 0xdb, 0xfe, 0x5b,
+	0x42, 0x92, 0xa0, 0x2d, 0x9b, 0xe9, 0xaf, 0x2d, 0x85, 0x09, 0x92, 0x33,
+	0x1d, 0xb4, 0x7b, 0xd3, 0xc0, 0xab, 0x3d, 0x8d, 0xa8, 0x92, 0x7b, 0x9c,
+	0x30, 0x31, 0x72, 0x41, 0xf3, 0xb6, 0x89, 0xf6, 0x7b, 0x52, 0xd0, 0xa1,
+	0xbd, 0x99, 0xe0, 0x3a, 0x6f, 0x86, 0xb8, 0x84, 0x3a, 0xa1, 0x66, 0x28,
+	0x4b, 0xe2, 0xb2, 0xea, 0xce, 0x3b, 0x21, 0x64, 0x00, 0xce, 0xe0, 0x90,
+	0xcf, 0xd8, 0x13, 0x8c, 0xe6, 0x70, 0xc3, 0xd6, 0xea, 0x00, 0xdb, 0xb1,
+	0xab, 0xd8, 0xdd, 0x6c, 0x76, 0xbf, 0x1b, 0xc5, 0x66, 0xe6, 0xab, 0x72,
+	0x7d, 0x32, 0xdd, 0xb7, 0xc7, 0x14, 0xc3, 0x18, 0x0a, 0x90, 0x14, 0x69,
+	0xb8, 0x54, 0x3b, 0x1c, 0xb5, 0x69, 0xf1, 0xc5, 0xbd, 0x57, 0x00, 0xaa,
+	0xa0, 0x5e, 0xab, 0x08, 0xdc, 0xd1, 0xa5, 0xfe, 0xa1, 0xe2, 0x69, 0x5b,
+	0x65, 0xe3, 0xfc, 0x08, 0x76, 0x71, 0xfb, 0x55, 0xa9, 0x3e, 0xb8, 0xfe,
+	0x9b, 0x42, 0x1e, 0x61, 0x2d, 0x14, 0x18, 0xa9, 0xa1, 0x48, 0xc9, 0x05,
+	0xce, 0xeb, 0x20, 0xd9, 0xd3, 0x8f, 0x5a, 0xb7, 0xc0, 0x65, 0xdd, 0x1d,
+	0x67, 0x4a, 0x68, 0x10, 0xd6, 0x41, 0xb1, 0x97, 0x19, 0xb6, 0x52, 0x47,
+	0xd0, 0x8a, 0x0d, 0xcd, 0xcb, 0x26, 0xfb, 0xff, 0x09, 0x60, 0x13, 0xf6,
+	0x47, 0x93, 0xbb, 0x9f, 0x8c, 0xf6, 0x71, 0xf2, 0xc4, 0xab, 0x35, 0x0d,
+	0xb8, 0x9a, 0xdb, 0x8c, 0x7a, 0xb1, 0xe2, 0x49, 0x5b, 0x27, 0xc3, 0x7c,
+	0x4a, 0x5e, 0x70, 0xb9, 0x77, 0x09, 0x78, 0x92, 0xd7, 0x5d, 0x72, 0x9e,
+	0x03, 0x05, 0x57, 0x7a, 0x0b, 0x43, 0x26, 0xe2, 0x6e, 0x2a, 0x7b, 0xe6,
+	0x91, 0xd2, 0x0a, 0x08, 0x95, 0x40, 0x23, 0xb5, 0x14, 0x21, 0x38, 0xc0,
+	0x73, 0xbc, 0x20, 0x73, 0x73, 0xd1, 0xf1, 0xbf, 0x1c, 0xb4, 0x78, 0xe3,
+	0xc6, 0xa8, 0x01, 0x4b, 0xb3, 0xa2, 0x4d, 0x9f, 0x6f, 0xc7, 0xa9, 0x12,
+	0x79, 0xb4, 0xb5, 0x33, 0x50, 0x64, 0xe5, 0x9e, 0x24, 0x74, 0x0b, 0x5f,
+	0xe6, 0xdb, 0x72, 0x9a, 0x42, 0x1d, 0x51, 0x2b, 0x17, 0x24, 0x6f, 0xba,
+	0x78, 0xff, 0x06, 0x91, 0x1d, 0xfb, 0x8a, 0x59, 0x8d, 0x66, 0x72, 0xeb,
+	0x53, 0xe8, 0x22, 0xfe, 0xa7, 0x83, 0x75, 0x5f, 0x1c, 0x7b, 0x89, 0x61,
+	0x0a, 0x65, 0x44, 0x8c, 0x4c, 0xd0, 0x9d, 0x7d, 0xe2, 0xdc, 0x0a, 0x14,
+	0x55, 0x79, 0x3f, 0x05, 0x2d, 0xda, 0xf8, 0x39, 0x6e, 0x90, 0xda, 0x89,
+	0x28, 0x9b, 0xe3, 0x0f, 0x39, 0x8f, 0x81, 0x06, 0x6b, 0xbd, 0x00, 0x71,
+	0x11, 0xf5, 0x73, 0xd5, 0xb0, 0xa7, 0x1a, 0xe5, 0x64, 0x84, 0x8f, 0xf0,
+	0x17, 0x9e, 0xce, 0xd5, 0xc1, 0xb6, 0xef, 0x96, 0xb1, 0x34, 0x28, 0xea,
+	0xf2, 0xfa, 0x4a, 0x5a, 0x31, 0xa1, 0x71, 0x58, 0x64, 0xf5, 0x9e, 0x05,
+	0x64, 0x4b, 0x7e, 0x72, 0xdb, 0x53, 0x8b, 0x12, 0x3e, 0xc4, 0x3f, 0x74,
+	0x3c, 0x2f, 0x8b, 0xec, 0xde, 0x37, 0xc0, 0x6c, 0x4c, 0x1f, 0x6c, 0xff,
+	0x2e, 0x11, 0x4f, 0xd3, 0xaa, 0x0b, 0xef, 0xe7, 0xa0, 0xc1, 0x5b, 0x3f,
+	0x42, 0x5d, 0x50, 0xbf, 0x55, 0x25, 0xfe, 0xa8, 0x73, 0x6b, 0x50, 0xd0,
+	0xa5, 0xfd, 0x91, 0xe4, 0x6a, 0x67, 0xa3, 0xf8, 0xcc, 0x3e, 0x75, 0x2e,
+	0x0d, 0x8e, 0xfa, 0xb4, 0xba, 0xc2, 0x5e, 0x69, 0x28, 0x54, 0x12, 0x8d,
+	0xf5, 0x42, 0xc4, 0xc1, 0x94, 0xcf, 0xd0, 0x93, 0x9c, 0xee, 0xd0, 0xd3,
+	0x9c, 0x6a, 0x90, 0xd3, 0x19, 0x3a, 0x92, 0x57, 0x5d, 0x7a, 0x1f, 0x03,
+	0x0f, 0xf6, 0x7e, 0x03, 0xca, 0xa6, 0xf8, 0xc7, 0x8e, 0x63, 0x25, 0x91,
+	0x58, 0xab, 0x04, 0x1c, 0xc9, 0xa9, 0x0e, 0xb9, 0x8d, 0xa9, 0x83, 0x69,
+	0x9f, 0x25, 0x67, 0x39, 0x58, 0xf1, 0xa5, 0xbd, 0x91, 0x60, 0x2a, 0x67,
+	0x26, 0xa8, 0xce, 0xba, 0x31, 0x6e, 0x80, 0xda, 0xa8, 0x38, 0xdb, 0xc2,
+	0x9b, 0x39, 0xae, 0x90, 0x56, 0x48, 0x28, 0x14, 0x12, 0x09, 0xb5, 0x42,
+	0x41, 0x91, 0x96, 0x4b, 0x94, 0xd3, 0x11, 0xba, 0x82, 0x5f, 0xfd, 0x6a,
+	0x55, 0x83, 0x9f, 0xfe, 0xd6, 0x92, 0x80, 0x2c, 0xc9, 0xcb, 0x2e, 0x7b,
+	0xef, 0x01, 0xc0, 0x03, 0xbc, 0xc7, 0x03, 0xb3, 0x37, 0x1d, 0xbc, 0xfb,
+	0xc3, 0xc8, 0x0b, 0x2d, 0xc7, 0x28, 0x02, 0x73, 0x34, 0xa1, 0x7b, 0xf8,
+	0x70, 0xff, 0x16, 0x91, 0x3c, 0xeb, 0xca, 0x78, 0x19, 0x66, 0x53, 0xfa,
+	0x03, 0xcb, 0xb7, 0xea, 0xc4, 0x9b, 0x35, 0x6e, 0x88, 0x5a, 0xb8, 0x30,
+	0x7b, 0xd2, 0xd1, 0xb9, 0x3e, 0x98, 0xfe, 0xd9, 0x62, 0x9e, 0x23, 0x05,
+	0x15, 0x5a, 0x8b, 0x01, 0x0e, 0xe3, 0x2c, 0x08, 0xdb, 0xa0, 0xbb, 0xfb,
+	0xcc, 0x38, 0x15, 0x22, 0x0b, 0xf6, 0x76, 0x83, 0xda, 0xae, 0x58, 0xd7,
+	0xc4, 0xe3, 0xb5, 0x99, 0xf0, 0x3a, 0x4e, 0x96, 0xf8, 0xa5, 0xae, 0xa1,
+	0x47, 0x39, 0x1b, 0xc1, 0x27, 0xfe, 0xad, 0x23, 0x61, 0x55, 0x94, 0xef,
+	0xd1, 0xc1, 0xbe, 0x6f, 0x86, 0xb9, 0x94, 0x38, 0xa0, 0x72, 0x6a, 0x42,
+	0xf2, 0xa0, 0xeb, 0xfb, 0x69, 0x68, 0x55, 0x86, 0xcf, 0xf4, 0xd3, 0xd6,
+	0xca, 0x00, 0x99, 0x91, 0x2b, 0x9a, 0xf5, 0x6d, 0x34, 0x9d, 0xbb, 0x83,
+	0x4c, 0xcf, 0x6d, 0x42, 0xfd, 0x50, 0xf5, 0xf4, 0xa5, 0xb6, 0x21, 0x76,
+	0x21, 0xfb, 0xf0, 0xf9, 0x7e, 0x1c, 0x3a, 0x99, 0xe7, 0x4b, 0x71, 0x83,
+	0xd5, 0x5e, 0x46, 0xd8, 0x08, 0x3d, 0xc1, 0x69, 0x1e, 0x35, 0x6d, 0xb9,
+	0x4c, 0xb9, 0x0d, 0xa9, 0x8b, 0xe8, 0x9f, 0x2f, 0xc6, 0x3d, 0x50, 0x78,
+	0x25, 0xa7, 0x38, 0xc4, 0x32, 0xa4, 0x26, 0x22, 0x6f, 0xb6, 0xb8, 0xe7,
+	0x0a, 0x61, 0x05, 0x94, 0x4a, 0x81, 0x81, 0x1a, 0xab, 0x84, 0x1c, 0xc1,
+	0x28, 0x0e, 0xb3, 0x2c, 0xad, 0x8b, 0xe0, 0x1f, 0x3f, 0xce, 0x9d, 0x40,
+	0x32, 0xa5, 0x37, 0x30, 0x6c, 0xa3, 0xee, 0xac, 0x13, 0x63, 0x16, 0xa0,
+	0x2d, 0x9a, 0xf9, 0xad, 0x2c, 0x91, 0x4b, 0x9b, 0x23, 0x0f, 0xb5, 0x4e,
+	0x81, 0x89, 0x9a, 0xbb, 0x8c, 0xbc, 0xd1, 0x62, 0x8e, 0x23, 0x24, 0x05,
+	0x1a, 0xaa, 0x95, 0x0e, 0xc2, 0x3d, 0x58, 0xf8, 0x35, 0xaf, 0x98, 0xd4,
+	0x78, 0x24, 0xb6, 0x2a, 0xc7, 0x27, 0xf2, 0x6d, 0x3b, 0x6d, 0xa5, 0x8c,
+	0x80, 0x11, 0x19, 0xb2, 0x13, 0x5f, 0xd6, 0xdb, 0x11, 0xaa, 0x82, 0x7e,
+	0xed, 0x2a, 0x74, 0x17, 0x9f, 0xdf, 0xc7, 0xc2, 0xa3, 0xb9, 0xdd, 0xa8,
+	0x36, 0x3b, 0xde, 0x95, 0xe1, 0x32, 0xed, 0xb6, 0xb4, 0x26, 0x02, 0x6f,
+	0xf4, 0x98, 0x67, 0x48, 0x49, 0x04, 0xd6, 0x68, 0x21, 0xc7, 0x30, 0x82,
+	0x42, 0x2c, 0x41, 0x4a, 0x26, 0xf0, 0x4e, 0x0f, 0x69, 0x8e, 0x34, 0x54,
+	0x2a, 0x0d, 0x86, 0x7a, 0xa4, 0xb2, 0x62, 0x4e, 0x23, 0xa8, 0xc4, 0x1a,
+	0x25, 0x64, 0x08, 0x4e, 0xf0, 0x98, 0x6f, 0xc8, 0x59, 0x0c, 0x76, 0x78,
+	0x6b, 0x47, 0xa0, 0x8a, 0xea, 0xbd, 0x0b, 0xc0, 0x17, 0xfc, 0xee, 0x17,
+	0xa3, 0x1e, 0xac, 0xfc, 0x92, 0xd6, 0x4c, 0x60, 0x9d, 0x16, 0x53, 0x1c,
+	0x63, 0x09, 0x50, 0x12, 0x85, 0x75, 0x52, 0xcc, 0x61, 0x84, 0x85, 0x50,
+	0x03, 0x94, 0x46, 0x41, 0x99, 0x16, 0x5b, 0x9c, 0x73, 0x01, 0xf0, 0x02,
+	0xcf, 0xf5, 0xc2, 0xc4, 0xc9, 0x15, 0xcf, 0xda, 0x32, 0x98, 0xe6, 0x59,
+	0x53, 0x86, 0xc3, 0x34, 0xcb, 0xda, 0x3a, 0x18, 0xf6, 0x51, 0xf3, 0x96,
+	0x89, 0xb4, 0x5b, 0xd2, 0x92, 0x89, 0xbc, 0xdb, 0xc2, 0x9a, 0x29, 0xac,
+	0x91, 0x42, 0x0a, 0x21, 0x04, 0x00, 0x08, 0x80, 0x10, 0x08, 0xa0, 0x10,
+	0x4a, 0x80, 0x90, 0x08, 0xa8, 0x91, 0x4a, 0x8a, 0x31, 0x0c, 0xa0, 0x18,
+	0xca, 0x90, 0x98, 0xa8, 0xb8, 0xdb, 0xca, 0x1a, 0x39, 0xa4, 0x31, 0x52,
+	0x40, 0xa1, 0x94, 0x08, 0xa0, 0x11, 0x5a, 0x82, 0x91, 0x1c, 0xea, 0x98,
+	0x5a, 0x98, 0x30, 0x39, 0xf2, 0x51, 0xfb, 0x16, 0x99, 0xbc, 0xfb, 0xc2,
+	0xd8, 0x09, 0x2c, 0xd3, 0x6a, 0x0b, 0x63, 0x26, 0xa0, 0x4e, 0xaa, 0x39,
+	0xce, 0x90, 0x90, 0x28, 0xa8, 0xd3, 0x6a, 0x0a, 0x73, 0x24, 0xa1, 0x5a,
+	0xe8, 0x30, 0xde, 0x82, 0x91, 0x1d, 0xfa, 0x9a, 0x5b, 0x8c, 0x72, 0x30,
+	0xe2, 0x43, 0xfa, 0x23, 0xcb, 0xf5, 0xca, 0x44, 0xd9, 0x1d, 0x6f, 0xca,
+	0x78, 0x18, 0x76, 0x51, 0xfb, 0x17, 0x89, 0xbe, 0xfa, 0xd6, 0x9a, 0x00,
+	0x3c, 0xc1, 0x6b, 0x3e, 0x31, 0x6f, 0x91, 0xc8, 0xab, 0x2d, 0x8d, 0x89,
+	0x82, 0x3b, 0xbd, 0xa4, 0x31, 0x53, 0x50, 0xa3, 0x95, 0x1c, 0xe2, 0x18,
+	0x4a, 0x90, 0x90, 0x29, 0xb8, 0xd1, 0x6b, 0x1e, 0x31, 0x2d, 0xb1, 0x48,
+	0xe9, 0x05, 0x8c, 0xcb, 0xa0, 0x9b, 0xfb, 0x8e, 0x18, 0x95, 0x60, 0x23,
+	0xf7, 0x34, 0xa1, 0x7a, 0xe8, 0x72, 0xfe, 0x02, 0xd3, 0x35, 0xfb, 0xd8,
+	0x79, 0x2c, 0x34, 0x1a, 0xcb, 0x85, 0xca, 0xa3, 0xa9, 0xdd, 0x89, 0x26,
+	0x7b, 0xff, 0x01, 0xe1, 0x13, 0xfc, 0xe6, 0x97, 0xb3, 0x16, 0x0c, 0xec,
+	0xd8, 0x56, 0xdc, 0x68, 0x35, 0x87, 0x19, 0x96, 0x52, 0x05, 0xf0, 0x0a,
+	0x4f, 0xe5, 0xca, 0x64, 0xd9, 0x5f, 0x4f, 0x4a, 0x3a, 0x30, 0x77, 0x13,
+	0xd9, 0xb7, 0xcf, 0x94, 0xd3, 0x10, 0xaa, 0x80, 0x5e, 0xe9, 0x28, 0x5c,
+	0x93, 0x8d, 0xff, 0xe3, 0xc0, 0xc9, 0x1d, 0x4f, 0xca, 0x3a, 0x38, 0xf6,
+	0x13, 0xd3, 0x16, 0xcb, 0x9c, 0x5a, 0x90, 0xb0, 0x29, 0xfa, 0xf1, 0xeb,
+	0x5c, 0x19, 0x2c, 0xf3, 0x6a, 0x49, 0x43, 0xa6, 0xe2, 0x66, 0xab, 0x7b,
+	0xec, 0x30, 0xd6, 0x02, 0x81, 0x15, 0x5a, 0x8a, 0x11, 0x0c, 0xe2, 0x38,
+	0x4a, 0xd2, 0xb0, 0xa9, 0xfa, 0xf9, 0x6a, 0x5c, 0x13, 0x8d, 0xf7, 0x62,
+	0xc0, 0xc3, 0xbc, 0x4b, 0xc2, 0xb3, 0xb8, 0xec, 0xba, 0x77, 0x0e, 0x08,
+	0x9c, 0xd0, 0x31, 0xbc, 0xa0, 0x73, 0x7b, 0x50, 0xf1, 0xb5, 0xbd, 0xb0,
+	0x70, 0x6a, 0x46, 0xb2, 0xa8, 0xef, 0xab, 0x61, 0x4d, 0x15, 0xce, 0xcb,
+	0x20, 0x9b, 0xf3, 0x0f, 0x18, 0x9f, 0xc1, 0x27, 0xff, 0xbd, 0x21, 0x60,
+	0x41, 0xd6, 0xe6, 0xc1, 0xd3, 0xbf, 0x5a, 0xd4, 0xf0, 0xa5, 0xbe, 0xa1,
+	0x66, 0x29, 0x5b, 0xe0, 0xb3, 0xfe, 0x8c, 0x32, 0x31, 0x76, 0x01, 0xfb,
+	0xb2, 0xd9, 0xfe, 0x5e, 0x12, 0x98, 0xa5, 0x69, 0xd1, 0xc5, 0xff, 0x77,
+	0x80, 0xe8, 0x88, 0x5f, 0xe9, 0x2a, 0x7c, 0x97, 0x8f, 0xd7, 0x67, 0xd2,
+	0xe9, 0x39, 0x4d, 0xa0, 0x9e, 0xaa, 0x94, 0x1f, 0xd0, 0x3e, 0x4d, 0xae,
+	0x7e, 0xb6, 0x9a, 0xc7, 0x4c, 0x43, 0xad, 0x52, 0x70, 0xa0, 0xe7, 0x3a,
+	0x61, 0x66, 0xa4, 0x8a, 0xe2, 0x3d, 0x1b, 0xc8, 0xb7, 0xec, 0xa4, 0x97,
+	0x33, 0x16, 0x04, 0x6d, 0xd8, 0x5c, 0x7d, 0x6c, 0x3d, 0x0e, 0x99, 0x8c,
+	0xfb, 0xa1, 0xe8, 0xc9, 0x4f, 0x6f, 0x6b, 0x68, 0x50, 0xd6, 0xc5, 0xf1,
+	0x97, 0x9c, 0xe6, 0x50, 0xc3, 0x94, 0xca, 0x80, 0x99, 0x99, 0xaa, 0x9a,
+	0xff, 0xcc, 0x30, 0x95, 0x32, 0x03, 0x56, 0x66, 0xc9, 0x5a, 0x3e, 0x50,
+	0x7f, 0x55, 0xa9, 0x3f, 0xa8, 0xfc, 0x9a, 0x56, 0x5c, 0x68, 0x3d, 0x06,
+	0x19, 0x9c, 0xf3, 0x01, 0xf8, 0x83, 0xcf, 0xff, 0x63, 0xc0, 0xc1, 0x9c,
+	0x4f, 0xc0, 0x9b, 0x3c, 0xfe, 0x9a, 0x53, 0x0c, 0x62, 0x38, 0x42, 0x53,
+	0xb0, 0xa3, 0x5b, 0xfd, 0x62, 0xd5, 0x93, 0x97, 0x5e, 0xc6, 0xd8, 0x00,
+	0xbc, 0xc1, 0x63, 0xbf, 0x31, 0x65, 0x30, 0xcc, 0xa3, 0xa4, 0x0d, 0x93,
+	0x2b, 0x9f, 0xa5, 0x67, 0x31, 0xd9, 0xf1, 0xaf, 0x1c, 0x95, 0x68, 0xa3,
+	0xe7, 0x3c, 0x01, 0x6a, 0xa2, 0xf2, 0x6e, 0x0a, 0x7b, 0xa4, 0xb1, 0x52,
+	0x48, 0x20, 0x94, 0x02, 0x01, 0x15, 0x52, 0x0b, 0x11, 0x06, 0x43, 0x3c,
+	0x42, 0x5b, 0x30, 0xb3, 0x53, 0x5d, 0x72, 0x9f, 0x13, 0x07, 0x56, 0x6e,
+	0x49, 0x4a, 0x36, 0xf0, 0x6f, 0x1f, 0x29, 0xaf, 0xa0, 0x54, 0x0b, 0x1c,
+	0xd6, 0x59, 0x31, 0xa6, 0x01, 0x56, 0x63, 0x99, 0x50, 0x3b, 0x14, 0x35,
+	0x79, 0xf9, 0x65, 0xad, 0x1d, 0x80, 0x3a, 0xa8, 0xf6, 0x3a, 0x42, 0x56,
+	0xe0, 0xa9, 0x5e, 0xb9, 0x28, 0xf9, 0xc3, 0xcd, 0x5b, 0x27, 0xc2, 0x6c,
+	0x48, 0x5f, 0x64, 0xfb, 0x7e, 0x19, 0x6a, 0x93, 0xe2, 0x0f, 0x3b, 0xaf,
+	0x85, 0x04, 0x43, 0x39, 0x12, 0x51, 0x35, 0xf7, 0x19, 0x71, 0x22, 0xc5,
+	0x16, 0xe6, 0x4c, 0x02, 0xbd, 0xd4, 0x31, 0xb4, 0x20, 0x63, 0x73, 0xf0,
+	0xe1, 0xff, 0x3d, 0x20, 0x78, 0xc2, 0xd7, 0xf8, 0x22, 0xde, 0xa7, 0xc1,
+	0x55, 0xdf, 0x5e, 0x53, 0x88, 0x23, 0x28, 0xc5, 0x02, 0xa6, 0x65, 0x16,
+	0xad, 0xfd, 0x80, 0xf4, 0x49, 0x76, 0xf7, 0x9b, 0x51, 0x2e, 0x46, 0x3e,
+	0x68, 0xff, 0x26, 0x91, 0x5f, 0xdb, 0x0a, 0x1b, 0xa5, 0x67, 0x30, 0xc9,
+	0xf3, 0xae, 0x08, 0xd7, 0x61, 0xb3, 0xf5, 0x3d, 0x34, 0x38, 0xeb, 0xc3,
+	0xe8, 0x0b, 0x6f, 0xe7, 0xa8, 0x40, 0x5b, 0x35, 0xe3, 0x59, 0x58, 0x36,
+	0xd5, 0x3f, 0x57, 0x0c, 0x6b, 0xa8, 0x50, 0x5a, 0x04, 0xf1, 0x18, 0x6d,
+	0xe0, 0xdc, 0x0e, 0x54, 0x5d, 0x7d, 0x6f, 0x0d, 0x08, 0x9a, 0xb0, 0x3d,
+	0xba, 0xd8, 0xff, 0x4c, 0x30, 0x9d, 0xb3, 0x03, 0x5c, 0xc7, 0xcd, 0x52,
+	0xb7, 0xd0, 0x65, 0xfc, 0x0d, 0x27, 0x6b, 0xfc, 0x10, 0xf7, 0x50, 0xe1,
+	0xb4, 0x8c, 0xa2, 0x31, 0x5f, 0x90, 0xbb, 0x99, 0xec, 0xfa, 0x77, 0x8a,
+	0x48, 0x9c, 0x55, 0x61, 0xbe, 0x24, 0x37, 0x3b, 0xdd, 0xa5, 0xe7, 0x31,
+	0xd1, 0x70, 0xaf, 0x16, 0x34, 0x6c, 0xab, 0x6e, 0xbc, 0x1b, 0xc3, 0x06,
+	0xea, 0xad, 0x0a, 0xf1, 0x05, 0xbd, 0xdb, 0xc1, 0xaa, 0x2f, 0xaf, 0xad,
+	0x84, 0x11, 0x11, 0x32, 0x03, 0x57, 0x76, 0xcb, 0x5b, 0x2a, 0x12, 0x76,
+	0x45, 0xbb, 0x3e, 0x9d, 0xae, 0xd3, 0x67, 0xda, 0x69, 0x29, 0x45, 0x00,
+	0x8e, 0xe0, 0x14, 0x8f, 0xd8, 0x96, 0xdc, 0xe4, 0xf4, 0x87, 0x96, 0x67,
+	0x54, 0x89, 0x3d, 0xca, 0xd8, 0x18, 0x3c, 0xf0, 0x7b, 0x5f, 0x00, 0xbb,
+	0xb0, 0x7d, 0xba, 0x5c, 0xbf, 0x4c, 0xb5, 0xcd, 0xb1, 0x87, 0x18, 0x87,
+	0x40, 0x06, 0xe5, 0x5c, 0x04, 0xfc, 0xc8, 0x77, 0xed, 0x38, 0x54, 0x32,
+	0x8d, 0xb7, 0x62, 0x44, 0x83, 0xbc, 0xce, 0x92, 0xb1, 0x3c, 0xa8, 0xfa,
+	0xfa, 0x5a, 0x5a, 0x10, 0xb1, 0x31, 0x79, 0xf0, 0xf5, 0xbf, 0x14, 0x34,
+	0x68, 0xeb, 0x66, 0xb8, 0x4b, 0xcb, 0x23, 0xaa, 0xe5, 0x0e, 0x25, 0x4d,
+	0x98, 0x1e, 0xd9, 0xac, 0x7f, 0xa3, 0xc8, 0xcc, 0x5d, 0x45, 0xee, 0x6e,
+	0x32, 0xfb, 0xd7, 0x89, 0x32, 0x3b, 0xd6, 0x15, 0xf1, 0x3a, 0x4d, 0xa6,
+	0xfe, 0xa6, 0x92, 0x67, 0x5c, 0x09, 0x2d, 0xc2, 0x78, 0x08, 0x76, 0x70,
+	0xeb, 0x57, 0xa8, 0x2a, 0xfa, 0xf7, 0x8b, 0x50, 0x1f, 0x54, 0x7f, 0x5d,
+	0x29, 0x2f, 0xa0, 0x5c, 0x8a, 0x1c, 0xdc, 0xf8, 0x35, 0xae, 0x88, 0xd6,
+	0x79, 0x30, 0xf4, 0x23, 0xd7, 0x35, 0xf3, 0x58, 0x69, 0x24, 0x94, 0x0a,
+	0x81, 0x05, 0x5a, 0xab, 0x01, 0x4c, 0xc3, 0xac, 0x4a, 0xf3, 0xa1, 0xf9,
+	0xd9, 0x6c, 0x7e, 0x3f, 0x0b, 0xcd, 0xc6, 0xf6, 0xe1, 0xf2, 0xed, 0x3a,
+	0x75, 0x26, 0x8d, 0x9e, 0xf2, 0x14, 0xaa, 0x88, 0xde, 0xf9, 0x20, 0xfc,
+	0x83, 0xc7, 0x7f, 0x73, 0xc8, 0x61, 0x8c, 0x05, 0x40, 0x0b, 0x34, 0x56,
+	0x0b, 0x19, 0x86, 0x53, 0x34, 0xe2, 0x4b, 0x7a, 0x33, 0xc3, 0x55, 0xda,
+	0x0e, 0x59, 0x8d, 0x67, 0x62, 0xe9, 0x52, 0xfc, 0x60, 0xf7, 0xb7, 0x91,
+	0x74, 0x6a, 0x4e, 0x32, 0xb8, 0xe7, 0x0b, 0x71, 0x07, 0x95, 0x5e, 0xc3,
+	0x88, 0x0a, 0xb9, 0x85, 0x29, 0x93, 0x61, 0x3f, 0x35, 0x2d, 0xb9, 0xc8,
+	0xf9, 0x0d, 0x2c, 0xdb, 0xea, 0x1b, 0x6b, 0x86, 0xb0, 0x04, 0x2a, 0xa9,
+	0xc6, 0x38, 0x01, 0x62, 0x22, 0xe2, 0x66, 0xaa, 0x6b, 0xee, 0x31, 0xc2,
+	0x40, 0x88, 0x05, 0x48, 0x8b, 0x24, 0x5e, 0xab, 0x09, 0xcc, 0xd3, 0xa4,
+	0xea, 0xe3, 0xeb, 0x79, 0x49, 0x64, 0xd6, 0xae, 0x41, 0x47, 0xf7, 0xfa,
+	0x41, 0xea, 0x27, 0xaa, 0xed, 0x8e, 0x35, 0x45, 0x38, 0x0e, 0x93, 0x2c,
+	0xef, 0xab, 0x60, 0x5d, 0x17, 0xcf, 0xdf, 0x62, 0x92, 0xe3, 0x1d, 0x19,
+	0xaa, 0x93, 0x6e, 0xce, 0x3b, 0x20, 0x74, 0x02, 0xcf, 0xf4, 0xd2, 0xc6,
+	0xc8, 0x01, 0x8d, 0xd3, 0x22, 0x8a, 0xe7, 0x6c, 0x01, 0xcf, 0xf2, 0xb2,
+	0xca, 0xce, 0x79, 0x01, 0xe4, 0x42, 0xe6, 0xe1, 0xd2, 0xed, 0x78, 0x55,
+	0xa6, 0xcf, 0xb6, 0xf3, 0x56, 0x88, 0x28, 0x98, 0xd3, 0x09, 0x3a, 0xb3,
+	0x47, 0x1d, 0x5b, 0x8b, 0x03, 0x2e, 0xe7, 0x2e, 0x20, 0x5f, 0xb2, 0x9b,
+	0xdf, 0xce, 0x52, 0xb1, 0xb0, 0x69, 0xfa, 0x75, 0xab, 0x5c, 0x9c, 0x7c,
+	0xf1, 0xee, 0x0d, 0x03, 0x2b, 0xb6, 0x34, 0x27, 0x1a, 0xec, 0xf5, 0x86,
+	0x84, 0x45, 0x51, 0x9f, 0x57, 0x47, 0xda, 0x2a, 0x19, 0xc7, 0x43, 0xb2,
+	0xa3, 0x5f, 0xbd, 0x6a, 0xd1, 0xc3, 0x9f, 0x7b, 0x86, 0x90, 0x04, 0x68,
+	0x89, 0x46, 0x7a, 0x29, 0x63, 0x60, 0xc0, 0xc6, 0xec, 0x41, 0xc7, 0xf7,
+	0xf2, 0xc0, 0xea, 0x2d, 0x0b, 0xe9, 0x86, 0xbc, 0xc5, 0x22, 0xa7, 0x37,
+	0x34, 0x2c, 0xab, 0xea, 0xfc, 0x1b, 0x46, 0x56, 0xe8, 0x29, 0x4e, 0xb1,
+	0x88, 0xe9, 0x89, 0x4d, 0xcb, 0x2f, 0x6a, 0xfd, 0x02, 0xd5, 0x55, 0xf7,
+	0xde, 0x01, 0xa0, 0x03, 0x7a, 0xa7, 0x83, 0x74, 0x4f, 0x1e, 0x7a, 0x9d,
+	0x23, 0x03, 0x75, 0x56, 0x8d, 0x79, 0x82, 0xd4, 0x4c, 0x64, 0xdd, 0x1e,
+	0x57, 0x4c, 0x6b, 0x2c, 0x10, 0x5a, 0x81, 0xa1, 0x1a, 0xe9, 0xa4, 0x9c,
+	0x83, 0x00, 0x0f, 0xf1, 0x0e, 0x0d, 0xcd, 0xca, 0x36, 0xf9, 0xfe, 0x1d,
+	0x22, 0x1a, 0xe6, 0x55, 0x92, 0x8e, 0xcd, 0xc5, 0xc7, 0xf7, 0xf3, 0xd0,
+	0xe8, 0x2c, 0x1f, 0xab, 0x8f, 0xac, 0xd7, 0x23, 0x92, 0x65, 0x7d, 0x1d,
+	0x2d, 0xeb, 0xe8, 0x58, 0x5f, 0x44, 0xfb, 0x3c, 0x39, 0xea, 0xd1, 0xca,
+	0x0e, 0x79, 0x8d, 0x25, 0x42, 0x69, 0x10, 0xd4, 0x61, 0xb5, 0x95, 0x31,
+	0x32, 0x40, 0x67, 0xf4, 0x88, 0x67, 0x69, 0x59, 0x44, 0xf7, 0xfc, 0x21,
+	0xe6, 0x21, 0xd2, 0x61, 0xb9, 0x55, 0x29, 0x3e, 0xb0, 0x7f, 0x9b, 0x48,
+	0xbf, 0x65, 0x25, 0x9d, 0x98, 0xb3, 0x08, 0xec, 0xd1, 0xc6, 0xce, 0x61,
+	0x81, 0xd5, 0x5a, 0x06, 0xd0, 0x0c, 0x6d, 0xc9, 0x4c, 0x5e, 0x7d, 0x69,
+	0x6d, 0x04, 0x9c, 0xc8, 0xb1, 0x8d, 0xb8, 0x93, 0x4a, 0x8e, 0x71, 0x04,
+	0xa4, 0x48, 0xc2, 0xb5, 0xd8, 0xe0, 0xbc, 0x0f, 0x82, 0x3f, 0xfc, 0xbc,
+	0x37, 0x02, 0x4c, 0xc4, 0xdc, 0x44, 0xf4, 0xcd, 0x37, 0xe7, 0x1c, 0x00,
+	0x38, 0x80, 0x73, 0x38, 0x60, 0x73, 0xf6, 0x81, 0xf3, 0x3b, 0x58, 0xf4,
+	0xf5, 0xb7, 0x94, 0x24, 0x60, 0x4b, 0x76, 0xf2, 0xcb, 0x5b, 0x2b, 0x02,
+	0x74, 0x44, 0xaf, 0x7c, 0x94, 0xbe, 0xc1, 0x66, 0xef, 0x3b, 0x60, 0x74,
+	0x86, 0x8f, 0xf4, 0x57, 0x96, 0xca, 0x85, 0xc9, 0x93, 0xaf, 0xde, 0xb5,
+	0xe0, 0x60, 0xcf, 0x37, 0xe2, 0x4c, 0x0a, 0x3d, 0xc4, 0x39, 0x14, 0x30,
+	0x29, 0xf3, 0x60, 0xe9, 0x57, 0xac, 0x6a, 0xf2, 0xf3, 0xdb, 0x58, 0x3a,
+	0x14, 0x37, 0x59, 0xfd, 0x67, 0x85, 0x99, 0x92, 0x1a, 0x8c, 0xf4, 0x50,
+	0xe6, 0xc4, 0x82, 0xa5, 0x5d, 0x91, 0xae, 0xcb, 0xe7, 0xeb, 0x71, 0xc9,
+	0x74, 0xde, 0x0e, 0x51, 0x0d, 0x77, 0x6a, 0x49, 0x42, 0xb6, 0xe0, 0x67,
+	0xbf, 0x39, 0xe5, 0x20, 0xc4, 0x03, 0xb4, 0x47, 0x13, 0xbb, 0x97, 0x0d,
+	0xf6, 0x7b, 0x53, 0xc0, 0xa3, 0xbc, 0x8d, 0xa2, 0x33, 0x7f, 0x94, 0xb9,
+	0xb1, 0x68, 0xe8, 0x57, 0xae, 0x4a, 0xf6, 0xf1, 0xf3, 0xdc, 0x28, 0x34,
+	0x13, 0x5b, 0x97, 0xc3, 0x17, 0xfb, 0x9e, 0x19, 0xa4, 0x72, 0x62, 0xc2,
+	0xe2, 0xa8, 0x4b, 0xeb, 0x23, 0xe8, 0xc5, 0x8e, 0x67, 0x65, 0x99, 0x5c,
+	0xfb, 0x0c, 0x39, 0x89, 0xe1, 0x0a, 0x6d, 0xc5, 0x8c, 0x46, 0x71, 0x99,
+	0x75, 0x6b, 0x5c, 0x10, 0xbd, 0xf1, 0x61, 0xfc, 0x05, 0xa7, 0x7b, 0xf4,
+	0xb0, 0xe7, 0x1a, 0x61, 0x24, 0x84, 0x0a, 0xa0, 0x15, 0x1a, 0x8a, 0x95,
+	0x4c, 0xe2, 0xbd, 0x1a, 0xd0, 0x34, 0xed, 0xba, 0x74, 0x3e, 0x0e, 0x9f,
+	0xec, 0xf7, 0xa7, 0x90, 0x45, 0x78, 0x0f, 0x07, 0x6e, 0xee, 0x3a, 0x72,
+	0x56, 0x83, 0x99, 0x9e, 0xda, 0x94, 0xf8, 0xa0, 0xfe, 0xab, 0x42, 0x7d,
+	0x51, 0xed, 0x77, 0xa4, 0xa8, 0xc2, 0x7b, 0x39, 0x60, 0x71, 0xd6, 0x85,
+	0xf1, 0x13, 0xdc, 0xe6, 0xd5, 0x93, 0x96, 0x4e, 0xc4, 0xd9, 0x14, 0xfe,
+	0xc8, 0x73, 0xad, 0x30, 0x50, 0x62, 0x85, 0x92, 0x22, 0x0c, 0x87, 0x68,
+	0x86, 0xb7, 0x74, 0x24, 0xae, 0xaa, 0xf6, 0x3f, 0x12, 0x5c, 0xe5, 0xed,
+	0x14, 0x95, 0x78, 0xa3, 0xc6, 0x2c, 0x41, 0x4b, 0x36, 0xf2, 0x4f, 0x1b,
+	0x2b, 0x87, 0x24, 0x46, 0x2b, 0x38, 0xd4, 0x33, 0x95, 0x34, 0x63, 0x5a,
+	0x60, 0xb1, 0xd6, 0x09, 0x30, 0x13, 0x53, 0x17, 0xd3, 0x1f, 0x5b, 0x8e,
+	0x53, 0x24, 0xe2, 0x6a, 0x6a, 0x73, 0xe2, 0xc1, 0xda, 0x2f, 0x48, 0xdd,
+	0x44, 0xf7, 0xfd, 0x31, 0xe4, 0x20, 0xc6, 0x23, 0xb0, 0x45, 0x3b, 0x3f,
+	0x85, 0x2d, 0xd2, 0x79, 0x39, 0x64, 0x31, 0xde, 0x81, 0xa1, 0x1b, 0xf9,
+	0xa6, 0x9d, 0x97, 0x42, 0x06, 0xe1, 0x1c, 0x0c, 0xf8, 0x98, 0x7f, 0xc8,
+	0x78, 0x1c, 0x36, 0x59, 0xff, 0x47, 0x81, 0x9b, 0xba, 0x9e, 0x9e, 0xd4,
+	0x74, 0xe4, 0xae, 0x26, 0x37, 0x3f, 0x9d, 0xad, 0xe3, 0x61, 0xd9, 0x55,
+	0xef, 0x5e, 0x30, 0xb8, 0xe3, 0x4b, 0x79, 0x03, 0xc5, 0x56, 0xe6, 0xc8,
+	0x42, 0xbd, 0x51, 0x61, 0xb6, 0xa4, 0x27, 0x33, 0x7d, 0xb5, 0xad, 0xb1,
+	0x41, 0x78, 0x07, 0x87, 0x7e, 0xe6, 0x9a, 0x62, 0x1c, 0x03, 0x09, 0x96,
+	0x72, 0x05, 0xb2, 0x2a, 0xcf, 0xa7, 0xe2, 0x65, 0x9b, 0x7d, 0xef, 0x0c,
+	0x10, 0x19, 0xb1, 0x23, 0x59, 0xd5, 0xe7, 0xd7, 0xb1, 0xb2, 0x48, 0xee,
+	0x75, 0x82, 0xcc, 0xcc, 0x55, 0xc5, 0xfe, 0x66, 0x92, 0xeb, 0x9d, 0x09,
+	0xa2, 0x33, 0x7e, 0x84, 0xbb, 0xb0, 0x7c, 0xaa, 0x5e, 0xbe, 0x58, 0xf7,
+	0xc4, 0xa1, 0x95, 0x19, 0xb2, 0x12, 0x4f, 0xd4, 0xda, 0x05, 0xe8, 0x8b,
+	0x6e, 0xff, 0x2b, 0x41, 0x45, 0xd6, 0xee, 0x41, 0xc3, 0xb7, 0xfa, 0xc4,
+	0xba, 0x25, 0x2e, 0xa9, 0xce, 0xb8, 0x11, 0x6a, 0x82, 0xf2, 0x2c, 0x2a,
+	0xfb, 0xe6, 0x99, 0x53, 0x0a, 0x02, 0x34, 0x44, 0x2b, 0x3c, 0x94, 0x3b,
+	0x91, 0x64, 0x6b, 0x7f, 0x20, 0xf9, 0xd2, 0xdd, 0x78, 0x36, 0x96, 0x0f,
+	0xd5, 0x4f, 0x57, 0xeb, 0x1b, 0x68, 0xb6, 0xb6, 0x07, 0x16, 0x6f, 0xdd,
+	0x08, 0x37, 0x61, 0x7d, 0x14, 0xbd, 0xf9, 0xe1, 0xec, 0x0d, 0x07, 0x6b,
+	0xbe, 0x30, 0x77, 0x12, 0xc9, 0xb5, 0xce, 0x80, 0x91, 0x19, 0xba, 0x92,
+	0x5f, 0xdc, 0x7a, 0x15, 0xa2, 0x0b, 0xfe, 0xf7, 0x83, 0xd0, 0x0f, 0x5c,
+	0xdf, 0x4d, 0x63, 0xaf, 0x30, 0x54, 0x22, 0x8d, 0x96, 0x72, 0x04, 0xa2,
+	0x28, 0xce, 0xb3, 0xa0, 0x6c, 0x8b, 0x6f, 0xee, 0x39, 0x42, 0x50, 0x80,
+	0xa5, 0x58, 0xc1, 0xa4, 0xce, 0xa3, 0xa1, 0x5d, 0x99, 0x2e, 0xdb, 0xef,
+	0x4b, 0x61, 0x83, 0xf4, 0x4e, 0x06, 0xf9, 0x9c, 0x3d, 0xe0, 0x78, 0x4e,
+	0x16, 0xf8, 0xad, 0x2f, 0xa1, 0x4d, 0x98, 0x1f, 0xc9, 0xae, 0x7e, 0xb7,
+	0x8a, 0xc5, 0x4d, 0x57, 0xef, 0x5b, 0x60, 0xb2, 0xe6, 0x0f, 0x33, 0x2f,
+	0x95, 0x0c, 0xe3, 0x29, 0x58, 0xd1, 0xa5, 0xff, 0xb1, 0xe0, 0x68, 0x4f,
+	0x27, 0xea, 0xec, 0x1a, 0x77, 0x44, 0xa9, 0x1c, 0x98, 0xb8, 0xb9, 0xea,
+	0xd8, 0x5b, 0x0c, 0x72, 0x38, 0x63, 0x43, 0xf0, 0x82, 0xcf, 0xfd, 0x43,
+	0xc4, 0xc3, 0xb4, 0xcb, 0xd2, 0xbb, 0x18, 0xfc, 0xf0, 0xf7, 0x9e, 0x00,
+	0x34, 0x41, 0x7b, 0x36, 0x91, 0x7f, 0xdb, 0x48, 0x3b, 0x25, 0x25, 0x18,
+	0xc8, 0xb1, 0x8c, 0xa8, 0x91, 0x4b, 0x9a, 0x33, 0x0d, 0xb4, 0x5a, 0xc3,
+	0x80, 0x8a, 0xa9, 0x8d, 0x89, 0x83, 0x2b, 0xbf, 0xa5, 0x25, 0x11, 0x59,
+	0xb3, 0x87, 0x1d, 0xd7, 0x4a, 0x03, 0xa1, 0x16, 0x28, 0xac, 0x92, 0x72,
+	0x0c, 0x22, 0x38, 0xc6, 0x13, 0xb0, 0x26, 0x0b, 0xff, 0xe6, 0x91, 0xd3,
+	0x1a, 0x0a, 0x94, 0x54, 0x61, 0xbc, 0x04, 0x33, 0x39, 0xf5, 0x21, 0xf5,
+	0x11, 0xf5, 0x72, 0xc5, 0xb2, 0xa6, 0x0e, 0xa7, 0x6d, 0x94, 0x9d, 0xf1,
+	0x22, 0xcc, 0x87, 0xe4, 0x47, 0xb7, 0xfb, 0xd5, 0xa8, 0x26, 0x3b, 0xff,
+	0x85, 0xa1, 0x13, 0x79, 0xb6, 0x95, 0x37, 0x52, 0x4c, 0x61, 0x8c, 0x04,
+	0x50, 0x09, 0x35, 0x42, 0x49, 0x10, 0x96, 0x41, 0x35, 0xd7, 0x19, 0x33,
+	0x02, 0x45, 0x54, 0xce, 0x4d, 0x40, 0x9f, 0x74, 0x77, 0x9e, 0x09, 0xa5,
+	0x43, 0x70, 0x83, 0xd7, 0x7e, 0x42, 0xda, 0x20, 0xb9, 0xd3, 0x49, 0x3a,
+	0x37, 0x07, 0x1d, 0xde, 0xdb, 0x01, 0xaa, 0xa3, 0x6e, 0xad, 0x0b, 0xe0,
+	0x17, 0xbe, 0xce, 0x97, 0xe1, 0x36, 0xad, 0xbe, 0xb0, 0x76, 0x0a, 0x4a,
+	0xb4, 0xd0, 0x63, 0x9c, 0x01, 0x21, 0x13, 0x70, 0x27, 0x97, 0x3c, 0xe7,
+	0x0a, 0x60, 0x15, 0x96, 0x4b, 0x95, 0xc3, 0x13, 0xbb, 0x96, 0x1d, 0xf4,
+	0x7a, 0x47, 0x82, 0xaa, 0xac, 0x9f, 0xa3, 0x06, 0x2d, 0xdd, 0x88, 0x37,
+	0x69, 0xfc, 0x14, 0xb7, 0x58, 0xe5, 0xe4, 0x84, 0x87, 0x71, 0x17, 0x94,
+	0x6f, 0xd1, 0xc9, 0x3f, 0x6f, 0x8c, 0x18, 0x90, 0x30, 0x29, 0xf2, 0x70,
+	0xeb, 0x56, 0xb8, 0x28, 0xfb, 0xe3, 0xc9, 0x59, 0x0f, 0x46, 0x7e, 0x68,
+	0x7b, 0x66, 0x91, 0xda, 0x8b, 0x08, 0x9f, 0xe1, 0x27, 0xbd, 0x9d, 0xa1,
+	0x22, 0x69, 0xd7, 0xa4, 0xe3, 0x73, 0xf9, 0x70, 0xfd, 0x36, 0x95, 0x3e,
+	0xc3, 0x4e, 0x6a, 0x39, 0x42, 0x51, 0x90, 0xa7, 0x59, 0xd5, 0xe6, 0xc7,
+	0xb3, 0xb3, 0x5c, 0xac, 0x7c, 0x92, 0xde, 0xcd, 0x60, 0x97, 0xb7, 0x57,
+	0x14, 0xea, 0x89, 0x4a, 0xbb, 0x21, 0x6d, 0x91, 0xcc, 0xeb, 0x25, 0x89,
+	0xd9, 0x8a, 0x1e, 0xfd, 0xec, 0x35, 0x87, 0x18, 0x86, 0x50, 0x04, 0xe4,
+	0x48, 0x46, 0xf5, 0xd8, 0x65, 0xec, 0x0d, 0x06, 0x7b, 0xbc, 0x31, 0x63,
+	0x50, 0xc0, 0xa5, 0xdc, 0x81, 0xa4, 0x4b, 0xf3, 0xa3, 0xd9, 0xdd, 0x6e,
+	0x56, 0xbb, 0x19, 0xed, 0xe2, 0xf4, 0x8b, 0x56, 0x7f, 0x58, 0x79, 0x25,
+	0xa5, 0x18, 0xc0, 0x30, 0x8c, 0xa2, 0x30, 0x4f, 0x92, 0xba, 0x8d, 0xae,
+	0xf3, 0x67, 0x98, 0x49, 0xa9, 0x07, 0x28, 0x8f, 0xa2, 0x36, 0x2f, 0x9e,
+	0xbc, 0xf5, 0x22, 0xc4, 0x07, 0xf4, 0x4f, 0x17, 0xeb, 0x9f, 0x28, 0xb6,
+	0x33, 0x57, 0x14, 0xeb, 0x99, 0x48, 0xba, 0x35, 0x2f, 0x98, 0xdc, 0xf9,
+	0x24, 0xbc, 0x8b, 0xc3, 0x2f, 0x7b, 0xed, 0x21, 0xc4, 0x01, 0x94, 0x43,
+	0x11, 0x93, 0x13, 0x1f, 0xd6, 0x5f, 0x51, 0xaa, 0x07, 0x2e, 0xef, 0xae,
+	0x30, 0x57, 0x12, 0x8b, 0x95, 0x4e, 0xc2, 0xb9, 0x18, 0xf8, 0xb0, 0xff,
+	0x9a, 0x50, 0x3c, 0x64, 0x3b, 0x7e, 0x95, 0xab, 0x93, 0x6d, 0xfe, 0x3d,
+	0x23, 0x48, 0xc4, 0xd4, 0xc4, 0xe4, 0xc5, 0x97, 0xf7, 0x56, 0x80, 0xa8,
+	0x88, 0xdb, 0xa9, 0x2a, 0xf9, 0xc7, 0x8d, 0x53, 0x23, 0x92, 0x64, 0x6d,
+	0x1f, 0x2c, 0xff, 0xaa, 0x51, 0x4f, 0x56, 0xfa, 0x09, 0x6b, 0xa3, 0xe0,
+	0x4c, 0x0f, 0x6d, 0xce, 0x3c, 0x50, 0x7a, 0x05, 0xa3, 0x3a, 0xec, 0xb6,
+	0xb6, 0x06, 0x06, 0x6d, 0xdc, 0x1c, 0x75, 0x68, 0x6d, 0x06, 0xbc, 0xcc,
+	0xb3, 0xa5, 0x3c, 0x81, 0x6a, 0xaa, 0x73, 0x6e, 0x00, 0xda, 0xa0, 0xb9,
+	0xdb, 0xc8, 0x3a, 0x3d, 0xa6, 0x19, 0xd6, 0x52, 0x81, 0xb0, 0x0a, 0xca,
+	0xb5, 0xc8, 0xe0, 0x9d, 0x1f, 0xc2, 0x1e, 0x68, 0xbc, 0x16, 0x13, 0x1c,
+	0xe7, 0x49, 0x50, 0x97, 0xd5, 0x77, 0xd6, 0x88, 0x21, 0x09, 0xd1, 0x02,
+	0x8f, 0xf5, 0x46, 0x84, 0xc9, 0x90, 0x9f, 0xd8, 0xb6, 0xdc, 0xa6, 0xd4,
+	0x07, 0xd4, 0x4f, 0x55, 0xcb, 0x1f, 0x6a, 0x9e, 0x32, 0x15, 0x36, 0x4b,
+	0xdf, 0x62, 0x93, 0xf3, 0x1f, 0x18, 0xbe, 0xd1, 0x67, 0xde, 0x29, 0x21,
+	0x41, 0x50, 0x86, 0xc5, 0x54, 0xc7, 0xdc, 0x42, 0x94, 0xc1, 0x31, 0x9f,
+	0x90, 0x37, 0x58, 0xec, 0x75, 0x86, 0x8c, 0xc4, 0x51, 0x95, 0xf6, 0x43,
+	0xd2, 0xa3, 0x99, 0xdd, 0xea, 0x16, 0xbb, 0x9c, 0xbd, 0xe0, 0x70, 0xcf,
+	0x16, 0xf2, 0x0c, 0x2b, 0xa9, 0xc4, 0x18, 0x05, 0x60, 0x0a, 0x66, 0x74,
+	0x8a, 0x4f, 0xec, 0x5b, 0x66, 0xd2, 0xea, 0x09, 0x4b, 0xa3, 0xa2, 0x6c,
+	0x8f, 0x2f, 0xe6, 0x3d, 0x12, 0x58, 0xa5, 0xe5, 0x10, 0xc5, 0x70, 0x86,
+	0x86, 0x64, 0x45, 0x9f, 0x7e, 0xd7, 0x8a, 0x03, 0x2d, 0xd7, 0x28, 0x23,
+	0x63, 0x74, 0x80, 0xef, 0xf8, 0x51, 0xee, 0x46, 0xb2, 0xa9, 0xff, 0xa9,
+	0x60, 0x59, 0x57, 0xc7, 0xdb, 0x32, 0x9a, 0xc6, 0x5d, 0x51, 0xae, 0x47,
+	0x26, 0xeb, 0xfe, 0x38, 0x72, 0x52, 0xc3, 0x91, 0x9a, 0x8a, 0x9c, 0xdd,
+	0xe0, 0xb6, 0xaf, 0x96, 0x35, 0x74, 0x28, 0x6f, 0xa2, 0xf8, 0xce, 0x1e,
+	0x71, 0x2c, 0x25, 0x0a, 0xe8, 0x94, 0x9e, 0xc0, 0x34, 0xcd, 0xba, 0x36,
+	0x1e, 0x8e, 0xdd, 0xc4, 0xf6, 0xe5, 0xb2, 0xe5, 0x3e, 0x25, 0x2e, 0xa8,
+	0xde, 0xba, 0x10, 0x7e, 0xc0, 0xfb, 0x3c, 0x38, 0xfa, 0xd3, 0xcb, 0x1a,
+	0x3b, 0x84, 0x35, 0x50, 0x68, 0x25, 0x86, 0x28, 0x84, 0x13, 0x30, 0x26,
+	0x03, 0x7e, 0xe6, 0x9b, 0x72, 0x1e, 0x02, 0x1d, 0xd4, 0x7b, 0x15, 0xa0,
+	0x2b, 0xfa, 0xf5, 0xab, 0x54, 0x1d, 0x7c, 0xfb, 0x4f, 0x09, 0x0b, 0xa2,
+	0x36, 0x2e, 0x8e, 0xbe, 0xf4, 0x36, 0x86, 0x0e, 0xe4, 0x5d, 0x16, 0xde,
+	0xcd, 0x61, 0x87, 0xb5, 0x56, 0x00, 0xa8, 0x80, 0x5a, 0xa9, 0x20, 0x58,
+	0xc3, 0x85, 0xda, 0xa3, 0x88, 0xcd, 0xc9, 0x07, 0xef, 0xff, 0x20, 0xf0,
+	0x43, 0xdf, 0x73, 0x83, 0xd0, 0x0e, 0x4c, 0xdd, 0x4c, 0x77, 0xed, 0x39,
+	0x44, 0x30, 0x8c, 0xa3, 0x20, 0x4d, 0x93, 0xae, 0xcf, 0xa7, 0xe3, 0x75,
+	0x99, 0x7c, 0xfb, 0x4e, 0x19, 0x09, 0xa3, 0x22, 0x6c, 0x87, 0xae, 0xe6,
+	0x37, 0xb3, 0x5c, 0xad, 0x6c, 0x90, 0xdf, 0xd9, 0x22, 0x9e, 0xa7, 0x45,
+	0x15, 0xdf, 0xdb, 0x03, 0x8a, 0xa7, 0x6c, 0x85, 0x8f, 0xf2, 0x37, 0x9a,
+	0xcc, 0xfd, 0x45, 0xa4, 0xcf, 0xb2, 0xb3, 0x5e, 0x8c, 0x78, 0x90, 0xf6,
+	0x49, 0x72, 0xb7, 0x93, 0x55, 0x7e, 0x4e, 0x1b, 0x28, 0xb7, 0x22, 0x45,
+	0x17, 0xfe, 0xcf, 0x03, 0xa3, 0x37, 0x3c, 0xac, 0xbb, 0xe2, 0x5c, 0x0b,
+	0x0c, 0xd6, 0x78, 0x21, 0xe6, 0x20, 0xc2, 0x63, 0xb8, 0x41, 0x6b, 0x37,
+	0xa0, 0x6d, 0x9a, 0x7d, 0xed, 0x2c, 0x14, 0x1b, 0x99, 0xa7, 0x4b, 0xf5,
+	0xc3, 0xd5, 0xdb, 0x16, 0xda, 0x8c, 0x79, 0x81, 0xe4, 0x4a, 0x67, 0xe1,
+	0xd8, 0x4c, 0x7c, 0x5d, 0x2f, 0x4f, 0xac, 0x5a, 0xf2, 0x90, 0xeb, 0x98,
+	0x59, 0xa8, 0x36, 0x3a, 0xce, 0x97, 0xe0, 0x26, 0xaf, 0xbf, 0xa4, 0x34,
+	0x03, 0x5a, 0xa6, 0xd1, 0x56, 0xce, 0x48, 0x10, 0x95, 0x71, 0x33, 0xd4,
+	0x25, 0xf5, 0x19, 0x75, 0x62, 0xcd, 0x12, 0xb6, 0x44, 0x27, 0xfd, 0x9c,
+	0x35, 0x60, 0x68, 0x46, 0xb6, 0xe8, 0xe7, 0xaf, 0x31, 0x45, 0x30, 0x8e,
+	0x83, 0x24, 0x4f, 0xbb, 0x2a, 0xdd, 0x87, 0xc7, 0x77, 0xf3, 0xd8, 0x69,
+	0x2c, 0x15, 0x0a, 0x8b, 0xa4, 0x5e, 0xa3, 0x88, 0xcc, 0xd9, 0x05, 0xee,
+	0xeb, 0x62, 0xf9, 0x53, 0xcd, 0x72, 0xb6, 0x82, 0x47, 0x7d, 0x5b, 0x4d,
+	0x63, 0xae, 0x20, 0x56, 0x23, 0x99, 0xd4, 0x7b, 0x14, 0xb0, 0x29, 0xfb,
+	0xe1, 0xe9, 0x5d, 0x0d, 0x6e, 0xfa, 0x7a, 0x5b, 0x42, 0x93, 0xb0, 0x2f,
+	0x9a, 0xfd, 0xed, 0x24, 0x95, 0x1b, 0x93, 0x06, 0x4f, 0xfd, 0x4a, 0x55,
+	0xc1, 0xbf, 0x7e, 0x94, 0xba, 0x81, 0x6e, 0xeb, 0x6b, 0x68, 0x51, 0xc6,
+	0xc7, 0xf0, 0x83, 0xde, 0xef, 0x40, 0xd1, 0x95, 0xff, 0xd2, 0xd0, 0xa8,
+	0x2c, 0x9b, 0xeb, 0x8f, 0x29, 0x87, 0x21, 0x16, 0x21, 0x3d, 0x90, 0x79,
+	0xb9, 0x64, 0x39, 0x5f, 0x81, 0xab, 0xba, 0xfd, 0xae, 0x14, 0x17, 0x58,
+	0xaf, 0x45, 0x04, 0xcf, 0xf8, 0x12, 0xde, 0xc4, 0xf1, 0x95, 0xbc, 0xe2,
+	0x52, 0xeb, 0x10, 0xd8, 0xa0, 0xbd, 0x9b, 0xc0, 0x3e, 0x6d, 0xae, 0x3c,
+	0x96, 0x1a, 0x85, 0x64, 0x42, 0xef, 0x70, 0xd0, 0xe6, 0xcd, 0x13, 0xa7,
+	0x56, 0x24, 0xe8, 0xca, 0x7e, 0x79, 0x6a, 0x55, 0x82, 0x8f, 0xfc, 0xd7,
+	0x86, 0xc2, 0x25, 0xd9, 0xd9, 0x2f, 0x4e, 0xbd, 0x48, 0xf1, 0x85, 0xbd,
+	0xd3, 0x40, 0xaa, 0x25, 0x0e, 0xa9, 0x8c, 0x98, 0x91, 0x28, 0xaa, 0xf3,
+	0x6e, 0x08, 0x5b, 0xa0, 0xb3, 0x7a, 0xcc, 0x32, 0xb4, 0x26, 0x03, 0x7f,
+	0xf6, 0x99, 0x73, 0x0a, 0x40, 0x14, 0xc4, 0x69, 0x14, 0x95, 0x79, 0xb3,
+	0xc4, 0x2d, 0x55, 0x09, 0x3f, 0xe2, 0x5d, 0x1a, 0x1e, 0xd5, 0x6d, 0x77,
+	0xad, 0x39, 0xc0, 0x70, 0x8c, 0x26, 0x70, 0x4f, 0x17, 0xea, 0x8f, 0x2a,
+	0xb7, 0x27, 0x15, 0x1d, 0xfb, 0x8b, 0x49, 0x8f, 0x67, 0x66, 0xa9, 0x5a,
+	0xf8, 0x30, 0xff, 0x92, 0xd1, 0x3c, 0x6e, 0x9a, 0x7a, 0x9d, 0x22, 0x13,
+	0x77, 0x57, 0x99, 0x3b, 0x8b, 0xc4, 0x5e, 0x65, 0xe8, 0x4c, 0x1e, 0x7d,
+	0xed, 0x2d, 0x04, 0x19, 0x98, 0xb3, 0x09, 0xfc, 0xd3, 0xc7, 0xda, 0x23,
+	0x88, 0xc5, 0x48, 0x07, 0xe5, 0x5e, 0x24, 0xf8, 0xca, 0x5f, 0x69, 0x2a,
+	0x74, 0x16, 0x8f, 0xdd, 0xc6, 0xd6, 0xe1, 0xb0, 0xcd, 0xba, 0x37, 0x0e,
+	0x8c, 0xdc, 0xd0, 0xb4, 0xec, 0xa2, 0xf7, 0x3f, 0x10, 0x7c, 0xe1, 0xef,
+	0x3c, 0x11, 0x6a, 0x83, 0xe2, 0x2e, 0x2b, 0xef, 0xa4, 0x90, 0x43, 0x18,
+	0x03, 0x01, 0x16, 0x62, 0x0d, 0x12, 0x3a, 0x85, 0x27, 0x72, 0x6d, 0x33,
+	0xec, 0xa5, 0x86, 0x21, 0x15, 0x11, 0x3b, 0x93, 0x45, 0x7f, 0x7f, 0x09,
+	0x69, 0x82, 0xf4, 0x4c, 0x26, 0xfd, 0x9e, 0x15, 0x64, 0x6a, 0x6e, 0x32,
+	0xfa, 0xc7, 0x8b, 0x33, 0x2f, 0x94, 0x1c, 0xe1, 0x28, 0x4c, 0x93, 0xac,
+	0xef, 0xa3, 0xe1, 0x5d, 0x1d, 0x6e, 0xdb, 0x6a, 0x1b, 0x63, 0x07, 0xb0,
+	0x0e, 0x8b, 0xad, 0xce, 0xb1, 0x81, 0x78, 0x8b, 0x46, 0x7e, 0x69, 0x6b,
+	0x64, 0x90, 0xce, 0xc9, 0x01, 0x8f, 0xf3, 0x26, 0x88, 0xcf, 0xe8, 0x13,
+	0xef, 0xd6, 0xb0, 0xa0, 0x6a, 0xeb, 0x63, 0xe8, 0x41, 0xce, 0x67, 0xe0,
+	0xc9, 0x5e, 0x7f, 0x48, 0x79, 0x04, 0xb5, 0x58, 0xe1, 0xa4, 0x8c, 0x83,
+	0x21, 0x1f, 0xb1, 0x2f, 0x99, 0xcd, 0xeb, 0x27, 0xa9, 0xdd, 0x88, 0x36,
+	0x79, 0xfe, 0x15, 0xa3, 0x1a, 0xec, 0xf4, 0x96, 0x86, 0x44, 0x45, 0xdd,
+	0x5e, 0x57, 0xc8, 0x2b, 0x2c, 0x95, 0x0a, 0x83, 0x25, 0x5e, 0xa9, 0x29,
+	0xc8, 0xd1, 0x8c, 0x6e, 0xf1, 0xcb, 0x5d, 0x4b, 0x0e, 0x72, 0x3c, 0x23,
+	0x4b, 0xf4, 0xd2, 0xc7, 0xd8, 0x03, 0x8c, 0xc7, 0x60, 0x83, 0xf7, 0x7e,
+	0x00, 0xfa, 0xa0, 0xfb, 0xfb, 0x48, 0x78, 0x15, 0xa7, 0x5b, 0xf4, 0xf2,
+	0xc7, 0x9a, 0x23, 0x0c, 0x85, 0x48, 0x82, 0xb5, 0x5c, 0xa0, 0xbc, 0x8a,
+	0xd2, 0x3d, 0x78, 0xf8, 0x77, 0x8f, 0x18, 0x96, 0x50, 0x25, 0xf4, 0x08,
+	0x67, 0x61, 0xd8, 0x44, 0xfd, 0x5d, 0x25, 0xee, 0xa8, 0x52, 0x7b, 0x10,
+	0xf1, 0x31, 0xfd, 0xb0, 0xf5, 0x3a, 0x44, 0x36, 0xec, 0xaf, 0x26, 0x35,
+	0x1f, 0x99, 0xaf, 0xcb, 0xe5, 0xcb, 0x75, 0xcb, 0x5c, 0x5a, 0x1c, 0x71,
+	0x29, 0x75, 0x00, 0xed, 0xd0, 0xd4, 0xec, 0x64, 0x97, 0xbf, 0xd7, 0x04,
+	0xe2, 0x29, 0x5a, 0xf1, 0xa1, 0xfd, 0x99, 0x64, 0x7a, 0x6f, 0x03, 0xe8,
+	0x86, 0xbe, 0xe5, 0x26, 0xa5, 0x1f, 0xb0, 0x3e, 0x8b, 0xce, 0xfe, 0x71,
+	0xe2, 0xc4, 0x8a, 0x25, 0x4d, 0x99, 0x0e, 0xdb, 0xad, 0x6b, 0xe1, 0xc1,
+	0xdc, 0x4f, 0x44, 0xdb, 0x3c, 0x7b, 0xca, 0x51, 0x88, 0x26, 0x78, 0xcf,
+	0x07, 0xe2, 0x2f, 0x3a, 0xfd, 0xa7, 0x85, 0x15, 0x53, 0x1a, 0x03, 0x05,
+	0x56, 0x6a, 0x09, 0x42, 0x32, 0xa0, 0x67, 0x3a, 0x69, 0xe7, 0xa4, 0x80,
+	0x43, 0x39, 0x13, 0x41, 0x37, 0xf6, 0x0d, 0x33, 0x2b, 0xd5, 0x04, 0xe7,
+	0x79, 0x50, 0xf4, 0xe5, 0xb7, 0xb5, 0x34, 0x20, 0x6a, 0xe2, 0xf2, 0xea,
+	0x4a, 0x7b, 0x21, 0xe1, 0x50, 0xcc, 0x64, 0xd4, 0x8f, 0x55, 0x47, 0xde,
+	0x6a, 0x11, 0xc3, 0x13, 0xba, 0x86, 0x1f, 0xf5, 0x6e, 0x05, 0x8b, 0xba,
+	0xbe, 0x9e, 0x96, 0x54, 0x64, 0xec, 0x0e, 0x36, 0x7d, 0xbf, 0x0d, 0xa5,
+	0x4b, 0xf0, 0x93, 0xdf, 0xde, 0x52, 0x90, 0xa0, 0x29, 0xdb, 0xe1, 0xab,
+	0x7d, 0x8d, 0x2c, 0xd2, 0x7b, 0x19, 0x60, 0x33, 0xf6, 0x05, 0xb3, 0x3b,
+	0xdd, 0xa4, 0xf7, 0x33, 0xd0, 0x64, 0xed, 0x1f, 0x24, 0x7e, 0xaa, 0x5b,
+	0xee, 0x52, 0xf2, 0x80, 0xeb, 0xb9, 0x49, 0xe8, 0x17, 0xae, 0xce, 0xb6,
+	0xf1, 0x76, 0x8c, 0x2a, 0xb0, 0x57, 0x1b, 0x1a, 0x97, 0x45, 0x77, 0xff,
+	0x19, 0x61, 0x22, 0xe4, 0x06, 0xa6, 0x6d, 0x96, 0xbd, 0xf5, 0x20, 0xe4,
+	0x03, 0xf6, 0x67, 0x93, 0xf9, 0xbf, 0x0c, 0xb4, 0x59, 0xf3, 0x86, 0x89,
+	0x95, 0x4b, 0x92, 0xb3, 0x1d, 0xbc, 0xfa, 0xd3, 0xca, 0x0a, 0x39, 0x85,
+	0x21, 0x12, 0x61, 0x35, 0x94, 0x29, 0xb1, 0x41, 0x79, 0x17, 0x85, 0x7f,
+	0xf2, 0xd8, 0x6b, 0x0c, 0x11, 0x08, 0xa3, 0x20, 0x4c, 0x83, 0xac, 0xce,
+	0xb3, 0xa1, 0x7c, 0x89, 0x6e, 0xfa, 0x7b, 0x4b, 0x40, 0x92, 0xa4, 0x6d,
+	0x93, 0xed, 0xff, 0x25, 0xa0, 0x49, 0xda, 0x37, 0xc9, 0xfc, 0x5e, 0x16,
+	0xd8, 0xad, 0x6d, 0x81, 0xcd, 0xda, 0x37, 0xc8, 0xec, 0x5c, 0x17, 0xcc,
+	0xef, 0x64, 0x91, 0xdf, 0xdb, 0x02, 0x9a, 0xa5, 0x6d, 0x91, 0xcd, 0xfb,
+	0x27, 0x88, 0xcd, 0xc8, 0x17, 0xed, 0xfe, 0x34, 0xb2, 0x4a, 0xcf, 0x61,
+	0x82, 0xe5, 0x5c, 0x05, 0xec, 0xca, 0x76, 0xf9, 0x7a, 0x5d, 0x22, 0x9f,
+	0xb6, 0x57, 0x16, 0xca, 0x8d, 0x48, 0x93, 0xa5, 0x7f, 0xb1, 0xe8, 0xe9,
+	0x4f, 0x2d, 0x4b, 0xe8, 0x12, 0xfe, 0xc4, 0xb3, 0xb5, 0x3c, 0xa0, 0x7a,
+	0xea, 0x52, 0xfa, 0x00, 0xfb, 0xb1, 0xe9, 0xf8, 0x5d, 0x2e, 0x5e, 0xbe,
+	0x59, 0xe7, 0xc6, 0xa0, 0x81, 0x5b, 0xbb, 0x02, 0x5d, 0xd5, 0xef, 0x57,
+	0xa1, 0xba, 0xe8, 0xfe, 0x3f, 0x02, 0x5c, 0xc4, 0xfd, 0x54, 0xb4, 0xec,
+	0xa3, 0xe7, 0x3d, 0x11, 0x68, 0xa3, 0xe6, 0x2c, 0x03, 0x6b, 0xb6, 0xb0,
+	0x67, 0x1a, 0x69, 0xa5, 0x84, 0x00, 0x01, 0x11, 0x12, 0x03, 0x15, 0x56,
+	0x4b, 0x19, 0x02, 0x13, 0x34, 0x67, 0x1b, 0x78, 0xb7, 0x87, 0x15, 0x57,
+	0x5a, 0x0b, 0x01, 0x06, 0x62, 0x2c, 0x02, 0x7a, 0xa4, 0xb3, 0x72, 0x4c,
+	0x22, 0xbc, 0x86, 0x13, 0x35, 0x76, 0x09, 0x7b, 0xa2, 0xd1, 0x5e, 0x4e,
+	0x58, 0x18, 0x35, 0x61, 0x79, 0x54, 0xb5, 0xfd, 0xb1, 0xe4, 0x28, 0x47,
+	0x23, 0xba, 0xe4, 0x3f, 0x37, 0x0c, 0xad, 0xc8, 0xd0, 0x9d, 0x7c, 0xf2,
+	0xde, 0x0b, 0x00, 0x17, 0x70, 0x2f, 0x17, 0x2c, 0xef, 0xaa, 0x70, 0x5f,
+	0x16, 0xdb, 0x9d, 0x6b, 0x82, 0xf1, 0x1c, 0x2c, 0xf8, 0xda, 0x5f, 0x48,
+	0x3a, 0x34, 0x37, 0x1b, 0xdd, 0xe7, 0xc7, 0xb1, 0x93, 0x58, 0xae, 0x54,
+	0x16, 0xcc, 0xed, 0x44, 0x95, 0xdd, 0xf3, 0x86, 0x88, 0x85, 0x49, 0x93,
+	0xa7, 0x5f, 0xb5, 0xea, 0xc1, 0xcb, 0x3f, 0x6b, 0xcc, 0x10, 0x94, 0x60,
+	0x21, 0xd7, 0x30, 0xa3, 0x52, 0x6c, 0x60, 0xde, 0x26, 0xd1, 0x5f, 0x5f,
+	0x4a, 0x1b, 0x20, 0x37, 0x32, 0x4d, 0xb7, 0xee, 0x85, 0x83, 0x33, 0x3f,
+	0x94, 0x3d, 0xf1, 0x68, 0x6d, 0x07, 0xac, 0xce, 0xb2, 0xb1, 0x7e, 0x88,
+	0x7a, 0xb8, 0x72, 0x5b, 0x52, 0x93, 0x91, 0x3f, 0xda, 0xdc, 0x79, 0x24,
+	0xb4, 0x0a, 0xc3, 0x25, 0xda, 0xe9, 0x29, 0x4d, 0x81, 0x8e, 0xea, 0xb5,
+	0x8b, 0xd0, 0x1f, 0x5c, 0xfe, 0x5d, 0x23, 0x8e, 0xa4, 0x54, 0x03, 0x9c,
+	0xc6, 0x51, 0x91, 0xb6, 0x4b, 0xd6, 0xf3, 0x91, 0xf8, 0xaa, 0x5e, 0xbf,
+	0x48, 0xf5, 0xc5, 0xb5, 0xd7, 0x10, 0xa2, 0x00, 0x4e, 0xe1, 0x88, 0x4c,
+	0xd9, 0x0d, 0x6f, 0xeb, 0x68, 0x58, 0x57, 0xc5, 0xfb, 0x36, 0x98, 0xee,
+	0xd9, 0x43, 0x8e, 0x63, 0x24, 0x81, 0x5a, 0xaa, 0x10, 0x5e, 0xc0, 0xb9,
+	0x1c, 0xb8, 0xb8, 0xfb, 0xca, 0x58, 0x19, 0x24, 0x73, 0x7a, 0x41, 0xe3,
+	0xb6, 0xa8, 0xe6, 0x3b, 0x73, 0x44, 0xa1, 0x9c, 0x88, 0xb0, 0x19, 0xfa,
+	0x92, 0xdb, 0x9c, 0x7a, 0x90, 0xf2, 0x09, 0x7a, 0xb3, 0xc3, 0x5d, 0x5b,
+	0x0e, 0x53, 0x2c, 0x63, 0x6a, 0x60, 0xd2, 0xe6, 0xc9, 0x53, 0xaf, 0x52,
+	0x74, 0xe0, 0xef, 0x3e, 0x31, 0x6e, 0x81, 0xca, 0xaa, 0x39, 0xcf, 0x80,
+	0x92, 0x29, 0xbc, 0x91, 0x63, 0x1a, 0x61, 0x25, 0x94, 0x08, 0xa1, 0x01,
+	0x58, 0x83, 0x85, 0x5e, 0xe3, 0x88, 0x48, 0x99, 0x05, 0x6b, 0xbb, 0x60,
+	0x7d, 0x17, 0x8d, 0xff, 0xe2, 0xd0, 0xcb, 0x1c, 0x5b, 0x88, 0x33, 0x28,
+	0xe4, 0x12, 0xe6, 0x44, 0x82, 0xad, 0xdc, 0x91, 0xa4, 0x6a, 0xe3, 0xe3,
+	0xf8, 0x49, 0x6e, 0x77, 0xaa, 0x49, 0xce, 0x77, 0xe0, 0xe8, 0x4e, 0x3f,
+	0x69, 0xed, 0x04, 0x94, 0x49, 0xb1, 0x87, 0x19, 0x97, 0x42, 0x07, 0xf1,
+	0x1e, 0x0d, 0xec, 0xda, 0x76, 0xd8, 0x6a, 0x1d, 0x03, 0x0b, 0xb6, 0x76,
+	0x07, 0x9a, 0xae, 0xdd, 0x87, 0xc6, 0x67, 0xf1, 0xd9, 0x7d, 0x6e, 0x1c,
+	0x1a, 0x99, 0xa5, 0x6b, 0xf1, 0xc1, 0xfd, 0x5f, 0x04, 0xfa, 0xa8, 0x7b,
+	0xeb, 0x40, 0xd8, 0x05, 0xed, 0xdb, 0x64, 0xfa, 0x6f, 0x0b, 0x69, 0x86,
+	0xb4, 0x44, 0x22, 0xad, 0x96, 0x30, 0x24, 0x22, 0x6a, 0xe6, 0xb2, 0xe2,
+	0x4e, 0x2b, 0x29, 0xc4, 0x10, 0x84, 0x60, 0x00, 0xc7, 0x70, 0x82, 0xc6,
+	0x6c, 0x41, 0xcf, 0x76, 0xf2, 0xca, 0x4b, 0x29, 0x03, 0x60, 0x06, 0xa6,
+	0x6c, 0x86, 0xbf, 0xf4, 0x34, 0xa6, 0x0a, 0xe6, 0x75, 0x92, 0xcc, 0xed,
+	0x45, 0x85, 0xdf, 0xf2, 0x92, 0xca, 0x8c, 0x59, 0x81, 0xa6, 0x6a, 0xe7,
+	0xa3, 0xf0, 0x4d, 0x3e, 0x7f, 0x8f, 0x09, 0x86, 0x73, 0x34, 0xa0, 0x6b,
+	0xfa, 0x71, 0xeb, 0x54, 0x98, 0x2c, 0xf9, 0xcb, 0x4d, 0x4b, 0x2f, 0x62,
+	0x7c, 0x02, 0xdf, 0xf4, 0xf3, 0xd6, 0x88, 0x20, 0x19, 0xd3, 0x03, 0x9b,
+	0xb7, 0x4f, 0x94, 0xdb, 0x91, 0xaa, 0x8a, 0xff, 0xed, 0x20, 0xd5, 0x13,
+	0x97, 0x56, 0x47, 0xd8, 0x0a, 0x1d, 0xc5, 0x6b, 0x36, 0xb1, 0x7f, 0x99,
+	0x68, 0xbb, 0x67, 0x0d, 0x19, 0x8a, 0x93, 0x2c, 0xee, 0xbb, 0x62, 0x5c,
+	0x03, 0x8d, 0xd6, 0x72, 0x80, 0xe2, 0x28, 0x4b, 0xe3, 0xa2, 0xe8, 0xcf,
+	0x2f, 0x63, 0x6d, 0x10, 0xdc, 0xe1, 0xa5, 0x9d, 0x91, 0x22, 0x0a, 0xe7,
+	0x64, 0x80, 0xcf, 0xf8, 0x13, 0xce, 0xc6, 0xf0, 0x81, 0xfe, 0xeb, 0x42,
+	0xf9, 0x11, 0xed, 0xf2, 0xf4, 0xaa, 0x46, 0x3f, 0x79, 0xed, 0x25, 0x84,
+	0x09, 0x90, 0x13, 0x19, 0xb6, 0x53, 0x57, 0xd2, 0x8b, 0x19, 0x8f, 0xc2,
+	0x36, 0xe9, 0xfe, 0x3c, 0x32, 0x5a, 0xc7, 0xc1, 0x92, 0xaf, 0xdc, 0x95,
+	0xe4, 0x62, 0xe7, 0xb3, 0xf0, 0x6c, 0x2e, 0x3f, 0xae, 0x9d, 0x86, 0x52,
+	0x25, 0xf0, 0x48, 0x6f, 0x65, 0x88, 0x4c, 0xd8, 0x1d, 0x6d, 0xea, 0x7c,
+	0x1a, 0x5e, 0xd5, 0xe9, 0x37, 0xad, 0xbc, 0x90, 0x72, 0x08, 0x62, 0x30,
+	0xc2, 0x43, 0xb8, 0x03, 0x4b, 0xb7, 0xe2, 0x45, 0x9b, 0x3f, 0xcf, 0x8c,
+	0x52, 0x31, 0xb0, 0x61, 0x7b, 0x75, 0xa1, 0xfd, 0x98, 0x74, 0x78, 0x6e,
+	0x17, 0xaa, 0x8f, 0xae, 0xf7, 0x27, 0x90, 0x4d, 0xf9, 0x0f, 0x0d, 0xcf,
+	0xea, 0x32, 0xfb, 0xd6, 0x99, 0x30, 0x3a, 0xc2, 0x57, 0xf8, 0x2a, 0x5f,
+	0xa7, 0xcb, 0xf4, 0xdb, 0x56, 0xda, 0x08, 0x39, 0x81, 0x61, 0x1a, 0x65,
+	0x65, 0x9c, 0x0c, 0xf1, 0x09, 0x7d, 0xc3, 0xcd, 0x5a, 0x37, 0xc0, 0x6d,
+	0x5c, 0x1d, 0x6d, 0xeb, 0x6c, 0x18, 0x5f, 0xc1, 0xab, 0x3e, 0xbd, 0xae,
+	0x91, 0x47, 0x5a, 0x2b, 0x01, 0x44, 0x42, 0xac, 0x40, 0x52, 0xa5, 0xf1,
+	0x50, 0xec, 0x64, 0x96, 0xaf, 0xd5, 0x05, 0xf6, 0x6b, 0x53, 0xe1, 0xb3,
+	0xfc, 0xac, 0x36, 0x33, 0x5e, 0x85, 0xe9, 0x92, 0xfd, 0xfc, 0x34, 0xb6,
+	0x0a, 0xc7, 0x65, 0xd2, 0xed, 0x79, 0x45, 0xa4, 0xce, 0xa2, 0xb1, 0x5f,
+	0x98, 0x3a, 0x99, 0xe6, 0x5b, 0x73, 0x82, 0xc1, 0x1c, 0x4f, 0xc8, 0x1a,
+	0x3c, 0xf4, 0x3b, 0x57, 0x04, 0xeb, 0xb8, 0x58, 0xfa, 0x14, 0xbb, 0x98,
+	0xfd, 0xe8, 0x74, 0x9f, 0x1e, 0xd7, 0x4c, 0x63, 0xad, 0x10, 0x50, 0x20,
+	0xa5, 0x12, 0x60, 0x24, 0x86, 0x2a, 0xa4, 0x17, 0x32, 0x0e, 0x87, 0x6c,
+	0xc6, 0xbf, 0x70, 0x74, 0xa6, 0x8f, 0xb6, 0x77, 0x16, 0x88, 0xad, 0xc8,
+	0xd1, 0x8d, 0x7e, 0xf3, 0xca, 0x49, 0x09, 0x07, 0x62, 0x2e, 0x22, 0x7e,
+	0xa6, 0x9b, 0xf6, 0x5e, 0x02, 0x98, 0x84, 0x79, 0x91, 0xe4, 0x6b, 0x77,
+	0xa1, 0xf9, 0xd8, 0x7c, 0x7c, 0x3e, 0x1f, 0x8f, 0xcf, 0xe6, 0xf3, 0xf3,
+	0xd8, 0x68, 0x3c, 0x17, 0x0b, 0x9f, 0xe6, 0x57, 0xb3, 0x9a, 0xcd, 0xec,
+	0x57, 0xa7, 0xda, 0xe4, 0xf8, 0x47, 0x8e, 0x6b, 0xa4, 0x91, 0x52, 0x0a,
+	0x00, 0x14, 0x40, 0x29, 0x14, 0x10, 0x29, 0xb1, 0x40, 0x69, 0x15, 0x84,
+	0x6b, 0xb0, 0xd1, 0x7b, 0x1e, 0x10, 0x3d, 0xf1, 0x69, 0x7d, 0x05, 0xad,
+	0xda, 0xf0, 0xb8, 0x6e, 0x9a, 0x7b, 0x8d, 0x20, 0x12, 0x63, 0x15, 0x90,
+	0x2b, 0x99, 0xc5, 0x6b, 0x37, 0xa1, 0x7d, 0x98, 0x7c, 0xf9, 0x6e, 0x1d,
+	0x0b, 0x8b, 0xa6, 0x7e, 0xa7, 0x8a, 0xe4, 0x5d, 0x17, 0xce, 0xcf, 0x60,
+	0x93, 0xf7, 0x5f, 0x10, 0xba, 0x81, 0x6f, 0xfb, 0x69, 0x69, 0x45, 0x84,
+	0xce, 0xe0, 0x91, 0xdf, 0xda, 0x12, 0x98, 0xa4, 0x79, 0xd3, 0xc4, 0xeb,
+	0x35, 0x89, 0xf8, 0x9a, 0x5e, 0xdc, 0x78, 0x35, 0xa6, 0x09, 0xd6, 0x73,
+	0x91, 0xf0, 0x2b, 0x5e, 0xb5, 0xe9, 0xf1, 0xcd, 0x3c, 0x57, 0x0a, 0x0b,
+	0xa4, 0x56, 0x22, 0x88, 0xc6, 0x78, 0x01, 0xe6, 0x62, 0xe2, 0xe3, 0xfa,
+	0x69, 0x6a, 0x75, 0x82, 0xcd, 0xdc, 0x57, 0xc4, 0xea, 0x24, 0x9b, 0xfb,
+	0x8f, 0x08, 0x97, 0x61, 0x37, 0xb5, 0x3d, 0xb1, 0x68, 0xe9, 0x47, 0xac,
+	0x4b, 0xe2, 0xb3, 0xfa, 0xcc, 0x3a, 0x35, 0x26, 0x09, 0xde, 0xf2, 0x91,
+	0xfa, 0x8a, 0x5a, 0xbd, 0x60, 0x71, 0xd7, 0x95, 0xf3, 0x12, 0xc8, 0xa4,
+	0xdc, 0x83, 0x84, 0x4f, 0xf1, 0x8b, 0x5d, 0xcf, 0x4e, 0x72, 0xb9, 0x73,
+	0x49, 0x70, 0x96, 0x87, 0x55, 0x57, 0xde, 0x4b, 0x01, 0x83, 0x32, 0x2e,
+	0x86, 0x3e, 0xe4, 0x3e, 0x26, 0x1e, 0xae, 0xdd, 0x86, 0xd6, 0x65, 0xf0,
+	0xcd, 0x3f, 0x67, 0x0c, 0x08, 0x98, 0x90, 0x39, 0xb8, 0xf0, 0x7b, 0x5e,
+	0x10, 0xb9, 0xb1, 0x69, 0xf8, 0x55, 0xaf, 0x5e, 0xb4, 0xf8, 0xe3, 0xce,
+	0x29, 0x01, 0x41, 0x12, 0xa6, 0x45, 0x16, 0xef, 0xdd, 0x00, 0xb6, 0x61,
+	0x77, 0xb5, 0xb9, 0xf1, 0x68, 0x6c, 0x17, 0xae, 0xcf, 0xa6, 0xf3, 0x77,
+	0x98, 0x68, 0xb9, 0x47, 0x09, 0x1b, 0xa2, 0x17, 0x3e, 0xce, 0x9f, 0x60,
+	0x36, 0xa7, 0x1f, 0xb4, 0x7e, 0x83, 0xca, 0xae, 0x79, 0xc7, 0x84, 0xc2,
+	0x21, 0x99, 0xd1, 0x2b, 0x1e, 0xb5, 0x6d, 0xb1, 0xcd, 0xb9, 0x07, 0x08,
+	0x8f, 0xe0, 0x16, 0xaf, 0xdc, 0x94, 0xf4, 0x60, 0xe6, 0xa7, 0xb2, 0x65,
+	0x3e, 0x2d, 0xaf, 0xa8, 0xd4, 0x1b, 0x14, 0x76, 0x49, 0x7b, 0x26, 0x91,
+	0x5e, 0xcb, 0x08, 0x1a, 0xb1, 0x25, 0x39, 0xd9, 0xe1, 0xaf, 0x3d, 0x85,
+	0x28, 0x82, 0x73, 0x3c, 0x20, 0x7b, 0xf2, 0xd1, 0xfb, 0x1e, 0x18, 0xbc,
+	0xf1, 0x63, 0xdc, 0x01, 0xa5, 0x53, 0x70, 0xa2, 0xc7, 0x3e, 0x63, 0x4e,
+	0x20, 0x98, 0xc2, 0x19, 0x19, 0xa2, 0x13, 0x7e, 0xc6, 0x9b, 0x30, 0x3e,
+	0x82, 0x5f, 0xfc, 0x7a, 0x57, 0x82, 0x8b, 0xbc, 0xdf, 0x82, 0x92, 0x2d,
+	0xfc, 0x99, 0x67, 0x4a, 0x69, 0x00, 0xd4, 0x40, 0xa5, 0xd5, 0x10, 0xa6,
+	0x40, 0x46, 0xe5, 0xd8, 0x44, 0xfc, 0x4d, 0x27, 0xef, 0xbc, 0x10, 0x72,
+	0x00, 0xe3, 0x30, 0xc8, 0xe2, 0xbc, 0x0b, 0xc2, 0x37, 0xf8, 0xec, 0x3f,
+	0x27, 0x0c, 0x8c, 0xd8, 0x90, 0xbc, 0xe8, 0xf2, 0xff, 0x1a, 0x50, 0x34,
+	0xe5, 0x3b, 0x74, 0x34, 0xaf, 0x9b, 0xe4, 0x7e, 0x27, 0x8a, 0xec, 0xdc,
+	0x17, 0xc4, 0x6e, 0x64, 0x9b, 0x7e, 0xdf, 0x0a, 0x13, 0x25, 0x77, 0x38,
+	0x69, 0xe3, 0xe4, 0x88, 0x47, 0x69, 0x1b, 0x64, 0x77, 0xbe, 0x09, 0xe7,
+	0x63, 0xf0, 0xc1, 0xff, 0x7f,
+};
@@ -0,0 +1,336 @@
+/*
+ * profile.c - per-frame timing of the emulation stages
+ *
+ * This file is part of the a5200 port of the Atari800 emulator.
+ * See profile.h for the description of the stages.
+ */
+
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "antic.h"
+#include "atari.h"
+#include "cartridge.h"
+#include "cpu.h"
+#include "gtia.h"
+#include "memory.h"
+#include "pokey.h"
+#include "profile.h"
+#include "util.h"
+
+#ifdef FRAME_PROFILE
+
+typedef struct {
+	ULONG stage_ns[PROFILE_STAGES];	/* [PROFILE_IDLE] is unused */
+	ULONG wall_ns;					/* since the start of the previous frame */
+} frame_record;
+
+static EMU_TLS frame_record history[PROFILE_HISTORY];
+static EMU_TLS unsigned int frames_recorded;	/* total, history is a ring */
+static EMU_TLS frame_record current;
+static EMU_TLS int current_stage = PROFILE_IDLE;
+static EMU_TLS unsigned long long last_switch;
+static EMU_TLS unsigned long long frame_start;
+
+static const char *stage_names[PROFILE_STAGES] = {
+	"total", "other", "cpu", "antic", "gtia", "pokey", "blit"
+};
+
+int PROFILE_Switch(int stage)
+{
+	unsigned long long now = Util_time_ns();
+	int prev = current_stage;
+
+	if (prev != PROFILE_IDLE)
+		current.stage_ns[prev] += (ULONG) (now - last_switch);
+	last_switch = now;
+	current_stage = stage;
+	return prev;
+}
+
+void PROFILE_BeginFrame(void)
+{
+	unsigned long long now;
+
+	PROFILE_Switch(PROFILE_OTHER);
+	now = last_switch;
+	if (frame_start != 0) {
+		current.wall_ns = (ULONG) (now - frame_start);
+		history[frames_recorded % PROFILE_HISTORY] = current;
+		frames_recorded++;
+	}
+	memset(&current, 0, sizeof(current));
+	frame_start = now;
+}
+
+void PROFILE_EndFrame(void)
+{
+	PROFILE_Switch(PROFILE_IDLE);
+}
+
+void PROFILE_Reset(void)
+{
+	frames_recorded = 0;
+	frame_start = 0;
+	memset(&current, 0, sizeof(current));
+}
+
+static unsigned int frames_kept(void)
+{
+	return frames_recorded < PROFILE_HISTORY ? frames_recorded : PROFILE_HISTORY;
+}
+
+static ULONG frame_total(const frame_record *rec)
+{
+	ULONG total = 0;
+	int stage;
+
+	for (stage = PROFILE_OTHER; stage < PROFILE_STAGES; stage++)
+		total += rec->stage_ns[stage];
+	return total;
+}
+
+int PROFILE_Histogram(int stage, unsigned int buckets[PROFILE_BUCKETS])
+{
+	unsigned int n = frames_kept();
+	unsigned int i;
+
+	memset(buckets, 0, PROFILE_BUCKETS * sizeof(buckets[0]));
+	for (i = 0; i < n; i++) {
+		const frame_record *rec = &history[i];
+		ULONG ns = stage == PROFILE_IDLE ? frame_total(rec) : rec->stage_ns[stage];
+		ULONG bucket = ns / (PROFILE_BUCKET_US * 1000);
+		buckets[bucket < PROFILE_BUCKETS ? bucket : PROFILE_BUCKETS - 1]++;
+	}
+	return n;
+}
+
+void PROFILE_PrintReport(FILE *fp)
+{
+	unsigned int buckets[PROFILE_BUCKETS];
+	unsigned int n = frames_kept();
+	unsigned int i;
+	int stage;
+	int b;
+
+	if (n == 0)
+		return;
+	fprintf(fp, "last %u frames, speed %d%%\n", n, percent_atari_speed);
+	fprintf(fp, "stage      avg us   max us  frames per %d us bucket\n", PROFILE_BUCKET_US);
+	for (stage = PROFILE_IDLE; stage < PROFILE_STAGES; stage++) {
+		unsigned long long sum = 0;
+		ULONG max = 0;
+		int last = 0;
+
+		for (i = 0; i < n; i++) {
+			ULONG ns = stage == PROFILE_IDLE ? frame_total(&history[i]) : history[i].stage_ns[stage];
+			sum += ns;
+			if (ns > max)
+				max = ns;
+		}
+		PROFILE_Histogram(stage, buckets);
+		for (b = 0; b < PROFILE_BUCKETS; b++)
+			if (buckets[b] != 0)
+				last = b;
+		fprintf(fp, "%-6s %10llu %8lu ", stage_names[stage], sum / n / 1000, (unsigned long) (max / 1000));
+		for (b = 0; b <= last; b++)
+			fprintf(fp, " %u", buckets[b]);
+		fprintf(fp, "\n");
+	}
+}
+
+int PROFILE_WriteCSV(const char *filename)
+{
+	FILE *fp = fopen(filename, "w");
+	unsigned int n = frames_kept();
+	unsigned int i;
+	int stage;
+
+	if (fp == NULL)
+		return FALSE;
+	fprintf(fp, "frame,wall");
+	for (stage = PROFILE_IDLE; stage < PROFILE_STAGES; stage++)
+		fprintf(fp, ",%s", stage_names[stage]);
+	fprintf(fp, "\n");
+	/* oldest first */
+	for (i = 0; i < n; i++) {
+		unsigned int frame = frames_recorded - n + i;
+		const frame_record *rec = &history[frame % PROFILE_HISTORY];
+		fprintf(fp, "%u,%lu,%lu", frame, (unsigned long) (rec->wall_ns / 1000),
+			(unsigned long) (frame_total(rec) / 1000));
+		for (stage = PROFILE_OTHER; stage < PROFILE_STAGES; stage++)
+			fprintf(fp, ",%lu", (unsigned long) (rec->stage_ns[stage] / 1000));
+		fprintf(fp, "\n");
+	}
+	fclose(fp);
+	return TRUE;
+}
+
+#endif /* FRAME_PROFILE */
+
+#ifdef MONITOR_PROFILE
+
+/* hottest code blocks listed in the report */
+#define HOT_BLOCKS 32
+
+enum {
+	AM_IMP, AM_IMM, AM_ZP, AM_ZPX, AM_ZPY, AM_ABS, AM_ABX, AM_ABY,
+	AM_IZX, AM_IZY, AM_IND, AM_REL, AM_MODES
+};
+
+static const char *mode_names[AM_MODES] = {
+	"implied", "#imm", "zp", "zp,x", "zp,y", "abs", "abs,x", "abs,y",
+	"(zp,x)", "(zp),y", "(abs)", "rel"
+};
+
+/* taken from the opcode comments in cpu.itcm.c */
+static const char opcode_mnemonic[256][4] = {
+	"BRK", "ORA", "CIM", "ASO", "NOP", "ORA", "ASL", "ASO", "PHP", "ORA", "ASL", "ANC", "NOP", "ORA", "ASL", "ASO",
+	"BPL", "ORA", "CIM", "ASO", "NOP", "ORA", "ASL", "ASO", "CLC", "ORA", "NOP", "ASO", "NOP", "ORA", "ASL", "ASO",
+	"JSR", "AND", "CIM", "RLA", "BIT", "AND", "ROL", "RLA", "PLP", "AND", "ROL", "ANC", "BIT", "AND", "ROL", "RLA",
+	"BMI", "AND", "CIM", "RLA", "NOP", "AND", "ROL", "RLA", "SEC", "AND", "NOP", "RLA", "NOP", "AND", "ROL", "RLA",
+	"RTI", "EOR", "CIM", "LSE", "NOP", "EOR", "LSR", "LSE", "PHA", "EOR", "LSR", "ALR", "JMP", "EOR", "LSR", "LSE",
+	"BVC", "EOR", "CIM", "LSE", "NOP", "EOR", "LSR", "LSE", "CLI", "EOR", "NOP", "LSE", "NOP", "EOR", "LSR", "LSE",
+	"RTS", "ADC", "CIM", "RRA", "NOP", "ADC", "ROR", "RRA", "PLA", "ADC", "ROR", "ARR", "JMP", "ADC", "ROR", "RRA",
+	"BVS", "ADC", "CIM", "RRA", "NOP", "ADC", "ROR", "RRA", "SEI", "ADC", "NOP", "RRA", "NOP", "ADC", "ROR", "RRA",
+	"NOP", "STA", "NOP", "SAX", "STY", "STA", "STX", "SAX", "DEY", "NOP", "TXA", "ANE", "STY", "STA", "STX", "SAX",
+	"BCC", "STA", "CIM", "SHA", "STY", "STA", "STX", "SAX", "TYA", "STA", "TXS", "SHS", "SHY", "STA", "SHX", "SHA",
+	"LDY", "LDA", "LDX", "LAX", "LDY", "LDA", "LDX", "LAX", "TAY", "LDA", "TAX", "ANX", "LDY", "LDA", "LDX", "LAX",
+	"BCS", "LDA", "CIM", "LAX", "LDY", "LDA", "LDX", "LAX", "CLV", "LDA", "TSX", "LAS", "LDY", "LDA", "LDX", "LAX",
+	"CPY", "CMP", "NOP", "DCM", "CPY", "CMP", "DEC", "DCM", "INY", "CMP", "DEX", "SBX", "CPY", "CMP", "DEC", "DCM",
+	"BNE", "CMP", "CIM", "DCM", "NOP", "CMP", "DEC", "DCM", "CLD", "CMP", "NOP", "DCM", "NOP", "CMP", "DEC", "DCM",
+	"CPX", "SBC", "NOP", "INS", "CPX", "SBC", "INC", "INS", "INX", "SBC", "NOP", "SBC", "CPX", "SBC", "INC", "INS",
+	"BEQ", "SBC", "CIM", "INS", "NOP", "SBC", "INC", "INS", "SED", "SBC", "NOP", "INS", "NOP", "SBC", "INC", "INS",
+};
+static const UBYTE opcode_mode[256] = {
+	AM_IMP, AM_IZX, AM_IMP, AM_IZX, AM_ZP, AM_ZP, AM_ZP, AM_ZP, AM_IMP, AM_IMM, AM_IMP, AM_IMM, AM_ABS, AM_ABS, AM_ABS, AM_ABS,
+	AM_REL, AM_IZY, AM_IMP, AM_IZY, AM_ZPX, AM_ZPX, AM_ZPX, AM_ZPX, AM_IMP, AM_ABY, AM_IMP, AM_ABY, AM_ABX, AM_ABX, AM_ABX, AM_ABX,
+	AM_ABS, AM_IZX, AM_IMP, AM_IZX, AM_ZP, AM_ZP, AM_ZP, AM_ZP, AM_IMP, AM_IMM, AM_IMP, AM_IMM, AM_ABS, AM_ABS, AM_ABS, AM_ABS,
+	AM_REL, AM_IZY, AM_IMP, AM_IZY, AM_ZPX, AM_ZPX, AM_ZPX, AM_ZPX, AM_IMP, AM_ABY, AM_IMP, AM_ABY, AM_ABX, AM_ABX, AM_ABX, AM_ABX,
+	AM_IMP, AM_IZX, AM_IMP, AM_IZX, AM_ZP, AM_ZP, AM_ZP, AM_ZP, AM_IMP, AM_IMM, AM_IMP, AM_IMM, AM_ABS, AM_ABS, AM_ABS, AM_ABS,
+	AM_REL, AM_IZY, AM_IMP, AM_IZY, AM_ZPX, AM_ZPX, AM_ZPX, AM_ZPX, AM_IMP, AM_ABY, AM_IMP, AM_ABY, AM_ABX, AM_ABX, AM_ABX, AM_ABX,
+	AM_IMP, AM_IZX, AM_IMP, AM_IZX, AM_ZP, AM_ZP, AM_ZP, AM_ZP, AM_IMP, AM_IMM, AM_IMP, AM_IMM, AM_IND, AM_ABS, AM_ABS, AM_ABS,
+	AM_REL, AM_IZY, AM_IMP, AM_IZY, AM_ZPX, AM_ZPX, AM_ZPX, AM_ZPX, AM_IMP, AM_ABY, AM_IMP, AM_ABY, AM_ABX, AM_ABX, AM_ABX, AM_ABX,
+	AM_IMM, AM_IZX, AM_IMM, AM_IZX, AM_ZP, AM_ZP, AM_ZP, AM_ZP, AM_IMP, AM_IMM, AM_IMP, AM_IMM, AM_ABS, AM_ABS, AM_ABS, AM_ABS,
+	AM_REL, AM_IZY, AM_IMP, AM_IZY, AM_ZPX, AM_ZPX, AM_ZPY, AM_ZPY, AM_IMP, AM_ABY, AM_IMP, AM_ABY, AM_ABX, AM_ABX, AM_ABY, AM_ABY,
+	AM_IMM, AM_IZX, AM_IMM, AM_IZX, AM_ZP, AM_ZP, AM_ZP, AM_ZP, AM_IMP, AM_IMM, AM_IMP, AM_IMM, AM_ABS, AM_ABS, AM_ABS, AM_ABS,
+	AM_REL, AM_IZY, AM_IMP, AM_IZY, AM_ZPX, AM_ZPX, AM_ZPY, AM_ZPY, AM_IMP, AM_ABY, AM_IMP, AM_ABY, AM_ABX, AM_ABX, AM_ABY, AM_ABY,
+	AM_IMM, AM_IZX, AM_IMM, AM_IZX, AM_ZP, AM_ZP, AM_ZP, AM_ZP, AM_IMP, AM_IMM, AM_IMP, AM_IMM, AM_ABS, AM_ABS, AM_ABS, AM_ABS,
+	AM_REL, AM_IZY, AM_IMP, AM_IZY, AM_ZPX, AM_ZPX, AM_ZPX, AM_ZPX, AM_IMP, AM_ABY, AM_IMP, AM_ABY, AM_ABX, AM_ABX, AM_ABX, AM_ABX,
+	AM_IMM, AM_IZX, AM_IMM, AM_IZX, AM_ZP, AM_ZP, AM_ZP, AM_ZP, AM_IMP, AM_IMM, AM_IMP, AM_IMM, AM_ABS, AM_ABS, AM_ABS, AM_ABS,
+	AM_REL, AM_IZY, AM_IMP, AM_IZY, AM_ZPX, AM_ZPX, AM_ZPX, AM_ZPX, AM_IMP, AM_ABY, AM_IMP, AM_ABY, AM_ABX, AM_ABX, AM_ABX, AM_ABX,
+};
+
+void PROFILE_CPUStart(void)
+{
+	memset(instruction_count, 0, sizeof(instruction_count));
+	memset(pc_block_count, 0, sizeof(pc_block_count));
+	memset(readmap_count, 0, sizeof(readmap_count));
+	memset(writemap_count, 0, sizeof(writemap_count));
+	monitor_profile = TRUE;
+}
+
+void PROFILE_CPUStop(void)
+{
+	monitor_profile = FALSE;
+}
+
+/* an index into a counter table and its count, sorted by decreasing count;
+   the count is copied in so the comparison needs nothing else, and threads
+   writing their reports at once don't share anything */
+typedef struct {
+	ULONG count;
+	int index;
+} count_entry;
+
+static int cmp_counts(const void *a, const void *b)
+{
+	const count_entry *ea = (const count_entry *) a;
+	const count_entry *eb = (const count_entry *) b;
+	return ea->count < eb->count ? 1 : ea->count > eb->count ? -1 : ea->index - eb->index;
+}
+
+static void sort_counts(count_entry *order, const ULONG *counts, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		order[i].count = counts[i];
+		order[i].index = i;
+	}
+	qsort(order, n, sizeof(order[0]), cmp_counts);
+}
+
+static const char *page_name(int page)
+{
+	if (writemap[page] == GTIA_PutByte)
+		return "GTIA";
+	if (writemap[page] == ANTIC_PutByte)
+		return "ANTIC";
+	if (writemap[page] == POKEY_PutByte)
+		return "POKEY";
+	if (writemap[page] == CART_PutByte)
+		return "cartridge bank switching";
+	if (writemap[page] == ROM_PutByte)
+		return "ROM";
+	return "";
+}
+
+int PROFILE_WriteCPUReport(const char *filename)
+{
+	FILE *fp = fopen(filename, "w");
+	count_entry order[0x10000 >> PC_BLOCK_SHIFT];
+	ULONG mode_count[AM_MODES];
+	unsigned long long total = 0;
+	int i;
+
+	if (fp == NULL)
+		return FALSE;
+
+	for (i = 0; i < 256; i++)
+		total += instruction_count[i];
+	fprintf(fp, "cartridge: %s", cart_filename);
+	if (cart_image != NULL)
+		fprintf(fp, " (crc %08lx)", crc32(0, cart_image, cart_kb[cart_type] << 10));
+	fprintf(fp, "\ninstructions: %llu\n", total);
+	if (total == 0)
+		total = 1;
+
+	fprintf(fp, "\nopcode                  count       %%\n");
+	sort_counts(order, instruction_count, 256);
+	for (i = 0; i < 256 && order[i].count != 0; i++) {
+		int insn = order[i].index;
+		fprintf(fp, "%02x %s %-8s %12lu %7.3f\n", insn, opcode_mnemonic[insn],
+			mode_names[opcode_mode[insn]], (unsigned long) instruction_count[insn],
+			instruction_count[insn] * 100.0 / total);
+	}
+
+	fprintf(fp, "\naddressing mode         count       %%\n");
+	memset(mode_count, 0, sizeof(mode_count));
+	for (i = 0; i < 256; i++)
+		mode_count[opcode_mode[i]] += instruction_count[i];
+	for (i = 0; i < AM_MODES; i++)
+		fprintf(fp, "%-15s %12lu %7.3f\n", mode_names[i],
+			(unsigned long) mode_count[i], mode_count[i] * 100.0 / total);
+
+	fprintf(fp, "\ncode block              count       %%\n");
+	sort_counts(order, pc_block_count, 0x10000 >> PC_BLOCK_SHIFT);
+	for (i = 0; i < HOT_BLOCKS && order[i].count != 0; i++) {
+		int start = order[i].index << PC_BLOCK_SHIFT;
+		fprintf(fp, "%04x-%04x       %12lu %7.3f\n", start, start + (1 << PC_BLOCK_SHIFT) - 1,
+			(unsigned long) order[i].count, order[i].count * 100.0 / total);
+	}
+
+	fprintf(fp, "\npage          reads       writes\n");
+	for (i = 0; i < 256; i++)
+		if (readmap_count[i] != 0 || writemap_count[i] != 0)
+			fprintf(fp, "%02xxx %12lu %12lu  %s\n", i, (unsigned long) readmap_count[i],
+				(unsigned long) writemap_count[i], page_name(i));
+
+	fclose(fp);
+	return TRUE;
+}
+
+#endif /* MONITOR_PROFILE */
@@ -0,0 +1,96 @@
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+#include <stdio.h>
+#include "atari.h"
+
+/* Per-frame timing of the emulation stages.
+
+   Compiled in only with FRAME_PROFILE defined (make PROFILE=1); otherwise
+   the macros below vanish and the core runs without any clock reads.
+
+   At any time exactly one stage is charged with the elapsed time:
+   PROFILE_Switch() reads the clock, adds the time since the previous
+   switch to the current stage and makes the given stage current. The
+   stage times of a frame therefore add up to its total time, with
+   everything not covered by a specific stage (ANTIC display list
+   processing, INPUT_Frame(), ...) counted as PROFILE_OTHER. Time spent
+   outside Atari800_Frame() and PROFILE_CALL() - waiting for the next
+   frame, menus - isn't charged to any stage.
+
+   A frame makes a few thousand switches; their cost (one clock_gettime()
+   each) ends up mostly in PROFILE_OTHER, so compare the other stages
+   between profiled builds rather than against a normal build. */
+
+#define PROFILE_IDLE     0	/* not charged */
+#define PROFILE_OTHER    1	/* rest of Atari800_Frame() */
+#define PROFILE_CPU      2	/* GO() */
+#define PROFILE_ANTIC    3	/* draw_antic_* line rendering */
+#define PROFILE_GTIA     4	/* new_pm_scanline(), update_pmpl_colls() */
+#define PROFILE_POKEY    5	/* POKEY_Scanline(), frontend: a frame's sound */
+#define PROFILE_BLIT     6	/* frontend: graphics_paint() */
+#define PROFILE_STAGES   7
+
+/* frames kept for the histograms and the CSV dump */
+#define PROFILE_HISTORY  512
+/* histogram buckets: 0.5 ms wide, the last one collects everything above */
+#define PROFILE_BUCKETS  40
+#define PROFILE_BUCKET_US 500
+
+#ifdef FRAME_PROFILE
+
+/* Evaluates call charging its time to stage, then returns to the stage
+   that was current before (stages may nest, e.g. GTIA inside CPU). */
+#define PROFILE_CALL(stage, call) do { \
+		int profile_prev_ = PROFILE_Switch(stage); \
+		call; \
+		PROFILE_Switch(profile_prev_); \
+	} while (0)
+
+/* Closes the previous frame record and starts a new one. Called at the
+   start of Atari800_Frame(). */
+void PROFILE_BeginFrame(void);
+/* Stops charging emulation time. Called at the end of Atari800_Frame(). */
+void PROFILE_EndFrame(void);
+/* Makes stage current and returns the previous current stage. */
+int PROFILE_Switch(int stage);
+/* Forgets all recorded frames. */
+void PROFILE_Reset(void);
+
+/* Fills buckets[PROFILE_BUCKETS] with the distribution of the time spent
+   in stage (PROFILE_IDLE: the total of the frame) over the last recorded frames.
+   Returns the number of frames counted. */
+int PROFILE_Histogram(int stage, unsigned int buckets[PROFILE_BUCKETS]);
+/* Prints the histograms and the averages of all stages. */
+void PROFILE_PrintReport(FILE *fp);
+/* Writes the recorded frames as CSV, one line per frame, times in us.
+   Returns FALSE if the file can't be written. */
+int PROFILE_WriteCSV(const char *filename);
+
+#else
+
+#define PROFILE_CALL(stage, call) call
+
+#endif /* FRAME_PROFILE */
+
+/* 6502 profile, compiled in with MONITOR_PROFILE (make PROFILE=1 too).
+   While switched on, GO() counts every executed opcode and the
+   instructions executed in each 16-byte block of code (see cpu.h), and
+   GetByte()/PutByte() count the readmap/writemap dispatches - hardware
+   registers, cartridge bank switching, writes to ROM - of each page
+   (see memory.h). Switched off it costs a test per instruction. */
+
+#ifdef MONITOR_PROFILE
+
+/* Clears the counters and starts counting. */
+void PROFILE_CPUStart(void);
+/* Stops counting, the counters are kept. */
+void PROFILE_CPUStop(void);
+/* Writes the opcodes, addressing modes, hottest code blocks and hardware
+   pages of the inserted cartridge. Returns FALSE if the file can't be
+   written. */
+int PROFILE_WriteCPUReport(const char *filename);
+
+#endif /* MONITOR_PROFILE */
+
+#endif /* _PROFILE_H_ */
@@ -0,0 +1,286 @@
+/*
+ * rewind.c - history of snapshots for stepping back
+ *
+ * This file is part of the a5200 port of the Atari800 emulator.
+ * See rewind.h for how the snapshots are kept.
+ */
+
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include "atari.h"
+#include "rewind.h"
+#include "statesav.h"
+
+/* A difference in the ring: its length, the bytes, the length again (to
+   find the start of the latest one from the end), wrapping around at the
+   end of the ring. The bytes are pairs of a count of unchanged bytes and
+   a count of changed ones, each 7 bits a byte with bit 7 set on all but
+   the last, followed by the changed bytes XORed. */
+#define REWIND_LEN 4
+
+static EMU_TLS int rewind_interval = 0;
+static EMU_TLS int rewind_countdown;
+
+static EMU_TLS UBYTE *rewind_ring = NULL;
+static EMU_TLS int rewind_ring_size;
+static EMU_TLS int rewind_head;			/* where the next difference goes */
+static EMU_TLS int rewind_tail;			/* the oldest difference */
+static EMU_TLS int rewind_used;
+static EMU_TLS int rewind_entries;
+
+/* the latest snapshot, the next one and a difference being coded */
+static EMU_TLS UBYTE *rewind_key = NULL;
+static EMU_TLS UBYTE *rewind_next = NULL;
+static EMU_TLS UBYTE *rewind_delta = NULL;
+static EMU_TLS int rewind_state_size = 0;
+static EMU_TLS int rewind_have_key;
+
+void Rewind_Reset(void)
+{
+	rewind_head = rewind_tail = rewind_used = rewind_entries = 0;
+	rewind_have_key = FALSE;
+	rewind_countdown = rewind_interval;
+}
+
+static void Rewind_FreeStates(void)
+{
+	free(rewind_key);
+	free(rewind_next);
+	free(rewind_delta);
+	rewind_key = rewind_next = rewind_delta = NULL;
+	rewind_state_size = 0;
+}
+
+int Rewind_Init(int interval, int size)
+{
+	free(rewind_ring);
+	rewind_ring = NULL;
+	Rewind_FreeStates();
+	rewind_interval = 0;
+	Rewind_Reset();
+	if (interval <= 0 || size <= 0)
+		return TRUE;
+	rewind_ring = (UBYTE *) malloc(size);
+	if (rewind_ring == NULL)
+		return FALSE;
+	rewind_ring_size = size;
+	rewind_interval = interval;
+	rewind_countdown = interval;
+	return TRUE;
+}
+
+static void Rewind_Put(int pos, const UBYTE *data, int len)
+{
+	int first = rewind_ring_size - pos;
+
+	if (len <= first)
+		memcpy(rewind_ring + pos, data, len);
+	else {
+		memcpy(rewind_ring + pos, data, first);
+		memcpy(rewind_ring, data + first, len - first);
+	}
+}
+
+static void Rewind_Get(int pos, UBYTE *data, int len)
+{
+	int first = rewind_ring_size - pos;
+
+	if (len <= first)
+		memcpy(data, rewind_ring + pos, len);
+	else {
+		memcpy(data, rewind_ring + pos, first);
+		memcpy(data + first, rewind_ring, len - first);
+	}
+}
+
+static int Rewind_GetLen(int pos)
+{
+	UBYTE b[REWIND_LEN];
+
+	Rewind_Get(pos, b, REWIND_LEN);
+	return b[0] | (b[1] << 8) | (b[2] << 16) | (b[3] << 24);
+}
+
+static int Rewind_Wrap(int pos)
+{
+	return pos >= rewind_ring_size ? pos - rewind_ring_size : pos;
+}
+
+/* Adds a difference as the latest, dropping the oldest ones for room. */
+static void Rewind_Push(const UBYTE *data, int len)
+{
+	int need = len + 2 * REWIND_LEN;
+	UBYTE b[REWIND_LEN];
+
+	if (need > rewind_ring_size) {
+		/* the whole ring wouldn't hold it: only the key is left */
+		rewind_head = rewind_tail = rewind_used = rewind_entries = 0;
+		return;
+	}
+	while (rewind_used + need > rewind_ring_size) {
+		int oldest = Rewind_GetLen(rewind_tail) + 2 * REWIND_LEN;
+		rewind_tail = Rewind_Wrap(rewind_tail + oldest);
+		rewind_used -= oldest;
+		rewind_entries--;
+	}
+	b[0] = (UBYTE) len;
+	b[1] = (UBYTE) (len >> 8);
+	b[2] = (UBYTE) (len >> 16);
+	b[3] = (UBYTE) (len >> 24);
+	Rewind_Put(rewind_head, b, REWIND_LEN);
+	Rewind_Put(Rewind_Wrap(rewind_head + REWIND_LEN), data, len);
+	Rewind_Put(Rewind_Wrap(rewind_head + REWIND_LEN + len), b, REWIND_LEN);
+	rewind_head = Rewind_Wrap(rewind_head + need);
+	rewind_used += need;
+	rewind_entries++;
+}
+
+/* Takes the latest difference out of the ring into data, returns its length. */
+static int Rewind_Pop(UBYTE *data)
+{
+	int end = rewind_head - REWIND_LEN;
+	int len;
+
+	if (end < 0)
+		end += rewind_ring_size;
+	len = Rewind_GetLen(end);
+	rewind_head = end - len - REWIND_LEN;
+	if (rewind_head < 0)
+		rewind_head += rewind_ring_size;
+	Rewind_Get(Rewind_Wrap(rewind_head + REWIND_LEN), data, len);
+	rewind_used -= len + 2 * REWIND_LEN;
+	rewind_entries--;
+	return len;
+}
+
+static UBYTE *Rewind_PutCount(UBYTE *out, int n)
+{
+	while (n >= 0x80) {
+		*out++ = (UBYTE) (n | 0x80);
+		n >>= 7;
+	}
+	*out++ = (UBYTE) n;
+	return out;
+}
+
+static const UBYTE *Rewind_GetCount(const UBYTE *in, int *n)
+{
+	int value = 0;
+	int shift = 0;
+
+	while (*in & 0x80) {
+		value |= (*in++ & 0x7f) << shift;
+		shift += 7;
+	}
+	*n = value | (*in++ << shift);
+	return in;
+}
+
+/* Codes a XOR b into out, returns its length. out has room for
+   size + size / 2 + 16 bytes, the most it can take: a run of changed
+   bytes only ends at 4 unchanged ones. */
+static int Rewind_Encode(UBYTE *out, const UBYTE *a, const UBYTE *b, int size)
+{
+	UBYTE *o = out;
+	int i = 0;
+
+	while (i < size) {
+		int start = i;
+		int changed;
+
+		/* unchanged, 8 bytes at a time while it lasts */
+		while (i + 8 <= size && memcmp(a + i, b + i, 8) == 0)
+			i += 8;
+		while (i < size && a[i] == b[i])
+			i++;
+		o = Rewind_PutCount(o, i - start);
+		start = i;
+		while (i < size) {
+			if (a[i] == b[i] && (i + 4 > size
+				|| (a[i + 1] == b[i + 1] && a[i + 2] == b[i + 2] && a[i + 3] == b[i + 3])))
+				break;
+			i++;
+		}
+		changed = i - start;
+		o = Rewind_PutCount(o, changed);
+		while (start < i) {
+			*o++ = a[start] ^ b[start];
+			start++;
+		}
+	}
+	return o - out;
+}
+
+/* XORs a difference from Rewind_Encode() into state. */
+static void Rewind_Decode(UBYTE *state, const UBYTE *in, int len)
+{
+	const UBYTE *end = in + len;
+	int pos = 0;
+
+	while (in < end) {
+		int unchanged, changed;
+		in = Rewind_GetCount(in, &unchanged);
+		in = Rewind_GetCount(in, &changed);
+		pos += unchanged;
+		while (changed-- > 0)
+			state[pos++] ^= *in++;
+	}
+}
+
+static void Rewind_Capture(void)
+{
+	int size = AtariStateSize(FALSE);
+	UBYTE *t;
+
+	if (size != rewind_state_size) {
+		/* the first snapshot of the cartridge, or one of another size:
+		   buffers to fit it */
+		Rewind_FreeStates();
+		Rewind_Reset();
+		rewind_key = (UBYTE *) malloc(size);
+		rewind_next = (UBYTE *) malloc(size);
+		rewind_delta = (UBYTE *) malloc(size + size / 2 + 16);
+		if (rewind_key == NULL || rewind_next == NULL || rewind_delta == NULL) {
+			Rewind_FreeStates();
+			return;
+		}
+		rewind_state_size = size;
+	}
+	if (SaveAtariStateMem(rewind_next, size, FALSE) == 0)
+		return;
+	if (rewind_have_key)
+		Rewind_Push(rewind_delta, Rewind_Encode(rewind_delta, rewind_key, rewind_next, size));
+	t = rewind_key;
+	rewind_key = rewind_next;
+	rewind_next = t;
+	rewind_have_key = TRUE;
+}
+
+void Rewind_Frame(void)
+{
+	if (rewind_interval == 0 || --rewind_countdown > 0)
+		return;
+	rewind_countdown = rewind_interval;
+	Rewind_Capture();
+}
+
+int Rewind_Back(void)
+{
+	if (!rewind_have_key || !ReadAtariStateMem(rewind_key, rewind_state_size))
+		return FALSE;
+	rewind_countdown = rewind_interval;
+	if (rewind_entries > 0)
+		Rewind_Decode(rewind_key, rewind_delta, Rewind_Pop(rewind_delta));
+	else
+		rewind_have_key = FALSE;
+	return TRUE;
+}
+
+int Rewind_Count(int *bytes)
+{
+	if (bytes != NULL)
+		*bytes = rewind_used + (rewind_have_key ? rewind_state_size : 0);
+	return rewind_entries + (rewind_have_key ? 1 : 0);
+}
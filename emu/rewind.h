@@ -0,0 +1,37 @@
+#ifndef _REWIND_H_
+#define _REWIND_H_
+
+#include "atari.h"
+
+/* Rewinding: a snapshot of the machine (SaveAtariStateMem()) every few
+   frames, kept in a ring of fixed size.
+
+   Only the latest snapshot is kept whole. Each older one is stored as
+   the difference to the one after it: the two XORed together, which is
+   zero for all but the few bytes that changed in between (most of the
+   snapshot is the 64 KB address space and its attributes, and of that
+   only the 16 KB of RAM changes), and those zeros run-length encoded.
+   A few hundred bytes to a few KB a snapshot, so minutes of history fit
+   in a few MB. When the ring is full the oldest differences make room.
+
+   Stepping back restores the latest snapshot and decodes the difference
+   before it into its place, so the next step goes back further. */
+
+/* Takes a snapshot every interval frames into a ring of size bytes,
+   dropping the history there was. 0 for either switches rewinding off
+   and frees the ring. Returns FALSE if there is no memory for it. */
+int Rewind_Init(int interval, int size);
+/* Drops the history, keeping the ring. CART_Start() calls it: the
+   snapshots of one cartridge would load the other one back from its
+   file. */
+void Rewind_Reset(void);
+/* Called by Atari800_Frame() after each frame. */
+void Rewind_Frame(void);
+/* Goes back to the latest snapshot, at most interval frames back.
+   Returns FALSE if there's none left. */
+int Rewind_Back(void);
+/* Snapshots in the history, the whole one included; *bytes, if not
+   NULL, receives the memory they take. */
+int Rewind_Count(int *bytes);
+
+#endif /* _REWIND_H_ */
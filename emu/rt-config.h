@@ -18,13 +18,13 @@ extern char atari_h3_dir[FILENAME_MAX];
 extern char atari_h4_dir[FILENAME_MAX];
 extern char atari_exe_dir[FILENAME_MAX];
 extern char atari_state_dir[FILENAME_MAX];
-extern char print_command[256];
+extern EMU_TLS char print_command[256];
 extern int hd_read_only;
 extern int refresh_rate;
-extern int disable_basic;
-extern int enable_sio_patch;
-extern int enable_h_patch;
-extern int enable_p_patch;
+extern EMU_TLS int disable_basic;
+extern EMU_TLS int enable_sio_patch;
+extern EMU_TLS int enable_h_patch;
+extern EMU_TLS int enable_p_patch;
 extern int disk_directories;
 
 int RtConfigLoad(char *rtconfig_filename);
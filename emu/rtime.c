@@ -35,16 +35,16 @@
 #include "atari.h"
 //#include "log.h"
 
-int rtime_enabled = 1;
+EMU_TLS int rtime_enabled = 1;
 
-static int rtime_state = 0;
+static EMU_TLS int rtime_state = 0;
 				/* 0 = waiting for register # */
 				/* 1 = got register #, waiting for hi nybble */
 				/* 2 = got hi nybble, waiting for lo nybble */
-static int rtime_tmp = 0;
-static int rtime_tmp2 = 0;
+static EMU_TLS int rtime_tmp = 0;
+static EMU_TLS int rtime_tmp2 = 0;
 
-static UBYTE regset[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+static EMU_TLS UBYTE regset[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
 
 void RTIME_Initialise(void)
 {
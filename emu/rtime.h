@@ -17,7 +17,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
 
 #include "atari.h"
 
-extern int rtime_enabled;
+extern EMU_TLS int rtime_enabled;
 
 void RTIME_Initialise(void);
 UBYTE RTIME_GetByte(void);
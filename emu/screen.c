@@ -32,7 +32,6 @@
 #endif
 
 //ALEK #include "main.h"
-#include "shared.h"
 
 #include "antic.h"
 #include "atari.h"
@@ -42,9 +41,130 @@
 #define ATARI_VISIBLE_WIDTH 336
 #define ATARI_LEFT_MARGIN 24
 
-UWORD *atari_screen = (UWORD *) vidBuf;
+EMU_TLS UBYTE vidBuf[SCREEN_PITCH * 512];
+EMU_TLS UWORD *atari_screen;	/* set to vidBuf by ANTIC_Initialise() */
 
 #ifdef DIRTYRECT
 UBYTE *screen_dirty = NULL;
 #endif
 
+
+/* Changed lines and host format output ----------------------------------- */
+
+EMU_TLS ULONG screen_frame_gen = 0;
+EMU_TLS ULONG screen_line_gen[ATARI_HEIGHT];
+static EMU_TLS ULONG line_hash[ATARI_HEIGHT];
+/* FALSE until the row has been hashed, and after Screen_InvalidateLines() */
+static EMU_TLS UBYTE line_valid[ATARI_HEIGHT];
+
+EMU_TLS int screen_host_format = SCREEN_HOST_NONE;
+static EMU_TLS UBYTE *host_pixels;
+static EMU_TLS int host_pitch;
+static EMU_TLS ULONG host_gen;		/* frame the host buffer shows */
+static EMU_TLS int host_gen_set;	/* host_gen from Screen_SetHostOutput() */
+static EMU_TLS ULONG host_palette[512];
+/* ANTIC draws the current line into the second line of host_line; the
+   first one gets a copy of it when the GTIA mode 11 delay reads it back
+   on the next line. ULONGs for the alignment. */
+static EMU_TLS ULONG host_line[2 * SCREEN_PITCH / 4];
+
+#ifdef WORDS_BIGENDIAN
+#define PIXEL_PAIR(left, right) (((left) << 16) | (right))
+#else
+#define PIXEL_PAIR(left, right) (((right) << 16) | (left))
+#endif
+
+void Screen_SetHostOutput(int format, void *pixels, int pitch, const ULONG *palette, ULONG gen)
+{
+	if (format == SCREEN_HOST_NONE || pixels == NULL) {
+		screen_host_format = SCREEN_HOST_NONE;
+		atari_screen = (UWORD *) vidBuf;
+		return;
+	}
+	screen_host_format = format;
+	host_pixels = (UBYTE *) pixels;
+	host_pitch = pitch;
+	host_gen = gen;
+	host_gen_set = TRUE;
+	memcpy(host_palette, palette, sizeof(host_palette));
+	atari_screen = (UWORD *) (host_line + SCREEN_PITCH / 4);
+}
+
+void Screen_FrameStart(void)
+{
+	/* the same buffer again: it has all of the last frame */
+	if (!host_gen_set)
+		host_gen = screen_frame_gen;
+	host_gen_set = FALSE;
+	screen_frame_gen++;
+}
+
+void Screen_InvalidateLines(int first, int last)
+{
+	if (first < 0)
+		first = 0;
+	if (last >= ATARI_HEIGHT)
+		last = ATARI_HEIGHT - 1;
+	if (first <= last)
+		memset(line_valid + first, FALSE, last - first + 1);
+}
+
+void Screen_LineDone(int row, int keep)
+{
+	const ULONG *line;
+	const UBYTE *src;
+	const ULONG *pal;
+	ULONG h0, h1, h2, h3;
+	int x;
+
+	if (row < 0 || row >= ATARI_HEIGHT)
+		return;
+	if (screen_host_format == SCREEN_HOST_NONE)
+		line = (const ULONG *) ((UBYTE *) atari_screen + row * SCREEN_PITCH + 32);
+	else
+		line = host_line + (SCREEN_PITCH + 32) / 4;
+
+	/* FNV-1a on 32-bit words, four independent lanes */
+	h0 = h1 = h2 = h3 = 0x811c9dc5;
+	for (x = 0; x < 320 / 4; x += 4) {
+		h0 = (h0 ^ line[x]) * 0x01000193;
+		h1 = (h1 ^ line[x + 1]) * 0x01000193;
+		h2 = (h2 ^ line[x + 2]) * 0x01000193;
+		h3 = (h3 ^ line[x + 3]) * 0x01000193;
+	}
+	h0 ^= (h1 << 8 | h1 >> 24) ^ (h2 << 16 | h2 >> 16) ^ (h3 << 24 | h3 >> 8);
+	if (h0 != line_hash[row] || !line_valid[row]) {
+		line_hash[row] = h0;
+		line_valid[row] = TRUE;
+		screen_line_gen[row] = screen_frame_gen;
+	}
+
+	if (screen_host_format == SCREEN_HOST_NONE)
+		return;
+	if (keep)
+		memcpy(host_line, host_line + SCREEN_PITCH / 4, SCREEN_PITCH);
+	/* the buffer shows this line already */
+	if (screen_line_gen[row] <= host_gen)
+		return;
+	src = (const UBYTE *) line;
+	pal = host_palette + ((row & 1) << 8);
+	if (screen_host_format == SCREEN_HOST_RGB565) {
+		/* two pixels per store */
+		ULONG *dst = (ULONG *) (host_pixels + row * host_pitch);
+		for (x = 0; x < 320; x += 4) {
+			dst[0] = PIXEL_PAIR(pal[src[x]], pal[src[x + 1]]);
+			dst[1] = PIXEL_PAIR(pal[src[x + 2]], pal[src[x + 3]]);
+			dst += 2;
+		}
+	}
+	else {
+		ULONG *dst = (ULONG *) (host_pixels + row * host_pitch);
+		for (x = 0; x < 320; x += 4) {
+			dst[0] = pal[src[x]];
+			dst[1] = pal[src[x + 1]];
+			dst[2] = pal[src[x + 2]];
+			dst[3] = pal[src[x + 3]];
+			dst += 4;
+		}
+	}
+}
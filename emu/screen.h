@@ -10,7 +10,48 @@ extern UBYTE *screen_dirty;
 #endif
 void entire_screen_dirty(void);
 
-extern UWORD *atari_screen;
+/* 8-bit frame buffer ANTIC draws into: 512 bytes per line,
+   the visible 320 pixels start at byte 32 of each line. */
+#define SCREEN_PITCH 512
+extern EMU_TLS UBYTE vidBuf[SCREEN_PITCH * 512];
+
+extern EMU_TLS UWORD *atari_screen;
+
+/* Changed lines. ANTIC counts the drawn frames in screen_frame_gen and
+   sets screen_line_gen[row] (row 0-239) to the count of the last frame
+   that changed the line, compared through a hash of its colour codes -
+   so it covers everything the line shows: playfield, colour registers,
+   players and missiles. Whatever has shown frame g (a host buffer, a
+   recorder) only needs the rows with screen_line_gen[row] > g. */
+extern EMU_TLS ULONG screen_frame_gen;
+extern EMU_TLS ULONG screen_line_gen[ATARI_HEIGHT];
+
+/* Makes rows first..last count as changed the next time they are drawn,
+   e.g. after a frontend has drawn over them. */
+void Screen_InvalidateLines(int first, int last);
+/* Called by ANTIC before it draws a frame. */
+void Screen_FrameStart(void);
+
+/* Pixel formats for Screen_SetHostOutput() */
+#define SCREEN_HOST_NONE      0	/* ANTIC draws into vidBuf */
+#define SCREEN_HOST_RGB565    1
+#define SCREEN_HOST_XRGB8888  2
+
+extern EMU_TLS int screen_host_format;
+
+/* Makes ANTIC convert each scanline as soon as it is drawn into a 320x240
+   host buffer at pixels, pitch bytes per line, instead of drawing the
+   frame into vidBuf. palette has the host pixel values of the 256 Atari
+   colours for the even lines, then for the odd lines (e.g. the same
+   twice, or with a scanline effect). gen is the screen_frame_gen the
+   buffer shows already, 0 if none: lines not changed since are left
+   alone, and so on for the next frames drawn into the same buffer. The
+   buffer must stay valid while frames are drawn; SCREEN_HOST_NONE goes
+   back to vidBuf. */
+void Screen_SetHostOutput(int format, void *pixels, int pitch, const ULONG *palette, ULONG gen);
+/* Called by ANTIC at the end of each drawn line of the frame (row 0-239),
+   keep if the next line reads this one back. */
+void Screen_LineDone(int row, int keep);
 
 #ifdef BITPL_SCR
 extern ULONG *atari_screen_b;
@@ -56,36 +56,36 @@
 #define BOOT_SECTORS_LOGICAL	0
 #define BOOT_SECTORS_PHYSICAL	1
 #define BOOT_SECTORS_SIO2PC		2
-static int boot_sectors_type[MAX_DRIVES];
+static EMU_TLS int boot_sectors_type[MAX_DRIVES];
 
-static int header_size[MAX_DRIVES];
-static FILE *disk[MAX_DRIVES] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
-static int sectorcount[MAX_DRIVES];
-static int sectorsize[MAX_DRIVES];
-static int format_sectorcount[MAX_DRIVES];
-static int format_sectorsize[MAX_DRIVES];
-static int io_success[MAX_DRIVES];
+static EMU_TLS int header_size[MAX_DRIVES];
+static EMU_TLS FILE *disk[MAX_DRIVES] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+static EMU_TLS int sectorcount[MAX_DRIVES];
+static EMU_TLS int sectorsize[MAX_DRIVES];
+static EMU_TLS int format_sectorcount[MAX_DRIVES];
+static EMU_TLS int format_sectorsize[MAX_DRIVES];
+static EMU_TLS int io_success[MAX_DRIVES];
 
-UnitStatus drive_status[MAX_DRIVES];
-char sio_filename[MAX_DRIVES][FILENAME_MAX];
+EMU_TLS UnitStatus drive_status[MAX_DRIVES];
+EMU_TLS char sio_filename[MAX_DRIVES][FILENAME_MAX];
 
 Util_tmpbufdef(static, sio_tmpbuf[MAX_DRIVES])
 
-int sio_last_op;
-int sio_last_op_time = 0;
-int sio_last_drive;
-int sio_last_sector;
-char sio_status[256];
+EMU_TLS int sio_last_op;
+EMU_TLS int sio_last_op_time = 0;
+EMU_TLS int sio_last_drive;
+EMU_TLS int sio_last_sector;
+EMU_TLS char sio_status[256];
 
 /* Serial I/O emulation support */
-static UBYTE CommandFrame[6];
-static int CommandIndex = 0;
-static UBYTE DataBuffer[256 + 3];
-static int DataIndex = 0;
-static int TransferStatus = SIO_NoFrame;
-static int ExpectedBytes = 0;
+static EMU_TLS UBYTE CommandFrame[6];
+static EMU_TLS int CommandIndex = 0;
+static EMU_TLS UBYTE DataBuffer[256 + 3];
+static EMU_TLS int DataIndex = 0;
+static EMU_TLS int TransferStatus = SIO_NoFrame;
+static EMU_TLS int ExpectedBytes = 0;
 
-int ignore_header_writeprotect = FALSE;
+EMU_TLS int ignore_header_writeprotect = FALSE;
 
 void SIO_Initialise(void) {
 	int i;
@@ -559,8 +559,8 @@ static int DriveStatus(int unit, UBYTE *buffer)
    faster than with a typical disk drive.  We introduce a delay
    of SECTOR_DELAY scanlines between successive reads of sector 1. */
 #define SECTOR_DELAY 3200
-static int delay_counter = 0;
-static int last_ypos = 0;
+static EMU_TLS int delay_counter = 0;
+static EMU_TLS int last_ypos = 0;
 #endif
 
 /* SIO patch emulation routine */
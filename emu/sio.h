@@ -17,16 +17,16 @@ typedef enum tagUnitStatus {
 	ReadWrite
 } UnitStatus;
 
-extern char sio_status[256];
-extern UnitStatus drive_status[MAX_DRIVES];
-extern char sio_filename[MAX_DRIVES][FILENAME_MAX];
+extern EMU_TLS char sio_status[256];
+extern EMU_TLS UnitStatus drive_status[MAX_DRIVES];
+extern EMU_TLS char sio_filename[MAX_DRIVES][FILENAME_MAX];
 
 #define SIO_LAST_READ 0
 #define SIO_LAST_WRITE 1
-extern int sio_last_op;
-extern int sio_last_op_time;
-extern int sio_last_drive; /* 1 .. 8 */
-extern int sio_last_sector;
+extern EMU_TLS int sio_last_op;
+extern EMU_TLS int sio_last_op_time;
+extern EMU_TLS int sio_last_drive; /* 1 .. 8 */
+extern EMU_TLS int sio_last_sector;
 
 int SIO_Mount(int diskno, const char *filename, int b_open_readonly);
 void SIO_Dismount(int diskno);
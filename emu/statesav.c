@@ -48,9 +48,10 @@
 
 #include "atari.h"
 //#include "log.h"
+#include "memory.h"
 #include "util.h"
 
-#define SAVE_VERSION_NUMBER 4
+#define SAVE_VERSION_NUMBER 5
 
 void AnticStateSave(void);
 void MainStateSave(void);
@@ -79,95 +80,109 @@ static size_t mem_write(const void *buf, size_t len, gzFile *stream);
 #define GZCLOSE(X)       mem_close(X)
 #define GZREAD(X, Y, Z)  mem_read(Y, Z, X)
 #define GZWRITE(X, Y, Z) mem_write(Y, Z, X)
-#undef GZERROR
 #elif defined(HAVE_LIBZ) /* above MEMCOMPR, below HAVE_LIBZ */
 #define GZOPEN(X, Y)     gzopen(X, Y)
 #define GZCLOSE(X)       gzclose(X)
 #define GZREAD(X, Y, Z)  gzread(X, Y, Z)
 #define GZWRITE(X, Y, Z) gzwrite(X, (const voidp) Y, Z)
-#define GZERROR(X, Y)    gzerror(X, Y)
 #else
 #define GZOPEN(X, Y)     fopen(X, Y)
 #define GZCLOSE(X)       fclose(X)
-#define GZREAD(X, Y, Z)  fread(Y, Z, 1, X)
-#define GZWRITE(X, Y, Z) fwrite(Y, Z, 1, X)
-#undef GZERROR
+#define GZREAD(X, Y, Z)  fread(Y, 1, Z, X)
+#define GZWRITE(X, Y, Z) fwrite(Y, 1, Z, X)
 #define gzFile  FILE
-#define Z_OK    0
 #endif
 
-static gzFile *StateFile = NULL;
-static int nFileError = Z_OK;
+/* The state is always built in and read from a buffer in memory: the
+   Save and Read calls below copy into it or out of it, and the state
+   files are that buffer written or read in one go. */
+#define STATE_IDLE  0
+#define STATE_COUNT 1			/* only adds up the size */
+#define STATE_SAVE  2
+#define STATE_READ  3
+
+static EMU_TLS int StateMode = STATE_IDLE;
+static EMU_TLS UBYTE *StateMem;
+static EMU_TLS int StateMemSize;
+static EMU_TLS int StateMemPos;
+static EMU_TLS int StateMemError;
+
+/* Room for len bytes to save, NULL if counting or the buffer is full. */
+static UBYTE *StateSpace(int len)
+{
+	UBYTE *p;
+
+	if (StateMode == STATE_COUNT) {
+		StateMemPos += len;
+		return NULL;
+	}
+	if (StateMode != STATE_SAVE || StateMemError)
+		return NULL;
+	if (len > StateMemSize - StateMemPos) {
+		fprintf(stderr,"State buffer too small.");
+		StateMemError = TRUE;
+		return NULL;
+	}
+	p = StateMem + StateMemPos;
+	StateMemPos += len;
+	return p;
+}
 
-static void GetGZErrorText(void)
+/* The next len bytes to read, NULL past the end of the state. */
+static const UBYTE *StateData(int len)
 {
-#ifdef GZERROR
-	const char *error = GZERROR(StateFile, &nFileError);
-	if (nFileError == Z_ERRNO) {
-#ifdef HAVE_STRERROR
-		fprintf(stderr,"The following general file I/O error occurred:");
-		fprintf(stderr,strerror(errno));
-#else
-		fprintf(stderr,"A file I/O error occurred");
-#endif
-		return;
+	const UBYTE *p;
+
+	if (StateMode != STATE_READ || StateMemError)
+		return NULL;
+	if (len > StateMemSize - StateMemPos) {
+		fprintf(stderr,"Failed read from Atari state: too short.");
+		StateMemError = TRUE;
+		return NULL;
 	}
-	fprintf(stderr,"ZLIB returned the following error: %s", error);
-#endif /* GZERROR */
-	fprintf(stderr,"State file I/O failed.");
+	p = StateMem + StateMemPos;
+	StateMemPos += len;
+	return p;
 }
 
 /* Value is memory location of data, num is number of type to save */
 void SaveUBYTE(const UBYTE *data, int num)
 {
-	if (!StateFile || nFileError != Z_OK)
-		return;
-
 	/* Assumption is that UBYTE = 8bits and the pointer passed in refers
 	   directly to the active bits if in a padded location. If not (unlikely)
 	   you'll have to redefine this to save appropriately for cross-platform
 	   compatibility */
-	if (GZWRITE(StateFile, data, num) == 0)
-		GetGZErrorText();
+	UBYTE *p = StateSpace(num);
+
+	if (p != NULL)
+		memcpy(p, data, num);
 }
 
 /* Value is memory location of data, num is number of type to save */
 void ReadUBYTE(UBYTE *data, int num)
 {
-	if (!StateFile || nFileError != Z_OK)
-		return;
+	const UBYTE *p = StateData(num);
 
-	if (GZREAD(StateFile, data, num) == 0)
-		GetGZErrorText();
+	if (p != NULL)
+		memcpy(data, p, num);
 }
 
 /* Value is memory location of data, num is number of type to save */
 void SaveUWORD(const UWORD *data, int num)
 {
-	if (!StateFile || nFileError != Z_OK)
-		return;
-
 	/* UWORDS are saved as 16bits, regardless of the size on this particular
 	   platform. Each byte of the UWORD will be pushed out individually in
 	   LSB order. The shifts here and in the read routines will work for both
 	   LSB and MSB architectures. */
+	UBYTE *p = StateSpace(num * 2);
+
+	if (p == NULL)
+		return;
 	while (num > 0) {
-		UWORD temp;
-		UBYTE byte;
-
-		temp = *data++;
-		byte = temp & 0xff;
-		if (GZWRITE(StateFile, &byte, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
+		UWORD temp = *data++;
 
-		temp >>= 8;
-		byte = temp & 0xff;
-		if (GZWRITE(StateFile, &byte, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
+		*p++ = temp & 0xff;
+		*p++ = (temp >> 8) & 0xff;
 		num--;
 	}
 }
@@ -175,40 +190,30 @@ void SaveUWORD(const UWORD *data, int num)
 /* Value is memory location of data, num is number of type to save */
 void ReadUWORD(UWORD *data, int num)
 {
-	if (!StateFile || nFileError != Z_OK)
-		return;
+	const UBYTE *p = StateData(num * 2);
 
+	if (p == NULL)
+		return;
 	while (num > 0) {
-		UBYTE byte1, byte2;
-
-		if (GZREAD(StateFile, &byte1, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
-		if (GZREAD(StateFile, &byte2, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
-		*data++ = (byte2 << 8) | byte1;
+		*data++ = (p[1] << 8) | p[0];
+		p += 2;
 		num--;
 	}
 }
 
 void SaveINT(const int *data, int num)
 {
-	if (!StateFile || nFileError != Z_OK)
-		return;
-
 	/* INTs are always saved as 32bits (4 bytes) in the file. They can be any size
 	   on the platform however. The sign bit is clobbered into the fourth byte saved
 	   for each int; on read it will be extended out to its proper position for the
 	   native INT size */
+	UBYTE *p = StateSpace(num * 4);
+
+	if (p == NULL)
+		return;
 	while (num > 0) {
 		UBYTE signbit = 0;
 		unsigned int temp;
-		UBYTE byte;
 		int temp0;
 
 		temp0 = *data++;
@@ -218,75 +223,28 @@ void SaveINT(const int *data, int num)
 		}
 		temp = (unsigned int) temp0;
 
-		byte = temp & 0xff;
-		if (GZWRITE(StateFile, &byte, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
-		temp >>= 8;
-		byte = temp & 0xff;
-		if (GZWRITE(StateFile, &byte, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
-		temp >>= 8;
-		byte = temp & 0xff;
-		if (GZWRITE(StateFile, &byte, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
-		temp >>= 8;
-		byte = (temp & 0x7f) | signbit;
-		if (GZWRITE(StateFile, &byte, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
+		*p++ = temp & 0xff;
+		*p++ = (temp >> 8) & 0xff;
+		*p++ = (temp >> 16) & 0xff;
+		*p++ = ((temp >> 24) & 0x7f) | signbit;
 		num--;
 	}
 }
 
 void ReadINT(int *data, int num)
 {
-	if (!StateFile || nFileError != Z_OK)
-		return;
+	const UBYTE *p = StateData(num * 4);
 
+	if (p == NULL)
+		return;
 	while (num > 0) {
-		UBYTE signbit = 0;
 		int temp;
-		UBYTE byte1, byte2, byte3, byte4;
-
-		if (GZREAD(StateFile, &byte1, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
 
-		if (GZREAD(StateFile, &byte2, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
-		if (GZREAD(StateFile, &byte3, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
-		if (GZREAD(StateFile, &byte4, 1) == 0) {
-			GetGZErrorText();
-			break;
-		}
-
-		signbit = byte4 & 0x80;
-		byte4 &= 0x7f;
-
-		temp = (byte4 << 24) | (byte3 << 16) | (byte2 << 8) | byte1;
-		if (signbit)
+		temp = ((p[3] & 0x7f) << 24) | (p[2] << 16) | (p[1] << 8) | p[0];
+		if (p[3] & 0x80)
 			temp = -temp;
 		*data++ = temp;
-
+		p += 4;
 		num--;
 	}
 }
@@ -324,29 +282,11 @@ void ReadFNAME(char *filename)
 	filename[namelen] = 0;
 }
 
-int SaveAtariState(const char *filename, const char *mode, UBYTE SaveVerbose)
+static void SaveMachine(UBYTE SaveVerbose)
 {
 	UBYTE StateVersion = SAVE_VERSION_NUMBER;
 
-	if (StateFile != NULL) {
-		GZCLOSE(StateFile);
-		StateFile = NULL;
-	}
-	nFileError = Z_OK;
-
-	StateFile = GZOPEN(filename, mode);
-	if (StateFile == NULL) {
-		fprintf(stderr,"Could not open %s for state save.", filename);
-		GetGZErrorText();
-		return FALSE;
-	}
-	if (GZWRITE(StateFile, "ATARI800", 8) == 0) {
-		GetGZErrorText();
-		GZCLOSE(StateFile);
-		StateFile = NULL;
-		return FALSE;
-	}
-
+	SaveUBYTE((const UBYTE *) "ATARI800", 8);
 	SaveUBYTE(&StateVersion, 1);
 	SaveUBYTE(&SaveVerbose, 1);
 	/* The order here is important. Main must be first because it saves the machine type, and
@@ -358,95 +298,173 @@ int SaveAtariState(const char *filename, const char *mode, UBYTE SaveVerbose)
 	CpuStateSave(SaveVerbose);
 	GTIAStateSave();
 	PIAStateSave();
-	//ALEK POKEYStateSave();
+	POKEYStateSave();
 #ifdef DREAMCAST
 	DCStateSave();
 #endif
+}
 
-	if (GZCLOSE(StateFile) != 0) {
-		StateFile = NULL;
-		return FALSE;
-	}
-	StateFile = NULL;
-
-	if (nFileError != Z_OK)
-		return FALSE;
-
-	return TRUE;
+int AtariStateSize(UBYTE SaveVerbose)
+{
+	StateMode = STATE_COUNT;
+	StateMemPos = 0;
+	SaveMachine(SaveVerbose);
+	StateMode = STATE_IDLE;
+	return StateMemPos;
 }
 
-int ReadAtariState(const char *filename, const char *mode)
+int SaveAtariStateMem(UBYTE *buf, int size, UBYTE SaveVerbose)
 {
-	char header_string[8];
-	UBYTE StateVersion = 0;  /* The version of the save file */
-	UBYTE SaveVerbose = 0;   /* Verbose mode means save basic, OS if patched */
+	StateMode = STATE_SAVE;
+	StateMem = buf;
+	StateMemSize = size;
+	StateMemPos = 0;
+	StateMemError = FALSE;
+	SaveMachine(SaveVerbose);
+	StateMode = STATE_IDLE;
+	StateMem = NULL;
+	return StateMemError ? 0 : StateMemPos;
+}
 
-	if (StateFile != NULL) {
-		GZCLOSE(StateFile);
-		StateFile = NULL;
+/* Reads a state whose header has been checked into the machine. */
+static int ReadMachine(const UBYTE *buf, int size)
+{
+	UBYTE StateVersion = buf[8];	/* The version of the save file */
+	UBYTE SaveVerbose = buf[9];		/* Verbose mode means save basic, OS if patched */
+
+	StateMode = STATE_READ;
+	StateMem = (UBYTE *) buf;
+	StateMemSize = size;
+	StateMemPos = 10;
+	StateMemError = FALSE;
+	MainStateRead();
+	if (StateVersion != 3) {
+		CARTStateRead();
+		SIOStateRead();
 	}
-	nFileError = Z_OK;
+	AnticStateRead();
+	CpuStateRead(SaveVerbose);
+	GTIAStateRead();
+	PIAStateRead();
+	/* versions before 5 were saved without POKEY */
+	if (StateVersion >= 5)
+		POKEYStateRead();
+#ifdef DREAMCAST
+	DCStateRead();
+#endif
+	StateMode = STATE_IDLE;
+	StateMem = NULL;
 
-	StateFile = GZOPEN(filename, mode);
-	if (StateFile == NULL) {
-		fprintf(stderr,"Could not open %s for state read.", filename);
-		GetGZErrorText();
-		return FALSE;
-	}
+	return !StateMemError;
+}
+
+int ReadAtariStateMem(const UBYTE *buf, int size)
+{
+	UBYTE StateVersion;
+	UBYTE *undo;
+	int undo_size;
+	int ok;
+#ifdef PAGED_ATTRIB
+	rdfunc undo_readmap[256];
+	wrfunc undo_writemap[256];
+#endif
 
-	if (GZREAD(StateFile, header_string, 8) == 0) {
-		GetGZErrorText();
-		GZCLOSE(StateFile);
-		StateFile = NULL;
+	if (size < 10 || memcmp(buf, "ATARI800", 8) != 0) {
+		fprintf(stderr,"This is not an Atari800 state save file.");
 		return FALSE;
 	}
-	if (memcmp(header_string, "ATARI800", 8) != 0) {
-		fprintf(stderr,"This is not an Atari800 state save file.");
-		GZCLOSE(StateFile);
-		StateFile = NULL;
+	StateVersion = buf[8];
+	if (StateVersion > SAVE_VERSION_NUMBER || StateVersion < 3) {
+		fprintf(stderr,"Cannot read this state file because it is an incompatible version.");
 		return FALSE;
 	}
 
-	if (GZREAD(StateFile, &StateVersion, 1) == 0
-	 || GZREAD(StateFile, &SaveVerbose, 1) == 0) {
-		fprintf(stderr,"Failed read from Atari state file.");
-		GetGZErrorText();
-		GZCLOSE(StateFile);
-		StateFile = NULL;
+	/* How much a state takes depends on what it holds (the machine, the
+	   cartridge file name...), so a short one is only found out part way
+	   through, with some of the machine read already: keep the machine as
+	   it is and put it back then. The page handlers a state doesn't name
+	   (the mirrors of the chips) are kept as they are by reading one, so
+	   they are put back from a copy. */
+	undo_size = AtariStateSize(TRUE);
+	undo = (UBYTE *) malloc(undo_size);
+	if (undo == NULL)
 		return FALSE;
+	undo_size = SaveAtariStateMem(undo, undo_size, TRUE);
+#ifdef PAGED_ATTRIB
+	memcpy(undo_readmap, readmap, sizeof(undo_readmap));
+	memcpy(undo_writemap, writemap, sizeof(undo_writemap));
+#endif
+	ok = ReadMachine(buf, size);
+	if (!ok) {
+		ReadMachine(undo, undo_size);
+#ifdef PAGED_ATTRIB
+		memcpy(readmap, undo_readmap, sizeof(undo_readmap));
+		memcpy(writemap, undo_writemap, sizeof(undo_writemap));
+		MAP_CHANGED;
+#endif
 	}
+	free(undo);
+	return ok;
+}
 
-	if (StateVersion != SAVE_VERSION_NUMBER && StateVersion != 3) {
-		fprintf(stderr,"Cannot read this state file because it is an incompatible version.");
-		GZCLOSE(StateFile);
-		StateFile = NULL;
+int WriteAtariStateFile(const char *filename, const char *mode, const UBYTE *buf, int size)
+{
+	gzFile *f = GZOPEN(filename, mode);
+
+	if (f == NULL) {
+		fprintf(stderr,"Could not open %s for state save.", filename);
 		return FALSE;
 	}
-
-	MainStateRead();
-	if (StateVersion != 3) {
-		CARTStateRead();
-		SIOStateRead();
+	if (GZWRITE(f, buf, size) != size) {
+		fprintf(stderr,"State file I/O failed.");
+		GZCLOSE(f);
+		return FALSE;
 	}
-	AnticStateRead();
-	CpuStateRead(SaveVerbose);
-	GTIAStateRead();
-	PIAStateRead();
-	//ALEK POKEYStateRead();
-#ifdef DREAMCAST
-	DCStateRead();
-#endif
+	return GZCLOSE(f) == 0;
+}
 
-	GZCLOSE(StateFile);
-	StateFile = NULL;
+int SaveAtariState(const char *filename, const char *mode, UBYTE SaveVerbose)
+{
+	int size = AtariStateSize(SaveVerbose);
+	UBYTE *buf = (UBYTE *) Util_malloc(size);
+	int ok;
+
+	size = SaveAtariStateMem(buf, size, SaveVerbose);
+	ok = size != 0 && WriteAtariStateFile(filename, mode, buf, size);
+	free(buf);
+	return ok;
+}
 
-	if (nFileError != Z_OK)
+int ReadAtariState(const char *filename, const char *mode)
+{
+	gzFile *f;
+	UBYTE *buf;
+	int size = 0;
+	int alloc = 0x20000;
+	int len;
+	int ok;
+
+	f = GZOPEN(filename, mode);
+	if (f == NULL) {
+		fprintf(stderr,"Could not open %s for state read.", filename);
 		return FALSE;
+	}
+	/* the length isn't known before the end of a compressed file */
+	buf = (UBYTE *) Util_malloc(alloc);
+	while ((len = GZREAD(f, buf + size, alloc - size)) > 0) {
+		size += len;
+		if (size == alloc) {
+			alloc *= 2;
+			buf = (UBYTE *) Util_realloc(buf, alloc);
+		}
+	}
+	GZCLOSE(f);
 
-	return TRUE;
+	ok = ReadAtariStateMem(buf, size);
+	free(buf);
+	return ok;
 }
 
-
 /* hack to compress in memory before writing
  * - for DREAMCAST only
  * - 2 reasons for this:
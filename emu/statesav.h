@@ -6,6 +6,18 @@
 int SaveAtariState(const char *filename, const char *mode, UBYTE SaveVerbose);
 int ReadAtariState(const char *filename, const char *mode);
 
+/* Bytes SaveAtariStateMem() needs for the machine as it is now. */
+int AtariStateSize(UBYTE SaveVerbose);
+/* Saves the machine into buf, the same bytes as an uncompressed state
+   file. Returns the length, 0 if size is too small. */
+int SaveAtariStateMem(UBYTE *buf, int size, UBYTE SaveVerbose);
+/* Restores the machine from a state in memory. Returns FALSE, with the
+   machine left as it was, if it isn't a state or it is cut short. */
+int ReadAtariStateMem(const UBYTE *buf, int size);
+/* Writes a state saved by SaveAtariStateMem() to a state file. Touches
+   nothing but its arguments, so it can run on another thread. */
+int WriteAtariStateFile(const char *filename, const char *mode, const UBYTE *buf, int size);
+
 void SaveUBYTE(const UBYTE *data, int num);
 void SaveUWORD(const UWORD *data, int num);
 void SaveINT(const int *data, int num);
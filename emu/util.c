@@ -29,6 +29,8 @@
 #ifdef HAVE_SYS_STAT_H
 #include <sys/stat.h>
 #endif
+#include <sys/time.h>
+#include <time.h>
 #ifdef WIN32
 #include <windows.h>
 #endif
@@ -351,3 +353,42 @@ int Util_unlink(const char *filename)
 	return (DeleteFile(wfilename) != 0) ? 0 : -1;
 }
 #endif /* defined(WIN32) && defined(UNICODE) */
+
+unsigned long long Util_time_ns(void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+	struct timeval tval;
+
+	gettimeofday(&tval, 0);
+	return ((unsigned long long) tval.tv_sec * 1000000 + tval.tv_usec) * 1000;
+#endif
+}
+
+/* Slicing by 8: the 8 bytes of a step are looked up independently,
+   each in the table of its distance from the end (emu/crctab.c). The
+   bytes are put together one by one, so it works at any alignment and
+   either byte order. */
+unsigned long crc32(unsigned int crc, const unsigned char *buf, unsigned int len)
+{
+	if (buf == 0)
+		return 0L;
+	crc = ~crc;
+	while (len >= 8) {
+		ULONG lo = crc ^ (buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((ULONG) buf[3] << 24));
+		ULONG hi = buf[4] | (buf[5] << 8) | (buf[6] << 16) | ((ULONG) buf[7] << 24);
+		crc = crc_table[7][lo & 0xff] ^ crc_table[6][(lo >> 8) & 0xff]
+			^ crc_table[5][(lo >> 16) & 0xff] ^ crc_table[4][lo >> 24]
+			^ crc_table[3][hi & 0xff] ^ crc_table[2][(hi >> 8) & 0xff]
+			^ crc_table[1][(hi >> 16) & 0xff] ^ crc_table[0][hi >> 24];
+		buf += 8;
+		len -= 8;
+	}
+	while (len-- > 0)
+		crc = crc_table[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+	return ~crc;
+}
@@ -165,4 +165,18 @@ FILE *Util_uniqopen(char *filename, const char *mode);
 #define Util_fclose(fp, tmpbuf)             fclose(fp)
 #endif
 
+/* Time ------------------------------------------------------------------ */
+
+/* A monotonic clock in nanoseconds, for measuring intervals. */
+unsigned long long Util_time_ns(void);
+
+/* Checksums ------------------------------------------------------------- */
+
+/* Updates a running CRC-32 (zlib polynomial) with len bytes of buf.
+   Pass 0 as crc for the first block. */
+unsigned long crc32(unsigned int crc, const unsigned char *buf, unsigned int len);
+/* crc_table[0] is the CRC-32 of each byte value, crc_table[k] the same
+   followed by k zero bytes (emu/crctab.c) */
+extern const ULONG crc_table[8][256];
+
 #endif /* _UTIL_H_ */
@@ -0,0 +1,303 @@
+/*
+ * batch_hl.c - parallel batch runner for the a5200 emulation core
+ *
+ * Boots every .a52/.bin image of a directory, runs it for a fixed number
+ * of frames and prints a hash of the last frame and of all the audio
+ * produced. Images are spread over a pool of worker threads, one emulated
+ * machine per thread (needs a core built with MULTI_INSTANCE).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "a5200core.h"
+#include "profile.h"
+#include "util.h"
+
+#define MAX_THREADS 64
+
+typedef struct {
+	char *filename;
+	int result;					/* AFILE_* value, AFILE_ERROR if not run */
+	unsigned long frame_crc;
+	unsigned long audio_crc;
+	unsigned long long elapsed;	/* microseconds */
+} job_t;
+
+/* Each worker owns a deque of job indexes: it takes its own work from
+   the tail and, once empty, steals from the head of the other deques.
+   Jobs last milliseconds to seconds, so a mutex per deque is plenty. */
+typedef struct {
+	pthread_mutex_t lock;
+	int *slots;
+	int head;
+	int tail;
+} deque_t;
+
+static const char *file_ext[] = { ".a52", ".bin", NULL };
+
+static const char *bios = "5200.rom";
+static unsigned int frames = 3600;
+static unsigned int refresh = 1;
+static const char *profile_dir = NULL;
+
+static job_t *jobs;
+static int njobs;
+static deque_t deques[MAX_THREADS];
+static int nthreads;
+
+static unsigned long long time_now(void)
+{
+	struct timeval tval;
+
+	gettimeofday(&tval, 0);
+	return (unsigned long long) tval.tv_sec * 1000000 + tval.tv_usec;
+}
+
+static int has_cart_ext(const char *name)
+{
+	size_t len = strlen(name);
+	int i;
+
+	for (i = 0; file_ext[i] != NULL; i++) {
+		size_t elen = strlen(file_ext[i]);
+		if (len > elen && strcasecmp(name + len - elen, file_ext[i]) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static int cmp_jobs(const void *a, const void *b)
+{
+	return strcmp(((const job_t *) a)->filename, ((const job_t *) b)->filename);
+}
+
+static int scan_dir(const char *dirname)
+{
+	DIR *dir = opendir(dirname);
+	struct dirent *de;
+	int size = 0;
+
+	if (dir == NULL)
+		return FALSE;
+	while ((de = readdir(dir)) != NULL) {
+		if (!has_cart_ext(de->d_name))
+			continue;
+		if (njobs == size) {
+			size = size ? size * 2 : 256;
+			jobs = (job_t *) realloc(jobs, size * sizeof(job_t));
+		}
+		jobs[njobs].filename = (char *) malloc(strlen(dirname) + strlen(de->d_name) + 2);
+		sprintf(jobs[njobs].filename, "%s/%s", dirname, de->d_name);
+		jobs[njobs].result = AFILE_ERROR;
+		njobs++;
+	}
+	closedir(dir);
+	/* sorted, so the report doesn't depend on the directory order */
+	qsort(jobs, njobs, sizeof(job_t), cmp_jobs);
+	return TRUE;
+}
+
+static void *run_job(void *arg)
+{
+	job_t *job = (job_t *) arg;
+	UBYTE sndbuf[A5200_SAMPLE_RATE / 60];
+	const UBYTE *fb;
+	int width, height, pitch;
+	unsigned long long start = time_now();
+	unsigned int i;
+	int y;
+
+	if (!A5200_Initialise(bios))
+		return NULL;
+	job->result = A5200_LoadCart(job->filename);
+	if (job->result == AFILE_ERROR) {
+		A5200_Exit();
+		return NULL;
+	}
+
+#ifdef MONITOR_PROFILE
+	if (profile_dir != NULL)
+		PROFILE_CPUStart();
+#endif
+	job->audio_crc = 0;
+	for (i = 0; i < frames; i++) {
+		A5200_StepFrames(1, refresh);
+		A5200_GetAudio(sndbuf, sizeof(sndbuf));
+		job->audio_crc = crc32(job->audio_crc, sndbuf, sizeof(sndbuf));
+	}
+
+	job->frame_crc = 0;
+	fb = A5200_GetFrameBuffer(&width, &height, &pitch);
+	for (y = 0; y < height; y++)
+		job->frame_crc = crc32(job->frame_crc, fb + y * pitch, width);
+
+#ifdef MONITOR_PROFILE
+	if (profile_dir != NULL) {
+		const char *name = strrchr(job->filename, '/') + 1;
+		char *report = (char *) malloc(strlen(profile_dir) + strlen(name) + 7);
+		sprintf(report, "%s/%s.prof", profile_dir, name);
+		PROFILE_WriteCPUReport(report);
+		free(report);
+	}
+#endif
+
+	A5200_Exit();
+	job->elapsed = time_now() - start;
+	return NULL;
+}
+
+/* Returns the next job index for worker self, -1 when no work is left. */
+static int next_job(int self)
+{
+	deque_t *dq = &deques[self];
+	int job = -1;
+	int i;
+
+	pthread_mutex_lock(&dq->lock);
+	if (dq->tail > dq->head)
+		job = dq->slots[--dq->tail];
+	pthread_mutex_unlock(&dq->lock);
+
+	for (i = 1; job < 0 && i < nthreads; i++) {
+		dq = &deques[(self + i) % nthreads];
+		pthread_mutex_lock(&dq->lock);
+		if (dq->tail > dq->head)
+			job = dq->slots[dq->head++];
+		pthread_mutex_unlock(&dq->lock);
+	}
+	return job;
+}
+
+static void *worker(void *arg)
+{
+	int self = (int) (long) arg;
+	pthread_t machine;
+	int job;
+
+	/* Like the real hardware, a coldstart doesn't clear RAM, POKEY or
+	   GTIA, so a machine reused for the next image would make its hashes
+	   depend on what ran before. The machine state is thread-local:
+	   running each image on a thread of its own starts it from the
+	   power-on values. */
+	while ((job = next_job(self)) >= 0) {
+		/* without a thread of its own the image stays AFILE_ERROR */
+		if (pthread_create(&machine, NULL, run_job, &jobs[job]) != 0) {
+			fprintf(stderr, "can't start a thread for %s\n", jobs[job].filename);
+			continue;
+		}
+		pthread_join(machine, NULL);
+	}
+	return NULL;
+}
+
+static void usage(const char *prgname)
+{
+	fprintf(stderr,
+		"usage: %s [options] directory\n"
+		"  -b <file>   5200 BIOS image (default 5200.rom)\n"
+		"  -n <num>    frames to emulate per image (default 3600)\n"
+		"  -r <num>    draw the screen once every <num> frames (default 1)\n"
+		"  -j <num>    worker threads (default: one per online cpu)\n"
+		"  -P <dir>    write each image's 6502 profile to <dir>/<image>.prof\n"
+		"              (make PROFILE=1)\n",
+		prgname);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *dirname = NULL;
+	pthread_t threads[MAX_THREADS];
+	int started[MAX_THREADS];
+	unsigned long long start, elapsed;
+	int failed = 0;
+	int i;
+
+	nthreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+			bios = argv[++i];
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+			refresh = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+			nthreads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc)
+			profile_dir = argv[++i];
+		else if (argv[i][0] != '-' && dirname == NULL)
+			dirname = argv[i];
+		else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (dirname == NULL) {
+		usage(argv[0]);
+		return 1;
+	}
+	if (nthreads < 1)
+		nthreads = 1;
+	if (nthreads > MAX_THREADS)
+		nthreads = MAX_THREADS;
+
+	if (!scan_dir(dirname)) {
+		fprintf(stderr, "can't read directory %s\n", dirname);
+		return 1;
+	}
+	if (nthreads > njobs)
+		nthreads = njobs > 0 ? njobs : 1;
+
+	/* deal the jobs round-robin, stealing evens out the rest */
+	for (i = 0; i < nthreads; i++) {
+		pthread_mutex_init(&deques[i].lock, NULL);
+		deques[i].slots = (int *) malloc((njobs / nthreads + 1) * sizeof(int));
+		deques[i].head = deques[i].tail = 0;
+	}
+	for (i = 0; i < njobs; i++) {
+		deque_t *dq = &deques[i % nthreads];
+		dq->slots[dq->tail++] = i;
+	}
+
+	start = time_now();
+	for (i = 0; i < nthreads; i++)
+		started[i] = pthread_create(&threads[i], NULL, worker, (void *) (long) i) == 0;
+	/* a worker that didn't start runs here: the workers keep no machine
+	   of their own, each image still gets a thread */
+	for (i = 0; i < nthreads; i++)
+		if (!started[i])
+			worker((void *) (long) i);
+	for (i = 0; i < nthreads; i++)
+		if (started[i])
+			pthread_join(threads[i], NULL);
+	elapsed = time_now() - start;
+
+	/* frame crc, audio crc, run time, image */
+	for (i = 0; i < njobs; i++) {
+		if (jobs[i].result == AFILE_ERROR) {
+			printf("-------- -------- %8s %s\n", "error", jobs[i].filename);
+			failed++;
+		}
+		else
+			printf("%08lx %08lx %6llums %s\n", jobs[i].frame_crc, jobs[i].audio_crc,
+				jobs[i].elapsed / 1000, jobs[i].filename);
+	}
+	fprintf(stderr, "%d images, %d failed, %d threads, %llu ms\n",
+		njobs, failed, nthreads, elapsed / 1000);
+
+	for (i = 0; i < nthreads; i++) {
+		pthread_mutex_destroy(&deques[i].lock);
+		free(deques[i].slots);
+	}
+	for (i = 0; i < njobs; i++)
+		free(jobs[i].filename);
+	free(jobs);
+	return failed ? 2 : 0;
+}
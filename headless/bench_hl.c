@@ -0,0 +1,1021 @@
+/*
+ * bench_hl.c - benchmark of the a5200 emulation core
+ *
+ * Runs a fixed set of synthetic workloads, each one a small cartridge
+ * built here together with a minimal BIOS, for a fixed number of frames
+ * and reports frames per second, nanoseconds per emulated machine cycle
+ * and 6502 instructions executed. Everything but the timings is
+ * deterministic, so the instruction counts and the frame and audio crcs
+ * also catch behaviour changes in the core.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "a5200core.h"
+#include "cpu.h"
+#include "rewind.h"
+#include "util.h"
+
+/* 5200 hardware registers */
+#define HPOSP0	0xc000
+#define SIZEP0	0xc008
+#define TRIG0	0xc010
+#define COLPM0	0xc012
+#define COLPF0	0xc016
+#define COLBK	0xc01a
+#define PRIOR	0xc01b
+#define GRACTL	0xc01d
+#define HITCLR	0xc01e
+#define DMACTL	0xd400
+#define DLISTL	0xd402
+#define DLISTH	0xd403
+#define HSCROL	0xd404
+#define PMBASE	0xd407
+#define CHBASE	0xd409
+#define WSYNC	0xd40a
+#define VCOUNT	0xd40b
+#define NMIEN	0xd40e
+#define NMIST	0xd40f
+#define AUDF1	0xe800
+#define AUDC1	0xe801
+#define AUDCTL	0xe808
+#define KBCODE	0xe809
+#define RANDOM	0xe80a
+#define SKCTL	0xe80f
+
+/* the bench BIOS jumps through these from its NMI handler */
+#define VDSLST	0x0200
+#define VVBLKI	0x0202
+
+#define BIOS_BASE	0xf800
+#define BIOS_SIZE	0x800
+#define CART_BASE	0x4000
+#define CART_SIZE	0x8000
+/* Bounty Bob Strikes Back (CART_5200_40): four 4 KB banks for each of
+   4000-4fff and 5000-5fff, then 8 KB at 8000-9fff and again at a000-bfff */
+#define BANKS_CART_SIZE	0xa000
+
+/* 6502 opcodes used by the workloads */
+enum {
+	ADC_ABSX = 0x7d, ADC_IMM = 0x69, AND_IMM = 0x29, BEQ = 0xf0, BNE = 0xd0,
+	BPL = 0x10, BVC = 0x50, BVS = 0x70, CLC = 0x18, CLD = 0xd8, CPX_IMM = 0xe0, DEX = 0xca, EOR_IMM = 0x49,
+	INC_ABS = 0xee, INC_ABSX = 0xfe, INC_ZP = 0xe6, INX = 0xe8,
+	JMP_ABS = 0x4c, JMP_IND = 0x6c, LDA_ABS = 0xad, LDA_ABSX = 0xbd,
+	LDA_IMM = 0xa9, LDA_ZP = 0xa5, LDA_ZPX = 0xb5, LDX_IMM = 0xa2,
+	LDX_ZP = 0xa6, PHA = 0x48, PLA = 0x68, RTI = 0x40, SBC_IMM = 0xe9,
+	SEC = 0x38, SEI = 0x78,
+	STA_ABS = 0x8d, STA_ABSX = 0x9d, STA_ZP = 0x85, STA_ZPX = 0x95,
+	STX_ZP = 0x86, TAX = 0xaa, TXA = 0x8a, TXS = 0x9a
+};
+
+/* A tiny assembler: the workloads are emitted straight into their images. */
+static UBYTE *asm_mem;
+static int asm_base;
+static int asm_pc;
+
+static void org(UBYTE *mem, int base, int addr)
+{
+	asm_mem = mem;
+	asm_base = base;
+	asm_pc = addr;
+}
+
+static int here(void)
+{
+	return asm_pc;
+}
+
+static void byte(int value)
+{
+	asm_mem[asm_pc++ - asm_base] = (UBYTE) value;
+}
+
+static void word(int value)
+{
+	byte(value & 0xff);
+	byte(value >> 8);
+}
+
+static void op(int opcode)
+{
+	byte(opcode);
+}
+
+static void op1(int opcode, int operand)
+{
+	byte(opcode);
+	byte(operand);
+}
+
+static void op2(int opcode, int operand)
+{
+	byte(opcode);
+	word(operand);
+}
+
+static void branch(int opcode, int target)
+{
+	byte(opcode);
+	byte(target - (asm_pc + 1));
+}
+
+/* Branch to a label not emitted yet: returns the operand to pass
+   to land() at the target. */
+static int branch_forward(int opcode)
+{
+	byte(opcode);
+	byte(0);
+	return asm_pc - 1;
+}
+
+static void land(int operand)
+{
+	asm_mem[operand - asm_base] = (UBYTE) (asm_pc - (operand + 1));
+}
+
+static void poke(int addr, int value)
+{
+	op1(LDA_IMM, value);
+	op2(STA_ABS, addr);
+}
+
+/* Minimal BIOS: clears the stack and the NMI vectors, then starts the
+   cartridge through $bffe. NMIs are dispatched through VVBLKI/VDSLST. */
+static void make_bios(UBYTE *bios)
+{
+	int reset, nmi, vbi, rti;
+
+	memset(bios, 0, BIOS_SIZE);
+	org(bios, BIOS_BASE, BIOS_BASE);
+
+	rti = here();
+	op(RTI);
+
+	reset = here();
+	op(SEI);
+	op(CLD);
+	op1(LDX_IMM, 0xff);
+	op(TXS);
+	poke(NMIEN, 0);
+	poke(DMACTL, 0);
+	op1(LDA_IMM, rti & 0xff);
+	op2(STA_ABS, VDSLST);
+	op2(STA_ABS, VVBLKI);
+	op1(LDA_IMM, rti >> 8);
+	op2(STA_ABS, VDSLST + 1);
+	op2(STA_ABS, VVBLKI + 1);
+	op2(JMP_IND, 0xbffe);
+
+	nmi = here();
+	op(PHA);
+	op2(LDA_ABS, NMIST);
+	op2(STA_ABS, NMIST);		/* NMIRES */
+	op1(AND_IMM, 0x40);
+	vbi = branch_forward(BNE);
+	op(PLA);
+	op2(JMP_IND, VDSLST);
+	land(vbi);
+	op(PLA);
+	op2(JMP_IND, VVBLKI);
+
+	org(bios, BIOS_BASE, 0xfffa);
+	word(nmi);
+	word(reset);
+	word(rti);
+}
+
+/* Fills len bytes at addr with reproducible noise. */
+static void noise(int addr, int len, unsigned int seed)
+{
+	while (len-- > 0) {
+		seed = seed * 1103515245 + 12345;
+		asm_mem[addr++ - asm_base] = (UBYTE) (seed >> 16);
+	}
+}
+
+/* Starts a cartridge image: code begins at CART_BASE. */
+static void cart_begin(UBYTE *cart)
+{
+	memset(cart, 0, CART_SIZE);
+	org(cart, CART_BASE, 0xbffe);
+	word(CART_BASE);
+	org(cart, CART_BASE, CART_BASE);
+}
+
+/* Common setup: POKEY out of reset, colours, display list, DMACTL,
+   VBI (and DLI) vectors and NMIEN. */
+static void cart_setup(int dlist, int dmactl, int vbi, int dli)
+{
+	int i;
+
+	poke(SKCTL, 3);
+	for (i = 0; i < 4; i++) {
+		poke(COLPF0 + i, 0x28 + i * 0x30);
+		poke(COLPM0 + i, 0x46 + i * 0x20);
+	}
+	poke(COLBK, 0x90);
+	poke(DLISTL, dlist & 0xff);
+	poke(DLISTH, dlist >> 8);
+	poke(CHBASE, 0x60);
+	poke(DMACTL, dmactl);
+	poke(VVBLKI, vbi & 0xff);
+	poke(VVBLKI + 1, vbi >> 8);
+	if (dli) {
+		poke(VDSLST, dli & 0xff);
+		poke(VDSLST + 1, dli >> 8);
+	}
+	poke(NMIEN, dli ? 0xc0 : 0x40);
+}
+
+/* The main program just waits for interrupts. */
+static void cart_wait(void)
+{
+	op2(JMP_ABS, here());
+}
+
+/* Two lines of mode 7 text, the rest blank: the BIOS title screen. */
+static void title_dlist(int addr)
+{
+	org(asm_mem, asm_base, addr);
+	op(0x70);
+	op(0x70);
+	op(0x70);
+	op2(0x47, 0x7000);
+	op(0x07);
+	op2(0x41, addr);
+}
+
+static void vbi_counter(int addr)
+{
+	org(asm_mem, asm_base, addr);
+	op1(INC_ZP, 0x80);
+	op(RTI);
+}
+
+static void cart_idle(UBYTE *cart)
+{
+	cart_begin(cart);
+	cart_setup(0x5000, 0x22, 0x5100, 0);
+	cart_wait();
+	title_dlist(0x5000);
+	vbi_counter(0x5100);
+	noise(0x6000, 0x400, 1);
+	noise(0x7000, 40, 2);
+}
+
+/* 24 lines of ANTIC mode 4 with LMS and HSCROL on each line, fine
+   scrolled every frame and coarse scrolled every fourth one. */
+static void cart_scroller(UBYTE *cart)
+{
+	int i, loop, done, copy;
+
+	cart_begin(cart);
+	/* the display list must be in RAM to be scrolled */
+	op1(LDX_IMM, 0);
+	copy = here();
+	op2(LDA_ABSX, 0x5000);
+	op2(STA_ABSX, 0x1000);
+	op(INX);
+	branch(BNE, copy);
+	cart_setup(0x1000, 0x22, 0x5100, 0);
+	cart_wait();
+
+	org(cart, CART_BASE, 0x5000);
+	op(0x70);
+	op(0x70);
+	op(0x70);
+	for (i = 0; i < 24; i++)
+		op2(0x54, 0x7000 + i * 0x100);
+	op2(0x41, 0x1000);
+
+	org(cart, CART_BASE, 0x5100);
+	op(PHA);
+	op(TXA);
+	op(PHA);
+	op1(INC_ZP, 0x80);
+	op1(LDA_ZP, 0x80);
+	op1(AND_IMM, 3);
+	op2(STA_ABS, HSCROL);
+	done = branch_forward(BNE);
+	op1(LDX_IMM, 0);
+	loop = here();
+	op2(INC_ABSX, 0x1004);
+	op(INX);
+	op(INX);
+	op(INX);
+	op1(CPX_IMM, 72);
+	branch(BNE, loop);
+	land(done);
+	op(PLA);
+	op(TAX);
+	op(PLA);
+	op(RTI);
+
+	noise(0x6000, 0x400, 3);
+	noise(0x7000, 24 * 0x100, 4);
+}
+
+/* Full screen ANTIC mode F, cycling through GTIA modes 9, 10 and 11. */
+static void cart_gtia(UBYTE *cart)
+{
+	int i, table, skip;
+
+	cart_begin(cart);
+	cart_setup(0x5000, 0x22, 0x5100, 0);
+	cart_wait();
+
+	org(cart, CART_BASE, 0x5000);
+	op(0x70);
+	op(0x70);
+	op(0x70);
+	op2(0x4f, 0x6000);
+	for (i = 1; i < 96; i++)
+		op(0x0f);
+	op2(0x4f, 0x7000);
+	for (i = 1; i < 96; i++)
+		op(0x0f);
+	op2(0x41, 0x5000);
+
+	org(cart, CART_BASE, 0x5200);
+	table = here();
+	byte(0x40);
+	byte(0x80);
+	byte(0xc0);
+
+	org(cart, CART_BASE, 0x5100);
+	op(PHA);
+	op(TXA);
+	op(PHA);
+	op1(LDX_ZP, 0x81);
+	op2(LDA_ABSX, table);
+	op2(STA_ABS, PRIOR);
+	op(INX);
+	op1(CPX_IMM, 3);
+	skip = branch_forward(BNE);
+	op1(LDX_IMM, 0);
+	land(skip);
+	op1(STX_ZP, 0x81);
+	op(PLA);
+	op(TAX);
+	op(PLA);
+	op(RTI);
+
+	noise(0x6000, 96 * 40, 5);
+	noise(0x7000, 96 * 40, 6);
+}
+
+/* Mode 2 text under four players and four missiles moving at different
+   speeds, repositioned by a DLI every eighth scan line. */
+static void cart_pm(UBYTE *cart)
+{
+	int i, loop, fill;
+
+	cart_begin(cart);
+	cart_setup(0x5000, 0x3e, 0x5100, 0x5180);
+	poke(PMBASE, 0x20);
+	poke(GRACTL, 3);
+	poke(PRIOR, 0x01);
+	for (i = 0; i < 4; i++)
+		poke(SIZEP0 + i, i);
+	op1(LDX_IMM, 0);
+	fill = here();
+	op(TXA);
+	op2(STA_ABSX, 0x2300);
+	op1(EOR_IMM, 0xff);
+	op2(STA_ABSX, 0x2400);
+	op1(AND_IMM, 0x3c);
+	op2(STA_ABSX, 0x2500);
+	op1(EOR_IMM, 0x81);
+	op2(STA_ABSX, 0x2600);
+	op2(STA_ABSX, 0x2700);
+	op(INX);
+	branch(BNE, fill);
+	cart_wait();
+
+	org(cart, CART_BASE, 0x5000);
+	op(0x70);
+	op(0x70);
+	op(0x70);
+	op2(0x42 | 0x80, 0x7000);
+	for (i = 1; i < 24; i++)
+		op(0x02 | 0x80);
+	op2(0x41, 0x5000);
+
+	/* VBI: move the eight objects */
+	org(cart, CART_BASE, 0x5100);
+	op(PHA);
+	op(TXA);
+	op(PHA);
+	op1(LDX_IMM, 7);
+	loop = here();
+	op1(LDA_ZPX, 0x90);
+	op(CLC);
+	op2(ADC_ABSX, 0x5200);		/* speeds */
+	op1(STA_ZPX, 0x90);
+	op2(STA_ABSX, HPOSP0);
+	op(DEX);
+	branch(BPL, loop);
+	op2(STA_ABS, HITCLR);
+	op(PLA);
+	op(TAX);
+	op(PLA);
+	op(RTI);
+
+	/* DLI: player 0 follows the beam */
+	org(cart, CART_BASE, 0x5180);
+	op(PHA);
+	op2(LDA_ABS, VCOUNT);
+	op2(STA_ABS, WSYNC);
+	op2(STA_ABS, HPOSP0);
+	op2(STA_ABS, COLPM0);
+	op(PLA);
+	op(RTI);
+
+	org(cart, CART_BASE, 0x5200);
+	for (i = 0; i < 8; i++)
+		byte(i + 1);
+
+	noise(0x6000, 0x400, 7);
+	noise(0x7000, 24 * 40, 8);
+}
+
+/* All four channels sweeping, switching every 64 frames between four
+   8-bit channels and two 16-bit channels clocked at 1.79 MHz. */
+static void cart_pokey(UBYTE *cart)
+{
+	int i, skip;
+
+	cart_begin(cart);
+	cart_setup(0x5000, 0x22, 0x5100, 0);
+	poke(AUDC1, 0xaa);
+	poke(AUDC1 + 2, 0xa6);
+	poke(AUDC1 + 4, 0x28);
+	poke(AUDC1 + 6, 0xc4);
+	cart_wait();
+
+	title_dlist(0x5000);
+
+	org(cart, CART_BASE, 0x5100);
+	op(PHA);
+	op1(INC_ZP, 0x80);
+	op1(LDA_ZP, 0x80);
+	for (i = 0; i < 4; i++) {
+		op2(STA_ABS, AUDF1 + i * 2);
+		op1(EOR_IMM, 0x35 + i * 0x22);
+	}
+	op1(LDA_ZP, 0x80);
+	op1(AND_IMM, 0x40);
+	skip = branch_forward(BEQ);
+	op1(LDA_IMM, 0x78);
+	land(skip);
+	op2(STA_ABS, AUDCTL);
+	op(PLA);
+	op(RTI);
+
+	noise(0x6000, 0x400, 9);
+	noise(0x7000, 40, 10);
+}
+
+/* The banks and the display of the Bounty Bob workloads: a 40 KB image
+   with its code and display list at 8000-bfff, two lines of mode 7 from
+   RAM taking their character set from the 4000-4fff window. */
+static void banks_image(UBYTE *cart)
+{
+	int k;
+
+	memset(cart, 0, BANKS_CART_SIZE);
+	org(cart, 0x2000, 0xbffe);
+	word(0x8000);
+
+	org(cart, 0, 0x9000);
+	op(0x70);
+	op(0x70);
+	op(0x70);
+	op2(0x47, 0x0800);
+	op(0x07);
+	op2(0x41, 0x9000);
+
+	for (k = 0; k < 4; k++) {
+		org(cart, 0x4000 - k * 0x1000, 0x4000);
+		noise(0x4000, 0x1000, 20 + k);
+		org(cart, 0x1000 - k * 0x1000, 0x5000);
+		noise(0x5000, 0x1000, 30 + k);
+	}
+	org(cart, 0, 0x8000);
+}
+
+/* Bank switching as Bounty Bob does it: the main loop selects the bank
+   of the frame in the 4000-4fff window (reading 4ff6-4ff9) before each
+   access to it, the way a game selects a bank ahead of each routine in
+   it, so most selects are of the bank that is in already; the VBI
+   switches the 5000-5fff window. */
+static void cart_banks(UBYTE *cart)
+{
+	int loop;
+
+	banks_image(cart);
+	cart_setup(0x9000, 0x22, 0x9100, 0);
+	poke(CHBASE, 0x48);
+	loop = here();
+	op1(LDA_ZP, 0x80);
+	op1(AND_IMM, 3);
+	op(TAX);
+	op2(LDA_ABSX, 0x4ff6);
+	op2(LDA_ABSX, 0x4000);
+	op2(ADC_ABSX, 0x5000);
+	op2(STA_ABSX, 0x0800);
+	op2(INC_ABS, 0x0804);
+	op2(JMP_ABS, loop);
+
+	org(cart, 0, 0x9100);
+	op(PHA);
+	op(TXA);
+	op(PHA);
+	op1(INC_ZP, 0x80);
+	op1(LDA_ZP, 0x80);
+	op1(AND_IMM, 3);
+	op(TAX);
+	op2(LDA_ABSX, 0x5ff6);
+	op(PLA);
+	op(TAX);
+	op(PLA);
+	op(RTI);
+}
+
+/* The same image with every select a different bank: the main loop
+   steps both windows to the next of their four banks on each pass and
+   reads from each, so each select copies a bank in. */
+static void cart_banks_switch(UBYTE *cart)
+{
+	int loop;
+
+	banks_image(cart);
+	cart_setup(0x9000, 0x22, 0x9100, 0);
+	poke(CHBASE, 0x48);
+	loop = here();
+	op1(INC_ZP, 0x81);
+	op1(LDA_ZP, 0x81);
+	op1(AND_IMM, 3);
+	op(TAX);
+	op2(LDA_ABSX, 0x4ff6);
+	op2(LDA_ABSX, 0x5ff6);
+	op2(LDA_ABSX, 0x4000);
+	op2(ADC_ABSX, 0x5000);
+	op2(STA_ABSX, 0x0800);
+	op2(JMP_ABS, loop);
+
+	vbi_counter(0x9100);
+}
+
+/* A main loop polling the chips the way games wait for a line or a
+   button: VCOUNT into the background colour, TRIG0, RANDOM, KBCODE and
+   a GTIA write, so most of its time is the dispatch of hardware
+   registers. */
+static void cart_hw(UBYTE *cart)
+{
+	int loop;
+
+	cart_begin(cart);
+	cart_setup(0x5000, 0x22, 0x5100, 0);
+	loop = here();
+	op2(LDA_ABS, VCOUNT);
+	op2(STA_ABS, COLBK);
+	op2(LDA_ABS, TRIG0);
+	op2(LDA_ABS, RANDOM);
+	op1(STA_ZP, 0x81);
+	op2(LDA_ABS, KBCODE);
+	op2(STA_ABS, HITCLR);
+	op2(JMP_ABS, loop);
+
+	title_dlist(0x5000);
+	vbi_counter(0x5100);
+	noise(0x6000, 0x400, 40);
+	noise(0x7000, 40, 41);
+}
+
+/* ADC and SBC over all values of A, counting in RAM, shown as text,
+   which of them overflow: V decides the branches, so a V flag gone
+   wrong changes the instruction count and the frame. */
+static void cart_overflow(UBYTE *cart)
+{
+	int loop, inner, skip;
+
+	cart_begin(cart);
+	cart_setup(0x5000, 0x22, 0x5100, 0);
+	loop = here();
+	op1(LDX_IMM, 0);
+	inner = here();
+	op(TXA);
+	op(CLC);
+	op1(ADC_IMM, 0x41);
+	skip = branch_forward(BVC);
+	op2(INC_ABSX, 0x0800);
+	land(skip);
+	op(TXA);
+	op(SEC);
+	op1(SBC_IMM, 0x41);
+	skip = branch_forward(BVS);
+	op2(INC_ABSX, 0x0900);
+	land(skip);
+	op(INX);
+	branch(BNE, inner);
+	op2(JMP_ABS, loop);
+
+	/* eight lines of mode 2 from RAM */
+	org(cart, CART_BASE, 0x5000);
+	op(0x70);
+	op(0x70);
+	op(0x70);
+	op2(0x42, 0x0800);
+	for (skip = 0; skip < 7; skip++)
+		op(0x02);
+	op2(0x41, 0x5000);
+	vbi_counter(0x5100);
+	noise(0x6000, 0x400, 50);
+}
+
+typedef struct {
+	const char *name;
+	void (*make)(UBYTE *cart);
+	int cart_size;
+} workload_t;
+
+static const workload_t workloads[] = {
+	{ "idle", cart_idle, CART_SIZE },
+	{ "antic4-scroll", cart_scroller, CART_SIZE },
+	{ "gtia-9-10-11", cart_gtia, CART_SIZE },
+	{ "pm-dli", cart_pm, CART_SIZE },
+	{ "pokey-4ch-16bit", cart_pokey, CART_SIZE },
+	{ "bank-switch", cart_banks, BANKS_CART_SIZE },
+	{ "bank-switch-all", cart_banks_switch, BANKS_CART_SIZE },
+	{ "hw-poll", cart_hw, CART_SIZE },
+	{ "adc-sbc-overflow", cart_overflow, CART_SIZE },
+};
+
+/* The results of a run of a workload */
+typedef struct {
+	const workload_t *workload;
+	int engine;
+	unsigned long long elapsed;	/* microseconds */
+	ULONG instructions;
+	ULONG cycles_per_frame;
+	unsigned long frame_crc;
+	unsigned long audio_crc;
+	/* -s */
+	int state_size;
+	unsigned long long save_ns, load_ns;	/* per snapshot */
+	int replay_same;
+	/* -w */
+	int rewind_count, rewind_bytes;
+	int rewind_same;
+} run_t;
+
+#define NUM_WORKLOADS (sizeof(workloads) / sizeof(workloads[0]))
+
+static UBYTE bios[BIOS_SIZE];
+static unsigned int frames = 3600;
+static int engine = A5200_CPU_INTERPRETER;
+static int video = A5200_VIDEO_INDEXED;
+static int frame_audio = FALSE;
+static int audio_quality = 0;
+static int snapshots = FALSE;
+static int rewind_interval = 0;
+static int compare = FALSE;
+
+/* -w: history for rewinding, and how far back the check steps */
+#define REWIND_SIZE (8 << 20)
+#define REWIND_STEPS 20
+
+/* -s: snapshots saved or loaded in a row for the timing */
+#define STATE_REPEAT 100
+
+/* -c: how much slower than the interpreter the JIT or the blocks may be measured, in
+   percent: two runs of the same engine differ that much on a busy host */
+#define COMPARE_MARGIN 10
+
+static unsigned long long time_now(void)
+{
+	struct timeval tval;
+
+	gettimeofday(&tval, 0);
+	return (unsigned long long) tval.tv_sec * 1000000 + tval.tv_usec;
+}
+
+/* crc of the last frame, from the frame buffer or the host pixels */
+static unsigned long frame_crc(const ULONG *host)
+{
+	unsigned long crc = 0;
+	const UBYTE *fb;
+	int width, height, pitch;
+	int x, y;
+	UBYTE line[A5200_SCREEN_WIDTH];
+
+	fb = A5200_GetFrameBuffer(&width, &height, &pitch);
+	for (y = 0; y < height; y++) {
+		if (video == A5200_VIDEO_RGB565) {
+			for (x = 0; x < width; x++)
+				line[x] = (UBYTE) ((const UWORD *) host)[y * width + x];
+			crc = crc32(crc, line, width);
+		}
+		else if (video == A5200_VIDEO_XRGB8888) {
+			for (x = 0; x < width; x++)
+				line[x] = (UBYTE) host[y * width + x];
+			crc = crc32(crc, line, width);
+		}
+		else
+			crc = crc32(crc, fb + y * pitch, width);
+	}
+	return crc;
+}
+
+/* -s, at the end of the run: loads the snapshot of the middle and runs
+   the second half again, which has to end in the same frame. */
+static void replay(run_t *run, const UBYTE *state, const ULONG *host)
+{
+	UBYTE sndbuf[A5200_SAMPLE_RATE / 60];
+	unsigned long long start;
+	unsigned int i;
+
+	start = time_now();
+	for (i = 0; i < STATE_REPEAT; i++)
+		A5200_LoadState(state, run->state_size);
+	run->load_ns = (time_now() - start) * 1000 / STATE_REPEAT;
+	for (i = frames / 2; i < frames; i++) {
+		A5200_StepFrames(1, 1);
+		if (frame_audio)
+			A5200_GetFrameAudio(sndbuf, sizeof(sndbuf));
+		else
+			A5200_GetAudio(sndbuf, sizeof(sndbuf));
+	}
+	run->replay_same = frame_crc(host) == run->frame_crc;
+}
+
+/* -w, at the end of the run: steps back through the history and runs
+   the frames again from there, which has to end in the same frame. */
+static void rewind_replay(run_t *run, const ULONG *host)
+{
+	UBYTE sndbuf[A5200_SAMPLE_RATE / 60];
+	unsigned int frame;
+	int steps = 0;
+
+	run->rewind_count = Rewind_Count(&run->rewind_bytes);
+	/* the latest snapshot is of the last frame that is a multiple of the interval */
+	frame = frames / rewind_interval * rewind_interval;
+	while (steps < REWIND_STEPS && A5200_Rewind()) {
+		if (steps > 0)
+			frame -= rewind_interval;
+		steps++;
+	}
+	A5200_SetRewind(0, 0);
+	for (; frame < frames; frame++) {
+		A5200_StepFrames(1, 1);
+		if (frame_audio)
+			A5200_GetFrameAudio(sndbuf, sizeof(sndbuf));
+		else
+			A5200_GetAudio(sndbuf, sizeof(sndbuf));
+	}
+	run->rewind_same = steps > 0 && frame_crc(host) == run->frame_crc;
+}
+
+/* Runs on a thread of its own, so it starts from the power-on state. */
+static void *run_workload(void *arg)
+{
+	run_t *run = (run_t *) arg;
+	UBYTE cart[BANKS_CART_SIZE];
+	UBYTE sndbuf[A5200_SAMPLE_RATE / 60];
+	UBYTE *state = NULL;
+	unsigned long long start, snapshot_time = 0;
+	unsigned int i, j;
+	/* -o: host pixels through a palette mapping each colour to itself,
+	   so the frame crc is the same as from the colour codes */
+	static EMU_TLS ULONG host[A5200_SCREEN_WIDTH * A5200_SCREEN_HEIGHT];
+	ULONG palette[512];
+
+	for (i = 0; i < 512; i++)
+		palette[i] = i & 0xff;
+
+	run->workload->make(cart);
+	A5200_InitialiseImage(bios);
+	A5200_SetCPUEngine(run->engine);
+	A5200_SetAudioQuality(audio_quality);
+	A5200_SetVideoOutput(video, host, video == A5200_VIDEO_RGB565
+		? A5200_SCREEN_WIDTH * 2 : A5200_SCREEN_WIDTH * 4, palette, 0);
+	A5200_LoadCartImage(cart, run->workload->cart_size);
+	if (rewind_interval > 0)
+		A5200_SetRewind(rewind_interval, REWIND_SIZE);
+
+	start = time_now();
+	run->audio_crc = 0;
+	for (i = 0; i < frames; i++) {
+		if (snapshots && i == frames / 2) {
+			unsigned long long t = time_now();
+			run->state_size = A5200_StateSize();
+			state = (UBYTE *) malloc(run->state_size);
+			for (j = 0; j < STATE_REPEAT; j++)
+				A5200_SaveState(state, run->state_size);
+			snapshot_time = time_now() - t;
+			run->save_ns = snapshot_time * 1000 / STATE_REPEAT;
+		}
+		A5200_StepFrames(1, 1);
+		if (frame_audio)
+			A5200_GetFrameAudio(sndbuf, sizeof(sndbuf));
+		else
+			A5200_GetAudio(sndbuf, sizeof(sndbuf));
+		run->audio_crc = crc32(run->audio_crc, sndbuf, sizeof(sndbuf));
+	}
+	run->elapsed = time_now() - start - snapshot_time;
+	run->instructions = cpu_instructions;
+	run->cycles_per_frame = LINE_C * max_ypos;
+
+	run->frame_crc = frame_crc(host);
+
+	/* rewinding first: it stops the history, which the frames run
+	   again for -s would otherwise add to */
+	if (rewind_interval > 0)
+		rewind_replay(run, host);
+	if (snapshots)
+		replay(run, state, host);
+	free(state);
+	A5200_Exit();
+	return NULL;
+}
+
+static void usage(const char *prgname)
+{
+	unsigned int i;
+
+	fprintf(stderr,
+		"usage: %s [options] [workload...]\n"
+		"  -n <num>    frames to emulate per workload (default 3600)\n"
+		"  -r <num>    runs per workload, the fastest is reported (default 3)\n"
+		"  -j          run the 6502 code through the x86-64 JIT (make JIT=1)\n"
+		"  -B          run the 6502 code as pre-decoded blocks (make BLOCKS=1)\n"
+		"  -c          run each workload with the interpreter and the JIT (or with\n"
+		"              -B the blocks) in turns and check the engine gets the same\n"
+		"              results and isn't slower, give or take the timing noise\n"
+		"  -o <fmt>    draw straight into a host buffer: rgb565 or xrgb8888\n"
+		"  -a          synthesize the audio a frame at a time with timed POKEY\n"
+		"              writes (A5200_GetFrameAudio())\n"
+		"  -q <num>    audio quality, 0 to 3 (A5200_SetAudioQuality(), default 0)\n"
+		"  -s          snapshot the machine half way (A5200_SaveState()), load it\n"
+		"              back at the end and check that the second half runs the same\n"
+		"  -w <num>    keep a snapshot every num frames for rewinding, step back\n"
+		"              through them at the end and check the frames run the same\n"
+		"exits with 2 if a check of -s, -w or -c fails, 1 if a workload couldn't run\n"
+		"workloads:",
+		prgname);
+	for (i = 0; i < NUM_WORKLOADS; i++)
+		fprintf(stderr, " %s", workloads[i].name);
+	fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int runs = 3;
+	int selected[NUM_WORKLOADS];
+	int any_selected = FALSE;
+	int other;
+	int status = 0;
+	unsigned int i, r;
+	int a;
+
+	memset(selected, 0, sizeof(selected));
+	for (a = 1; a < argc; a++) {
+		if (strcmp(argv[a], "-n") == 0 && a + 1 < argc)
+			frames = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-r") == 0 && a + 1 < argc)
+			runs = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-j") == 0)
+			engine = A5200_CPU_JIT;
+		else if (strcmp(argv[a], "-B") == 0)
+			engine = A5200_CPU_BLOCKS;
+		else if (strcmp(argv[a], "-c") == 0)
+			compare = TRUE;
+		else if (strcmp(argv[a], "-a") == 0)
+			frame_audio = TRUE;
+		else if (strcmp(argv[a], "-q") == 0 && a + 1 < argc)
+			audio_quality = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-s") == 0)
+			snapshots = TRUE;
+		else if (strcmp(argv[a], "-w") == 0 && a + 1 < argc)
+			rewind_interval = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-o") == 0 && a + 1 < argc && strcmp(argv[a + 1], "rgb565") == 0) {
+			video = A5200_VIDEO_RGB565;
+			a++;
+		}
+		else if (strcmp(argv[a], "-o") == 0 && a + 1 < argc && strcmp(argv[a + 1], "xrgb8888") == 0) {
+			video = A5200_VIDEO_XRGB8888;
+			a++;
+		}
+		else if (argv[a][0] != '-') {
+			for (i = 0; i < NUM_WORKLOADS; i++)
+				if (strcmp(argv[a], workloads[i].name) == 0)
+					break;
+			if (i == NUM_WORKLOADS) {
+				usage(argv[0]);
+				return 1;
+			}
+			selected[i] = any_selected = TRUE;
+		}
+		else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (frames == 0 || runs == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	/* -c: the engine to compare the interpreter with */
+	other = engine == A5200_CPU_INTERPRETER ? A5200_CPU_JIT : engine;
+	if (compare)
+		engine = A5200_CPU_INTERPRETER;
+	if (!A5200_SetCPUEngine(compare ? other : engine)) {
+		fprintf(stderr, "can't start the %s (make %s)\n",
+			other == A5200_CPU_JIT ? "JIT" : "blocks",
+			other == A5200_CPU_JIT ? "JIT=1, x86-64 only" : "BLOCKS=1");
+		return 1;
+	}
+	A5200_SetCPUEngine(A5200_CPU_INTERPRETER);
+
+	make_bios(bios);
+
+	printf("%-16s %7s %7s %9s %13s %9s %9s\n",
+		"workload", "frames", "fps", "ns/cycle", "instructions", "frame", "audio");
+	for (i = 0; i < NUM_WORKLOADS; i++) {
+		/* the engine asked for, and for -c the one to compare with */
+		run_t run[2];
+		unsigned long long best[2] = { 0, 0 };
+		unsigned long long ns_per_kcycle;
+		int nruns = compare ? 2 : 1;
+		int e;
+
+		if (any_selected && !selected[i])
+			continue;
+		memset(run, 0, sizeof(run));
+		run[0].workload = run[1].workload = &workloads[i];
+		run[0].engine = engine;
+		run[1].engine = other;
+		/* -c: the two take turns, so both see the same load of the host */
+		for (r = 0; r < runs; r++) {
+			for (e = 0; e < nruns; e++) {
+				pthread_t machine;
+				if (pthread_create(&machine, NULL, run_workload, &run[e]) != 0)
+					break;
+				pthread_join(machine, NULL);
+				if (r == 0 || run[e].elapsed < best[e])
+					best[e] = run[e].elapsed;
+			}
+			if (e < nruns)
+				break;
+		}
+		/* without a thread of its own the workload isn't run */
+		if (r < runs) {
+			fprintf(stderr, "can't start a thread for %s\n", workloads[i].name);
+			if (status == 0)
+				status = 1;
+			continue;
+		}
+		for (e = 0; e < nruns; e++)
+			if (best[e] == 0)
+				best[e] = 1;
+		ns_per_kcycle = best[0] * 1000000 / ((unsigned long long) frames * run[0].cycles_per_frame);
+		printf("%-16s %7u %7llu %5llu.%03llu %13lu %08lx  %08lx\n",
+			workloads[i].name, frames, frames * 1000000ULL / best[0],
+			ns_per_kcycle / 1000, ns_per_kcycle % 1000,
+			(unsigned long) run[0].instructions, run[0].frame_crc, run[0].audio_crc);
+		if (snapshots) {
+			printf("%-16s snapshot %d bytes, save %llu.%03llu us, load %llu.%03llu us, replay %s\n",
+				"", run[0].state_size, run[0].save_ns / 1000, run[0].save_ns % 1000,
+				run[0].load_ns / 1000, run[0].load_ns % 1000,
+				run[0].replay_same && (!compare || run[1].replay_same) ? "same" : "DIFFERS");
+			if (!run[0].replay_same || (compare && !run[1].replay_same))
+				status = 2;
+		}
+		if (rewind_interval > 0) {
+			printf("%-16s rewind %d snapshots in %d bytes, replay %s\n", "",
+				run[0].rewind_count, run[0].rewind_bytes,
+				run[0].rewind_same && (!compare || run[1].rewind_same) ? "same" : "DIFFERS");
+			if (!run[0].rewind_same || (compare && !run[1].rewind_same))
+				status = 2;
+		}
+		if (compare) {
+			int same = run[1].instructions == run[0].instructions
+				&& run[1].frame_crc == run[0].frame_crc
+				&& run[1].audio_crc == run[0].audio_crc;
+			int slower = best[1] * 100 > best[0] * (100 + COMPARE_MARGIN);
+			printf("%-16s %s %llu fps, %llu.%02llux, %s\n", "",
+				other == A5200_CPU_JIT ? "jit" : "blocks", frames * 1000000ULL / best[1], best[0] / best[1],
+				best[0] * 100 / best[1] % 100,
+				!same ? "DIFFERS" : slower ? "SLOWER" : "ok");
+			if (!same || slower)
+				status = 2;
+		}
+	}
+	return status;
+}
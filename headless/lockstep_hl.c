@@ -0,0 +1,333 @@
+/*
+ * lockstep_hl.c - differential testing of two builds of the a5200 core
+ *
+ * Loads two shared builds of the core (make LOCKSTEP=1 liba5200core.so,
+ * e.g. a plain one as the reference and one with JIT=1, BLOCKS=1 or other
+ * CPU_OPTS as the candidate), runs the same cartridge on both a frame at
+ * a time and compares what they did: the registers, beam position and
+ * RAM at the end of each scanline, every write to the hardware and, with
+ * -i, the registers before every instruction. Reports the earliest point
+ * where the builds disagree, with the last state they agreed on.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+
+#include "a5200core.h"
+#include "util.h"
+
+#define RAM_SIZE 0x4000
+
+/* what a core does in a frame, one event per hook call */
+#define EV_LINE  0				/* end of a scanline, with a RAM copy */
+#define EV_INSN  1				/* before an instruction */
+#define EV_WRITE 2				/* write to a hardware register or the cartridge */
+
+typedef struct {
+	int type;
+	A5200_CPUState cpu;
+	UWORD addr;					/* EV_WRITE */
+	UBYTE byte;
+} event_t;
+
+typedef struct {
+	const char *path;
+	void *lib;
+	int (*Initialise)(const char *bios_filename);
+	int (*LoadCart)(const char *filename);
+	void (*StepFrames)(unsigned int frames, unsigned int refresh_rate);
+	const UBYTE *(*GetFrameBuffer)(int *width, int *height, int *pitch);
+	int (*SetCPUEngine)(int engine);
+	void (*GetCPUState)(A5200_CPUState *state);
+	const UBYTE *(*GetMemory)(void);
+	int (*SetTraceHooks)(void (*line)(void), void (*write)(UWORD addr, UBYTE byte),
+		void (*insn)(void));
+	void (*Exit)(void);
+
+	event_t *events;
+	int nevents;
+	int size;
+	UBYTE *ram;					/* RAM copies of the EV_LINE events, in order */
+	int nram;
+	int ramsize;
+} core_t;
+
+static const char *event_name[] = { "line", "insn", "write" };
+
+/* core the hooks record into */
+static core_t *current;
+
+static event_t *add_event(int type)
+{
+	core_t *c = current;
+	event_t *ev;
+
+	if (c->nevents == c->size) {
+		c->size = c->size ? c->size * 2 : 1024;
+		c->events = (event_t *) realloc(c->events, c->size * sizeof(event_t));
+	}
+	ev = &c->events[c->nevents++];
+	memset(ev, 0, sizeof(event_t));
+	ev->type = type;
+	c->GetCPUState(&ev->cpu);
+	return ev;
+}
+
+static void line_hook(void)
+{
+	core_t *c = current;
+
+	add_event(EV_LINE);
+	if (c->nram == c->ramsize) {
+		c->ramsize = c->ramsize ? c->ramsize * 2 : 320;
+		c->ram = (UBYTE *) realloc(c->ram, (size_t) c->ramsize * RAM_SIZE);
+	}
+	memcpy(c->ram + (size_t) c->nram++ * RAM_SIZE, c->GetMemory(), RAM_SIZE);
+}
+
+static void insn_hook(void)
+{
+	add_event(EV_INSN);
+}
+
+static void write_hook(UWORD addr, UBYTE byte)
+{
+	event_t *ev = add_event(EV_WRITE);
+
+	ev->addr = addr;
+	ev->byte = byte;
+}
+
+static int load_core(core_t *c, const char *path)
+{
+	/* RTLD_LOCAL and a core linked with -Bsymbolic: each library keeps
+	   its own machine, even with the same symbol names */
+	c->path = path;
+	c->lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if (c->lib == NULL) {
+		fprintf(stderr, "%s\n", dlerror());
+		return FALSE;
+	}
+#define SYM(name) \
+	if ((*(void **) &c->name = dlsym(c->lib, "A5200_" #name)) == NULL) { \
+		fprintf(stderr, "%s: no A5200_" #name "\n", path); \
+		return FALSE; \
+	}
+	SYM(Initialise)
+	SYM(LoadCart)
+	SYM(StepFrames)
+	SYM(GetFrameBuffer)
+	SYM(SetCPUEngine)
+	SYM(GetCPUState)
+	SYM(GetMemory)
+	SYM(SetTraceHooks)
+	SYM(Exit)
+#undef SYM
+	return TRUE;
+}
+
+static void print_event(const char *name, const event_t *ev)
+{
+	printf("  %-5s %-5s ypos %3d xpos %3d insns %lu", name, event_name[ev->type],
+		ev->cpu.ypos, ev->cpu.xpos, (unsigned long) ev->cpu.instructions);
+	/* the registers aren't up to date in the middle of an instruction */
+	if (ev->type == EV_WRITE)
+		printf("  %04x <- %02x\n", ev->addr, ev->byte);
+	else
+		printf("  PC=%04x A=%02x X=%02x Y=%02x S=%02x P=%02x\n", ev->cpu.pc,
+			ev->cpu.a, ev->cpu.x, ev->cpu.y, ev->cpu.s, ev->cpu.p);
+}
+
+static int same_event(const event_t *a, const event_t *b)
+{
+	if (a->type != b->type || a->cpu.xpos != b->cpu.xpos || a->cpu.ypos != b->cpu.ypos
+		|| a->cpu.instructions != b->cpu.instructions)
+		return FALSE;
+	if (a->type == EV_WRITE)
+		return a->addr == b->addr && a->byte == b->byte;
+	return a->cpu.pc == b->cpu.pc && a->cpu.a == b->cpu.a && a->cpu.x == b->cpu.x
+		&& a->cpu.y == b->cpu.y && a->cpu.s == b->cpu.s && a->cpu.p == b->cpu.p;
+}
+
+/* Compares the events of a frame, prints the first difference.
+   Returns FALSE if there is one. */
+static int compare_frame(const core_t *ref, const core_t *test, unsigned int frame)
+{
+	int n = ref->nevents < test->nevents ? ref->nevents : test->nevents;
+	int line = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		const event_t *a = &ref->events[i];
+		const event_t *b = &test->events[i];
+		const UBYTE *ram_a, *ram_b;
+		int addr, shown;
+
+		if (!same_event(a, b))
+			break;
+		if (a->type != EV_LINE)
+			continue;
+		ram_a = ref->ram + (size_t) line * RAM_SIZE;
+		ram_b = test->ram + (size_t) line * RAM_SIZE;
+		line++;
+		if (memcmp(ram_a, ram_b, RAM_SIZE) == 0)
+			continue;
+		printf("frame %u, event %d: RAM differs\n", frame, i);
+		print_event("both", a);
+		for (addr = 0, shown = 0; addr < RAM_SIZE && shown < 16; addr++) {
+			if (ram_a[addr] != ram_b[addr]) {
+				printf("  %04x: %02x %02x\n", addr, ram_a[addr], ram_b[addr]);
+				shown++;
+			}
+		}
+		return FALSE;
+	}
+	if (i == ref->nevents && i == test->nevents)
+		return TRUE;
+
+	printf("frame %u, event %d: the cores diverge\n", frame, i);
+	if (i < ref->nevents)
+		print_event("ref", &ref->events[i]);
+	else
+		printf("  ref   frame ends\n");
+	if (i < test->nevents)
+		print_event("test", &test->events[i]);
+	else
+		printf("  test  frame ends\n");
+	/* the last state with the registers, then the events in between */
+	while (--i >= 0 && ref->events[i].type == EV_WRITE)
+		;
+	if (i >= 0) {
+		printf("last agreeing state:\n");
+		for (; i < n && same_event(&ref->events[i], &test->events[i]); i++)
+			print_event("", &ref->events[i]);
+	}
+	return FALSE;
+}
+
+static int compare_screen(const core_t *ref, const core_t *test, unsigned int frame)
+{
+	const UBYTE *fa, *fb;
+	int width, height, pitch_a, pitch_b;
+	int x, y;
+
+	fa = ref->GetFrameBuffer(&width, &height, &pitch_a);
+	fb = test->GetFrameBuffer(&width, &height, &pitch_b);
+	for (y = 0; y < height; y++) {
+		for (x = 0; x < width; x++) {
+			if (fa[y * pitch_a + x] != fb[y * pitch_b + x]) {
+				printf("frame %u: the screens differ from line %d, pixel %d: %02x %02x\n",
+					frame, y, x, fa[y * pitch_a + x], fb[y * pitch_b + x]);
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+/* Runs a frame of c, recording its events. */
+static void step(core_t *c)
+{
+	current = c;
+	c->nevents = 0;
+	c->nram = 0;
+	c->StepFrames(1, 1);
+}
+
+static void usage(const char *prgname)
+{
+	fprintf(stderr,
+		"usage: %s [options] ref.so test.so cartridge\n"
+		"  -b <file>   5200 BIOS image (default 5200.rom)\n"
+		"  -n <num>    frames to compare (default 600)\n"
+		"  -i          compare before every instruction, not only every scanline\n"
+		"              (leaves out the JIT and the blocks)\n"
+		"  -j          run the JIT in test.so (make LOCKSTEP=1 JIT=1)\n"
+		"  -B          run the blocks in test.so (make LOCKSTEP=1 BLOCKS=1)\n"
+		"Both cores are built with make LOCKSTEP=1 liba5200core.so; give paths\n"
+		"with a slash (./ref.so) so dlopen() doesn't search for them.\n",
+		prgname);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *bios = "5200.rom";
+	const char *files[3];
+	unsigned int frames = 600;
+	int per_insn = FALSE;
+	int engine = A5200_CPU_INTERPRETER;
+	int nfiles = 0;
+	core_t cores[2];
+	unsigned int frame;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+			bios = argv[++i];
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-i") == 0)
+			per_insn = TRUE;
+		else if (strcmp(argv[i], "-j") == 0)
+			engine = A5200_CPU_JIT;
+		else if (strcmp(argv[i], "-B") == 0)
+			engine = A5200_CPU_BLOCKS;
+		else if (argv[i][0] != '-' && nfiles < 3)
+			files[nfiles++] = argv[i];
+		else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (nfiles != 3) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	memset(cores, 0, sizeof(cores));
+	for (i = 0; i < 2; i++) {
+		core_t *c = &cores[i];
+		if (!load_core(c, files[i]))
+			return 1;
+		if (!c->SetTraceHooks(line_hook, write_hook, per_insn ? insn_hook : NULL)) {
+			fprintf(stderr, "%s: built without trace hooks (make LOCKSTEP=1)\n", files[i]);
+			return 1;
+		}
+		/* the hooks run from the start, the boot is compared too */
+		current = c;
+		if (!c->Initialise(bios)) {
+			fprintf(stderr, "can't load BIOS %s\n", bios);
+			return 1;
+		}
+		if (i == 1 && !c->SetCPUEngine(engine)) {
+			fprintf(stderr, "%s: %s not available\n", files[i],
+				engine == A5200_CPU_JIT ? "JIT" : "blocks");
+			return 1;
+		}
+		if (c->LoadCart(files[2]) == AFILE_ERROR) {
+			fprintf(stderr, "can't load cartridge %s\n", files[2]);
+			return 1;
+		}
+	}
+
+	for (frame = 0; frame < frames; frame++) {
+		step(&cores[0]);
+		step(&cores[1]);
+		if (!compare_frame(&cores[0], &cores[1], frame)
+			|| !compare_screen(&cores[0], &cores[1], frame))
+			break;
+	}
+	if (frame == frames)
+		printf("%u frames, no divergence\n", frames);
+
+	for (i = 0; i < 2; i++) {
+		current = &cores[i];
+		cores[i].SetTraceHooks(NULL, NULL, NULL);
+		cores[i].Exit();
+		free(cores[i].events);
+		free(cores[i].ram);
+	}
+	return frame == frames ? 0 : 2;
+}
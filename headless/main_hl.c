@@ -0,0 +1,315 @@
+/*
+ * main_hl.c - headless driver for the a5200 emulation core
+ *
+ * Runs a cartridge for a fixed number of frames without any display,
+ * sound device or frame pacing and reports the raw emulation speed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "a5200core.h"
+#include "cartdb.h"
+#include "profile.h"
+#include "util.h"
+
+/* microseconds, same clock as the SDL frontend uses for pacing */
+static unsigned long long time_now(void)
+{
+	struct timeval tval;
+
+	gettimeofday(&tval, 0);
+	return (unsigned long long) tval.tv_sec * 1000000 + tval.tv_usec;
+}
+
+/* -V: the same cartridge on two machines, one per thread (the machine
+   state is thread-local), stepped a frame at a time and compared after
+   each frame. */
+typedef struct {
+	int engine;
+	const char *bios;
+	const char *cart;
+	unsigned int refresh;
+	int ok;
+	A5200_CPUState cpu;
+	UBYTE ram[0x4000];
+	unsigned long frame_crc;
+} lockstep_t;
+
+static pthread_barrier_t lockstep_barrier;
+static int lockstep_done = FALSE;
+
+static void *lockstep_machine(void *arg)
+{
+	lockstep_t *m = (lockstep_t *) arg;
+	const UBYTE *fb;
+	int width, height, pitch;
+	int y;
+
+	m->ok = A5200_Initialise(m->bios) && A5200_SetCPUEngine(m->engine)
+		&& A5200_LoadCart(m->cart) != AFILE_ERROR;
+	pthread_barrier_wait(&lockstep_barrier);
+	for (;;) {
+		pthread_barrier_wait(&lockstep_barrier);
+		if (lockstep_done)
+			break;
+		A5200_StepFrames(1, m->refresh);
+		A5200_GetCPUState(&m->cpu);
+		memcpy(m->ram, A5200_GetMemory(), sizeof(m->ram));
+		m->frame_crc = 0;
+		fb = A5200_GetFrameBuffer(&width, &height, &pitch);
+		for (y = 0; y < height; y++)
+			m->frame_crc = crc32(m->frame_crc, fb + y * pitch, width);
+		pthread_barrier_wait(&lockstep_barrier);
+	}
+	A5200_Exit();
+	return NULL;
+}
+
+/* what -V calls the engine of the second machine */
+static const char *engine_name(int engine)
+{
+	return engine == A5200_CPU_JIT ? "jit" : "blocks";
+}
+
+/* Prints the first difference between the interpreter machine and the
+   other one, returns FALSE if there is one. */
+static int lockstep_compare(const lockstep_t *a, const lockstep_t *b, unsigned int frame)
+{
+	const char *name = engine_name(b->engine);
+	char label[16];
+	int i;
+
+	if (memcmp(&a->cpu, &b->cpu, sizeof(a->cpu)) != 0) {
+		sprintf(label, "%s:", name);
+		printf("frame %u: cpu differs\n"
+			"  interpreter: PC=%04x A=%02x X=%02x Y=%02x S=%02x P=%02x insns=%lu\n"
+			"  %-12s PC=%04x A=%02x X=%02x Y=%02x S=%02x P=%02x insns=%lu\n",
+			frame, a->cpu.pc, a->cpu.a, a->cpu.x, a->cpu.y, a->cpu.s, a->cpu.p,
+			(unsigned long) a->cpu.instructions,
+			label, b->cpu.pc, b->cpu.a, b->cpu.x, b->cpu.y, b->cpu.s, b->cpu.p,
+			(unsigned long) b->cpu.instructions);
+		return FALSE;
+	}
+	for (i = 0; i < (int) sizeof(a->ram); i++) {
+		if (a->ram[i] != b->ram[i]) {
+			printf("frame %u: ram differs at %04x: interpreter %02x, %s %02x\n",
+				frame, i, a->ram[i], name, b->ram[i]);
+			return FALSE;
+		}
+	}
+	if (a->frame_crc != b->frame_crc) {
+		printf("frame %u: frame crc differs: interpreter %08lx, %s %08lx\n",
+			frame, a->frame_crc, name, b->frame_crc);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Returns 0 if the machines agree on all frames, 2 if they don't,
+   1 if they can't be started. */
+static int lockstep(const char *bios, const char *cart, unsigned int frames,
+	unsigned int refresh, int engine)
+{
+	lockstep_t machines[2];
+	pthread_t threads[2];
+	unsigned int frame = 0;
+	int result = 0;
+	int i;
+
+	pthread_barrier_init(&lockstep_barrier, NULL, 3);
+	for (i = 0; i < 2; i++) {
+		memset(&machines[i], 0, sizeof(machines[i]));
+		machines[i].engine = i == 0 ? A5200_CPU_INTERPRETER : engine;
+		machines[i].bios = bios;
+		machines[i].cart = cart;
+		machines[i].refresh = refresh;
+		pthread_create(&threads[i], NULL, lockstep_machine, &machines[i]);
+	}
+	pthread_barrier_wait(&lockstep_barrier);
+	if (!machines[0].ok || !machines[1].ok) {
+		fprintf(stderr, "can't start %s with %s and %s (make JIT=1 or BLOCKS=1)\n",
+			cart, bios, machines[0].ok ? engine_name(engine) : "the interpreter");
+		result = 1;
+	}
+	for (;;) {
+		lockstep_done = result != 0 || frame == frames;
+		pthread_barrier_wait(&lockstep_barrier);
+		if (lockstep_done)
+			break;
+		pthread_barrier_wait(&lockstep_barrier);
+		if (!lockstep_compare(&machines[0], &machines[1], ++frame))
+			result = 2;
+	}
+	for (i = 0; i < 2; i++)
+		pthread_join(threads[i], NULL);
+	pthread_barrier_destroy(&lockstep_barrier);
+
+	if (result == 0)
+		printf("frames: %u\ninterpreter and %s agree, %lu instructions\n",
+			frames, engine_name(engine), (unsigned long) machines[0].cpu.instructions);
+	return result;
+}
+
+static void usage(const char *prgname)
+{
+	fprintf(stderr,
+		"usage: %s [options] cartridge\n"
+		"  -b <file>   5200 BIOS image (default 5200.rom)\n"
+		"  -d <file>   cartridge database to identify the cartridge with\n"
+		"  -n <num>    frames to emulate (default 3600)\n"
+		"  -r <num>    draw the screen once every <num> frames (default 1)\n"
+		"  -a          synthesize audio every frame\n"
+		"  -j          run the 6502 code through the x86-64 JIT (make JIT=1)\n"
+		"  -B          run the 6502 code as pre-decoded blocks (make BLOCKS=1)\n"
+		"  -V          run the interpreter and the JIT (or with -B the blocks) side\n"
+		"              by side and stop at the first frame where their cpu, RAM\n"
+		"              or screen differ\n"
+		"  -o <file>   write the last frame as raw 8-bit colour codes\n"
+		"  -p <file>   write per-frame stage timings as CSV (make PROFILE=1)\n"
+		"  -P <file>   write the 6502 opcode/code/page profile (make PROFILE=1)\n",
+		prgname);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *bios = "5200.rom";
+	const char *cart = NULL;
+	const char *db = NULL;
+	const char *dump = NULL;
+	const char *profile = NULL;
+	const char *cpu_profile = NULL;
+	unsigned int frames = 3600;
+	unsigned int refresh = 1;
+	int audio = FALSE;
+	int engine = A5200_CPU_INTERPRETER;
+	int verify = FALSE;
+	UBYTE sndbuf[A5200_SAMPLE_RATE / 60];
+	const UBYTE *fb;
+	int width, height, pitch;
+	unsigned long crc = 0;
+	unsigned long long start, elapsed;
+	unsigned int i;
+	int y;
+
+	for (i = 1; i < (unsigned int) argc; i++) {
+		if (strcmp(argv[i], "-b") == 0 && i + 1 < (unsigned int) argc)
+			bios = argv[++i];
+		else if (strcmp(argv[i], "-d") == 0 && i + 1 < (unsigned int) argc)
+			db = argv[++i];
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < (unsigned int) argc)
+			frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < (unsigned int) argc)
+			refresh = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-a") == 0)
+			audio = TRUE;
+		else if (strcmp(argv[i], "-j") == 0)
+			engine = A5200_CPU_JIT;
+		else if (strcmp(argv[i], "-B") == 0)
+			engine = A5200_CPU_BLOCKS;
+		else if (strcmp(argv[i], "-V") == 0)
+			verify = TRUE;
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < (unsigned int) argc)
+			dump = argv[++i];
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < (unsigned int) argc)
+			profile = argv[++i];
+		else if (strcmp(argv[i], "-P") == 0 && i + 1 < (unsigned int) argc)
+			cpu_profile = argv[++i];
+		else if (argv[i][0] != '-' && cart == NULL)
+			cart = argv[i];
+		else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (cart == NULL) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (db != NULL && CARTDB_Load(db) < 0) {
+		fprintf(stderr, "can't read cartridge database %s\n", db);
+		return 1;
+	}
+	if (verify)
+		return lockstep(bios, cart, frames, refresh,
+			engine == A5200_CPU_INTERPRETER ? A5200_CPU_JIT : engine);
+
+	if (!A5200_Initialise(bios)) {
+		fprintf(stderr, "can't load atari 5200 bios %s\n", bios);
+		return 1;
+	}
+	if (!A5200_SetCPUEngine(engine)) {
+		fprintf(stderr, "can't start the %s (make %s)\n",
+			engine == A5200_CPU_JIT ? "JIT" : "blocks",
+			engine == A5200_CPU_JIT ? "JIT=1, x86-64 only" : "BLOCKS=1");
+		return 1;
+	}
+	if (A5200_LoadCart(cart) == AFILE_ERROR) {
+		fprintf(stderr, "can't load cartridge %s\n", cart);
+		return 1;
+	}
+
+#ifdef MONITOR_PROFILE
+	if (cpu_profile != NULL)
+		PROFILE_CPUStart();
+#endif
+	start = time_now();
+	if (audio) {
+		for (i = 0; i < frames; i++) {
+			A5200_StepFrames(1, refresh);
+			A5200_GetAudio(sndbuf, sizeof(sndbuf));
+		}
+	}
+	else
+		A5200_StepFrames(frames, refresh);
+	elapsed = time_now() - start;
+
+	fb = A5200_GetFrameBuffer(&width, &height, &pitch);
+	for (y = 0; y < height; y++)
+		crc = crc32(crc, fb + y * pitch, width);
+
+	if (dump != NULL) {
+		FILE *fp = fopen(dump, "wb");
+		if (fp == NULL) {
+			fprintf(stderr, "can't write %s\n", dump);
+			return 1;
+		}
+		for (y = 0; y < height; y++)
+			fwrite(fb + y * pitch, 1, width, fp);
+		fclose(fp);
+	}
+
+	printf("frames: %u\n", frames);
+	printf("time: %llu us\n", elapsed);
+	printf("fps: %llu\n", elapsed > 0 ? frames * 1000000ULL / elapsed : 0);
+	printf("frame crc: %08lx\n", crc);
+
+	if (profile != NULL) {
+#ifdef FRAME_PROFILE
+		PROFILE_PrintReport(stdout);
+		if (!PROFILE_WriteCSV(profile)) {
+			fprintf(stderr, "can't write %s\n", profile);
+			return 1;
+		}
+#else
+		fprintf(stderr, "built without FRAME_PROFILE, use make PROFILE=1\n");
+#endif
+	}
+	if (cpu_profile != NULL) {
+#ifdef MONITOR_PROFILE
+		if (!PROFILE_WriteCPUReport(cpu_profile)) {
+			fprintf(stderr, "can't write %s\n", cpu_profile);
+			return 1;
+		}
+#else
+		fprintf(stderr, "built without MONITOR_PROFILE, use make PROFILE=1\n");
+#endif
+	}
+
+	A5200_Exit();
+	return 0;
+}
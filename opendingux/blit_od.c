@@ -0,0 +1,257 @@
+/*
+ * blit_od.c - conversion of vidBuf to the 16-bit screen
+ *
+ * vidBuf holds one Atari colour byte per pixel, 512 bytes per line with
+ * the visible 320 pixels at offset 32. blit_select() picks, once per mode
+ * change, a line kernel for the screen width and the palettes for the
+ * scanline effect; blit_end_frame() then only runs that kernel per line.
+ *
+ * At 320x240 and 16 bits per pixel there is nothing to scale, so
+ * blit_begin_frame() makes ANTIC convert each line straight into the
+ * screen as it draws it (Screen_SetHostOutput()) and vidBuf isn't used.
+ *
+ * Either way only the lines ANTIC has changed since the frame that is in
+ * the surface already are written (screen_line_gen[]). With double
+ * buffering that is a different frame for each buffer, so the frame each
+ * one shows is kept by its pixels address. Whatever the frontend draws
+ * over the game (the menu, the FPS counter) has to be drawn over again:
+ * blit_invalidate() and blit_overlay() take care of that.
+ *
+ * blit_present() only reads its arguments and the state of this file, so
+ * it can run on a presenter thread (video_od.c) with the frame of a
+ * buffer the emulation has finished.
+ *
+ * The scanline effect (darker odd, brighter even lines) depends on
+ * nothing but the colour and the line parity, so it is folded into two
+ * extra copies of the palette instead of being a second pass over the
+ * screen. The palette lookup itself is a gather, which SSE2, NEON and
+ * MIPS DSP can't do; the kernels instead read the source a word at a
+ * time and write two pixels per 32-bit store.
+ */
+
+#include <string.h>
+
+#include "shared.h"
+#include "screen.h"
+
+#define SCANLINE_INTENSITY 0x18E3
+
+#define VIDBUF_PITCH	512
+#define VIDBUF_LEFT		32
+
+typedef void (*blit_line_t)(unsigned short *dst, const unsigned char *src,
+	const unsigned short *pal, unsigned int width, unsigned int step);
+
+/* plain, even (brighter) and odd (darker) lines */
+static unsigned short blit_pal[3][256];
+
+static blit_line_t blit_line;
+static unsigned int blit_width, blit_height;
+static unsigned int blit_xstep, blit_ystep;	/* 16.16 source pixels per screen pixel */
+static int blit_scanline;
+/* even and odd line palettes for Screen_SetHostOutput() */
+static ULONG blit_host_pal[512];
+
+/* the buffers of the surface */
+#define BLIT_PAGES 3
+typedef struct {
+	void *pixels;
+	ULONG gen;					/* screen_frame_gen of the frame in it, 0 if unknown */
+	int overlay_first;			/* screen lines drawn over since */
+	int overlay_lines;
+} blit_page_t;
+static blit_page_t blit_pages[BLIT_PAGES];
+static int blit_next_page;
+
+#ifdef WORDS_BIGENDIAN
+#define PIXEL_PAIR(left, right) (((ULONG) (left) << 16) | (right))
+#else
+#define PIXEL_PAIR(left, right) (((ULONG) (right) << 16) | (left))
+#endif
+
+/* 320 -> 320: four source pixels, two stores */
+static void blit_line_1x(unsigned short *dst, const unsigned char *src,
+	const unsigned short *pal, unsigned int width, unsigned int step)
+{
+	ULONG *d = (ULONG *) dst;
+
+	for (width >>= 2; width > 0; width--) {
+		d[0] = PIXEL_PAIR(pal[src[0]], pal[src[1]]);
+		d[1] = PIXEL_PAIR(pal[src[2]], pal[src[3]]);
+		d += 2;
+		src += 4;
+	}
+}
+
+/* 320 -> 640: each source pixel is one doubled store */
+static void blit_line_2x(unsigned short *dst, const unsigned char *src,
+	const unsigned short *pal, unsigned int width, unsigned int step)
+{
+	ULONG *d = (ULONG *) dst;
+
+	for (width >>= 1; width > 0; width--) {
+		ULONG p = pal[*src++];
+		*d++ = p | (p << 16);
+	}
+}
+
+/* any other width */
+static void blit_line_scaled(unsigned short *dst, const unsigned char *src,
+	const unsigned short *pal, unsigned int width, unsigned int step)
+{
+	unsigned int x = 0;
+
+	do {
+		*dst++ = pal[src[x >> 16]];
+		x += step;
+	} while (--width);
+}
+
+void blit_palette(const unsigned short *pal)
+{
+	int i;
+
+	for (i = 0; i < 256; i++) {
+		unsigned short c = pal[i];
+		blit_pal[0][i] = c;
+		blit_pal[1][i] = c + ((~c >> 3) & SCANLINE_INTENSITY);
+		blit_pal[2][i] = c - ((c >> 3) & SCANLINE_INTENSITY);
+	}
+	blit_line = NULL;	/* blit_host_pal is set up again */
+}
+
+static blit_page_t *blit_page(void *pixels)
+{
+	blit_page_t *page;
+	int i;
+
+	for (i = 0; i < BLIT_PAGES; i++)
+		if (blit_pages[i].pixels == pixels)
+			return &blit_pages[i];
+	/* a buffer not seen yet: holds nothing we know of */
+	page = &blit_pages[blit_next_page];
+	blit_next_page = (blit_next_page + 1) % BLIT_PAGES;
+	memset(page, 0, sizeof(blit_page_t));
+	page->pixels = pixels;
+	return page;
+}
+
+void blit_invalidate(void)
+{
+	blit_line = NULL;	/* blit_select() forgets the frames in the buffers */
+}
+
+void blit_overlay(SDL_Surface *surface, int first, int lines)
+{
+	blit_page_t *page = blit_page(surface->pixels);
+
+	page->overlay_first = first;
+	page->overlay_lines = lines;
+}
+
+static void blit_select(unsigned int width, unsigned int height, int scanline)
+{
+	int i;
+
+	blit_width = width;
+	blit_height = height;
+	blit_xstep = (SYSVID_WIDTH << 16) / width;
+	blit_ystep = (SYSVID_HEIGHT << 16) / height;
+	blit_scanline = scanline;
+	if (width == SYSVID_WIDTH)
+		blit_line = blit_line_1x;
+	else if (width == SYSVID_WIDTH * 2)
+		blit_line = blit_line_2x;
+	else
+		blit_line = blit_line_scaled;
+	for (i = 0; i < 256; i++) {
+		blit_host_pal[i] = blit_pal[scanline ? 1 : 0][i];
+		blit_host_pal[i + 256] = blit_pal[scanline ? 2 : 0][i];
+	}
+	memset(blit_pages, 0, sizeof(blit_pages));
+}
+
+static int blit_selected(unsigned int width, unsigned int height, int scanline)
+{
+	return blit_line != NULL && width == blit_width && height == blit_height
+		&& scanline == blit_scanline;
+}
+
+int blit_begin_frame(SDL_Surface *surface, int scanline)
+{
+	int direct;
+
+	if (!blit_selected(surface->w, surface->h, scanline))
+		blit_select(surface->w, surface->h, scanline);
+	direct = blit_line == blit_line_1x && blit_height == SYSVID_HEIGHT
+		&& surface->format->BytesPerPixel == 2;
+	if (direct) {
+		blit_page_t *page = blit_page(surface->pixels);
+		/* locked until graphics_paint() has drawn the overlays */
+		if (SDL_MUSTLOCK(surface))
+			SDL_LockSurface(surface);
+		if (page->overlay_lines > 0) {
+			Screen_InvalidateLines(page->overlay_first, page->overlay_first + page->overlay_lines - 1);
+			page->overlay_lines = 0;
+		}
+		Screen_SetHostOutput(SCREEN_HOST_RGB565, surface->pixels, surface->pitch, blit_host_pal,
+			page->gen);
+	}
+	else
+		Screen_SetHostOutput(SCREEN_HOST_NONE, NULL, 0, NULL, 0);
+	return direct;
+}
+
+/* The lines of src changed since the frame in page, and those drawn over. */
+static void blit_frame(unsigned short *dst, unsigned int pitch, const UBYTE *src,
+	const ULONG *line_gen, blit_page_t *page)
+{
+	const unsigned short *prev = NULL;
+	unsigned int prev_y = ~0U;
+	unsigned int y = 0;
+	unsigned int over_first = page->overlay_first;
+	unsigned int over_end = page->overlay_first + page->overlay_lines;
+	unsigned int h;
+
+	for (h = 0; h < blit_height; h++) {
+		unsigned int sy = y >> 16;
+		if (line_gen[sy] <= page->gen && (h < over_first || h >= over_end)) {
+			/* this buffer has it already */
+		}
+		else if (sy == prev_y) {
+			/* vertical scaling: the same source line again */
+			memcpy(dst, prev, blit_width * sizeof(unsigned short));
+		}
+		else {
+			const unsigned short *pal = blit_scanline ? blit_pal[1 + (sy & 1)] : blit_pal[0];
+			blit_line(dst, &src[sy * VIDBUF_PITCH + VIDBUF_LEFT], pal, blit_width, blit_xstep);
+			prev_y = sy;
+		}
+		prev = dst;
+		dst += pitch;
+		y += blit_ystep;
+	}
+}
+
+void blit_present(SDL_Surface *surface, const UBYTE *src, const ULONG *line_gen, ULONG gen,
+	int scanline)
+{
+	blit_page_t *page;
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_LockSurface(surface);
+	if (!blit_selected(surface->w, surface->h, scanline))
+		blit_select(surface->w, surface->h, scanline);
+	page = blit_page(surface->pixels);
+	blit_frame((unsigned short *) surface->pixels, surface->pitch / 2, src, line_gen, page);
+	page->gen = gen;
+	page->overlay_lines = 0;
+}
+
+void blit_end_frame(SDL_Surface *surface, int direct)
+{
+	if (direct)
+		blit_page(surface->pixels)->gen = screen_frame_gen;
+	else
+		blit_present(surface, vidBuf, screen_line_gen, screen_frame_gen, blit_scanline);
+}
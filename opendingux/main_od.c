@@ -1,16 +1,30 @@
 #include  <sys/time.h>
 
 #include "shared.h"
+#include "profile.h"
+#include "pokeysnd.h"
+#include "rewind.h"
+#include "cartdb.h"
+#ifdef CPU_BLOCKS
+#include "cpu_blocks.h"
+#endif
+
+// rewinding (SELECT + L): a snapshot every 10 frames in 4 MB, minutes of history
+#define REWIND_INTERVAL 10
+#define REWIND_SIZE (4 << 20)
+
+// per-title settings from the cartridge database, a5200.db next to the
+// config (see emu/cartdb.h for its format)
+static unsigned int game_refresh;
 
 unsigned int m_Flag;
 unsigned int interval;
 
-unsigned int gameCRC;
 gamecfg GameConf;
 char gameName[512];
 char current_conf_app[MAX__PATH];
 char current_bios_app[MAX__PATH];
-unsigned char vidBuf[512*512];
+char current_db_app[MAX__PATH];
 
 unsigned char *filebuffer;
 
@@ -24,9 +38,24 @@ SDL_Event event;
 SDL_Joystick *stick = NULL;
 #define JOYSTICK_AXIS 8192
 
-SDL_mutex *sndlock;
+// Audio ring: the emulation adds a frame of samples after each frame, the
+// callback only copies them out. Each side writes only its own index, so
+// there is no lock between them.
+#define SND_RING_SIZE 16384	// a power of two
+#define SND_FRAME (44100 / 60)
+static unsigned char snd_ring[SND_RING_SIZE];
+static volatile unsigned int snd_head;	// next sample to play, moved by the callback
+static volatile unsigned int snd_tail;	// next free slot, moved by the emulation
+
+// Rate control: the frames are paced by the timer, the samples played by
+// the audio device, and the two never quite agree. Each frame gets up to
+// SND_MAX_DELTA/4096 (0.5%) more or fewer samples, in proportion to how
+// far the ring is from snd_target, so the fill level settles there - low
+// latency without underruns, at a pitch difference no one can hear.
+#define SND_MAX_DELTA 20
+static unsigned int snd_target;	// a device buffer and two frames
+static unsigned int snd_frac;	// 16.16 samples carried over to the next frame
 
-unsigned int atari_analog = 0;
 unsigned short atari_pal16[256];
 
 unsigned long SDL_UXTimerRead(void) {
@@ -36,51 +65,10 @@ unsigned long SDL_UXTimerRead(void) {
 	return (((tval.tv_sec*1000000) + (tval.tv_usec )));
 }
 
-void graphics_scanline(unsigned short y, unsigned short width, unsigned short *buf) {
-	#define SCANLINE_INTENSITY 0x18E3
-	unsigned int x;
-	unsigned short *pScr=buf;
-	
-    if (y & 1) {
-		for (x=0;x<width;x++)  {
-			*pScr -= (*pScr>>3) & SCANLINE_INTENSITY; 
-			pScr++;
-		}
-	}
-    else {
-		for (x=0;x<width;++x) {
-			*pScr += (~*pScr>>3) & SCANLINE_INTENSITY; 
-			pScr++;
-		}
-	}
-}
-
-void graphics_paint(void) {
-	unsigned short *buffer_scr = (unsigned short *) actualScreen->pixels;
-	unsigned char *buffer_flip = (unsigned char *) &vidBuf;
-	unsigned int W,H,ix,iy,x,y;
+// FPS counter and flip of the locked screen, once the frame is in it
+void graphics_flip(void) {
 	static char buffer[32];
 
-	if(SDL_MUSTLOCK(actualScreen)) SDL_LockSurface(actualScreen);
-	
-	x=0;
-	y=0; 
-	W=320;
-	H=240;
-	ix=(SYSVID_WIDTH<<16)/W;
-	iy=(SYSVID_HEIGHT<<16)/H;
-
-	do   {
-		unsigned char *buffer_mem=&vidBuf[(y>>16)*512]+32;
-		W=320; x=0;
-		do {
-			*buffer_scr++=atari_pal16[buffer_mem[x>>16]];
-			x+=ix;
-		} while (--W);
-		if (GameConf.m_Scanline) graphics_scanline(y>>16,320,buffer_scr-320);
-		y+=iy;
-	} while (--H);
-
 	pastFPS++;
 	newTick = SDL_UXTimerRead();
 	if ((newTick-lastTick)>1000000) {
@@ -92,19 +80,61 @@ void graphics_paint(void) {
 	if (GameConf.m_DisplayFPS) {
 		sprintf(buffer,"%02d",FPS);
 		print_string_video(300,1,buffer);
+		// drawn over the game: these lines are blitted again next time
+		blit_overlay(actualScreen, 1, 8);
 	}
 		
 	if (SDL_MUSTLOCK(actualScreen)) SDL_UnlockSurface(actualScreen);
 	SDL_Flip(actualScreen);
 }
 
+// direct: ANTIC has drawn the frame into the locked screen already
+void graphics_paint(int direct) {
+	// only the lines changed since the frame in this buffer
+	blit_end_frame(actualScreen, direct);
+	graphics_flip();
+}
+
 
 void audio_callback(void *userdata, Uint8 *stream, int len) {
-	SDL_mutexP(sndlock);
+	static unsigned char last = 128;
+	unsigned int head = snd_head;
+	unsigned int n = snd_tail - head;
+	unsigned int i;
+
+	if (n > (unsigned int) len) n = len;
+	__sync_synchronize(); // the samples are read after the index
+	for (i = 0; i < n; i++)
+		stream[i] = snd_ring[(head + i) & (SND_RING_SIZE - 1)];
+	if (n > 0) last = stream[n - 1];
+	// running late: hold the last sample rather than click
+	for (; i < (unsigned int) len; i++)
+		stream[i] = last;
+	__sync_synchronize(); // and before the slots are given back
+	snd_head = head + n;
+}
 
-	Pokey_process(stream,len);
-	
-	SDL_mutexV(sndlock);
+// the sound of the frame just emulated into the ring
+static void audio_frame(void) {
+	unsigned char frame[SND_FRAME + SND_FRAME / 128 + 1];
+	unsigned int tail = snd_tail;
+	unsigned int fill = tail - snd_head;
+	unsigned int room = SND_RING_SIZE - fill;
+	int error = (int) snd_target - (int) (fill < 2 * snd_target ? fill : 2 * snd_target);
+	unsigned int n, i;
+
+	// in 64 bits: the product passes 2^31 once snd_target is over 9000
+	snd_frac += (SND_FRAME << 16) + (int) ((long long) ((SND_FRAME << 16) / 4096 * SND_MAX_DELTA) * error / (int) snd_target);
+	n = snd_frac >> 16;
+	snd_frac &= 0xffff;
+	Pokey_process_frame(frame, n);
+	// far too much queued (after a stall): skip a frame's sound to get back
+	if (fill > 2 * snd_target) n = 0;
+	if (n > room) n = room;
+	for (i = 0; i < n; i++)
+		snd_ring[(tail + i) & (SND_RING_SIZE - 1)] = frame[i];
+	__sync_synchronize(); // the samples are written before the index
+	snd_tail = tail + n;
 }
 
 void initSDL(void) {
@@ -167,14 +197,10 @@ void initSDL(void) {
         fprintf(stderr, "Unable to open audio: %s\n", SDL_GetError());
         exit(1);
     }
+	snd_target = retSpec.samples + 2 * SND_FRAME;
+	// twice the target has to fit in the ring
+	if (snd_target > SND_RING_SIZE / 2 - 1) snd_target = SND_RING_SIZE / 2 - 1;
 
-	sndlock = SDL_CreateMutex();
-	if (sndlock == NULL) {
-		fprintf(stderr, "Unable to create lock: %s\n", SDL_GetError());
-		SDL_CloseAudio();
-        exit(1);
-	}
-	
 	//nit joystick
 	SDL_InitSubSystem(SDL_INIT_JOYSTICK);
 	SDL_JoystickEventState(SDL_ENABLE);
@@ -248,137 +274,6 @@ const unsigned int palette_ntsc[256] = {
   0xffc160, 0xffc671, 0xffcb83, 0xffcb83
 };
 
-/*
-#  
-bd52623b  Defender # A5200.A52
-ce07d9ad  Diagnostic Cart.bin
-6a687f9c  Dig Dug # A5200.A52
-d3bd3221  Final Legacy (Prototype) # A5200.A52
-d3bd3221  FinalLegacy.bin
-04b299a4  Frisky Tom (Prototype) # A5200.A52
-0af19345  Frogger 2 - Threedeep! # A5200.A52
-1062ef6a  Frogger.bin
-0fe438b3  frogger2.bin
-04b299a4  frskytom.bin
-97b15243  Gorf.bin
-cfd4a7f9  Gyruss # A5200.A52
-cfd4a7f9  Gyruss.bin
-18a73af3  H.E.R.O. # A5200.A52
-18a73af3  H.E.R.O. (1984) (Activision).a52
-18a73af3  Hero.a52
-d9ae4518  James Bond 007 # A5200.A52
-d9ae4518  JamesBond007.bin
-bfd30c01  Joust # A5200.A52
-7c30592c  Jr Pac-Man # A5200.A52
-2c676662  Jungle Hunt # A5200.A52
-ecfa624f  Kangaroo # A5200.A52
-02cdfc70  KrazyShootOut.bin
-83517703  Last Starfighter # A5200.A52
-84df4925  Looney Tunes Hotel (Prototype # A5200.A52
-ab8e035b  Meteorites # A5200.A52
-931a454a  MICRGAMN.BIN
-931a454a  Microgammon SB (Prototype) # A5200.A52
-969cfe1a  Millipede # A5200.A52
-7df1adfb  Miner 2049 # A5200.A52
-c597c087  Miniature Golf # A5200.A52
-c597c087  MINIGOLF.BIN
-2a640143  Montezuma's Revenge # A5200.A52
-d0b2f285  Moon Patrol # A5200.A52
-457fb9b3  Mr. Do's Castle.bin
-752f5efd  Ms. Pac-Man # A5200.A52
-59983c40  pacjr52.bin
-8873ef51  Pac-Man # A5200.A52
-e9f826bd  pete.bin
-4b910461  Pitfall 2 - the Lost Caverns # A5200.A52
-4b910461  Pitfall II - The Lost Caverns (1984) (Activision).a52
-abc2d1e4  Pole Position # A5200.A52
-abc2d1e4  PolePosition.bin
-a18a9a40  Popeye # A5200.A52
-3c33f26e  Qbert.bin
-aea6d2c2  QIX # A5200.A52
-b5f3402b  Quest for Quintana Roo # A5200.A52
-4336c2cc  Realsports Football # A5200.A52
-ecbd1853  Realsports Soccer # A5200.A52
-10f33c90  Realsports Tennis # A5200.A52
-0f996184  RealsportsBasketballRev1.bin
-4336c2cc  RealsportsFootball.bin
-10f33c90  RealsportsTennis.bin
-a97606ab  Roadrunner # A5200.A52
-4252abd9  Robotron 2084 # A5200.A52
-b68d61e8  Space Dungeon # A5200.A52
-387365dc  Space Shuttle - a Journey Into Space # A5200.A52
-b68d61e8  SpaceDungeon.bin
-73b5b6fb  Sport Goofy (Prototype) # A5200.A52
-7d819a9f  Star Raiders # A5200.A52
-69f23548  Star Trek - Strategic Operations Simulator # A5200.A52
-75f566df  Star Wars - the Arcade Game # A5200.A52
-1d1cee27  Stargate # A5200.A52
-75f566df  StarWarsArcade.bin
-fd8f0cd4  Super Pac Man Final (5200).bin
-0a4ddb1e  Super Pac-Man (Prototype) # A5200.A52
-1187342f  Tempest (Prototype) # A5200.A52
-1187342f  Tempst52.bin
-0ba22ece  Track and Field # A5200.A52
-d6f7ddfd  Wizard of Wor# A5200.A52
-b8faaec3  Xari Arena (Prototype) # A5200.A52
-b8faaec3  xari52.bin
-12cc298f  yellwsub.bin
-2959d827  Zone Ranger # A5200.A52
-*/
-
-int cartfind16kmapping ( unsigned int crc ) {
-	if ( crc == 0x35484751 ||     /* AE                */
-       crc == 0x9bae58dc ||     /* Beamrider         */
-	     crc == 0xbe3cd348 ||     /* Berzerk           */
-       crc == 0xc8f9c094 ||     /* Blaster           */
-	     crc == 0x0624E6E7 ||     /* BluePrint         */
-       
-       
-	     crc == 0x9ad53bbc ||     /* ChopLifter        */
-	     crc == 0xf43e7cd0 ||     /* Decathlon         */
-	     crc == 0xd3bd3221 ||     /* Final Legacy      */
-	     crc == 0x18a73af3 ||     /* H.E.R.O           */
-	     crc == 0x83517703 ||     /* Last StarFigtr    */
-	     crc == 0xab8e035b ||     /* Meteorites        */
-	     crc == 0x969cfe1a ||     /* Millipede         */
-	     crc == 0x7df1adfb ||     /* Miner 2049er      */
-	     crc == 0xb8b6a2fd ||     /* Missle Command+   */
-	     crc == 0xd0b2f285 ||     /* Moon Patrol       */
-	     crc == 0xe8b130c4 ||     /* PAM Diags2.0      */
-	     crc == 0x4b910461 ||     /* Pitfall II        */
-	     crc == 0x47dc1314 ||     /* Preppie (Conv)    */
-	     crc == 0xF1E21530 ||     /* Preppie (Conv)    */
-	     crc == 0xb5f3402b ||     /* Quest Quintana    */
-	     crc == 0x4252abd9 ||     /* Robotron 2084     */
-	     crc == 0x387365dc ||     /* Space Shuttle     */
-	     crc == 0x82E2981F ||     /* Super Pacman      */
-	     crc == 0xFD8F0CD4 ||     /* Super Pacman      */
-	     crc == 0xa4ddb1e  ||     /* Super Pacman      */
-	     crc == 0xe80dbb2  ||     /* Time Runner (Conv) */
-	     crc == 0x0ba22ece ||     /* Track and Field   */
-	     crc == 0xd6f7ddfd ||     /* Wizard of Wor     */
-	     crc == 0x2959d827 ||     /* Zone Ranger       */
-	     crc == 0xB8FAAEC3 ||     /* Xari arena        */
-	     crc == 0x38F4A6A4    ) { /* Xmas (Demo)       */
-		return 2;
-	}
-	else {
-//         crc == 0x8d2aaab5 || // asteroid.bin
-//         crc == 0x4019ecec || // Astro Chase # A5200.A52
-//         crc == 0xb3b8e314 || // Battlezone
-//	       crc == 0x04807705 || // Buck Rogers - Planet of Zoom # A5200.A52
-//	       crc == 7a9d9f85  boogie.bin
-//	       crc == 536a70fe  Centipede # A5200.A52
-//	       crc == 536a70fe  Centipede.bin
-//	       crc == 82b91800  Congo Bongo # A5200.A52
-//	       crc == 82b91800  CongoBongo.bin
-//	       crc == fd541c80  Countermeasure # A5200.A52
-
-//         crc == 0x1187342f || // Tempest           
-		return 1;
-  }
-} // cart_find_16k_mapping 
-
 int load_os(char *filename ) {
   FILE *romfile = fopen(filename, "rb");
   if (romfile == NULL) return 1;
@@ -389,15 +284,28 @@ int load_os(char *filename ) {
  	return 0;
 } /* end load_os */
 
-int atari_waitoncardtype(unsigned long crcfile) {
-	int bRet=1;
-	unsigned int posdeb=2;
-
-	posdeb = cartfind16kmapping(crcfile) == 1 ? 18 : 2;
+// controller of the title from the database, the user's setting otherwise
+static void atari_controller(void) {
+	const CARTDB_Entry *db = CARTDB_Lookup(gameCRC);
 
-	bRet = (posdeb==2 ? 2 : 1);
+	atari_analog = GameConf.m_Analog;
+	if (db != NULL && db->controller != CARTDB_UNSET)
+		atari_analog = (db->controller == CARTDB_ANALOG);
+}
 
-	return bRet;
+// settings of the title from the database, the defaults for the rest
+static void atari_profile(void) {
+	const CARTDB_Entry *db = CARTDB_Lookup(gameCRC);
+
+	atari_controller();
+	game_refresh = 0;
+	Pokey_set_mzquality(0);
+	if (db == NULL)
+		return;
+	if (db->refresh_rate != CARTDB_UNSET)
+		game_refresh = db->refresh_rate;
+	if (db->audio_quality != CARTDB_UNSET)
+		Pokey_set_mzquality(db->audio_quality);
 }
 
 int atari_init(char *filename) {
@@ -417,20 +325,25 @@ int atari_init(char *filename) {
 			b = (unsigned char)  ((palette_ntsc[index]& 0x000000ff) );
 			atari_pal16[index] = PIX_TO_RGB(actualScreen->format,r,g,b);
 		}
+		blit_palette(atari_pal16);
+		atari_profile();
 		return 1;
 	}
 	
 	return 0;
 }
 
-extern unsigned int trig0;
-extern unsigned int stick0;
+extern EMU_TLS unsigned int trig0;
+extern EMU_TLS unsigned int stick0;
 
 int main(int argc, char *argv[]) {
 	unsigned int index;
 	double period;
 	unsigned int ksel = 0, kx = 0, ky = 0, key_x=0, key_y=0,key_l=0,key_se=0,key_r=0;
 	int shiftctrl;
+#ifndef VIDEO_THREAD
+	int direct;
+#endif
 	
 	// Get init file directory & name
 	gethomedir(current_conf_app, "a5200");
@@ -444,6 +357,10 @@ int main(int argc, char *argv[]) {
 	m_Flag = GF_MAINUI;
 	system_loadcfg(current_conf_app);
 
+	gethomedir(current_db_app, "a5200");
+	sprintf(current_db_app,"%s//a5200.db",current_db_app);
+	CARTDB_Load(current_db_app);
+
 	SDL_WM_SetCaption("a5200-od", NULL);
 
 	gethomedir(current_bios_app, "");
@@ -466,7 +383,14 @@ int main(int argc, char *argv[]) {
 		switch (m_Flag) {
 			case GF_MAINUI:
 				SDL_PauseAudio(1);
+#ifdef VIDEO_THREAD
+				// the menu draws on the screen itself
+				video_stop();
+#endif
 				screen_showtopmenu();
+				// the menu may have changed the user's setting, the title's stays
+				atari_controller();
+				blit_invalidate();
 				if (cartridge_IsLoaded()) {
 					// let's go for sound :)
 					SDL_PauseAudio(0);
@@ -478,6 +402,16 @@ int main(int argc, char *argv[]) {
 				if (atari_init(gameName)) {
 					m_Flag = GF_GAMERUNNING;
 					Atari800_Initialise();
+#ifdef CPU_BLOCKS
+					// no JIT on the handhelds: run the ROM code as blocks
+					BLOCKS_Enable(TRUE);
+#endif
+					// register writes timed to the cycle, for audio_frame()
+					Pokey_set_timed(TRUE);
+					Rewind_Init(REWIND_INTERVAL, REWIND_SIZE);
+#ifdef MONITOR_PROFILE
+					PROFILE_CPUStart();
+#endif
 
 					// Init timing
 					period = 1.0 / 60;
@@ -496,11 +430,23 @@ int main(int argc, char *argv[]) {
 						usleep(wait);
 				}
 				
-				// Execute one frame
-				Atari800_Frame(0);
+#ifdef VIDEO_THREAD
+				// Execute one frame into a back buffer, the presenter thread draws it
+				video_start();
+				video_begin_frame();
+				Atari800_Frame(game_refresh);
+				video_end_frame();
+#else
+				// Execute one frame, straight into the screen when it needs no scaling
+				direct = blit_begin_frame(actualScreen, GameConf.m_Scanline);
+				Atari800_Frame(game_refresh);
 
 				// Draw frame
-				graphics_paint();
+				PROFILE_CALL(PROFILE_BLIT, graphics_paint(direct));
+#endif
+
+				// Sound of the frame, for the callback to play
+				PROFILE_CALL(PROFILE_POKEY, audio_frame());
 
 				// Wait for keys
 				key_consol = CONSOL_NONE; //|= (CONSOL_OPTION | CONSOL_SELECT | CONSOL_START); /* OPTION/START/SELECT key OFF */
@@ -548,6 +494,11 @@ int main(int argc, char *argv[]) {
 				if ((keys[SDLK_ESCAPE] == SDL_PRESSED) && (keys[SDLK_RETURN] == SDL_PRESSED )) { 
 					m_Flag = GF_MAINUI;
 				}
+				else if ((keys[SDLK_ESCAPE] == SDL_PRESSED) && (keys[SDLK_TAB] == SDL_PRESSED)) { // SELECT + L
+					// back a snapshot each frame while held
+					Rewind_Back();
+					key_code = AKEY_NONE;
+				}
 				else if ( (keys[SDLK_ESCAPE] == SDL_PRESSED) )  { // SELECT
 					key_code = AKEY_5200_PAUSE + key_code;
 				} 
@@ -561,8 +512,30 @@ int main(int argc, char *argv[]) {
 		}
 	}
 
+#ifdef VIDEO_THREAD
+	video_stop();
+#endif
 	SDL_PauseAudio(1);
-	SDL_DestroyMutex(sndlock);
+	if (!state_wait())	/* a state still being written */
+		fprintf(stderr, "Couldn't write the save state\n");
+
+#ifdef FRAME_PROFILE
+	{
+		char profile_dir[MAX__PATH], profile_file[MAX__PATH];
+		gethomedir(profile_dir, "a5200");
+		sprintf(profile_file,"%s//a5200-profile.csv",profile_dir);
+		PROFILE_WriteCSV(profile_file);
+		PROFILE_PrintReport(stdout);
+	}
+#endif
+#ifdef MONITOR_PROFILE
+	{
+		char profile_dir[MAX__PATH], profile_file[MAX__PATH];
+		gethomedir(profile_dir, "a5200");
+		sprintf(profile_file,"%s//a5200-cpu.prof",profile_dir);
+		PROFILE_WriteCPUReport(profile_file);
+	}
+#endif
 
 	// Free memory
 	//SDL_FreeSurface(layericons);
@@ -577,77 +550,3 @@ int main(int argc, char *argv[]) {
 	
 	exit(0);
 }
-
-
-#define DO1(buf) crc = crc_table[((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
-#define DO2(buf)  DO1(buf); DO1(buf);
-#define DO4(buf)  DO2(buf); DO2(buf);
-#define DO8(buf)  DO4(buf); DO4(buf);
-// Table of CRC-32's of all single-byte values (made by make_crc_table)
-unsigned int crc_table[256] = {
-  0x00000000L, 0x77073096L, 0xee0e612cL, 0x990951baL, 0x076dc419L,
-  0x706af48fL, 0xe963a535L, 0x9e6495a3L, 0x0edb8832L, 0x79dcb8a4L,
-  0xe0d5e91eL, 0x97d2d988L, 0x09b64c2bL, 0x7eb17cbdL, 0xe7b82d07L,
-  0x90bf1d91L, 0x1db71064L, 0x6ab020f2L, 0xf3b97148L, 0x84be41deL,
-  0x1adad47dL, 0x6ddde4ebL, 0xf4d4b551L, 0x83d385c7L, 0x136c9856L,
-  0x646ba8c0L, 0xfd62f97aL, 0x8a65c9ecL, 0x14015c4fL, 0x63066cd9L,
-  0xfa0f3d63L, 0x8d080df5L, 0x3b6e20c8L, 0x4c69105eL, 0xd56041e4L,
-  0xa2677172L, 0x3c03e4d1L, 0x4b04d447L, 0xd20d85fdL, 0xa50ab56bL,
-  0x35b5a8faL, 0x42b2986cL, 0xdbbbc9d6L, 0xacbcf940L, 0x32d86ce3L,
-  0x45df5c75L, 0xdcd60dcfL, 0xabd13d59L, 0x26d930acL, 0x51de003aL,
-  0xc8d75180L, 0xbfd06116L, 0x21b4f4b5L, 0x56b3c423L, 0xcfba9599L,
-  0xb8bda50fL, 0x2802b89eL, 0x5f058808L, 0xc60cd9b2L, 0xb10be924L,
-  0x2f6f7c87L, 0x58684c11L, 0xc1611dabL, 0xb6662d3dL, 0x76dc4190L,
-  0x01db7106L, 0x98d220bcL, 0xefd5102aL, 0x71b18589L, 0x06b6b51fL,
-  0x9fbfe4a5L, 0xe8b8d433L, 0x7807c9a2L, 0x0f00f934L, 0x9609a88eL,
-  0xe10e9818L, 0x7f6a0dbbL, 0x086d3d2dL, 0x91646c97L, 0xe6635c01L,
-  0x6b6b51f4L, 0x1c6c6162L, 0x856530d8L, 0xf262004eL, 0x6c0695edL,
-  0x1b01a57bL, 0x8208f4c1L, 0xf50fc457L, 0x65b0d9c6L, 0x12b7e950L,
-  0x8bbeb8eaL, 0xfcb9887cL, 0x62dd1ddfL, 0x15da2d49L, 0x8cd37cf3L,
-  0xfbd44c65L, 0x4db26158L, 0x3ab551ceL, 0xa3bc0074L, 0xd4bb30e2L,
-  0x4adfa541L, 0x3dd895d7L, 0xa4d1c46dL, 0xd3d6f4fbL, 0x4369e96aL,
-  0x346ed9fcL, 0xad678846L, 0xda60b8d0L, 0x44042d73L, 0x33031de5L,
-  0xaa0a4c5fL, 0xdd0d7cc9L, 0x5005713cL, 0x270241aaL, 0xbe0b1010L,
-  0xc90c2086L, 0x5768b525L, 0x206f85b3L, 0xb966d409L, 0xce61e49fL,
-  0x5edef90eL, 0x29d9c998L, 0xb0d09822L, 0xc7d7a8b4L, 0x59b33d17L,
-  0x2eb40d81L, 0xb7bd5c3bL, 0xc0ba6cadL, 0xedb88320L, 0x9abfb3b6L,
-  0x03b6e20cL, 0x74b1d29aL, 0xead54739L, 0x9dd277afL, 0x04db2615L,
-  0x73dc1683L, 0xe3630b12L, 0x94643b84L, 0x0d6d6a3eL, 0x7a6a5aa8L,
-  0xe40ecf0bL, 0x9309ff9dL, 0x0a00ae27L, 0x7d079eb1L, 0xf00f9344L,
-  0x8708a3d2L, 0x1e01f268L, 0x6906c2feL, 0xf762575dL, 0x806567cbL,
-  0x196c3671L, 0x6e6b06e7L, 0xfed41b76L, 0x89d32be0L, 0x10da7a5aL,
-  0x67dd4accL, 0xf9b9df6fL, 0x8ebeeff9L, 0x17b7be43L, 0x60b08ed5L,
-  0xd6d6a3e8L, 0xa1d1937eL, 0x38d8c2c4L, 0x4fdff252L, 0xd1bb67f1L,
-  0xa6bc5767L, 0x3fb506ddL, 0x48b2364bL, 0xd80d2bdaL, 0xaf0a1b4cL,
-  0x36034af6L, 0x41047a60L, 0xdf60efc3L, 0xa867df55L, 0x316e8eefL,
-  0x4669be79L, 0xcb61b38cL, 0xbc66831aL, 0x256fd2a0L, 0x5268e236L,
-  0xcc0c7795L, 0xbb0b4703L, 0x220216b9L, 0x5505262fL, 0xc5ba3bbeL,
-  0xb2bd0b28L, 0x2bb45a92L, 0x5cb36a04L, 0xc2d7ffa7L, 0xb5d0cf31L,
-  0x2cd99e8bL, 0x5bdeae1dL, 0x9b64c2b0L, 0xec63f226L, 0x756aa39cL,
-  0x026d930aL, 0x9c0906a9L, 0xeb0e363fL, 0x72076785L, 0x05005713L,
-  0x95bf4a82L, 0xe2b87a14L, 0x7bb12baeL, 0x0cb61b38L, 0x92d28e9bL,
-  0xe5d5be0dL, 0x7cdcefb7L, 0x0bdbdf21L, 0x86d3d2d4L, 0xf1d4e242L,
-  0x68ddb3f8L, 0x1fda836eL, 0x81be16cdL, 0xf6b9265bL, 0x6fb077e1L,
-  0x18b74777L, 0x88085ae6L, 0xff0f6a70L, 0x66063bcaL, 0x11010b5cL,
-  0x8f659effL, 0xf862ae69L, 0x616bffd3L, 0x166ccf45L, 0xa00ae278L,
-  0xd70dd2eeL, 0x4e048354L, 0x3903b3c2L, 0xa7672661L, 0xd06016f7L,
-  0x4969474dL, 0x3e6e77dbL, 0xaed16a4aL, 0xd9d65adcL, 0x40df0b66L,
-  0x37d83bf0L, 0xa9bcae53L, 0xdebb9ec5L, 0x47b2cf7fL, 0x30b5ffe9L,
-  0xbdbdf21cL, 0xcabac28aL, 0x53b39330L, 0x24b4a3a6L, 0xbad03605L,
-  0xcdd70693L, 0x54de5729L, 0x23d967bfL, 0xb3667a2eL, 0xc4614ab8L,
-  0x5d681b02L, 0x2a6f2b94L, 0xb40bbe37L, 0xc30c8ea1L, 0x5a05df1bL,
-  0x2d02ef8dL
-};
-
-unsigned long crc32 (unsigned int crc, const unsigned char *buf, unsigned int len) {
-  if (buf == 0) return 0L;
-  crc = crc ^ 0xffffffffL;
-  while (len >= 8) {
-    DO8(buf);
-    len -= 8;
-  }
-  if (len) do {
-    DO1(buf);
-  } while (--len);
-  return crc ^ 0xffffffffL;
-}
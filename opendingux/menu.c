@@ -384,6 +384,7 @@ void screen_showmainmenu(MENU *menu) {
 	MENUITEM *mi;
 	char szVal[100];
 	int isSta = 0;
+	int saveFailed = 0;
 	unsigned int keya=0, keyb=0, keyup=0, keydown=0, keyleft=0, keyright=0;
 
 	gameMenu=true;
@@ -473,6 +474,9 @@ void screen_showmainmenu(MENU *menu) {
 			screen_showmenu(menu); // show menu items
 			if (menu == &mnuMainMenu) {
 				print_string("V1.0", COLOR_LIGHT,COLOR_BG, 294,29);
+				// a save state written in the background failed
+				if (!state_check()) saveFailed = 1;
+				if (saveFailed) print_string("Last save failed",COLOR_KO,COLOR_BG, 8,240-5 -10*3);
 				if (cartridge_IsLoaded()) {
 #ifdef _OPENDINGUX_
 					sprintf(szVal,"Game:%s",strrchr(gameName,'/')+1);szVal[(320/6)-2] = '\0'; 
@@ -521,7 +525,6 @@ void screen_showtopmenu(void) {
 
 	// save actual config
 	system_savecfg(current_conf_app);
-	atari_analog = GameConf.m_Analog;
 }
 
 //----------------------------------------------------------------------
@@ -905,8 +908,11 @@ void menuSaveState(void) {
 		strcpy(szFile, gameName);
 		strcpy(strrchr(szFile, '.'), ".sta");
 		print_string("Saving...", COLOR_OK, COLOR_BG, 8,240-5 -10*3);
-		//state_store(szFile);
-		print_string("Save OK",COLOR_OK,COLOR_BG, 8+10*8,240-5 -10*3);
+		// written in the background, the menu tells if that fails
+		if (state_store(szFile))
+			print_string("Save started",COLOR_OK,COLOR_BG, 8+10*8,240-5 -10*3);
+		else
+			print_string("Save failed",COLOR_KO,COLOR_BG, 8+10*8,240-5 -10*3);
 		screen_flip();
 		screen_waitkey();
 	}
@@ -920,8 +926,16 @@ void menuLoadState(void) {
 		strcpy(szFile, gameName);
 		strcpy(strrchr(szFile, '.'), ".sta");
 		print_string("Loading...", COLOR_OK, COLOR_BG, 8,240-5 -10*3);
-		//state_restore(szFile);
+		if (!state_restore(szFile)) {
+			print_string("Load failed",COLOR_KO,COLOR_BG, 8+10*8,240-5 -10*3);
+			screen_flip();
+			screen_waitkey();
+			return;
+		}
 		print_string("Load OK",COLOR_OK,COLOR_BG, 8+10*8,240-5 -10*3);
+		// the last save didn't make it: this is the state before it
+		if (!state_check())
+			print_string("Last save failed",COLOR_KO,COLOR_BG, 8,240-5 -10*2);
 		screen_flip();
 		screen_waitkey();
 		gameMenu=false;
@@ -39,7 +39,7 @@
 #include "input.h"
 #include "pia.h"
 
-extern UBYTE *cart_image ;		/* For cartridge memory */
+extern EMU_TLS UBYTE *cart_image ;		/* For cartridge memory */
 
 #define cartridge_IsLoaded() (cart_image != NULL)
 
@@ -63,28 +63,47 @@ extern SDL_Surface *layer,*layerback,*layerbackgrey;//,*layericons;
 
 extern SDL_Event event;
 
-extern SDL_mutex *sndlock;
-
 extern gamecfg GameConf;
 
 extern char gameName[512];
 extern char current_conf_app[MAX__PATH];
 
-extern unsigned char vidBuf[512*512];
+extern EMU_TLS unsigned char vidBuf[512*512];
 
 extern unsigned char *filebuffer;
 
-extern unsigned int gameCRC;
+extern EMU_TLS unsigned int gameCRC;
 
 extern void system_loadcfg(char *cfg_name);
 extern void system_savecfg(char *cfg_name);
 extern void gethomedir(char *dir, char* name);
 
-extern unsigned int atari_analog;
+extern EMU_TLS unsigned int atari_analog;
 
 extern unsigned long crc32 (unsigned int crc, const unsigned char *buf, unsigned int len);
 
-extern int atari_waitoncardtype(unsigned long crcfile);
+// blitter (blit_od.c)
+extern void blit_palette(const unsigned short *pal);
+extern void blit_invalidate(void);
+extern void blit_overlay(SDL_Surface *surface, int first, int lines);
+extern int blit_begin_frame(SDL_Surface *surface, int scanline);
+extern void blit_end_frame(SDL_Surface *surface, int direct);
+extern void blit_present(SDL_Surface *surface, const UBYTE *src, const ULONG *line_gen, ULONG gen,
+	int scanline);
+
+// presenter thread (video_od.c, make VIDEO_THREAD=1)
+extern void video_start(void);
+extern void video_stop(void);
+extern void video_begin_frame(void);
+extern void video_end_frame(void);
+
+extern void graphics_flip(void);
+
+// save states (state_od.c)
+extern int state_store(const char *filename);
+extern int state_restore(const char *filename);
+extern int state_wait(void);
+extern int state_check(void);
 
 // menu
 extern void screen_showtopmenu(void);
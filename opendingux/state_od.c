@@ -0,0 +1,94 @@
+/*
+ * state_od.c - save states of the menu
+ *
+ * state_store() snapshots the machine into memory (SaveAtariStateMem(),
+ * a bulk copy taking microseconds) and leaves writing it to the card,
+ * compressed in a build with zlib, to a thread of its own; the menu
+ * doesn't wait for the card. state_restore() and state_wait() wait for
+ * a write still going on, so a state is never read half written. A write
+ * that fails is told by state_check() the next time the menu looks.
+ */
+
+#include <string.h>
+
+#include "shared.h"
+#include "statesav.h"
+
+typedef struct {
+	char filename[MAX__PATH];
+	UBYTE *buf;
+	int size;
+	int ok;
+} state_write_t;
+
+static state_write_t state_pending;
+static SDL_Thread *state_writer;
+static volatile int state_done;	/* set by the writer as it ends */
+static int state_failed;		/* a write failed, not told yet */
+
+static int state_write(void *arg)
+{
+	state_write_t *w = (state_write_t *) arg;
+
+	w->ok = WriteAtariStateFile(w->filename, "wb", w->buf, w->size);
+	state_done = TRUE;
+	return 0;
+}
+
+/* Waits for the last state_store(). Returns FALSE if it failed. */
+int state_wait(void)
+{
+	if (state_writer == NULL)
+		return TRUE;
+	SDL_WaitThread(state_writer, NULL);
+	state_writer = NULL;
+	free(state_pending.buf);
+	state_pending.buf = NULL;
+	if (!state_pending.ok)
+		state_failed = TRUE;
+	return state_pending.ok;
+}
+
+/* Returns FALSE, once, if a write of state_store() has failed since the
+   last call; a write still going on isn't waited for. */
+int state_check(void)
+{
+	int failed;
+
+	if (state_writer != NULL && state_done)
+		state_wait();
+	failed = state_failed;
+	state_failed = FALSE;
+	return !failed;
+}
+
+int state_store(const char *filename)
+{
+	int size;
+
+	state_wait();
+	size = AtariStateSize(FALSE);
+	state_pending.buf = (UBYTE *) malloc(size);
+	if (state_pending.buf == NULL)
+		return FALSE;
+	state_pending.size = SaveAtariStateMem(state_pending.buf, size, FALSE);
+	strncpy(state_pending.filename, filename, MAX__PATH - 1);
+	state_pending.filename[MAX__PATH - 1] = '\0';
+	state_pending.ok = FALSE;
+	state_done = FALSE;
+	state_writer = SDL_CreateThread(state_write, &state_pending);
+	if (state_writer == NULL) {
+		/* no thread: write it here */
+		state_write(&state_pending);
+		free(state_pending.buf);
+		state_pending.buf = NULL;
+		return state_pending.ok;
+	}
+	return TRUE;
+}
+
+int state_restore(const char *filename)
+{
+	state_wait();
+	return ReadAtariState(filename, "rb");
+}
@@ -0,0 +1,124 @@
+/*
+ * video_od.c - presenting the frames on a thread of their own
+ *
+ * Built with make VIDEO_THREAD=1. The emulation draws each frame with
+ * ANTIC into a back buffer and hands it over; a presenter thread converts
+ * it to the screen format, scales it, draws the FPS counter and flips,
+ * while the emulation goes on with the next frame. The blit and a flip
+ * waiting for the vertical blank are then off the emulation's path and,
+ * on a device with a second core, run next to it.
+ *
+ * The hand-off is a triple buffer: the emulation owns the back buffer,
+ * the presenter the front one, and the third is in between. The index of
+ * the one in between and a flag saying it holds a new frame are a single
+ * word, exchanged with compare-and-swap, so neither side ever takes a
+ * lock or waits for the other; a frame the presenter hasn't taken yet is
+ * replaced by the next one. A semaphore only wakes the presenter up.
+ *
+ * Each buffer also carries the line generations of its frame (see
+ * screen_line_gen[]): the core's own copy belongs to the emulation thread
+ * (and is thread-local in a MULTI_INSTANCE build), and the presenter
+ * needs the ones matching the frame it shows to blit only what changed.
+ */
+
+#include <string.h>
+
+#include "shared.h"
+#include "screen.h"
+
+#ifdef VIDEO_THREAD
+
+#define VIDEO_FRESH 4	/* video_state: the buffer in between holds a new frame */
+
+typedef struct {
+	/* a line in front of the frame for the GTIA mode 11 delay */
+	UBYTE pixels[SCREEN_PITCH * (ATARI_HEIGHT + 1)];
+	ULONG line_gen[ATARI_HEIGHT];
+	ULONG gen;
+} video_buffer;
+
+static video_buffer video_buffers[3];
+static volatile int video_state;	/* buffer in between | VIDEO_FRESH */
+static int video_back, video_front;
+static ULONG video_published;
+
+static SDL_Thread *video_presenter;
+static SDL_sem *video_wakeup;
+static volatile int video_quit;
+
+/* Puts value in video_state, returns the old one. */
+static int video_exchange(int value)
+{
+	int old;
+
+	/* a full barrier: the frame is written before it is handed over,
+	   and read after */
+	do
+		old = video_state;
+	while (!__sync_bool_compare_and_swap(&video_state, old, value));
+	return old;
+}
+
+static int video_present(void *arg)
+{
+	for (;;) {
+		video_buffer *buf;
+
+		SDL_SemWait(video_wakeup);
+		if (video_quit)
+			break;
+		if (!(video_state & VIDEO_FRESH))
+			continue;
+		video_front = video_exchange(video_front) & 3;
+		buf = &video_buffers[video_front];
+		blit_present(actualScreen, buf->pixels + SCREEN_PITCH, buf->line_gen, buf->gen,
+			GameConf.m_Scanline);
+		graphics_flip();
+	}
+	return 0;
+}
+
+void video_start(void)
+{
+	if (video_presenter != NULL)
+		return;
+	if (video_wakeup == NULL) {
+		video_wakeup = SDL_CreateSemaphore(0);
+		video_back = 0;
+		video_state = 1;
+		video_front = 2;
+	}
+	video_quit = 0;
+	video_presenter = SDL_CreateThread(video_present, NULL);
+}
+
+void video_stop(void)
+{
+	if (video_presenter == NULL)
+		return;
+	video_quit = 1;
+	SDL_SemPost(video_wakeup);
+	SDL_WaitThread(video_presenter, NULL);
+	video_presenter = NULL;
+}
+
+void video_begin_frame(void)
+{
+	atari_screen = (UWORD *) (video_buffers[video_back].pixels + SCREEN_PITCH);
+}
+
+void video_end_frame(void)
+{
+	video_buffer *buf = &video_buffers[video_back];
+
+	/* not drawn (refresh rate), the buffer has an older frame */
+	if (screen_frame_gen == video_published)
+		return;
+	video_published = screen_frame_gen;
+	memcpy(buf->line_gen, screen_line_gen, sizeof(buf->line_gen));
+	buf->gen = screen_frame_gen;
+	video_back = video_exchange(video_back | VIDEO_FRESH) & 3;
+	SDL_SemPost(video_wakeup);
+}
+
+#endif /* VIDEO_THREAD */
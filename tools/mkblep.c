@@ -0,0 +1,93 @@
+/*
+ * mkblep.c - generates emu/bleptab.c, the band-limited step kernels of
+ * Pokey_process()
+ *
+ * Run by make bleptab with the host compiler. The output is in the
+ * repository, so building the emulator (or cross-compiling it) doesn't
+ * need this, and no emulated machine builds a kernel at run time.
+ *
+ * BLEP_* must match emu/pokeysnd.h. For each quality q (8 << q taps)
+ * and each of the BLEP_PHASES positions of a step between two samples,
+ * tap j is how much of the step the output takes in sample j: the
+ * differences of the integral of a Blackman-windowed sinc, in fixed
+ * point of BLEP_FRAC bits, summing to 1 << BLEP_FRAC.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define BLEP_PHASE_BITS 6
+#define BLEP_PHASES (1 << BLEP_PHASE_BITS)
+#define BLEP_QUALITIES 3
+#define BLEP_TAPS_MAX (8 << (BLEP_QUALITIES - 1))
+#define BLEP_FRAC 15
+
+static long kernel[BLEP_QUALITIES][BLEP_PHASES][BLEP_TAPS_MAX + 1];
+
+static void build(int quality)
+{
+	int taps = 8 << quality;
+	int half = taps / 2;
+	/* cut off below half the sample rate, leaving room for the slope */
+	double cutoff = 0.5 - 1.0 / taps;
+	double step[BLEP_TAPS_MAX * BLEP_PHASES + 1];
+	double sum = 0;
+	int i, p, j;
+
+	/* the integral of the windowed sinc at every 1/BLEP_PHASES sample,
+	   from -half to half, with 8 points in between */
+	step[0] = 0;
+	for (i = 0; i < taps * BLEP_PHASES * 8; i++) {
+		double u = (i + 0.5) / (BLEP_PHASES * 8) - half;
+		double x = 2 * M_PI * cutoff * u;
+		double w = 0.42 + 0.5 * cos(M_PI * u / half) + 0.08 * cos(2 * M_PI * u / half);
+		sum += (x == 0 ? 1 : sin(x) / x) * w;
+		if ((i + 1) % 8 == 0)
+			step[(i + 1) / 8] = sum;
+	}
+	for (i = 0; i <= taps * BLEP_PHASES; i++)
+		step[i] /= sum;
+
+	/* tap j of position p: from the sample before to the sample
+	   1 + j - p / BLEP_PHASES after the step, half of them late */
+	for (p = 0; p < BLEP_PHASES; p++) {
+		long prev = 0;
+		for (j = 0; j <= taps; j++) {
+			int u = (1 + j) * BLEP_PHASES - p;
+			long level = u >= taps * BLEP_PHASES ? 1L << BLEP_FRAC
+				: (long) (step[u] * (1 << BLEP_FRAC) + 0.5);
+			kernel[quality][p][j] = level - prev;
+			prev = level;
+		}
+		for (; j <= BLEP_TAPS_MAX; j++)
+			kernel[quality][p][j] = 0;
+	}
+}
+
+int main(void)
+{
+	int q, p, j;
+
+	for (q = 0; q < BLEP_QUALITIES; q++)
+		build(q);
+
+	printf("/* Generated by tools/mkblep.c (make bleptab), do not edit. */\n\n");
+	printf("#include \"pokeysnd.h\"\n\n");
+	printf("const int32 blep_kernel[BLEP_QUALITIES][BLEP_PHASES][BLEP_TAPS_MAX + 1] = {");
+	for (q = 0; q < BLEP_QUALITIES; q++) {
+		printf("\n\t{");
+		for (p = 0; p < BLEP_PHASES; p++) {
+			printf("\n\t\t{");
+			for (j = 0; j <= BLEP_TAPS_MAX; j++)
+				printf("%s%ld,", j % 11 == 0 ? "\n\t\t\t" : " ", kernel[q][p][j]);
+			printf("\n\t\t},");
+		}
+		printf("\n\t},");
+	}
+	printf("\n};\n");
+	return 0;
+}
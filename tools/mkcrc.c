@@ -0,0 +1,44 @@
+/*
+ * mkcrc.c - generates emu/crctab.c, the CRC-32 tables of crc32()
+ *
+ * Run by make crctab with the host compiler. The output is in the
+ * repository, so building the emulator (or cross-compiling it) doesn't
+ * need this.
+ *
+ * crc_table[0] is the usual table of the CRC-32 (zlib polynomial) of
+ * each byte value. crc_table[k] is the CRC of that byte followed by k
+ * zero bytes, so crc32() can take 8 bytes at a time with 8 lookups
+ * ("slicing by 8") instead of 8 dependent ones.
+ */
+
+#include <stdio.h>
+
+int main(void)
+{
+	unsigned long table[8][256];
+	unsigned long c;
+	int i, k;
+
+	for (i = 0; i < 256; i++) {
+		c = i;
+		for (k = 0; k < 8; k++)
+			c = c & 1 ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+		table[0][i] = c;
+	}
+	for (i = 0; i < 256; i++)
+		for (k = 1; k < 8; k++)
+			table[k][i] = table[0][table[k - 1][i] & 0xff] ^ (table[k - 1][i] >> 8);
+
+	printf("/* Generated by tools/mkcrc.c (make crctab), do not edit. */\n\n");
+	printf("#include \"atari.h\"\n");
+	printf("#include \"util.h\"\n\n");
+	printf("const ULONG crc_table[8][256] = {");
+	for (k = 0; k < 8; k++) {
+		printf("\n\t{");
+		for (i = 0; i < 256; i++)
+			printf("%s0x%08lx,", i % 6 == 0 ? "\n\t\t" : " ", table[k][i]);
+		printf("\n\t},");
+	}
+	printf("\n};\n");
+	return 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * mkpoly.c - generates emu/polytab.c, the POKEY polynomial tables
+ *
+ * Run by make polytab with the host compiler. The output is in the
+ * repository, so building the emulator (or cross-compiling it) doesn't
+ * need this.
+ *
+ * Both sequences are stored a bit per step, bit (i & 7) of byte i >> 3:
+ * the sound only needs the current bit, and RANDOM reads 8 consecutive
+ * bits from two bytes. poly9_lookup repeats its first bits after the 511
+ * steps so those reads never wrap; poly17_lookup has a byte more than its
+ * 131071 steps, as the table built at run time had.
+ */
+
+#include <stdio.h>
+
+#define POLY9_SIZE  0x01ff
+#define POLY17_SIZE 0x0001ffff
+
+#define POLY9_BYTES  ((POLY9_SIZE + 7 + 7) / 8)
+#define POLY17_BYTES 16385
+
+static void print_table(const char *name, const unsigned char *table, int size)
+{
+	int i;
+
+	printf("const UBYTE %s[%d] = {", name, size);
+	for (i = 0; i < size; i++)
+		printf("%s0x%02x,", i % 12 == 0 ? "\n\t" : " ", table[i]);
+	printf("\n};\n");
+}
+
+int main(void)
+{
+	unsigned char poly9[POLY9_BYTES] = { 0 };
+	unsigned char poly17[POLY17_BYTES];
+	unsigned char seq9[POLY9_SIZE];
+	unsigned long reg;
+	int i;
+
+	/* the 9-bit register: bit 0 after step i + 1 is step i's output,
+	   the byte RANDOM reads is the 8 outputs from step i on */
+	reg = 0x1ff;
+	for (i = 0; i < POLY9_SIZE; i++) {
+		reg = ((((reg >> 5) ^ reg) & 1) << 8) + (reg >> 1);
+		seq9[i] = (unsigned char) (reg & 1);
+	}
+	for (i = 0; i < POLY9_SIZE + 7; i++)
+		poly9[i >> 3] |= seq9[i % POLY9_SIZE] << (i & 7);
+
+	/* the 17-bit register, shifted 8 steps at a time */
+	reg = 0x1ffff;
+	for (i = 0; i < POLY17_BYTES; i++) {
+		reg = ((((reg >> 5) ^ reg) & 0xff) << 9) + (reg >> 8);
+		poly17[i] = (unsigned char) (reg >> 1);
+	}
+
+	printf("/* Generated by tools/mkpoly.c (make polytab), do not edit. */\n\n");
+	printf("#include \"atari.h\"\n");
+	printf("#include \"pokey.h\"\n\n");
+	print_table("poly9_lookup", poly9, POLY9_BYTES);
+	printf("\n");
+	print_table("poly17_lookup", poly17, POLY17_BYTES);
+	return 0;
+}